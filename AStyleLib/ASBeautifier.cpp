@@ -16,9 +16,6 @@
 //-----------------------------------------------------------------------------
 
 namespace astyle {
-//
-// this must be global
-static int g_preprocessorCppExternCBrace;
 
 //-----------------------------------------------------------------------------
 // ASBeautifier class
@@ -31,24 +28,16 @@ static int g_preprocessorCppExternCBrace;
  */
 ASBeautifier::ASBeautifier()
 {
-	waitingBeautifierStack = nullptr;
-	activeBeautifierStack = nullptr;
-	waitingBeautifierStackLengthStack = nullptr;
-	activeBeautifierStackLengthStack = nullptr;
-
-	headerStack = nullptr;
-	tempStacks = nullptr;
-	parenDepthStack = nullptr;
-	blockStatementStack = nullptr;
-	parenStatementStack = nullptr;
-	braceBlockStateStack = nullptr;
-	continuationIndentStack = nullptr;
-	continuationIndentStackSizeStack = nullptr;
-	parenIndentStack = nullptr;
-	preprocIndentStack = nullptr;
+	options = BeautifierOptions();
+	flags = BeautifierFlags();
+	hints = BeautifierHints();
+	lambdaIndicator = false;
+	arena = nullptr;
 	sourceIterator = nullptr;
-	isModeManuallySet = false;
-	shouldForceTabIndentation = false;
+	cppExternCBraceState = 0;
+	cppExternCBrace = &cppExternCBraceState;
+	options.isModeManuallySet = false;
+	options.shouldForceTabIndentation = false;
 	setSpaceIndentation(4);
 	setContinuationIndentation(1);
 	setMinConditionalIndentOption(MINCOND_TWO);
@@ -72,70 +61,53 @@ ASBeautifier::ASBeautifier()
 	setPreprocDefineIndent(false);
 	setPreprocConditionalIndent(false);
 	setAlignMethodColon(false);
-	isInAssignment = false;
+	flags.isInAssignment = false;
 
-	// initialize ASBeautifier member vectors
+	// ASBeautifier member vectors are set by initVectors
 	beautifierFileType = INVALID_TYPE;		// reset to an invalid type
-	headers = new std::vector<const std::string*>;
-	nonParenHeaders = new std::vector<const std::string*>;
-	assignmentOperators = new std::vector<const std::string*>;
-	nonAssignmentOperators = new std::vector<const std::string*>;
-	preBlockStatements = new std::vector<const std::string*>;
-	preCommandHeaders = new std::vector<const std::string*>;
-	indentableHeaders = new std::vector<const std::string*>;
+	headers = nullptr;
+	nonParenHeaders = nullptr;
+	assignmentOperators = nullptr;
+	nonAssignmentOperators = nullptr;
+	preBlockStatements = nullptr;
+	preCommandHeaders = nullptr;
+	indentableHeaders = nullptr;
 }
 
 /**
  * ASBeautifier's copy constructor
- * Copy the vector objects to vectors in the new ASBeautifier
- * object so the new object can be destroyed without deleting
- * the vector objects in the copied vector.
- * This is the reason a copy constructor is needed.
+ * The state stacks are ASStack objects that share their elements
+ * with the copied object until one of them is changed, so a clone
+ * made for a preprocessor directive does not copy the stacks.
+ * The beautifier stacks are not copied.
+ * The clone shares the extern "C" state of the copied object.
  *
  * Must explicitly call the base class copy constructor.
  */
 ASBeautifier::ASBeautifier(const ASBeautifier& other) : ASBase(other)
 {
-	// these don't need to copy the stack
-	waitingBeautifierStack = nullptr;
-	activeBeautifierStack = nullptr;
-	waitingBeautifierStackLengthStack = nullptr;
-	activeBeautifierStackLengthStack = nullptr;
-
-	// vector '=' operator performs a DEEP copy of all elements in the vector
-
-	headerStack = new std::vector<const std::string*>;
-	*headerStack = *other.headerStack;
-
-	tempStacks = copyTempStacks(other);
-
-	parenDepthStack = new std::vector<int>;
-	*parenDepthStack = *other.parenDepthStack;
-
-	blockStatementStack = new std::vector<bool>;
-	*blockStatementStack = *other.blockStatementStack;
-
-	parenStatementStack = new std::vector<bool>;
-	*parenStatementStack = *other.parenStatementStack;
-
-	braceBlockStateStack = new std::vector<bool>;
-	*braceBlockStateStack = *other.braceBlockStateStack;
-
-	continuationIndentStack = new std::vector<int>;
-	*continuationIndentStack = *other.continuationIndentStack;
-
-	continuationIndentStackSizeStack = new std::vector<size_t>;
-	*continuationIndentStackSizeStack = *other.continuationIndentStackSizeStack;
-
-	parenIndentStack = new std::vector<int>;
-	*parenIndentStack = *other.parenIndentStack;
-
-	preprocIndentStack = new std::vector<std::pair<int, int> >;
-	*preprocIndentStack = *other.preprocIndentStack;
+	// the beautifier stacks are not copied, they start empty
+	// the clone allocates from the same arena
+	arena = other.arena;
+	cppExternCBraceState = other.cppExternCBraceState;
+	cppExternCBrace = other.cppExternCBrace;
+
+	// the state stacks are copy-on-write,
+	// the elements are copied only when the clone changes a stack
+	headerStack = other.headerStack;
+	tempStacks = other.tempStacks;
+	parenDepthStack = other.parenDepthStack;
+	blockStatementStack = other.blockStatementStack;
+	parenStatementStack = other.parenStatementStack;
+	braceBlockStateStack = other.braceBlockStateStack;
+	continuationIndentStack = other.continuationIndentStack;
+	continuationIndentStackSizeStack = other.continuationIndentStackSizeStack;
+	parenIndentStack = other.parenIndentStack;
+	preprocIndentStack = other.preprocIndentStack;
 
 	// Copy the pointers to std::vectors.
-	// This is ok because the original ASBeautifier object
-	// is not deleted until end of job.
+	// This is ok because the vectors are shared by all objects
+	// and are never deleted.
 	beautifierFileType = other.beautifierFileType;
 	headers = other.headers;
 	nonParenHeaders = other.nonParenHeaders;
@@ -152,16 +124,7 @@ ASBeautifier::ASBeautifier(const ASBeautifier& other) : ASBase(other)
 	runInIndentContinuation = other.runInIndentContinuation;
 	nonInStatementBrace = other.nonInStatementBrace;
 	objCColonAlignSubsequent = other.objCColonAlignSubsequent;
-	lineCommentNoBeautify = other.lineCommentNoBeautify;
-	isElseHeaderIndent = other.isElseHeaderIndent;
-	isCaseHeaderCommentIndent = other.isCaseHeaderCommentIndent;
-	isNonInStatementArray = other.isNonInStatementArray;
-	isSharpAccessor = other.isSharpAccessor;
-	isSharpDelegate = other.isSharpDelegate;
-	isInExternC = other.isInExternC;
-	isInBeautifySQL = other.isInBeautifySQL;
-	isInIndentableStruct = other.isInIndentableStruct;
-	isInIndentablePreproc = other.isInIndentablePreproc;
+	hints = other.hints;
 
 	// private variables
 	sourceIterator = other.sourceIterator;
@@ -171,75 +134,9 @@ ASBeautifier::ASBeautifier(const ASBeautifier& other) : ASBase(other)
 	lastLineHeader = other.lastLineHeader;
 	indentString = other.indentString;
 	verbatimDelimiter = other.verbatimDelimiter;
-	isInQuote = other.isInQuote;
-	isInVerbatimQuote = other.isInVerbatimQuote;
-	haveLineContinuationChar = other.haveLineContinuationChar;
-	isInAsm = other.isInAsm;
-	isInAsmOneLine = other.isInAsmOneLine;
-	isInAsmBlock = other.isInAsmBlock;
-	isInComment = other.isInComment;
-	isInPreprocessorComment = other.isInPreprocessorComment;
-	isInRunInComment = other.isInRunInComment;
-	isInCase = other.isInCase;
-	isInQuestion = other.isInQuestion;
-	isContinuation = other.isContinuation;
-	isInHeader = other.isInHeader;
-	isInTemplate = other.isInTemplate;
-	isInDefine = other.isInDefine;
-	isInDefineDefinition = other.isInDefineDefinition;
-	classIndent = other.classIndent;
-	isIndentModeOff = other.isIndentModeOff;
-	isInClassHeader = other.isInClassHeader;
-	isInClassHeaderTab = other.isInClassHeaderTab;
-	isInClassInitializer = other.isInClassInitializer;
-	isInClass = other.isInClass;
-	isInObjCMethodDefinition = other.isInObjCMethodDefinition;
-	isInObjCMethodCall = other.isInObjCMethodCall;
-	isInObjCMethodCallFirst = other.isInObjCMethodCallFirst;
-	isImmediatelyPostObjCMethodDefinition = other.isImmediatelyPostObjCMethodDefinition;
-	isImmediatelyPostObjCMethodCall = other.isImmediatelyPostObjCMethodCall;
-	isInIndentablePreprocBlock = other.isInIndentablePreprocBlock;
-	isInObjCInterface = other.isInObjCInterface;
-	isInEnum = other.isInEnum;
-	isInEnumTypeID = other.isInEnumTypeID;
-	isInStruct = other.isInStruct;
-	isInLet = other.isInLet;
-	isInTrailingReturnType = other.isInTrailingReturnType;
-	modifierIndent = other.modifierIndent;
-	switchIndent = other.switchIndent;
-	caseIndent = other.caseIndent;
-	squeezeWhitespace = other.squeezeWhitespace;
-	attemptLambdaIndentation = other.attemptLambdaIndentation;
-	isInAssignment = other.isInAssignment;
-	namespaceIndent = other.namespaceIndent;
-	braceIndent = other.braceIndent;
-	braceIndentVtk = other.braceIndentVtk;
-	blockIndent = other.blockIndent;
-	shouldIndentAfterParen = other.shouldIndentAfterParen;
-	labelIndent = other.labelIndent;
-	isInConditional = other.isInConditional;
-	isModeManuallySet = other.isModeManuallySet;
-	shouldForceTabIndentation = other.shouldForceTabIndentation;
-	emptyLineFill = other.emptyLineFill;
-	lineOpensWithLineComment = other.lineOpensWithLineComment;
-	lineOpensWithComment = other.lineOpensWithComment;
-	lineStartsInComment = other.lineStartsInComment;
-	backslashEndsPrevLine = other.backslashEndsPrevLine;
-	blockCommentNoIndent = other.blockCommentNoIndent;
-	blockCommentNoBeautify = other.blockCommentNoBeautify;
-	previousLineProbationTab = other.previousLineProbationTab;
-	lineBeginsWithOpenBrace = other.lineBeginsWithOpenBrace;
-	lineBeginsWithCloseBrace = other.lineBeginsWithCloseBrace;
-	lineBeginsWithComma = other.lineBeginsWithComma;
-	lineIsCommentOnly = other.lineIsCommentOnly;
-	lineIsLineCommentOnly = other.lineIsLineCommentOnly;
-	shouldIndentBracedLine = other.shouldIndentBracedLine;
-	isInSwitch = other.isInSwitch;
-	foundPreCommandHeader = other.foundPreCommandHeader;
-	foundPreCommandMacro = other.foundPreCommandMacro;
-	shouldAlignMethodColon = other.shouldAlignMethodColon;
-	shouldIndentPreprocDefine = other.shouldIndentPreprocDefine;
-	shouldIndentPreprocConditional = other.shouldIndentPreprocConditional;
+	static_assert(std::is_trivially_copyable<BeautifierFlags>::value, "BeautifierFlags must be trivially copyable");
+	options = other.options;
+	flags = other.flags;		// the bool variables in one copy
 	lambdaIndicator = other.lambdaIndicator;
 
 	indentCount = other.indentCount;
@@ -247,6 +144,7 @@ ASBeautifier::ASBeautifier(const ASBeautifier& other) : ASBase(other)
 	spaceIndentObjCMethodAlignment = other.spaceIndentObjCMethodAlignment;
 	bracePosObjCMethodAlignment = other.bracePosObjCMethodAlignment;
 	colonIndentObjCMethodAlignment = other.colonIndentObjCMethodAlignment;
+	keywordIndentObjCMethodAlignment = other.keywordIndentObjCMethodAlignment;
 	lineOpeningBlocksNum = other.lineOpeningBlocksNum;
 	lineClosingBlocksNum = other.lineClosingBlocksNum;
 	fileType = other.fileType;
@@ -279,18 +177,214 @@ ASBeautifier::~ASBeautifier()
 {
 	deleteBeautifierContainer(waitingBeautifierStack);
 	deleteBeautifierContainer(activeBeautifierStack);
-	deleteContainer(waitingBeautifierStackLengthStack);
-	deleteContainer(activeBeautifierStackLengthStack);
-	deleteContainer(headerStack);
-	deleteTempStacksContainer(tempStacks);
-	deleteContainer(parenDepthStack);
-	deleteContainer(blockStatementStack);
-	deleteContainer(parenStatementStack);
-	deleteContainer(braceBlockStateStack);
-	deleteContainer(continuationIndentStack);
-	deleteContainer(continuationIndentStackSizeStack);
-	deleteContainer(parenIndentStack);
-	deleteContainer(preprocIndentStack);
+}
+
+/**
+ * Delete the beautifier clones and empty the state stacks.
+ * Nothing allocated from the arena is referenced after this,
+ * so the arena can be released.
+ */
+void ASBeautifier::deleteBeautifierState()
+{
+	deleteBeautifierContainer(waitingBeautifierStack);
+	deleteBeautifierContainer(activeBeautifierStack);
+	waitingBeautifierStackLengthStack.clear();
+	activeBeautifierStackLengthStack.clear();
+	headerStack.reset(arena);
+	tempStacks.reset(arena);
+	parenDepthStack.reset(arena);
+	blockStatementStack.reset(arena);
+	parenStatementStack.reset(arena);
+	braceBlockStateStack.reset(arena);
+	continuationIndentStack.reset(arena);
+	continuationIndentStackSizeStack.reset(arena);
+	parenIndentStack.reset(arena);
+	preprocIndentStack.reset(arena);
+}
+
+/**
+ * Give a copy of 'other' a beautifier state of its own.
+ * The copy constructor shares the state stacks and does not copy the
+ * preprocessor clones. This copies the stacks into 'arena_' and copies
+ * the clones recursively, so the copy does not reference the arena of
+ * 'other'. It is used for the ASFormatter checkpoints.
+ *
+ * @param other     the beautifier this was copied from.
+ * @param arena_    the arena for the copied state, or nullptr.
+ * @param iter      the source iterator of the copy.
+ */
+void ASBeautifier::copyBeautifierState(const ASBeautifier& other, ASArena* arena_, ASSourceIterator* iter)
+{
+	deleteBeautifierContainer(waitingBeautifierStack);
+	deleteBeautifierContainer(activeBeautifierStack);
+	arena = arena_;
+	sourceIterator = iter;
+
+	headerStack.rehome(arena);
+	parenDepthStack.rehome(arena);
+	blockStatementStack.rehome(arena);
+	parenStatementStack.rehome(arena);
+	braceBlockStateStack.rehome(arena);
+	continuationIndentStack.rehome(arena);
+	continuationIndentStackSizeStack.rehome(arena);
+	parenIndentStack.rehome(arena);
+	preprocIndentStack.rehome(arena);
+	// the temporary stacks are nested, each one is copied
+	ASStack<ASStack<const std::string*> > stacks;
+	stacks.reset(arena);
+	for (const ASStack<const std::string*>& stack : other.tempStacks)
+	{
+		stacks.push_back(stack);
+		stacks.mutableBack().rehome(arena);
+	}
+	tempStacks = stacks;
+
+	// a copy of a beautifier that is not a clone has its own extern "C" state,
+	// the copied clones share it
+	if (other.cppExternCBrace == &other.cppExternCBraceState)
+	{
+		cppExternCBraceState = other.cppExternCBraceState;
+		cppExternCBrace = &cppExternCBraceState;
+	}
+	for (const ASBeautifier* beautifier : other.waitingBeautifierStack)
+	{
+		waitingBeautifierStack.emplace_back(newBeautifierClone(*beautifier));
+		waitingBeautifierStack.back()->cppExternCBrace = cppExternCBrace;
+		waitingBeautifierStack.back()->copyBeautifierState(*beautifier, arena, iter);
+	}
+	for (const ASBeautifier* beautifier : other.activeBeautifierStack)
+	{
+		activeBeautifierStack.emplace_back(newBeautifierClone(*beautifier));
+		activeBeautifierStack.back()->cppExternCBrace = cppExternCBrace;
+		activeBeautifierStack.back()->copyBeautifierState(*beautifier, arena, iter);
+	}
+	waitingBeautifierStackLengthStack = other.waitingBeautifierStackLengthStack;
+	activeBeautifierStackLengthStack = other.activeBeautifierStackLengthStack;
+}
+
+/**
+ * Compare the beautifier state with another beautifier, including
+ * the options and the preprocessor clones. The arena, the source
+ * iterator and the line number are not compared.
+ * Used by ASFormatter to find where an edited input converges
+ * with a previous checkpoint.
+ *
+ * @param other     the beautifier to compare.
+ * @return          is the state the same.
+ */
+bool ASBeautifier::hasEqualState(const ASBeautifier& other) const
+{
+	if (!equalStateBlocks(options, other.options)
+	        || !equalStateBlocks(flags, other.flags)
+	        || !equalStateBlocks(hints, other.hints)
+	        || headerStack != other.headerStack
+	        || tempStacks != other.tempStacks
+	        || parenDepthStack != other.parenDepthStack
+	        || blockStatementStack != other.blockStatementStack
+	        || parenStatementStack != other.parenStatementStack
+	        || braceBlockStateStack != other.braceBlockStateStack
+	        || continuationIndentStack != other.continuationIndentStack
+	        || continuationIndentStackSizeStack != other.continuationIndentStackSizeStack
+	        || parenIndentStack != other.parenIndentStack
+	        || preprocIndentStack != other.preprocIndentStack
+	        || waitingBeautifierStackLengthStack != other.waitingBeautifierStackLengthStack
+	        || activeBeautifierStackLengthStack != other.activeBeautifierStackLengthStack
+	        || waitingBeautifierStack.size() != other.waitingBeautifierStack.size()
+	        || activeBeautifierStack.size() != other.activeBeautifierStack.size())
+		return false;
+
+	if (runInIndentContinuation != other.runInIndentContinuation
+	        || nonInStatementBrace != other.nonInStatementBrace
+	        || objCColonAlignSubsequent != other.objCColonAlignSubsequent
+	        || lambdaIndicator != other.lambdaIndicator)
+		return false;
+
+	if (beautifierFileType != other.beautifierFileType
+	        || headers != other.headers
+	        || currentHeader != other.currentHeader
+	        || previousLastLineHeader != other.previousLastLineHeader
+	        || probationHeader != other.probationHeader
+	        || lastLineHeader != other.lastLineHeader
+	        || indentString != other.indentString
+	        || verbatimDelimiter != other.verbatimDelimiter
+	        || squeezeWSStack != other.squeezeWSStack)
+		return false;
+
+	if (indentCount != other.indentCount
+	        || spaceIndentCount != other.spaceIndentCount
+	        || spaceIndentObjCMethodAlignment != other.spaceIndentObjCMethodAlignment
+	        || bracePosObjCMethodAlignment != other.bracePosObjCMethodAlignment
+	        || colonIndentObjCMethodAlignment != other.colonIndentObjCMethodAlignment
+	        || keywordIndentObjCMethodAlignment != other.keywordIndentObjCMethodAlignment
+	        || *cppExternCBrace != *other.cppExternCBrace
+	        || lineOpeningBlocksNum != other.lineOpeningBlocksNum
+	        || lineClosingBlocksNum != other.lineClosingBlocksNum
+	        || fileType != other.fileType
+	        || minConditionalOption != other.minConditionalOption
+	        || minConditionalIndent != other.minConditionalIndent
+	        || parenDepth != other.parenDepth
+	        || indentLength != other.indentLength
+	        || tabLength != other.tabLength
+	        || continuationIndent != other.continuationIndent
+	        || blockTabCount != other.blockTabCount
+	        || maxContinuationIndent != other.maxContinuationIndent
+	        || classInitializerIndents != other.classInitializerIndents
+	        || templateDepth != other.templateDepth
+	        || squareBracketCount != other.squareBracketCount
+	        || prevFinalLineSpaceIndentCount != other.prevFinalLineSpaceIndentCount
+	        || prevFinalLineIndentCount != other.prevFinalLineIndentCount
+	        || defineIndentCount != other.defineIndentCount
+	        || preprocBlockIndent != other.preprocBlockIndent
+	        || quoteChar != other.quoteChar
+	        || prevNonSpaceCh != other.prevNonSpaceCh
+	        || currentNonSpaceCh != other.currentNonSpaceCh
+	        || currentNonLegalCh != other.currentNonLegalCh
+	        || prevNonLegalCh != other.prevNonLegalCh)
+		return false;
+
+	for (size_t i = 0; i < waitingBeautifierStack.size(); i++)
+		if (!waitingBeautifierStack[i]->hasEqualState(*other.waitingBeautifierStack[i]))
+			return false;
+	for (size_t i = 0; i < activeBeautifierStack.size(); i++)
+		if (!activeBeautifierStack[i]->hasEqualState(*other.activeBeautifierStack[i]))
+			return false;
+	return true;
+}
+
+/**
+ * Set the arena used for the clones and the state stacks.
+ * It is used starting with the next init().
+ * A nullptr arena uses the global heap.
+ */
+void ASBeautifier::setArena(ASArena* arena_)
+{
+	arena = arena_;
+}
+
+/**
+ * Clone a beautifier for a preprocessor directive.
+ * The clone is allocated from the arena if there is one.
+ */
+ASBeautifier* ASBeautifier::newBeautifierClone(const ASBeautifier& other) const
+{
+	if (arena == nullptr)
+		return new ASBeautifier(other);
+	void* memory = arena->allocate(sizeof(ASBeautifier), alignof(ASBeautifier));
+	return new (memory) ASBeautifier(other);
+}
+
+/**
+ * Delete a beautifier created by newBeautifierClone().
+ */
+void ASBeautifier::deleteBeautifierClone(ASBeautifier* beautifier) const
+{
+	if (arena == nullptr)
+	{
+		delete beautifier;
+		return;
+	}
+	beautifier->~ASBeautifier();
+	arena->deallocate(beautifier, sizeof(ASBeautifier), alignof(ASBeautifier));
 }
 
 /**
@@ -309,66 +403,53 @@ void ASBeautifier::init(ASSourceIterator* iter)
 	sourceIterator = iter;
 	initVectors();
 	ASBase::init(getFileType());
-	g_preprocessorCppExternCBrace = 0;
-
-	initContainer(waitingBeautifierStack, new std::vector<ASBeautifier*>);
-	initContainer(activeBeautifierStack, new std::vector<ASBeautifier*>);
-
-	initContainer(waitingBeautifierStackLengthStack, new std::vector<size_t>);
-	initContainer(activeBeautifierStackLengthStack, new std::vector<size_t>);
+	*cppExternCBrace = 0;
 
-	initContainer(headerStack, new std::vector<const std::string*>);
+	// the previous session must not use the arena after it is released
+	deleteBeautifierState();
+	if (arena != nullptr)
+		arena->release();
 
-	initTempStacksContainer(tempStacks, new std::vector<std::vector<const std::string*>*>);
-	tempStacks->emplace_back(new std::vector<const std::string*>);
-
-	initContainer(parenDepthStack, new std::vector<int>);
-	initContainer(blockStatementStack, new std::vector<bool>);
-	initContainer(parenStatementStack, new std::vector<bool>);
-	initContainer(braceBlockStateStack, new std::vector<bool>);
+	tempStacks.emplace_back();
 	// do not use emplace_back on std::vector<bool> until supported by macOS
-	braceBlockStateStack->push_back(true);
-	initContainer(continuationIndentStack, new std::vector<int>);
-	initContainer(continuationIndentStackSizeStack, new std::vector<size_t>);
-	continuationIndentStackSizeStack->emplace_back(0);
-	initContainer(parenIndentStack, new std::vector<int>);
-	initContainer(preprocIndentStack, new std::vector<std::pair<int, int> >);
+	braceBlockStateStack.push_back(true);
+	continuationIndentStackSizeStack.emplace_back(0);
 
 	previousLastLineHeader = nullptr;
 	currentHeader = nullptr;
 
-	isInQuote = false;
-	isInVerbatimQuote = false;
-	haveLineContinuationChar = false;
-	isInAsm = false;
-	isInAsmOneLine = false;
-	isInAsmBlock = false;
-	isInComment = false;
-	isInPreprocessorComment = false;
-	isInRunInComment = false;
-	isContinuation = false;
-	isInCase = false;
-	isInQuestion = false;
-	isIndentModeOff = false;
-	isInClassHeader = false;
-	isInClassHeaderTab = false;
-	isInClassInitializer = false;
-	isInClass = false;
-	isInObjCMethodDefinition = false;
-	isInObjCMethodCall = false;
-	isInObjCMethodCallFirst = false;
-	isImmediatelyPostObjCMethodDefinition = false;
-	isImmediatelyPostObjCMethodCall = false;
-	isInIndentablePreprocBlock = false;
-	isInObjCInterface = false;
-	isInEnum = false;
-	isInEnumTypeID = false;
-	isInStruct = false;
-	isInLet = false;
-	isInHeader = false;
-	isInTemplate = false;
-	isInConditional = false;
-	isInTrailingReturnType = false;
+	flags.isInQuote = false;
+	flags.isInVerbatimQuote = false;
+	flags.haveLineContinuationChar = false;
+	flags.isInAsm = false;
+	flags.isInAsmOneLine = false;
+	flags.isInAsmBlock = false;
+	flags.isInComment = false;
+	flags.isInPreprocessorComment = false;
+	flags.isInRunInComment = false;
+	flags.isContinuation = false;
+	flags.isInCase = false;
+	flags.isInQuestion = false;
+	flags.isIndentModeOff = false;
+	flags.isInClassHeader = false;
+	flags.isInClassHeaderTab = false;
+	flags.isInClassInitializer = false;
+	flags.isInClass = false;
+	flags.isInObjCMethodDefinition = false;
+	flags.isInObjCMethodCall = false;
+	flags.isInObjCMethodCallFirst = false;
+	flags.isImmediatelyPostObjCMethodDefinition = false;
+	flags.isImmediatelyPostObjCMethodCall = false;
+	flags.isInIndentablePreprocBlock = false;
+	flags.isInObjCInterface = false;
+	flags.isInEnum = false;
+	flags.isInEnumTypeID = false;
+	flags.isInStruct = false;
+	flags.isInLet = false;
+	flags.isInHeader = false;
+	flags.isInTemplate = false;
+	flags.isInConditional = false;
+	flags.isInTrailingReturnType = false;
 	lambdaIndicator = false;
 
 	indentCount = 0;
@@ -376,6 +457,7 @@ void ASBeautifier::init(ASSourceIterator* iter)
 	spaceIndentObjCMethodAlignment = 0;
 	bracePosObjCMethodAlignment = 0;
 	colonIndentObjCMethodAlignment = 0;
+	keywordIndentObjCMethodAlignment = 0;
 	lineOpeningBlocksNum = 0;
 	lineClosingBlocksNum = 0;
 	templateDepth = 0;
@@ -393,35 +475,35 @@ void ASBeautifier::init(ASSourceIterator* iter)
 	quoteChar = ' ';
 	probationHeader = nullptr;
 	lastLineHeader = nullptr;
-	backslashEndsPrevLine = false;
-	lineOpensWithLineComment = false;
-	lineOpensWithComment = false;
-	lineStartsInComment = false;
-	isInDefine = false;
-	isInDefineDefinition = false;
-	lineCommentNoBeautify = false;
-	isElseHeaderIndent = false;
-	isCaseHeaderCommentIndent = false;
-	blockCommentNoIndent = false;
-	blockCommentNoBeautify = false;
-	previousLineProbationTab = false;
-	lineBeginsWithOpenBrace = false;
-	lineBeginsWithCloseBrace = false;
-	lineBeginsWithComma = false;
-	lineIsCommentOnly = false;
-	lineIsLineCommentOnly = false;
-	shouldIndentBracedLine = true;
-	isInSwitch = false;
-	foundPreCommandHeader = false;
-	foundPreCommandMacro = false;
-
-	isNonInStatementArray = false;
-	isSharpAccessor = false;
-	isSharpDelegate = false;
-	isInExternC = false;
-	isInBeautifySQL = false;
-	isInIndentableStruct = false;
-	isInIndentablePreproc = false;
+	flags.backslashEndsPrevLine = false;
+	flags.lineOpensWithLineComment = false;
+	flags.lineOpensWithComment = false;
+	flags.lineStartsInComment = false;
+	flags.isInDefine = false;
+	flags.isInDefineDefinition = false;
+	hints.lineCommentNoBeautify = false;
+	hints.isElseHeaderIndent = false;
+	hints.isCaseHeaderCommentIndent = false;
+	flags.blockCommentNoIndent = false;
+	flags.blockCommentNoBeautify = false;
+	flags.previousLineProbationTab = false;
+	flags.lineBeginsWithOpenBrace = false;
+	flags.lineBeginsWithCloseBrace = false;
+	flags.lineBeginsWithComma = false;
+	flags.lineIsCommentOnly = false;
+	flags.lineIsLineCommentOnly = false;
+	flags.shouldIndentBracedLine = true;
+	flags.isInSwitch = false;
+	flags.foundPreCommandHeader = false;
+	flags.foundPreCommandMacro = false;
+
+	hints.isNonInStatementArray = false;
+	hints.isSharpAccessor = false;
+	hints.isSharpDelegate = false;
+	hints.isInExternC = false;
+	hints.isInBeautifySQL = false;
+	hints.isInIndentableStruct = false;
+	hints.isInIndentablePreproc = false;
 
 	inLineNumber = 0;
 	runInIndentContinuation = 0;
@@ -439,21 +521,14 @@ void ASBeautifier::initVectors()
 
 	beautifierFileType = fileType;
 
-	headers->clear();
-	nonParenHeaders->clear();
-	assignmentOperators->clear();
-	nonAssignmentOperators->clear();
-	preBlockStatements->clear();
-	preCommandHeaders->clear();
-	indentableHeaders->clear();
-
-	ASResource::buildHeaders(headers, fileType, true);
-	ASResource::buildNonParenHeaders(nonParenHeaders, fileType, true);
-	ASResource::buildAssignmentOperators(assignmentOperators);
-	ASResource::buildNonAssignmentOperators(nonAssignmentOperators);
-	ASResource::buildPreBlockStatements(preBlockStatements, fileType);
-	ASResource::buildPreCommandHeaders(preCommandHeaders, fileType);
-	ASResource::buildIndentableHeaders(indentableHeaders);
+	const ASLanguageVectors& languageVectors = ASLanguageVectors::get(fileType);
+	headers = &languageVectors.beautifierHeaderSet;
+	nonParenHeaders = &languageVectors.beautifierNonParenHeaders;
+	assignmentOperators = &languageVectors.assignmentOperatorSet;
+	nonAssignmentOperators = &languageVectors.nonAssignmentOperatorSet;
+	preBlockStatements = &languageVectors.preBlockStatementSet;
+	preCommandHeaders = &languageVectors.preCommandHeaderSet;
+	indentableHeaders = &languageVectors.indentableHeaderSet;
 }
 
 /**
@@ -467,32 +542,32 @@ void ASBeautifier::initVectors()
 std::string ASBeautifier::beautify(const std::string& originalLine)
 {
 	std::string line;
-	bool isInQuoteContinuation = isInVerbatimQuote || haveLineContinuationChar;
+	bool isInQuoteContinuation = flags.isInVerbatimQuote || flags.haveLineContinuationChar;
 
 	currentHeader = nullptr;
 	lastLineHeader = nullptr;
-	blockCommentNoBeautify = blockCommentNoIndent;
-	isInClass = false;
-	isInSwitch = false;
-	lineBeginsWithOpenBrace = false;
-	lineBeginsWithCloseBrace = false;
-	lineBeginsWithComma = false;
-	lineIsCommentOnly = false;
-	lineIsLineCommentOnly = false;
-	shouldIndentBracedLine = true;
-	isInAsmOneLine = false;
-	lineOpensWithLineComment = false;
-	lineOpensWithComment = false;
-	lineStartsInComment = isInComment;
-	previousLineProbationTab = false;
+	flags.blockCommentNoBeautify = flags.blockCommentNoIndent;
+	flags.isInClass = false;
+	flags.isInSwitch = false;
+	flags.lineBeginsWithOpenBrace = false;
+	flags.lineBeginsWithCloseBrace = false;
+	flags.lineBeginsWithComma = false;
+	flags.lineIsCommentOnly = false;
+	flags.lineIsLineCommentOnly = false;
+	flags.shouldIndentBracedLine = true;
+	flags.isInAsmOneLine = false;
+	flags.lineOpensWithLineComment = false;
+	flags.lineOpensWithComment = false;
+	flags.lineStartsInComment = flags.isInComment;
+	flags.previousLineProbationTab = false;
 	lineOpeningBlocksNum = 0;
 	lineClosingBlocksNum = 0;
-	if (isImmediatelyPostObjCMethodDefinition)
+	if (flags.isImmediatelyPostObjCMethodDefinition)
 		clearObjCMethodDefinitionAlignment();
-	if (isImmediatelyPostObjCMethodCall)
+	if (flags.isImmediatelyPostObjCMethodCall)
 	{
-		isImmediatelyPostObjCMethodCall = false;
-		isInObjCMethodCall = false;
+		flags.isImmediatelyPostObjCMethodCall = false;
+		flags.isInObjCMethodCall = false;
 		objCColonAlignSubsequent = 0;
 	}
 
@@ -506,7 +581,7 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 		if (!(originalLine.length() == 1 && originalLine[0] == ' '))
 			line = originalLine;
 	}
-	else if (isInComment || isInBeautifySQL)
+	else if (flags.isInComment || hints.isInBeautifySQL)
 	{
 		// trim the end of comment and SQL lines
 		line = originalLine;
@@ -522,11 +597,11 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 		if (firstChar != std::string::npos)
 		{
 			if (line[firstChar] == '{')
-				lineBeginsWithOpenBrace = true;
+				flags.lineBeginsWithOpenBrace = true;
 			else if (line[firstChar] == '}')
-				lineBeginsWithCloseBrace = true;
+				flags.lineBeginsWithCloseBrace = true;
 			else if (line[firstChar] == ',')
-				lineBeginsWithComma = true;
+				flags.lineBeginsWithComma = true;
 		}
 	}
 	else
@@ -535,63 +610,63 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 		if (line.length() > 0)
 		{
 			if (line[0] == '{')
-				lineBeginsWithOpenBrace = true;
+				flags.lineBeginsWithOpenBrace = true;
 			else if (line[0] == '}')
-				lineBeginsWithCloseBrace = true;
+				flags.lineBeginsWithCloseBrace = true;
 			else if (line[0] == ',')
-				lineBeginsWithComma = true;
+				flags.lineBeginsWithComma = true;
 			else if (line.compare(0, 2, "//") == 0)
-				lineIsLineCommentOnly = true;
+				flags.lineIsLineCommentOnly = true;
 			else if (line.compare(0, 2, "/*") == 0)
 			{
 				if (line.find("*/", 2) != std::string::npos)
-					lineIsCommentOnly = true;
+					flags.lineIsCommentOnly = true;
 			}
 		}
 
-		isInRunInComment = false;
+		flags.isInRunInComment = false;
 		size_t j = line.find_first_not_of(" \t{");
 		if (j != std::string::npos && line.compare(j, 2, "//") == 0)
-			lineOpensWithLineComment = true;
+			flags.lineOpensWithLineComment = true;
 		if (j != std::string::npos && line.compare(j, 2, "/*") == 0)
 		{
-			lineOpensWithComment = true;
+			flags.lineOpensWithComment = true;
 			size_t k = line.find_first_not_of(" \t");
 			if (k != std::string::npos && line.compare(k, 1, "{") == 0)
-				isInRunInComment = true;
+				flags.isInRunInComment = true;
 		}
 	}
 
 	// When indent is OFF the lines must still be processed by ASBeautifier.
 	// Otherwise the lines immediately following may not be indented correctly.
-	if ((lineIsLineCommentOnly || lineIsCommentOnly)
+	if ((flags.lineIsLineCommentOnly || flags.lineIsCommentOnly)
 	        && line.find("*INDENT-OFF*", 0) != std::string::npos)
-		isIndentModeOff = true;
+		flags.isIndentModeOff = true;
 
 	if (line.length() == 0)
 	{
-		if (backslashEndsPrevLine)
+		if (flags.backslashEndsPrevLine)
 		{
-			backslashEndsPrevLine = false;
+			flags.backslashEndsPrevLine = false;
 			// check if this line ends a multi-line #define
 			// if so, remove the #define's cloned beautifier from the active
 			// beautifier stack and delete it.
-			if (isInDefineDefinition && !isInDefine)
+			if (flags.isInDefineDefinition && !flags.isInDefine)
 			{
-				isInDefineDefinition = false;
-				if (!activeBeautifierStack->empty())
+				flags.isInDefineDefinition = false;
+				if (!activeBeautifierStack.empty())
 				{
-					ASBeautifier* defineBeautifier = activeBeautifierStack->back();
-					activeBeautifierStack->pop_back();
-					delete defineBeautifier;
+					ASBeautifier* defineBeautifier = activeBeautifierStack.back();
+					activeBeautifierStack.pop_back();
+					deleteBeautifierClone(defineBeautifier);
 				}
 			}
 		}
-		if (emptyLineFill && !isInQuoteContinuation)
+		if (options.emptyLineFill && !isInQuoteContinuation)
 		{
-			if (isInIndentablePreprocBlock)
+			if (flags.isInIndentablePreprocBlock)
 				return preLineWS(preprocBlockIndent, 0);
-			if (!headerStack->empty() || isInEnum || isInStruct)
+			if (!headerStack.empty() || flags.isInEnum || flags.isInStruct)
 				return preLineWS(prevFinalLineIndentCount, prevFinalLineSpaceIndentCount);
 			// must fall thru here
 		}
@@ -600,12 +675,12 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 	}
 
 	// handle preprocessor commands
-	if (isInIndentablePreprocBlock
+	if (flags.isInIndentablePreprocBlock
 	        && line.length() > 0
 	        && line[0] != '#')
 	{
 		std::string indentedLine;
-		if (isInClassHeaderTab || isInClassInitializer)
+		if (flags.isInClassHeaderTab || flags.isInClassInitializer)
 		{
 			// parsing is turned off in ASFormatter by indent-off
 			// the originalLine will probably never be returned here
@@ -616,24 +691,24 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 		return getIndentedLineReturn(indentedLine, originalLine);
 	}
 
-	if (!isInComment
+	if (!flags.isInComment
 	        && !isInQuoteContinuation
 	        && line.length() > 0
 	        && ((line[0] == '#' && !isIndentedPreprocessor(line, 0))
-	            || backslashEndsPrevLine))
+	            || flags.backslashEndsPrevLine))
 	{
-		if (line[0] == '#' && !isInDefine)
+		if (line[0] == '#' && !flags.isInDefine)
 		{
 			std::string preproc = extractPreprocessorStatement(line);
 			processPreprocessor(preproc, line);
-			if (isInIndentablePreprocBlock || isInIndentablePreproc)
+			if (flags.isInIndentablePreprocBlock || hints.isInIndentablePreproc)
 			{
 				std::string indentedLine;
 				if (preproc.length() >= 2 && preproc.substr(0, 2) == "if") // #if, #ifdef, #ifndef
 				{
 					indentedLine = preLineWS(preprocBlockIndent, 0) + line;
 					preprocBlockIndent += 1;
-					isInIndentablePreprocBlock = true;
+					flags.isInIndentablePreprocBlock = true;
 				}
 				else if (preproc == "else" || preproc == "elif")
 				{
@@ -644,43 +719,43 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 					preprocBlockIndent -= 1;
 					indentedLine = preLineWS(preprocBlockIndent, 0) + line;
 					if (preprocBlockIndent == 0)
-						isInIndentablePreprocBlock = false;
+						flags.isInIndentablePreprocBlock = false;
 				}
 				else
 					indentedLine = preLineWS(preprocBlockIndent, 0) + line;
 				return getIndentedLineReturn(indentedLine, originalLine);
 			}
-			if (shouldIndentPreprocConditional && preproc.length() > 0)
+			if (options.shouldIndentPreprocConditional && preproc.length() > 0)
 			{
 				std::string indentedLine;
 				if (preproc.length() >= 2 && preproc.substr(0, 2) == "if") // #if, #ifdef, #ifndef
 				{
 					std::pair<int, int> entry;	// indentCount, spaceIndentCount
-					if (!isInDefine && activeBeautifierStack != nullptr && !activeBeautifierStack->empty())
-						entry = activeBeautifierStack->back()->computePreprocessorIndent();
+					if (!flags.isInDefine && !activeBeautifierStack.empty())
+						entry = activeBeautifierStack.back()->computePreprocessorIndent();
 					else
 						entry = computePreprocessorIndent();
-					preprocIndentStack->emplace_back(entry);
-					indentedLine = preLineWS(preprocIndentStack->back().first,
-					                         preprocIndentStack->back().second) + line;
+					preprocIndentStack.emplace_back(entry);
+					indentedLine = preLineWS(preprocIndentStack.back().first,
+					                         preprocIndentStack.back().second) + line;
 					return getIndentedLineReturn(indentedLine, originalLine);
 				}
 				if (preproc == "else" || preproc == "elif")
 				{
-					if (!preprocIndentStack->empty())	// if no entry don't indent
+					if (!preprocIndentStack.empty())	// if no entry don't indent
 					{
-						indentedLine = preLineWS(preprocIndentStack->back().first,
-						                         preprocIndentStack->back().second) + line;
+						indentedLine = preLineWS(preprocIndentStack.back().first,
+						                         preprocIndentStack.back().second) + line;
 						return getIndentedLineReturn(indentedLine, originalLine);
 					}
 				}
 				else if (preproc == "endif")
 				{
-					if (!preprocIndentStack->empty())	// if no entry don't indent
+					if (!preprocIndentStack.empty())	// if no entry don't indent
 					{
-						indentedLine = preLineWS(preprocIndentStack->back().first,
-						                         preprocIndentStack->back().second) + line;
-						preprocIndentStack->pop_back();
+						indentedLine = preLineWS(preprocIndentStack.back().first,
+						                         preprocIndentStack.back().second) + line;
+						preprocIndentStack.pop_back();
 						return getIndentedLineReturn(indentedLine, originalLine);
 					}
 				}
@@ -689,66 +764,57 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 
 		// check if the last char is a backslash
 		if (line.length() > 0)
-			backslashEndsPrevLine = (line[line.length() - 1] == '\\');
+			flags.backslashEndsPrevLine = (line[line.length() - 1] == '\\');
 		// comments within the definition line can be continued without the backslash
 		if (isInPreprocessorUnterminatedComment(line))
-			backslashEndsPrevLine = true;
+			flags.backslashEndsPrevLine = true;
 
 		// check if this line ends a multi-line #define
 		// if so, use the #define's cloned beautifier for the line's indentation
 		// and then remove it from the active beautifier stack and delete it.
-		if (!backslashEndsPrevLine && isInDefineDefinition && !isInDefine)
+		if (!flags.backslashEndsPrevLine && flags.isInDefineDefinition && !flags.isInDefine)
 		{
-			isInDefineDefinition = false;
+			flags.isInDefineDefinition = false;
 			// this could happen with invalid input
-			if (activeBeautifierStack->empty())
+			if (activeBeautifierStack.empty())
 				return originalLine;
-			ASBeautifier* defineBeautifier = activeBeautifierStack->back();
-			activeBeautifierStack->pop_back();
+			ASBeautifier* defineBeautifier = activeBeautifierStack.back();
+			activeBeautifierStack.pop_back();
 
 			std::string indentedLine = defineBeautifier->beautify(line);
-			delete defineBeautifier;
+			deleteBeautifierClone(defineBeautifier);
 			return getIndentedLineReturn(indentedLine, originalLine);
 		}
 
 		// unless this is a multi-line #define, return this precompiler line as is.
-		if (!isInDefine && !isInDefineDefinition)
+		if (!flags.isInDefine && !flags.isInDefineDefinition)
 			return originalLine;
 	}
 
 	// if there exists any worker beautifier in the activeBeautifierStack,
 	// then use it instead of me to indent the current line.
 	// variables set by ASFormatter must be updated.
-	if (!isInDefine && activeBeautifierStack != nullptr && !activeBeautifierStack->empty())
+	if (!flags.isInDefine && !activeBeautifierStack.empty())
 	{
-		activeBeautifierStack->back()->inLineNumber = inLineNumber;
-		activeBeautifierStack->back()->runInIndentContinuation = runInIndentContinuation;
-		activeBeautifierStack->back()->nonInStatementBrace = nonInStatementBrace;
-		activeBeautifierStack->back()->objCColonAlignSubsequent = objCColonAlignSubsequent;
-		activeBeautifierStack->back()->lineCommentNoBeautify = lineCommentNoBeautify;
-		activeBeautifierStack->back()->isElseHeaderIndent = isElseHeaderIndent;
-		activeBeautifierStack->back()->isCaseHeaderCommentIndent = isCaseHeaderCommentIndent;
-		activeBeautifierStack->back()->isNonInStatementArray = isNonInStatementArray;
-		activeBeautifierStack->back()->isSharpAccessor = isSharpAccessor;
-		activeBeautifierStack->back()->isSharpDelegate = isSharpDelegate;
-		activeBeautifierStack->back()->isInExternC = isInExternC;
-		activeBeautifierStack->back()->isInBeautifySQL = isInBeautifySQL;
-		activeBeautifierStack->back()->isInIndentableStruct = isInIndentableStruct;
-		activeBeautifierStack->back()->isInIndentablePreproc = isInIndentablePreproc;
+		activeBeautifierStack.back()->inLineNumber = inLineNumber;
+		activeBeautifierStack.back()->runInIndentContinuation = runInIndentContinuation;
+		activeBeautifierStack.back()->nonInStatementBrace = nonInStatementBrace;
+		activeBeautifierStack.back()->objCColonAlignSubsequent = objCColonAlignSubsequent;
+		activeBeautifierStack.back()->hints = hints;
 		// must return originalLine not the trimmed line
-		return activeBeautifierStack->back()->beautify(originalLine);
+		return activeBeautifierStack.back()->beautify(originalLine);
 	}
 
 	// Flag an indented header in case this line is a one-line block.
 	// The header in the header stack will be deleted by a one-line block.
 	bool isInExtraHeaderIndent = false;
-	if (!headerStack->empty()
-	        && lineBeginsWithOpenBrace
-	        && (headerStack->back() != &AS_OPEN_BRACE
+	if (!headerStack.empty()
+	        && flags.lineBeginsWithOpenBrace
+	        && (headerStack.back() != &AS_OPEN_BRACE
 	            || probationHeader != nullptr))
 		isInExtraHeaderIndent = true;
 
-	size_t iPrelim = headerStack->size();
+	size_t iPrelim = headerStack.size();
 
 	// calculate preliminary indentation based on headerStack and data from past lines
 	computePreliminaryIndentation();
@@ -765,13 +831,13 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 	// handle special cases of indentation
 	adjustParsedLineIndentation(iPrelim, isInExtraHeaderIndent);
 
-	if (isInObjCMethodDefinition)
+	if (flags.isInObjCMethodDefinition)
 		adjustObjCMethodDefinitionIndentation(line);
 
-	if (isInObjCMethodCall)
+	if (flags.isInObjCMethodCall)
 		adjustObjCMethodCallIndentation(line);
 
-	if (isInDefine)
+	if (flags.isInDefine)
 	{
 		if (line.length() > 0 && line[0] == '#')
 		{
@@ -779,8 +845,8 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 			std::string preproc = trim(line.substr(1));
 			if (preproc.compare(0, 6, "define") == 0)
 			{
-				if (!continuationIndentStack->empty()
-				        && continuationIndentStack->back() > 0)
+				if (!continuationIndentStack.empty()
+				        && continuationIndentStack.back() > 0)
 				{
 					defineIndentCount = indentCount;
 				}
@@ -798,7 +864,7 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 	if (indentCount < 0)
 		indentCount = 0;
 
-	if (lineCommentNoBeautify || blockCommentNoBeautify || isInQuoteContinuation)
+	if (hints.lineCommentNoBeautify || flags.blockCommentNoBeautify || isInQuoteContinuation)
 		indentCount = spaceIndentCount = 0;
 
 	// finally, insert indentations into beginning of line
@@ -811,9 +877,9 @@ std::string ASBeautifier::beautify(const std::string& originalLine)
 	if (lastLineHeader != nullptr)
 		previousLastLineHeader = lastLineHeader;
 
-	if ((lineIsLineCommentOnly || lineIsCommentOnly)
+	if ((flags.lineIsLineCommentOnly || flags.lineIsCommentOnly)
 	        && line.find("*INDENT-ON*", 0) != std::string::npos)
-		isIndentModeOff = false;
+		flags.isIndentModeOff = false;
 
 	return indentedLine;
 }
@@ -863,7 +929,7 @@ void ASBeautifier::setSharpStyle()
  */
 void ASBeautifier::setModeManuallySet(bool state)
 {
-	isModeManuallySet = state;
+	options.isModeManuallySet = state;
 }
 
 /**
@@ -887,7 +953,7 @@ void ASBeautifier::setForceTabXIndentation(int length)
 	// set tabLength instead of indentLength
 	indentString = "\t";
 	tabLength = length;
-	shouldForceTabIndentation = true;
+	options.shouldForceTabIndentation = true;
 }
 
 /**
@@ -897,7 +963,7 @@ void ASBeautifier::setTabIndentation(int length, bool forceTabs)
 {
 	indentString = "\t";
 	indentLength = length;
-	shouldForceTabIndentation = forceTabs;
+	options.shouldForceTabIndentation = forceTabs;
 }
 
 /**
@@ -973,7 +1039,7 @@ void ASBeautifier::setMinConditionalIndentLength()
  */
 void ASBeautifier::setBraceIndent(bool state)
 {
-	braceIndent = state;
+	options.braceIndent = state;
 }
 
 /**
@@ -986,7 +1052,7 @@ void ASBeautifier::setBraceIndentVtk(bool state)
 {
 	// need to set both of these
 	setBraceIndent(state);
-	braceIndentVtk = state;
+	options.braceIndentVtk = state;
 }
 
 /**
@@ -997,7 +1063,7 @@ void ASBeautifier::setBraceIndentVtk(bool state)
  */
 void ASBeautifier::setBlockIndent(bool state)
 {
-	blockIndent = state;
+	options.blockIndent = state;
 }
 
 /**
@@ -1008,7 +1074,7 @@ void ASBeautifier::setBlockIndent(bool state)
  */
 void ASBeautifier::setClassIndent(bool state)
 {
-	classIndent = state;
+	options.classIndent = state;
 }
 
 /**
@@ -1019,7 +1085,7 @@ void ASBeautifier::setClassIndent(bool state)
  */
 void ASBeautifier::setModifierIndent(bool state)
 {
-	modifierIndent = state;
+	options.modifierIndent = state;
 }
 
 /**
@@ -1030,7 +1096,7 @@ void ASBeautifier::setModifierIndent(bool state)
  */
 void ASBeautifier::setSwitchIndent(bool state)
 {
-	switchIndent = state;
+	options.switchIndent = state;
 }
 
 /**
@@ -1041,7 +1107,7 @@ void ASBeautifier::setSwitchIndent(bool state)
  */
 void ASBeautifier::setCaseIndent(bool state)
 {
-	caseIndent = state;
+	options.caseIndent = state;
 }
 
 /**
@@ -1053,7 +1119,7 @@ void ASBeautifier::setCaseIndent(bool state)
  */
 void ASBeautifier::setNamespaceIndent(bool state)
 {
-	namespaceIndent = state;
+	options.namespaceIndent = state;
 }
 
 /**
@@ -1063,7 +1129,7 @@ void ASBeautifier::setNamespaceIndent(bool state)
 */
 void ASBeautifier::setAfterParenIndent(bool state)
 {
-	shouldIndentAfterParen = state;
+	options.shouldIndentAfterParen = state;
 }
 
 /**
@@ -1077,7 +1143,7 @@ void ASBeautifier::setAfterParenIndent(bool state)
  */
 void ASBeautifier::setLabelIndent(bool state)
 {
-	labelIndent = state;
+	options.labelIndent = state;
 }
 
 /**
@@ -1088,12 +1154,12 @@ void ASBeautifier::setLabelIndent(bool state)
  */
 void ASBeautifier::setPreprocDefineIndent(bool state)
 {
-	shouldIndentPreprocDefine = state;
+	options.shouldIndentPreprocDefine = state;
 }
 
 void ASBeautifier::setPreprocConditionalIndent(bool state)
 {
-	shouldIndentPreprocConditional = state;
+	options.shouldIndentPreprocConditional = state;
 }
 
 /**
@@ -1106,12 +1172,12 @@ void ASBeautifier::setPreprocConditionalIndent(bool state)
  */
 void ASBeautifier::setEmptyLineFill(bool state)
 {
-	emptyLineFill = state;
+	options.emptyLineFill = state;
 }
 
 void ASBeautifier::setAlignMethodColon(bool state)
 {
-	shouldAlignMethodColon = state;
+	options.shouldAlignMethodColon = state;
 }
 
 /**
@@ -1122,7 +1188,7 @@ void ASBeautifier::setAlignMethodColon(bool state)
  */
 void ASBeautifier::setSqueezeWhitespace(bool state)
 {
-	squeezeWhitespace = state;
+	options.squeezeWhitespace = state;
 }
 
 /**
@@ -1134,7 +1200,7 @@ void ASBeautifier::setSqueezeWhitespace(bool state)
  */
 void ASBeautifier::setLambdaIndentation(bool state)
 {
-	attemptLambdaIndentation = state;
+	options.attemptLambdaIndentation = state;
 }
 
 /**
@@ -1170,7 +1236,7 @@ std::string ASBeautifier::getIndentString() const
  */
 bool ASBeautifier::getModeManuallySet() const
 {
-	return isModeManuallySet;
+	return options.isModeManuallySet;
 }
 
 /**
@@ -1180,7 +1246,7 @@ bool ASBeautifier::getModeManuallySet() const
  */
 bool ASBeautifier::getForceTabIndentation() const
 {
-	return shouldForceTabIndentation;
+	return options.shouldForceTabIndentation;
 }
 
 /**
@@ -1190,7 +1256,7 @@ bool ASBeautifier::getForceTabIndentation() const
 */
 bool ASBeautifier::getAlignMethodColon() const
 {
-	return shouldAlignMethodColon;
+	return options.shouldAlignMethodColon;
 }
 
 /**
@@ -1200,7 +1266,7 @@ bool ASBeautifier::getAlignMethodColon() const
  */
 bool ASBeautifier::getBlockIndent() const
 {
-	return blockIndent;
+	return options.blockIndent;
 }
 
 /**
@@ -1210,7 +1276,7 @@ bool ASBeautifier::getBlockIndent() const
  */
 bool ASBeautifier::getBraceIndent() const
 {
-	return braceIndent;
+	return options.braceIndent;
 }
 
 /**
@@ -1221,7 +1287,7 @@ bool ASBeautifier::getBraceIndent() const
 */
 bool ASBeautifier::getNamespaceIndent() const
 {
-	return namespaceIndent;
+	return options.namespaceIndent;
 }
 
 /**
@@ -1232,7 +1298,7 @@ bool ASBeautifier::getNamespaceIndent() const
  */
 bool ASBeautifier::getClassIndent() const
 {
-	return classIndent;
+	return options.classIndent;
 }
 
 /**
@@ -1243,7 +1309,7 @@ bool ASBeautifier::getClassIndent() const
  */
 bool ASBeautifier::getModifierIndent() const
 {
-	return modifierIndent;
+	return options.modifierIndent;
 }
 
 /**
@@ -1254,7 +1320,7 @@ bool ASBeautifier::getModifierIndent() const
  */
 bool ASBeautifier::getSwitchIndent() const
 {
-	return switchIndent;
+	return options.switchIndent;
 }
 
 /**
@@ -1265,7 +1331,7 @@ bool ASBeautifier::getSwitchIndent() const
  */
 bool ASBeautifier::getCaseIndent() const
 {
-	return caseIndent;
+	return options.caseIndent;
 }
 
 /**
@@ -1278,7 +1344,18 @@ bool ASBeautifier::getCaseIndent() const
  */
 bool ASBeautifier::getEmptyLineFill() const
 {
-	return emptyLineFill;
+	return options.emptyLineFill;
+}
+
+/**
+ * get the state of the preprocessor conditional indentation option.
+ * If true, preprocessor conditional statements will be indented.
+ *
+ * @return   state of shouldIndentPreprocConditional option.
+ */
+bool ASBeautifier::getPreprocConditionalIndent() const
+{
+	return options.shouldIndentPreprocConditional;
 }
 
 /**
@@ -1290,7 +1367,7 @@ bool ASBeautifier::getEmptyLineFill() const
  */
 bool ASBeautifier::getPreprocDefineIndent() const
 {
-	return shouldIndentPreprocDefine;
+	return options.shouldIndentPreprocDefine;
 }
 
 /**
@@ -1305,14 +1382,14 @@ int ASBeautifier::getTabLength() const
 
 const std::string& ASBeautifier::getIndentedLineReturn(const std::string& newLine, const std::string& originalLine) const
 {
-	if (isIndentModeOff)
+	if (flags.isIndentModeOff)
 		return originalLine;
 	return newLine;
 }
 
 std::string ASBeautifier::preLineWS(int lineIndentCount, int lineSpaceIndentCount) const
 {
-	if (shouldForceTabIndentation)
+	if (options.shouldForceTabIndentation)
 	{
 		if (tabLength != indentLength)
 		{
@@ -1349,25 +1426,25 @@ void ASBeautifier::registerContinuationIndent(const std::string& line, int i, in
 
 	// if indent is around the last char in the line OR indent-after-paren is requested,
 	// indent with the continuation indent
-	if (nextNonWSChar == remainingCharNum || shouldIndentAfterParen)
+	if (nextNonWSChar == remainingCharNum || options.shouldIndentAfterParen)
 	{
 		int previousIndent = spaceIndentCount_;
-		if (!continuationIndentStack->empty())
-			previousIndent = continuationIndentStack->back();
+		if (!continuationIndentStack.empty())
+			previousIndent = continuationIndentStack.back();
 		int currIndent = continuationIndent * indentLength + previousIndent;
 		if (currIndent > maxContinuationIndent && line[i] != '{')
 			currIndent = indentLength * 2 + spaceIndentCount_;
-		continuationIndentStack->emplace_back(currIndent);
+		continuationIndentStack.emplace_back(currIndent);
 		if (updateParenStack)
-			parenIndentStack->emplace_back(previousIndent);
+			parenIndentStack.emplace_back(previousIndent);
 		return;
 	}
 
 	if (updateParenStack)
 	{
-		parenIndentStack->emplace_back(i + spaceIndentCount_ - runInIndentContinuation);
-		if (parenIndentStack->back() < 0)
-			parenIndentStack->back() = 0;
+		parenIndentStack.emplace_back(i + spaceIndentCount_ - runInIndentContinuation);
+		if (parenIndentStack.back() < 0)
+			parenIndentStack.mutableBack() = 0;
 	}
 
 	int tabIncrement = tabIncrementIn;
@@ -1389,21 +1466,21 @@ void ASBeautifier::registerContinuationIndent(const std::string& line, int i, in
 		continuationIndentCount = minIndent + spaceIndentCount_;
 
 	// this is not done for an in-statement array
-	int multiplier = isInAssignment ? 1 : 2; // GH16 - no multiply in assignments
+	int multiplier = flags.isInAssignment ? 1 : 2; // GH16 - no multiply in assignments
 	if (continuationIndentCount > maxContinuationIndent
 	        && !(prevNonLegalCh == '=' && currentNonLegalCh == '{'))
 		continuationIndentCount = indentLength * multiplier + spaceIndentCount_;
 
-	if (!continuationIndentStack->empty()
-	        && continuationIndentCount < continuationIndentStack->back())
-		continuationIndentCount = continuationIndentStack->back();
+	if (!continuationIndentStack.empty()
+	        && continuationIndentCount < continuationIndentStack.back())
+		continuationIndentCount = continuationIndentStack.back();
 
 	// the block opener is not indented for a NonInStatementArray
-	if ((isNonInStatementArray && i >= 0 && line[i] == '{')
-	        && !isInEnum && !isInStruct && !braceBlockStateStack->empty() && braceBlockStateStack->back())
+	if ((hints.isNonInStatementArray && i >= 0 && line[i] == '{')
+	        && !flags.isInEnum && !flags.isInStruct && !braceBlockStateStack.empty() && braceBlockStateStack.back())
 		continuationIndentCount = 0;
 
-	continuationIndentStack->emplace_back(continuationIndentCount);
+	continuationIndentStack.emplace_back(continuationIndentCount);
 }
 
 /**
@@ -1412,7 +1489,7 @@ void ASBeautifier::registerContinuationIndent(const std::string& line, int i, in
 void ASBeautifier::registerContinuationIndentColon(const std::string& line, int i, int tabIncrementIn)
 {
 	assert(line[i] == ':');
-	assert(isInClassInitializer || isInClassHeaderTab);
+	assert(flags.isInClassInitializer || flags.isInClassHeaderTab);
 
 	// register indent at first word after the colon
 	size_t firstChar = line.find_first_not_of(" \t");
@@ -1422,8 +1499,8 @@ void ASBeautifier::registerContinuationIndentColon(const std::string& line, int
 		if (firstWord != std::string::npos)
 		{
 			int continuationIndentCount = firstWord + spaceIndentCount + tabIncrementIn;
-			continuationIndentStack->emplace_back(continuationIndentCount);
-			isContinuation = true;
+			continuationIndentStack.emplace_back(continuationIndentCount);
+			flags.isContinuation = true;
 		}
 	}
 }
@@ -1437,12 +1514,12 @@ std::pair<int, int> ASBeautifier::computePreprocessorIndent()
 {
 	computePreliminaryIndentation();
 	std::pair<int, int> entry(indentCount, spaceIndentCount);
-	if (!headerStack->empty()
+	if (!headerStack.empty()
 	        && entry.first > 0
-	        && (headerStack->back() == &AS_IF
-	            || headerStack->back() == &AS_ELSE
-	            || headerStack->back() == &AS_FOR
-	            || headerStack->back() == &AS_WHILE))
+	        && (headerStack.back() == &AS_IF
+	            || headerStack.back() == &AS_ELSE
+	            || headerStack.back() == &AS_FOR
+	            || headerStack.back() == &AS_WHILE))
 		--entry.first;
 	return entry;
 }
@@ -1493,14 +1570,13 @@ int ASBeautifier::getNextProgramCharDistance(const std::string& line, int i) con
  * find the index number of a std::string element in a container of std::strings
  *
  * @return              the index number of element in the container. -1 if element not found.
- * @param container     a vector of std::strings.
+ * @param container     a vector or ASStack of std::strings.
  * @param element       the element to find .
  */
-int ASBeautifier::indexOf(const std::vector<const std::string*>& container, const std::string* element) const
+template<typename T>
+int ASBeautifier::indexOf(const T& container, const std::string* element) const
 {
-	std::vector<const std::string*>::const_iterator where;
-
-	where = find(container.begin(), container.end(), element);
+	auto where = find(container.begin(), container.end(), element);
 	if (where == container.end())
 		return -1;
 	return (int) (where - container.begin());
@@ -1561,123 +1637,16 @@ std::string ASBeautifier::rtrim(const std::string& str) const
 }
 
 /**
- * Copy tempStacks for the copy constructor.
- * The value of the vectors must also be copied.
- */
-std::vector<std::vector<const std::string*>*>* ASBeautifier::copyTempStacks(const ASBeautifier& other) const
-{
-	std::vector<std::vector<const std::string*>*>* tempStacksNew = new std::vector<std::vector<const std::string*>*>;
-	std::vector<std::vector<const std::string*>*>::iterator iter;
-	for (iter = other.tempStacks->begin();
-	        iter != other.tempStacks->end();
-	        ++iter)
-	{
-		std::vector<const std::string*>* newVec = new std::vector<const std::string*>;
-		*newVec = **iter;
-		tempStacksNew->emplace_back(newVec);
-	}
-	return tempStacksNew;
-}
-
-/**
- * delete a member vectors to eliminate memory leak reporting
- */
-void ASBeautifier::deleteBeautifierVectors()
-{
-	beautifierFileType = INVALID_TYPE;		// reset to an invalid type
-	delete headers;
-	delete nonParenHeaders;
-	delete preBlockStatements;
-	delete preCommandHeaders;
-	delete assignmentOperators;
-	delete nonAssignmentOperators;
-	delete indentableHeaders;
-}
-
-/**
- * delete a vector object
- * T is the type of vector
- * used for all vectors except tempStacks
- */
-template<typename T>
-void ASBeautifier::deleteContainer(T& container)
-{
-	if (container != nullptr)
-	{
-		container->clear();
-		delete (container);
-		container = nullptr;
-	}
-}
-
-/**
- * Delete the ASBeautifier vector object.
- * This is a vector of pointers to ASBeautifier objects allocated with the 'new' operator.
+ * Delete the ASBeautifier objects in a beautifier stack.
+ * This is a stack of pointers to ASBeautifier objects allocated with the 'new' operator.
  * Therefore the ASBeautifier objects have to be deleted in addition to the
  * ASBeautifier pointer entries.
  */
-void ASBeautifier::deleteBeautifierContainer(std::vector<ASBeautifier*>*& container)
+void ASBeautifier::deleteBeautifierContainer(ASSmallVector<ASBeautifier*, 8>& container)
 {
-	if (container != nullptr)
-	{
-		std::vector<ASBeautifier*>::iterator iter = container->begin();
-		while (iter < container->end())
-		{
-			delete *iter;
-			++iter;
-		}
-		container->clear();
-		delete (container);
-		container = nullptr;
-	}
-}
-
-/**
- * Delete the tempStacks vector object.
- * The tempStacks is a vector of pointers to std::strings allocated with the 'new' operator.
- * Therefore the std::strings have to be deleted in addition to the tempStacks entries.
- */
-void ASBeautifier::deleteTempStacksContainer(std::vector<std::vector<const std::string*>*>*& container)
-{
-	if (container != nullptr)
-	{
-		std::vector<std::vector<const std::string*>*>::iterator iter = container->begin();
-		while (iter < container->end())
-		{
-			delete *iter;
-			++iter;
-		}
-		container->clear();
-		delete (container);
-		container = nullptr;
-	}
-}
-
-/**
- * initialize a vector object
- * T is the type of vector used for all vectors
- */
-template<typename T>
-void ASBeautifier::initContainer(T& container, T value)
-{
-	// since the ASFormatter object is never deleted,
-	// the existing vectors must be deleted before creating new ones
-	if (container != nullptr)
-		deleteContainer(container);
-	container = value;
-}
-
-/**
- * Initialize the tempStacks vector object.
- * The tempStacks is a vector of pointers to std::strings allocated with the 'new' operator.
- * Any residual entries are deleted before the vector is initialized.
- */
-void ASBeautifier::initTempStacksContainer(std::vector<std::vector<const std::string*>*>*& container,
-                                           std::vector<std::vector<const std::string*>*>* value)
-{
-	if (container != nullptr)
-		deleteTempStacksContainer(container);
-	container = value;
+	for (ASBeautifier* beautifier : container)
+		deleteBeautifierClone(beautifier);
+	container.clear();
 }
 
 /**
@@ -1957,7 +1926,7 @@ bool ASBeautifier::isPreprocessorConditionalCplusplus(const std::string& line) c
  */
 bool ASBeautifier::isInPreprocessorUnterminatedComment(const std::string& line)
 {
-	if (!isInPreprocessorComment)
+	if (!flags.isInPreprocessorComment)
 	{
 		size_t startPos = line.find("/*");
 		if (startPos == std::string::npos)
@@ -1966,21 +1935,21 @@ bool ASBeautifier::isInPreprocessorUnterminatedComment(const std::string& line)
 	size_t endNum = line.find("*/");
 	if (endNum != std::string::npos)
 	{
-		isInPreprocessorComment = false;
+		flags.isInPreprocessorComment = false;
 		return false;
 	}
-	isInPreprocessorComment = true;
+	flags.isInPreprocessorComment = true;
 	return true;
 }
 
 void ASBeautifier::popLastContinuationIndent()
 {
-	assert(!continuationIndentStackSizeStack->empty());
-	int previousIndentStackSize = continuationIndentStackSizeStack->back();
-	if (continuationIndentStackSizeStack->size() > 1)
-		continuationIndentStackSizeStack->pop_back();
-	while (previousIndentStackSize < (int) continuationIndentStack->size())
-		continuationIndentStack->pop_back();
+	assert(!continuationIndentStackSizeStack.empty());
+	int previousIndentStackSize = continuationIndentStackSizeStack.back();
+	if (continuationIndentStackSizeStack.size() > 1)
+		continuationIndentStackSizeStack.pop_back();
+	while (previousIndentStackSize < (int) continuationIndentStack.size())
+		continuationIndentStack.pop_back();
 }
 
 // for unit testing
@@ -1999,51 +1968,51 @@ void ASBeautifier::processPreprocessor(const std::string& preproc, const std::st
 	//    to be called for the actual indentation.
 	// The original beautifier will have isInDefineDefinition = true, isInDefine = false
 	// The cloned beautifier will have   isInDefineDefinition = true, isInDefine = true
-	if (shouldIndentPreprocDefine && preproc == "define" && line[line.length() - 1] == '\\')
+	if (options.shouldIndentPreprocDefine && preproc == "define" && line[line.length() - 1] == '\\')
 	{
-		if (!isInDefineDefinition)
+		if (!flags.isInDefineDefinition)
 		{
 			// this is the original beautifier
-			isInDefineDefinition = true;
+			flags.isInDefineDefinition = true;
 
 			// push a new beautifier into the active stack
 			// this beautifier will be used for the indentation of this define
-			ASBeautifier* defineBeautifier = new ASBeautifier(*this);
-			activeBeautifierStack->emplace_back(defineBeautifier);
+			ASBeautifier* defineBeautifier = newBeautifierClone(*this);
+			activeBeautifierStack.emplace_back(defineBeautifier);
 		}
 		else
 		{
 			// the is the cloned beautifier that is in charge of indenting the #define.
-			isInDefine = true;
+			flags.isInDefine = true;
 		}
 	}
 	else if (preproc.length() >= 2 && preproc.substr(0, 2) == "if")
 	{
-		if (isPreprocessorConditionalCplusplus(line) && !g_preprocessorCppExternCBrace)
-			g_preprocessorCppExternCBrace = 1;
+		if (isPreprocessorConditionalCplusplus(line) && !*cppExternCBrace)
+			*cppExternCBrace = 1;
 		// push a new beautifier into the stack
-		waitingBeautifierStackLengthStack->emplace_back(waitingBeautifierStack->size());
-		activeBeautifierStackLengthStack->emplace_back(activeBeautifierStack->size());
-		if (activeBeautifierStackLengthStack->back() == 0)
-			waitingBeautifierStack->emplace_back(new ASBeautifier(*this));
+		waitingBeautifierStackLengthStack.emplace_back(waitingBeautifierStack.size());
+		activeBeautifierStackLengthStack.emplace_back(activeBeautifierStack.size());
+		if (activeBeautifierStackLengthStack.back() == 0)
+			waitingBeautifierStack.emplace_back(newBeautifierClone(*this));
 		else
-			waitingBeautifierStack->emplace_back(new ASBeautifier(*activeBeautifierStack->back()));
+			waitingBeautifierStack.emplace_back(newBeautifierClone(*activeBeautifierStack.back()));
 	}
 	else if (preproc == "else")
 	{
-		if ((waitingBeautifierStack != nullptr) && !waitingBeautifierStack->empty())
+		if (!waitingBeautifierStack.empty())
 		{
 			// MOVE current waiting beautifier to active stack.
-			activeBeautifierStack->emplace_back(waitingBeautifierStack->back());
-			waitingBeautifierStack->pop_back();
+			activeBeautifierStack.emplace_back(waitingBeautifierStack.back());
+			waitingBeautifierStack.pop_back();
 		}
 	}
 	else if (preproc == "elif")
 	{
-		if ((waitingBeautifierStack != nullptr) && !waitingBeautifierStack->empty())
+		if (!waitingBeautifierStack.empty())
 		{
 			// append a COPY current waiting beautifier to active stack, WITHOUT deleting the original.
-			activeBeautifierStack->emplace_back(new ASBeautifier(*(waitingBeautifierStack->back())));
+			activeBeautifierStack.emplace_back(newBeautifierClone(*(waitingBeautifierStack.back())));
 		}
 	}
 	else if (preproc == "endif")
@@ -2051,27 +2020,27 @@ void ASBeautifier::processPreprocessor(const std::string& preproc, const std::st
 		int stackLength = 0;
 		ASBeautifier* beautifier = nullptr;
 
-		if (waitingBeautifierStackLengthStack != nullptr && !waitingBeautifierStackLengthStack->empty())
+		if (!waitingBeautifierStackLengthStack.empty())
 		{
-			stackLength = waitingBeautifierStackLengthStack->back();
-			waitingBeautifierStackLengthStack->pop_back();
-			while ((int) waitingBeautifierStack->size() > stackLength)
+			stackLength = waitingBeautifierStackLengthStack.back();
+			waitingBeautifierStackLengthStack.pop_back();
+			while ((int) waitingBeautifierStack.size() > stackLength)
 			{
-				beautifier = waitingBeautifierStack->back();
-				waitingBeautifierStack->pop_back();
-				delete beautifier;
+				beautifier = waitingBeautifierStack.back();
+				waitingBeautifierStack.pop_back();
+				deleteBeautifierClone(beautifier);
 			}
 		}
 
-		if (!activeBeautifierStackLengthStack->empty())
+		if (!activeBeautifierStackLengthStack.empty())
 		{
-			stackLength = activeBeautifierStackLengthStack->back();
-			activeBeautifierStackLengthStack->pop_back();
-			while ((int) activeBeautifierStack->size() > stackLength)
+			stackLength = activeBeautifierStackLengthStack.back();
+			activeBeautifierStackLengthStack.pop_back();
+			while ((int) activeBeautifierStack.size() > stackLength)
 			{
-				beautifier = activeBeautifierStack->back();
-				activeBeautifierStack->pop_back();
-				delete beautifier;
+				beautifier = activeBeautifierStack.back();
+				activeBeautifierStack.pop_back();
+				deleteBeautifierClone(beautifier);
 			}
 		}
 	}
@@ -2084,130 +2053,130 @@ void ASBeautifier::computePreliminaryIndentation()
 {
 	indentCount = 0;
 	spaceIndentCount = 0;
-	isInClassHeaderTab = false;
+	flags.isInClassHeaderTab = false;
 
-	if (isInObjCMethodDefinition && !continuationIndentStack->empty())
-		spaceIndentObjCMethodAlignment = continuationIndentStack->back();
+	if (flags.isInObjCMethodDefinition && !continuationIndentStack.empty())
+		spaceIndentObjCMethodAlignment = continuationIndentStack.back();
 
-	if (!continuationIndentStack->empty())
-		spaceIndentCount = continuationIndentStack->back();
+	if (!continuationIndentStack.empty())
+		spaceIndentCount = continuationIndentStack.back();
 
-	for (size_t i = 0; i < headerStack->size(); i++)
+	for (size_t i = 0; i < headerStack.size(); i++)
 	{
-		isInClass = false;
+		flags.isInClass = false;
 
-		if (blockIndent)
+		if (options.blockIndent)
 		{
 			// do NOT indent opening block for these headers
-			if (!((*headerStack)[i] == &AS_NAMESPACE
-			        || (*headerStack)[i] == &AS_MODULE
-			        || (*headerStack)[i] == &AS_CLASS
-			        || (*headerStack)[i] == &AS_STRUCT
-			        || (*headerStack)[i] == &AS_UNION
-			        || (*headerStack)[i] == &AS_INTERFACE
-			        || (*headerStack)[i] == &AS_THROWS
-			        || (*headerStack)[i] == &AS_STATIC))
+			if (!(headerStack[i] == &AS_NAMESPACE
+			        || headerStack[i] == &AS_MODULE
+			        || headerStack[i] == &AS_CLASS
+			        || headerStack[i] == &AS_STRUCT
+			        || headerStack[i] == &AS_UNION
+			        || headerStack[i] == &AS_INTERFACE
+			        || headerStack[i] == &AS_THROWS
+			        || headerStack[i] == &AS_STATIC))
 				++indentCount;
 		}
-		else if (!(i > 0 && (*headerStack)[i - 1] != &AS_OPEN_BRACE
-		           && (*headerStack)[i] == &AS_OPEN_BRACE))
+		else if (!(i > 0 && headerStack[i - 1] != &AS_OPEN_BRACE
+		           && headerStack[i] == &AS_OPEN_BRACE))
 			++indentCount;
 
-		if (!isJavaStyle() && !namespaceIndent && i > 0
-		        && ((*headerStack)[i - 1] == &AS_NAMESPACE
-		            || (*headerStack)[i - 1] == &AS_MODULE)
-		        && (*headerStack)[i] == &AS_OPEN_BRACE)
+		if (!isJavaStyle() && !options.namespaceIndent && i > 0
+		        && (headerStack[i - 1] == &AS_NAMESPACE
+		            || headerStack[i - 1] == &AS_MODULE)
+		        && headerStack[i] == &AS_OPEN_BRACE)
 			--indentCount;
 
 		if (isCStyle() && i >= 1
-		        && (*headerStack)[i - 1] == &AS_CLASS
-		        && (*headerStack)[i] == &AS_OPEN_BRACE)
+		        && headerStack[i - 1] == &AS_CLASS
+		        && headerStack[i] == &AS_OPEN_BRACE)
 		{
-			if (classIndent)
+			if (options.classIndent)
 				++indentCount;
-			isInClass = true;
+			flags.isInClass = true;
 		}
 
 		// is the switchIndent option is on, indent switch statements an additional indent.
-		else if (switchIndent && i > 1
-		         && (*headerStack)[i - 1] == &AS_SWITCH
-		         && (*headerStack)[i] == &AS_OPEN_BRACE)
+		else if (options.switchIndent && i > 1
+		         && headerStack[i - 1] == &AS_SWITCH
+		         && headerStack[i] == &AS_OPEN_BRACE)
 		{
 			++indentCount;
-			isInSwitch = true;
+			flags.isInSwitch = true;
 		}
 
 	}	// end of for loop
 
-	if (isInClassHeader)
+	if (flags.isInClassHeader)
 	{
 		if (!isJavaStyle())
-			isInClassHeaderTab = true;
-		if (lineOpensWithLineComment || lineStartsInComment || lineOpensWithComment)
+			flags.isInClassHeaderTab = true;
+		if (flags.lineOpensWithLineComment || flags.lineStartsInComment || flags.lineOpensWithComment)
 		{
-			if (!lineBeginsWithOpenBrace)
+			if (!flags.lineBeginsWithOpenBrace)
 				--indentCount;
-			if (!continuationIndentStack->empty())
-				spaceIndentCount -= continuationIndentStack->back();
+			if (!continuationIndentStack.empty())
+				spaceIndentCount -= continuationIndentStack.back();
 		}
-		else if (blockIndent)
+		else if (options.blockIndent)
 		{
-			if (!lineBeginsWithOpenBrace)
+			if (!flags.lineBeginsWithOpenBrace)
 				++indentCount;
 		}
 	}
 
-	if (isInClassInitializer || isInEnumTypeID)
+	if (flags.isInClassInitializer || flags.isInEnumTypeID)
 	{
 		indentCount += classInitializerIndents;
 	}
 
-	if ( (isInEnum || isInStruct) && lineBeginsWithComma && !continuationIndentStack->empty())
+	if ( (flags.isInEnum || flags.isInStruct) && flags.lineBeginsWithComma && !continuationIndentStack.empty())
 	{
 		// unregister '=' indent from the previous line
-		continuationIndentStack->pop_back();
-		isContinuation = false;
+		continuationIndentStack.pop_back();
+		flags.isContinuation = false;
 		spaceIndentCount = 0;
 	}
 
 	// Objective-C interface continuation line
-	if (isInObjCInterface)
+	if (flags.isInObjCInterface)
 		++indentCount;
 
 	// unindent a class closing brace...
-	if (!lineStartsInComment
+	if (!flags.lineStartsInComment
 	        && isCStyle()
-	        && isInClass
-	        && classIndent
-	        && headerStack->size() >= 2
-	        && (*headerStack)[headerStack->size() - 2] == &AS_CLASS
-	        && (*headerStack)[headerStack->size() - 1] == &AS_OPEN_BRACE
-	        && lineBeginsWithCloseBrace
-	        && braceBlockStateStack->back())
+	        && flags.isInClass
+	        && options.classIndent
+	        && headerStack.size() >= 2
+	        && headerStack[headerStack.size() - 2] == &AS_CLASS
+	        && headerStack[headerStack.size() - 1] == &AS_OPEN_BRACE
+	        && flags.lineBeginsWithCloseBrace
+	        && braceBlockStateStack.back())
 		--indentCount;
 
 	// unindent an indented switch closing brace...
-	else if (!lineStartsInComment
-	         && isInSwitch
-	         && switchIndent
-	         && headerStack->size() >= 2
-	         && (*headerStack)[headerStack->size() - 2] == &AS_SWITCH
-	         && (*headerStack)[headerStack->size() - 1] == &AS_OPEN_BRACE
-	         && lineBeginsWithCloseBrace)
+	else if (!flags.lineStartsInComment
+	         && flags.isInSwitch
+	         && options.switchIndent
+	         && headerStack.size() >= 2
+	         && headerStack[headerStack.size() - 2] == &AS_SWITCH
+	         && headerStack[headerStack.size() - 1] == &AS_OPEN_BRACE
+	         && flags.lineBeginsWithCloseBrace)
 		--indentCount;
 
 	// handle special case of run-in comment in an indented class statement
-	if (isInClass
-	        && classIndent
-	        && isInRunInComment
-	        && !lineOpensWithComment
-	        && headerStack->size() > 1
-	        && (*headerStack)[headerStack->size() - 2] == &AS_CLASS)
+	if (flags.isInClass
+	        && options.classIndent
+	        && flags.isInRunInComment
+	        && !flags.lineOpensWithComment
+	        && headerStack.size() > 1
+	        && headerStack[headerStack.size() - 2] == &AS_CLASS)
 		--indentCount;
 
-	if (isInConditional)
+	if (flags.isInConditional)
 		--indentCount;
-	if (g_preprocessorCppExternCBrace >= 4)
+	if (*cppExternCBrace >= 4)
 		--indentCount;
 
 
@@ -2215,16 +2184,16 @@ void ASBeautifier::computePreliminaryIndentation()
 
 void ASBeautifier::adjustParsedLineIndentation(size_t iPrelim, bool isInExtraHeaderIndent)
 {
-	if (lineStartsInComment)
+	if (flags.lineStartsInComment)
 		return;
 
 	// unindent a one-line statement in a header indent
-	if (!blockIndent
-	        && lineBeginsWithOpenBrace
-	        && headerStack->size() < iPrelim
+	if (!options.blockIndent
+	        && flags.lineBeginsWithOpenBrace
+	        && headerStack.size() < iPrelim
 	        && isInExtraHeaderIndent
 	        && (lineOpeningBlocksNum > 0 && lineOpeningBlocksNum <= lineClosingBlocksNum)
-	        && shouldIndentBracedLine)
+	        && flags.shouldIndentBracedLine)
 		--indentCount;
 
 	/*
@@ -2232,65 +2201,65 @@ void ASBeautifier::adjustParsedLineIndentation(size_t iPrelim, bool isInExtraHea
 	 * (but rather another header such as "for" or "if", then unindent it
 	 * by one indentation relative to its block.
 	 */
-	else if (!blockIndent
-	         && lineBeginsWithOpenBrace
+	else if (!options.blockIndent
+	         && flags.lineBeginsWithOpenBrace
 	         && !(lineOpeningBlocksNum > 0 && lineOpeningBlocksNum <= lineClosingBlocksNum)
-	         && (headerStack->size() > 1 && (*headerStack)[headerStack->size() - 2] != &AS_OPEN_BRACE)
-	         && shouldIndentBracedLine)
+	         && (headerStack.size() > 1 && headerStack[headerStack.size() - 2] != &AS_OPEN_BRACE)
+	         && flags.shouldIndentBracedLine)
 		--indentCount;
 
 	// must check one less in headerStack if more than one header on a line (allow-addins)...
-	else if (headerStack->size() > iPrelim + 1
-	         && !blockIndent
-	         && lineBeginsWithOpenBrace
+	else if (headerStack.size() > iPrelim + 1
+	         && !options.blockIndent
+	         && flags.lineBeginsWithOpenBrace
 	         && !(lineOpeningBlocksNum > 0 && lineOpeningBlocksNum <= lineClosingBlocksNum)
-	         && (headerStack->size() > 2 && (*headerStack)[headerStack->size() - 3] != &AS_OPEN_BRACE)
-	         && shouldIndentBracedLine)
+	         && (headerStack.size() > 2 && headerStack[headerStack.size() - 3] != &AS_OPEN_BRACE)
+	         && flags.shouldIndentBracedLine)
 		--indentCount;
 
 	// unindent a closing brace...
-	else if (lineBeginsWithCloseBrace
-	         && shouldIndentBracedLine)
+	else if (flags.lineBeginsWithCloseBrace
+	         && flags.shouldIndentBracedLine)
 		--indentCount;
 
 	// correctly indent one-line-blocks...
 	else if (lineOpeningBlocksNum > 0
 	         && lineOpeningBlocksNum == lineClosingBlocksNum
-	         && previousLineProbationTab)
+	         && flags.previousLineProbationTab)
 		--indentCount;
 
 	if (indentCount < 0)
 		indentCount = 0;
 
 	// take care of extra brace indentation option...
-	if (!lineStartsInComment
-	        && braceIndent
-	        && shouldIndentBracedLine
-	        && (lineBeginsWithOpenBrace || lineBeginsWithCloseBrace))
+	if (!flags.lineStartsInComment
+	        && options.braceIndent
+	        && flags.shouldIndentBracedLine
+	        && (flags.lineBeginsWithOpenBrace || flags.lineBeginsWithCloseBrace))
 	{
-		if (!braceIndentVtk)
+		if (!options.braceIndentVtk)
 			++indentCount;
 		else
 		{
 			// determine if a style VTK brace is indented
 			bool haveUnindentedBrace = false;
-			for (size_t i = 0; i < headerStack->size(); i++)
-			{
-				if (((*headerStack)[i] == &AS_NAMESPACE
-				        || (*headerStack)[i] == &AS_MODULE
-				        || (*headerStack)[i] == &AS_CLASS
-				        || (*headerStack)[i] == &AS_STRUCT)
-				        && i + 1 < headerStack->size()
-				        && (*headerStack)[i + 1] == &AS_OPEN_BRACE)
+			for (size_t i = 0; i < headerStack.size(); i++)
+			{
+				if ((headerStack[i] == &AS_NAMESPACE
+				        || headerStack[i] == &AS_MODULE
+				        || headerStack[i] == &AS_CLASS
+				        || headerStack[i] == &AS_STRUCT)
+				        && i + 1 < headerStack.size()
+				        && headerStack[i + 1] == &AS_OPEN_BRACE)
 					i++;
-				else if (lineBeginsWithOpenBrace)
+				else if (flags.lineBeginsWithOpenBrace)
 				{
 					// don't double count the current brace
-					if (i + 1 < headerStack->size()
-					        && (*headerStack)[i] == &AS_OPEN_BRACE)
+					if (i + 1 < headerStack.size()
+					        && headerStack[i] == &AS_OPEN_BRACE)
 						haveUnindentedBrace = true;
 				}
-				else if ((*headerStack)[i] == &AS_OPEN_BRACE)
+				else if (headerStack[i] == &AS_OPEN_BRACE)
 					haveUnindentedBrace = true;
 			}	// end of for loop
 			if (haveUnindentedBrace)
@@ -2306,16 +2275,12 @@ void ASBeautifier::adjustParsedLineIndentation(size_t iPrelim, bool isInExtraHea
  */
 int ASBeautifier::adjustIndentCountForBreakElseIfComments() const
 {
-	assert(isElseHeaderIndent && !tempStacks->empty());
+	assert(hints.isElseHeaderIndent && !tempStacks.empty());
 	int indentCountIncrement = 0;
-	std::vector<const std::string*>* lastTempStack = tempStacks->back();
-	if (lastTempStack != nullptr)
+	for (const std::string* const lastTemp : tempStacks.back())
 	{
-		for (const std::string* const lastTemp : *lastTempStack)
-		{
-			if (*lastTemp == AS_ELSE)
-				indentCountIncrement++;
-		}
+		if (*lastTemp == AS_ELSE)
+			indentCountIncrement++;
 	}
 	return indentCountIncrement;
 }
@@ -2343,7 +2308,7 @@ void ASBeautifier::adjustObjCMethodDefinitionIndentation(const std::string& line
 	if (line_.length() > 0
 	        && (line_[0] == '-' || line_[0] == '+'))
 	{
-		if (shouldAlignMethodColon && objCColonAlignSubsequent != -1)
+		if (options.shouldAlignMethodColon && objCColonAlignSubsequent != -1)
 		{
 			std::string convertedLine = getIndentedSpaceEquivalent(line_);
 			colonIndentObjCMethodAlignment = findObjCColonAlignment(convertedLine);
@@ -2351,31 +2316,30 @@ void ASBeautifier::adjustObjCMethodDefinitionIndentation(const std::string& line
 			if (objCColonAlignSubsequentIndent > colonIndentObjCMethodAlignment)
 				colonIndentObjCMethodAlignment = objCColonAlignSubsequentIndent;
 		}
-		else if (continuationIndentStack->empty()
-		         || continuationIndentStack->back() == 0)
+		else if (continuationIndentStack.empty()
+		         || continuationIndentStack.back() == 0)
 		{
-			continuationIndentStack->emplace_back(indentLength);
-			isContinuation = true;
+			continuationIndentStack.emplace_back(indentLength);
+			flags.isContinuation = true;
 		}
 	}
 	// set indent for last definition line
-	else if (!lineBeginsWithOpenBrace)
+	else if (!flags.lineBeginsWithOpenBrace)
 	{
-		if (shouldAlignMethodColon)
+		if (options.shouldAlignMethodColon)
 			spaceIndentCount = computeObjCColonAlignment(line_, colonIndentObjCMethodAlignment);
-		else if (continuationIndentStack->empty())
+		else if (continuationIndentStack.empty())
 			spaceIndentCount = spaceIndentObjCMethodAlignment;
 	}
 }
 
 void ASBeautifier::adjustObjCMethodCallIndentation(const std::string& line_)
 {
-	static int keywordIndentObjCMethodAlignment = 0;
-	if (shouldAlignMethodColon && objCColonAlignSubsequent != -1)
+	if (options.shouldAlignMethodColon && objCColonAlignSubsequent != -1)
 	{
-		if (isInObjCMethodCallFirst)
+		if (flags.isInObjCMethodCallFirst)
 		{
-			isInObjCMethodCallFirst = false;
+			flags.isInObjCMethodCallFirst = false;
 			std::string convertedLine = getIndentedSpaceEquivalent(line_);
 			bracePosObjCMethodAlignment = convertedLine.find('[');
 			keywordIndentObjCMethodAlignment =
@@ -2386,7 +2350,7 @@ void ASBeautifier::adjustObjCMethodCallIndentation(const std::string& line_)
 				int objCColonAlignSubsequentIndent = objCColonAlignSubsequent + indentLength;
 				if (objCColonAlignSubsequentIndent > colonIndentObjCMethodAlignment)
 					colonIndentObjCMethodAlignment = objCColonAlignSubsequentIndent;
-				if (lineBeginsWithOpenBrace)
+				if (flags.lineBeginsWithOpenBrace)
 					colonIndentObjCMethodAlignment -= indentLength;
 			}
 		}
@@ -2410,9 +2374,9 @@ void ASBeautifier::adjustObjCMethodCallIndentation(const std::string& line_)
 	}
 	else    // align keywords instead of colons
 	{
-		if (isInObjCMethodCallFirst)
+		if (flags.isInObjCMethodCallFirst)
 		{
-			isInObjCMethodCallFirst = false;
+			flags.isInObjCMethodCallFirst = false;
 			std::string convertedLine = getIndentedSpaceEquivalent(line_);
 			bracePosObjCMethodAlignment = convertedLine.find('[');
 			keywordIndentObjCMethodAlignment =
@@ -2431,14 +2395,14 @@ void ASBeautifier::adjustObjCMethodCallIndentation(const std::string& line_)
  */
 void ASBeautifier::clearObjCMethodDefinitionAlignment()
 {
-	assert(isImmediatelyPostObjCMethodDefinition);
+	assert(flags.isImmediatelyPostObjCMethodDefinition);
 	spaceIndentCount = 0;
 	spaceIndentObjCMethodAlignment = 0;
 	colonIndentObjCMethodAlignment = 0;
-	isInObjCMethodDefinition = false;
-	isImmediatelyPostObjCMethodDefinition = false;
-	if (!continuationIndentStack->empty())
-		continuationIndentStack->pop_back();
+	flags.isInObjCMethodDefinition = false;
+	flags.isImmediatelyPostObjCMethodDefinition = false;
+	if (!continuationIndentStack.empty())
+		continuationIndentStack.pop_back();
 }
 
 /**
@@ -2579,29 +2543,46 @@ std::string ASBeautifier::getIndentedSpaceEquivalent(const std::string& line_) c
  */
 bool ASBeautifier::isTopLevel() const
 {
-	if (headerStack->empty())
+	if (headerStack.empty())
 		return true;
-	if (headerStack->back() == &AS_OPEN_BRACE
-	        && headerStack->size() >= 2)
+	if (headerStack.back() == &AS_OPEN_BRACE
+	        && headerStack.size() >= 2)
 	{
-		if ((*headerStack)[headerStack->size() - 2] == &AS_NAMESPACE
-		        || (*headerStack)[headerStack->size() - 2] == &AS_MODULE
-		        || (*headerStack)[headerStack->size() - 2] == &AS_CLASS
-		        || (*headerStack)[headerStack->size() - 2] == &AS_INTERFACE
-		        || (*headerStack)[headerStack->size() - 2] == &AS_STRUCT
-		        || (*headerStack)[headerStack->size() - 2] == &AS_UNION)
+		if (headerStack[headerStack.size() - 2] == &AS_NAMESPACE
+		        || headerStack[headerStack.size() - 2] == &AS_MODULE
+		        || headerStack[headerStack.size() - 2] == &AS_CLASS
+		        || headerStack[headerStack.size() - 2] == &AS_INTERFACE
+		        || headerStack[headerStack.size() - 2] == &AS_STRUCT
+		        || headerStack[headerStack.size() - 2] == &AS_UNION)
 			return true;
 	}
-	if (headerStack->back() == &AS_NAMESPACE
-	        || headerStack->back() == &AS_MODULE
-	        || headerStack->back() == &AS_CLASS
-	        || headerStack->back() == &AS_INTERFACE
-	        || headerStack->back() == &AS_STRUCT
-	        || headerStack->back() == &AS_UNION)
+	if (headerStack.back() == &AS_NAMESPACE
+	        || headerStack.back() == &AS_MODULE
+	        || headerStack.back() == &AS_CLASS
+	        || headerStack.back() == &AS_INTERFACE
+	        || headerStack.back() == &AS_STRUCT
+	        || headerStack.back() == &AS_UNION)
 		return true;
 	return false;
 }
 
+/**
+ * Check if the beautifier is at a line boundary between top level
+ * statements, with no open header, paren, continuation or comment.
+ * Used by ASFormatter for the top level checkpoints.
+ */
+bool ASBeautifier::isTopLevelBoundary() const
+{
+	return headerStack.empty()
+	       && parenDepth == 0
+	       && continuationIndentStack.empty()
+	       && activeBeautifierStack.empty()
+	       && !flags.isContinuation
+	       && !flags.isInComment
+	       && !flags.isInQuote
+	       && !flags.isInDefine;
+}
+
 /**
  * Parse the current line to update indentCount and spaceIndentCount.
  */
@@ -2617,23 +2598,23 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 	char ch = ' ';
 	int tabIncrementIn = 0;
 
-	if (isInQuote
-	        && !haveLineContinuationChar
-	        && !isInVerbatimQuote
-	        && !isInAsm)
-		isInQuote = false;				// missing closing quote
+	if (flags.isInQuote
+	        && !flags.haveLineContinuationChar
+	        && !flags.isInVerbatimQuote
+	        && !flags.isInAsm)
+		flags.isInQuote = false;				// missing closing quote
 
-	haveLineContinuationChar = false;
+	flags.haveLineContinuationChar = false;
 
 	for (size_t i = 0; i < line.length(); i++)
 	{
 		ch = line[i];
 
-		if (isInBeautifySQL)
+		if (hints.isInBeautifySQL)
 			continue;
 
 		// handle special characters (i.e. backslash+character such as \n, \t, ...)
-		if (isInQuote && !isInVerbatimQuote)
+		if (flags.isInQuote && !flags.isInVerbatimQuote)
 		{
 			if (isSpecialChar)
 			{
@@ -2648,19 +2629,19 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			if (ch == '\\')
 			{
 				if (peekNextChar(line, i) == ' ')   // is this '\' at end of line
-					haveLineContinuationChar = true;
+					flags.haveLineContinuationChar = true;
 				else
 					isSpecialChar = true;
 				continue;
 			}
 		}
-		else if (isInDefine && ch == '\\')
+		else if (flags.isInDefine && ch == '\\')
 			continue;
 
 		// bypass whitespace here
 		if (isWhiteSpace(ch))
 		{
-			if (squeezeWhitespace && !isInComment && !isInQuote && isWhiteSpace(line[i + 1]) && !isWhiteSpace(line[i - 1]))
+			if (options.squeezeWhitespace && !flags.isInComment && !flags.isInQuote && isWhiteSpace(line[i + 1]) && !isWhiteSpace(line[i - 1]))
 			{
 				size_t wsSpanEnd = line.find_first_not_of(" \t", i + 1);
 				std::pair<size_t, size_t> wsSpan(i, wsSpanEnd - i - 1);
@@ -2673,14 +2654,14 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 		}
 
 		// handle quotes (such as 'x' and "Hello Dolly")
-		if (!(isInComment || isInLineComment)
+		if (!(flags.isInComment || isInLineComment)
 		        && (ch == '"'
 		            || (ch == '\'' && !isDigitSeparator(line, i))))
 		{
-			if (!isInQuote)
+			if (!flags.isInQuote)
 			{
 				quoteChar = ch;
-				isInQuote = true;
+				flags.isInQuote = true;
 
 				char prevCh = i > 0 ? line[i - 1] : ' ';
 
@@ -2690,17 +2671,17 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 					int parenPos = line.find('(', i);
 					if (parenPos != -1)
 					{
-						isInVerbatimQuote = true;
+						flags.isInVerbatimQuote = true;
 						verbatimDelimiter = line.substr(i + 1, parenPos - i - 1);
 					}
 				}
 				else if (isSharpStyle() && prevCh == '@')
-					isInVerbatimQuote = true;
+					flags.isInVerbatimQuote = true;
 				// check for "C" following "extern"
-				else if (g_preprocessorCppExternCBrace == 2 && line.compare(i, 3, "\"C\"") == 0)
-					++g_preprocessorCppExternCBrace;
+				else if (*cppExternCBrace == 2 && line.compare(i, 3, "\"C\"") == 0)
+					++*cppExternCBrace;
 			}
-			else if (isInVerbatimQuote && ch == '"')
+			else if (flags.isInVerbatimQuote && ch == '"')
 			{
 				if (isCStyle())
 				{
@@ -2708,8 +2689,8 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 					int delimStart = i - delim.length();
 					if (delimStart >= 0 && line.substr(delimStart, delim.length()) == delim)
 					{
-						isInQuote = false;
-						isInVerbatimQuote = false;
+						flags.isInQuote = false;
+						flags.isInVerbatimQuote = false;
 					}
 				}
 				else if (isSharpStyle())
@@ -2720,70 +2701,70 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 					}
 					else
 					{
-						isInQuote = false;
-						isInVerbatimQuote = false;
+						flags.isInQuote = false;
+						flags.isInVerbatimQuote = false;
 						continue;
 					}
 				}
 			}
 			else if (quoteChar == ch)
 			{
-				isInQuote = false;
-				isContinuation = true;
+				flags.isInQuote = false;
+				flags.isContinuation = true;
 				continue;
 			}
 		}
-		if (isInQuote)
+		if (flags.isInQuote)
 			continue;
 
 		// handle comments
 
-		if (!(isInComment || isInLineComment) && line.compare(i, 2, "//") == 0)
+		if (!(flags.isInComment || isInLineComment) && line.compare(i, 2, "//") == 0)
 		{
 			// if there is a 'case' statement after these comments unindent by 1
-			if (isCaseHeaderCommentIndent)
+			if (hints.isCaseHeaderCommentIndent)
 				--indentCount;
 			// isElseHeaderIndent is set by ASFormatter if shouldBreakElseIfs is requested
 			// if there is an 'else' after these comments a tempStacks indent is required
-			if (isElseHeaderIndent && lineOpensWithLineComment && !tempStacks->empty())
+			if (hints.isElseHeaderIndent && flags.lineOpensWithLineComment && !tempStacks.empty())
 				indentCount += adjustIndentCountForBreakElseIfComments();
 			isInLineComment = true;
 			i++;
 			continue;
 		}
-		if (!(isInComment || isInLineComment) && line.compare(i, 2, "/*") == 0)
+		if (!(flags.isInComment || isInLineComment) && line.compare(i, 2, "/*") == 0)
 		{
 			// if there is a 'case' statement after these comments unindent by 1
-			if (isCaseHeaderCommentIndent && lineOpensWithComment)
+			if (hints.isCaseHeaderCommentIndent && flags.lineOpensWithComment)
 				--indentCount;
 			// isElseHeaderIndent is set by ASFormatter if shouldBreakElseIfs is requested
 			// if there is an 'else' after these comments a tempStacks indent is required
-			if (isElseHeaderIndent && lineOpensWithComment && !tempStacks->empty())
+			if (hints.isElseHeaderIndent && flags.lineOpensWithComment && !tempStacks.empty())
 				indentCount += adjustIndentCountForBreakElseIfComments();
-			isInComment = true;
+			flags.isInComment = true;
 			i++;
-			if (!lineOpensWithComment)				// does line start with comment?
-				blockCommentNoIndent = true;        // if no, cannot indent continuation lines
+			if (!flags.lineOpensWithComment)				// does line start with comment?
+				flags.blockCommentNoIndent = true;        // if no, cannot indent continuation lines
 			continue;
 		}
-		if ((isInComment || isInLineComment) && line.compare(i, 2, "*/") == 0)
+		if ((flags.isInComment || isInLineComment) && line.compare(i, 2, "*/") == 0)
 		{
 			size_t firstText = line.find_first_not_of(" \t");
 			// if there is a 'case' statement after these comments unindent by 1
 			// only if the ending comment is the first entry on the line
-			if (isCaseHeaderCommentIndent && firstText == i)
+			if (hints.isCaseHeaderCommentIndent && firstText == i)
 				--indentCount;
 			// if this comment close starts the line, must check for else-if indent
 			// isElseHeaderIndent is set by ASFormatter if shouldBreakElseIfs is requested
 			// if there is an 'else' after these comments a tempStacks indent is required
 			if (firstText == i)
 			{
-				if (isElseHeaderIndent && !lineOpensWithComment && !tempStacks->empty())
+				if (hints.isElseHeaderIndent && !flags.lineOpensWithComment && !tempStacks.empty())
 					indentCount += adjustIndentCountForBreakElseIfComments();
 			}
-			isInComment = false;
+			flags.isInComment = false;
 			i++;
-			blockCommentNoIndent = false;           // ok to indent next comment
+			flags.blockCommentNoIndent = false;           // ok to indent next comment
 			continue;
 		}
 		// treat indented preprocessor lines as a line comment
@@ -2800,14 +2781,14 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 
 			continue;
 		}
-		if (isInComment)
+		if (flags.isInComment)
 		{
 			// if there is a 'case' statement after these comments unindent by 1
-			if (!lineOpensWithComment && isCaseHeaderCommentIndent)
+			if (!flags.lineOpensWithComment && hints.isCaseHeaderCommentIndent)
 				--indentCount;
 			// isElseHeaderIndent is set by ASFormatter if shouldBreakElseIfs is requested
 			// if there is an 'else' after these comments a tempStacks indent is required
-			if (!lineOpensWithComment && isElseHeaderIndent && !tempStacks->empty())
+			if (!flags.lineOpensWithComment && hints.isElseHeaderIndent && !tempStacks.empty())
 				indentCount += adjustIndentCountForBreakElseIfComments();
 			// bypass rest of the comment up to the comment end
 			while (i + 1 < line.length()
@@ -2825,20 +2806,20 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			        || (probationHeader == &AS_SYNCHRONIZED && ch == '('))
 			{
 				// insert the probation header as a new header
-				isInHeader = true;
-				headerStack->emplace_back(probationHeader);
+				flags.isInHeader = true;
+				headerStack.emplace_back(probationHeader);
 
 				// handle the specific probation header
-				isInConditional = (probationHeader == &AS_SYNCHRONIZED);
+				flags.isInConditional = (probationHeader == &AS_SYNCHRONIZED);
 
-				isContinuation = false;
+				flags.isContinuation = false;
 				// if the probation comes from the previous line, then indent by 1 tab count.
 				if (previousLineProbation
 				        && ch == '{'
-				        && !(blockIndent && probationHeader == &AS_STATIC))
+				        && !(options.blockIndent && probationHeader == &AS_STATIC))
 				{
 					++indentCount;
-					previousLineProbationTab = true;
+					flags.previousLineProbationTab = true;
 				}
 				previousLineProbation = false;
 			}
@@ -2857,22 +2838,22 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			currentNonLegalCh = ch;
 		}
 
-		if (isInHeader)
+		if (flags.isInHeader)
 		{
-			isInHeader = false;
-			currentHeader = headerStack->back();
+			flags.isInHeader = false;
+			currentHeader = headerStack.back();
 		}
 		else
 			currentHeader = nullptr;
 
-		if (isCStyle() && isInTemplate
+		if (isCStyle() && flags.isInTemplate
 		        && (ch == '<' || ch == '>')
 		        && !(line.length() > i + 1 && line.compare(i, 2, ">=") == 0))
 		{
 			if (ch == '<')
 			{
 				++templateDepth;
-				continuationIndentStackSizeStack->emplace_back(continuationIndentStack->size());
+				continuationIndentStackSizeStack.emplace_back(continuationIndentStack.size());
 				registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, 0, true);
 			}
 			else if (ch == '>')
@@ -2881,7 +2862,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				if (--templateDepth <= 0)
 				{
 					ch = ';';
-					isInTemplate = false;
+					flags.isInTemplate = false;
 					templateDepth = 0;
 				}
 			}
@@ -2895,11 +2876,11 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				isInOperator = false;
 				// if have a struct header, this is a declaration not a definition
 				if (ch == '('
-				        && !headerStack->empty()
-				        && headerStack->back() == &AS_STRUCT)
+				        && !headerStack.empty()
+				        && headerStack.back() == &AS_STRUCT)
 				{
-					headerStack->pop_back();
-					isInClassHeader = false;
+					headerStack.pop_back();
+					flags.isInClassHeader = false;
 
 					if (line.find("struct ", 0) > i)        // if not on this line #526, GH #12
 						indentCount -= classInitializerIndents;
@@ -2910,8 +2891,8 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				if (parenDepth == 0)
 				{
 					// do not use emplace_back on vector<bool> until supported by macOS
-					parenStatementStack->push_back(isContinuation);
-					isContinuation = true;
+					parenStatementStack.push_back(flags.isContinuation);
+					flags.isContinuation = true;
 				}
 				parenDepth++;
 				if (ch == '[')
@@ -2920,8 +2901,8 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 					// #525 Maybe check for opening brace in the line
 					if (squareBracketCount == 1 && isObjCStyle() && line.find("{", i + 1 ) == std::string::npos)
 					{
-						isInObjCMethodCall = true;
-						isInObjCMethodCallFirst = true;
+						flags.isInObjCMethodCall = true;
+						flags.isInObjCMethodCallFirst = true;
 					}
 
 					// #121
@@ -2936,11 +2917,11 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 					}
 				}
 
-				continuationIndentStackSizeStack->emplace_back(continuationIndentStack->size());
+				continuationIndentStackSizeStack.emplace_back(continuationIndentStack.size());
 
 				if (currentHeader != nullptr)
 					registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, minConditionalIndent, true);
-				else if (!isInObjCMethodDefinition
+				else if (!flags.isInObjCMethodDefinition
 				         //&& xxxCondition && shouldForceTabIndentation  // only count one opening parentheses per line #498
 				        )
 					registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, 0, true);
@@ -2953,31 +2934,31 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				if (squareBracketCount <= 0)
 				{
 					squareBracketCount = 0;
-					if (isInObjCMethodCall)
-						isImmediatelyPostObjCMethodCall = true;
+					if (flags.isInObjCMethodCall)
+						flags.isImmediatelyPostObjCMethodCall = true;
 				}
-				foundPreCommandHeader = false;
+				flags.foundPreCommandHeader = false;
 				parenDepth--;
 
 				if (parenDepth == 0)
 				{
-					if (!parenStatementStack->empty())      // in case of unmatched closing parens
+					if (!parenStatementStack.empty())      // in case of unmatched closing parens
 					{
-						isContinuation = parenStatementStack->back();
-						parenStatementStack->pop_back();
+						flags.isContinuation = parenStatementStack.back();
+						parenStatementStack.pop_back();
 					}
-					isInAsm = false;
-					isInConditional = false;
+					flags.isInAsm = false;
+					flags.isInConditional = false;
 				}
 
-				if (!continuationIndentStackSizeStack->empty())
+				if (!continuationIndentStackSizeStack.empty())
 				{
 					popLastContinuationIndent();
 
-					if (!parenIndentStack->empty())
+					if (!parenIndentStack.empty())
 					{
-						int poppedIndent = parenIndentStack->back();
-						parenIndentStack->pop_back();
+						int poppedIndent = parenIndentStack.back();
+						parenIndentStack.pop_back();
 
 						if (i == 0)
 							spaceIndentCount = poppedIndent;
@@ -2990,38 +2971,38 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 		if (ch == '{')
 		{
 			// first, check if '{' is a block-opener or a static-array opener
-			bool isBlockOpener = ((prevNonSpaceCh == '{' && braceBlockStateStack->back())
+			bool isBlockOpener = ((prevNonSpaceCh == '{' && braceBlockStateStack.back())
 			                      || prevNonSpaceCh == '}'
 			                      || prevNonSpaceCh == ')'
 			                      || prevNonSpaceCh == ';'
 			                      || peekNextChar(line, i) == '{'
-			                      || isInTrailingReturnType
-			                      || foundPreCommandHeader
-			                      || foundPreCommandMacro
-			                      || isInClassHeader
-			                      || (isInClassInitializer && !isLegalNameChar(prevNonSpaceCh))
-			                      || isNonInStatementArray
-			                      || isInObjCMethodDefinition
-			                      || isInObjCInterface
-			                      || isSharpAccessor
-			                      || isSharpDelegate
-			                      || isInExternC
-			                      || isInAsmBlock
+			                      || flags.isInTrailingReturnType
+			                      || flags.foundPreCommandHeader
+			                      || flags.foundPreCommandMacro
+			                      || flags.isInClassHeader
+			                      || (flags.isInClassInitializer && !isLegalNameChar(prevNonSpaceCh))
+			                      || hints.isNonInStatementArray
+			                      || flags.isInObjCMethodDefinition
+			                      || flags.isInObjCInterface
+			                      || hints.isSharpAccessor
+			                      || hints.isSharpDelegate
+			                      || hints.isInExternC
+			                      || flags.isInAsmBlock
 			                      //|| getNextWord(line, i) == AS_NEW // #487
-			                      || (isInDefine
+			                      || (flags.isInDefine
 			                          && (prevNonSpaceCh == '('
 			                              || isLegalNameChar(prevNonSpaceCh))));
 
-			if (isInObjCMethodDefinition)
+			if (flags.isInObjCMethodDefinition)
 			{
 				objCColonAlignSubsequent = 0;
-				isImmediatelyPostObjCMethodDefinition = true;
-				if (lineBeginsWithOpenBrace)		// for run-in braces
+				flags.isImmediatelyPostObjCMethodDefinition = true;
+				if (flags.lineBeginsWithOpenBrace)		// for run-in braces
 					clearObjCMethodDefinitionAlignment();
 			}
 
 			// !isInStruct omitted: fix for https://gitlab.com/saalen/astyle/-/issues/3
-			if (!isBlockOpener && !isContinuation && !isInClassInitializer && !isInEnum /*&& !isInStruct*/)
+			if (!isBlockOpener && !flags.isContinuation && !flags.isInClassInitializer && !flags.isInEnum /*&& !flags.isInStruct*/)
 			{
 				if (isTopLevel())
 					isBlockOpener = true;
@@ -3038,22 +3019,22 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			}
 
 			// #121 fix indent of lambda bodies, also GH #7
-			if (isCStyle() && lambdaIndicator && attemptLambdaIndentation )
+			if (isCStyle() && lambdaIndicator && options.attemptLambdaIndentation )
 			{
 				isBlockOpener = false;
 			}
 
 			// do not use emplace_back on vector<bool> until supported by macOS
-			braceBlockStateStack->push_back(isBlockOpener);
+			braceBlockStateStack.push_back(isBlockOpener);
 
 			if (!isBlockOpener)
 			{
-				continuationIndentStackSizeStack->emplace_back(continuationIndentStack->size());
+				continuationIndentStackSizeStack.emplace_back(continuationIndentStack.size());
 				registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, 0, true);
 				parenDepth++;
 				if (i == 0)
-					shouldIndentBracedLine = false;
-				isInEnumTypeID = false;
+					flags.shouldIndentBracedLine = false;
+				flags.isInEnumTypeID = false;
 
 				continue;
 			}
@@ -3062,15 +3043,15 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 
 			++lineOpeningBlocksNum;
 
-			if (isInClassInitializer || isInEnumTypeID)
+			if (flags.isInClassInitializer || flags.isInEnumTypeID)
 			{
 				// decrease tab count if brace is broken
-				if (lineBeginsWithOpenBrace)
+				if (flags.lineBeginsWithOpenBrace)
 				{
 					indentCount -= classInitializerIndents;
 					// decrease one more if an empty class
-					if (!headerStack->empty()
-					        && (*headerStack).back() == &AS_CLASS)
+					if (!headerStack.empty()
+					        && headerStack.back() == &AS_CLASS)
 					{
 						int nextChar = getNextProgramCharDistance(line, i);
 						if ((int) line.length() > nextChar && line[nextChar] == '}')
@@ -3079,64 +3060,64 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				}
 			}
 
-			if (isInObjCInterface)
+			if (flags.isInObjCInterface)
 			{
-				isInObjCInterface = false;
-				if (lineBeginsWithOpenBrace)
+				flags.isInObjCInterface = false;
+				if (flags.lineBeginsWithOpenBrace)
 					--indentCount;
 			}
 
-			if (braceIndent && !namespaceIndent && !headerStack->empty()
-			        && ((*headerStack).back() == &AS_NAMESPACE
-			            || (*headerStack).back() == &AS_MODULE))
+			if (options.braceIndent && !options.namespaceIndent && !headerStack.empty()
+			        && (headerStack.back() == &AS_NAMESPACE
+			            || headerStack.back() == &AS_MODULE))
 			{
-				shouldIndentBracedLine = false;
+				flags.shouldIndentBracedLine = false;
 				--indentCount;
 			}
 
 			// an indentable struct is treated like a class in the header stack
-			if (!headerStack->empty()
-			        && (*headerStack).back() == &AS_STRUCT
-			        && isInIndentableStruct)
-				(*headerStack).back() = &AS_CLASS;
+			if (!headerStack.empty()
+			        && headerStack.back() == &AS_STRUCT
+			        && hints.isInIndentableStruct)
+				headerStack.mutableBack() = &AS_CLASS;
 
 			// is a brace inside a paren?
-			parenDepthStack->emplace_back(parenDepth);
+			parenDepthStack.emplace_back(parenDepth);
 			// do not use emplace_back on vector<bool> until supported by macOS
-			blockStatementStack->push_back(isContinuation);
+			blockStatementStack.push_back(flags.isContinuation);
 
-			if (!continuationIndentStack->empty())
+			if (!continuationIndentStack.empty())
 			{
 				// completely purge the continuationIndentStack
-				while (!continuationIndentStack->empty())
+				while (!continuationIndentStack.empty())
 					popLastContinuationIndent();
-				if (isInClassInitializer || isInClassHeaderTab)
+				if (flags.isInClassInitializer || flags.isInClassHeaderTab)
 				{
-					if (lineBeginsWithOpenBrace || lineBeginsWithComma)
+					if (flags.lineBeginsWithOpenBrace || flags.lineBeginsWithComma)
 						spaceIndentCount = 0;
 				}
 				else
 					spaceIndentCount = 0;
 			}
 
-			blockTabCount += (isContinuation ? 1 : 0);
-			if (g_preprocessorCppExternCBrace == 3)
-				++g_preprocessorCppExternCBrace;
+			blockTabCount += (flags.isContinuation ? 1 : 0);
+			if (*cppExternCBrace == 3)
+				++*cppExternCBrace;
 			parenDepth = 0;
-			isInTrailingReturnType = false;
-			isInClassHeader = false;
-			isInClassHeaderTab = false;
-			isInClassInitializer = false;
-			isInEnumTypeID = false;
-			isContinuation = false;
-			isInQuestion = false;
-			isInLet = false;
-			foundPreCommandHeader = false;
-			foundPreCommandMacro = false;
-			isInExternC = false;
-
-			tempStacks->emplace_back(new std::vector<const std::string*>);
-			headerStack->emplace_back(&AS_OPEN_BRACE);
+			flags.isInTrailingReturnType = false;
+			flags.isInClassHeader = false;
+			flags.isInClassHeaderTab = false;
+			flags.isInClassInitializer = false;
+			flags.isInEnumTypeID = false;
+			flags.isContinuation = false;
+			flags.isInQuestion = false;
+			flags.isInLet = false;
+			flags.foundPreCommandHeader = false;
+			flags.foundPreCommandMacro = false;
+			hints.isInExternC = false;
+
+			tempStacks.emplace_back();
+			headerStack.emplace_back(&AS_OPEN_BRACE);
 			lastLineHeader = &AS_OPEN_BRACE;
 
 			continue;
@@ -3175,11 +3156,11 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				// if we reached here, then this is a header...
 				bool isIndentableHeader = true;
 
-				isInHeader = true;
+				flags.isInHeader = true;
 
-				std::vector<const std::string*>* lastTempStack = nullptr;
-				if (!tempStacks->empty())
-					lastTempStack = tempStacks->back();
+				ASStack<const std::string*>* lastTempStack = nullptr;
+				if (!tempStacks.empty())
+					lastTempStack = &tempStacks.mutableBack();
 
 				// if a new block is opened, push a new stack into tempStacks to hold the
 				// future list of headers in the new block.
@@ -3187,8 +3168,8 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				// take care of the special case: 'else if (...)'
 				if (newHeader == &AS_IF && lastLineHeader == &AS_ELSE)
 				{
-					if (!headerStack->empty())
-						headerStack->pop_back();
+					if (!headerStack.empty())
+						headerStack.pop_back();
 				}
 
 				// take care of 'else'
@@ -3204,7 +3185,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 							int restackSize = lastTempStack->size() - indexOfIf - 1;
 							for (int r = 0; r < restackSize; r++)
 							{
-								headerStack->emplace_back(lastTempStack->back());
+								headerStack.emplace_back(lastTempStack->back());
 								lastTempStack->pop_back();
 							}
 							if (!closingBraceReached)
@@ -3231,7 +3212,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 							int restackSize = lastTempStack->size() - indexOfDo - 1;
 							for (int r = 0; r < restackSize; r++)
 							{
-								headerStack->emplace_back(lastTempStack->back());
+								headerStack.emplace_back(lastTempStack->back());
 								lastTempStack->pop_back();
 							}
 							if (!closingBraceReached)
@@ -3254,7 +3235,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 							int restackSize = lastTempStack->size() - indexOfTry - 1;
 							for (int r = 0; r < restackSize; r++)
 							{
-								headerStack->emplace_back(lastTempStack->back());
+								headerStack.emplace_back(lastTempStack->back());
 								lastTempStack->pop_back();
 							}
 
@@ -3265,25 +3246,25 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				}
 				else if (newHeader == &AS_CASE)
 				{
-					isInCase = true;
+					flags.isInCase = true;
 					if (!haveCaseIndent)
 					{
 						haveCaseIndent = true;
-						if (!lineBeginsWithOpenBrace)
+						if (!flags.lineBeginsWithOpenBrace)
 							--indentCount;
 					}
 				}
 				else if (newHeader == &AS_DEFAULT)
 				{
-					isInCase = true;
+					flags.isInCase = true;
 					--indentCount;
 				}
 				else if (newHeader == &AS_STATIC
 				         || newHeader == &AS_SYNCHRONIZED)
 				{
-					if (!headerStack->empty()
-					        && (headerStack->back() == &AS_STATIC
-					            || headerStack->back() == &AS_SYNCHRONIZED))
+					if (!headerStack.empty()
+					        && (headerStack.back() == &AS_STATIC
+					            || headerStack.back() == &AS_SYNCHRONIZED))
 					{
 						isIndentableHeader = false;
 					}
@@ -3295,22 +3276,22 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				}
 				else if (newHeader == &AS_TEMPLATE)
 				{
-					isInTemplate = true;
+					flags.isInTemplate = true;
 					isIndentableHeader = false;
 				}
 
 				if (isIndentableHeader)
 				{
-					headerStack->emplace_back(newHeader);
-					isContinuation = false;
+					headerStack.emplace_back(newHeader);
+					flags.isContinuation = false;
 					if (indexOf(*nonParenHeaders, newHeader) == -1)
 					{
-						isInConditional = true;
+						flags.isInConditional = true;
 					}
 					lastLineHeader = newHeader;
 				}
 				else
-					isInHeader = false;
+					flags.isInHeader = false;
 
 				i += newHeader->length() - 1;
 
@@ -3320,45 +3301,45 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			if (findHeader(line, i, preCommandHeaders) != nullptr)
 				// must be after function arguments
 				if (prevNonSpaceCh == ')')
-					foundPreCommandHeader = true;
+					flags.foundPreCommandHeader = true;
 
 			// Objective-C NSException macros are preCommandHeaders
 			if (isObjCStyle() && findKeyword(line, i, AS_NS_DURING))
-				foundPreCommandMacro = true;
+				flags.foundPreCommandMacro = true;
 			if (isObjCStyle() && findKeyword(line, i, AS_NS_HANDLER))
-				foundPreCommandMacro = true;
+				flags.foundPreCommandMacro = true;
 
 			//https://sourceforge.net/p/astyle/bugs/353/
 			// new is ending the line?
 			if (isJavaStyle() && findKeyword(line, i, AS_NEW) && line.length() - 3 == i)
 			{
-				headerStack->emplace_back(&AS_FIXED); // needs to be something which will not match - need to define a token which will never match
+				headerStack.emplace_back(&AS_FIXED); // needs to be something which will not match - need to define a token which will never match
 			}
 
 			//https://sourceforge.net/p/astyle/bugs/550/
 			//enum can be function return value
 			if (parenDepth == 0 && findKeyword(line, i, AS_ENUM) && line.find_first_of(AS_OPEN_PAREN, i) == std::string::npos){
-				isInEnum = true;
+				flags.isInEnum = true;
 			}
 
 			if (parenDepth == 0 && (findKeyword(line, i, AS_TYPEDEF_STRUCT) || findKeyword(line, i, AS_STRUCT)) && line.find_first_of(AS_SEMICOLON, i) == std::string::npos)
 			{
-				isInStruct = true;
+				flags.isInStruct = true;
 			}
 
 			// avoid regression with neovim test dataset
 			if (parenDepth == 0 && findKeyword(line, i, AS_UNION) )
 			{
-				isInStruct = false;
+				flags.isInStruct = false;
 			}
 
 			if (isSharpStyle() && findKeyword(line, i, AS_LET))
-				isInLet = true;
+				flags.isInLet = true;
 
 		}   // isPotentialHeader
 
 		if (ch == '?')
-			isInQuestion = true;
+			flags.isInQuestion = true;
 
 
 
@@ -3370,7 +3351,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				++i;
 				continue;
 			}
-			else if (isInQuestion)		// NOLINT
+			else if (flags.isInQuestion)		// NOLINT
 			{
 				// do nothing special
 			}
@@ -3379,31 +3360,31 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				// found a 'for' loop or an objective-C statement
 				// so do nothing special
 			}
-			else if (isInEnum)
+			else if (flags.isInEnum)
 			{
 				// found an enum with a base-type
-				isInEnumTypeID = true;
+				flags.isInEnumTypeID = true;
 				if (i == 0)
 					indentCount += classInitializerIndents;
 			}
 			else if ((isCStyle() || isSharpStyle())
-			         && !isInCase
-			         && (prevNonSpaceCh == ')' || foundPreCommandHeader))
+			         && !flags.isInCase
+			         && (prevNonSpaceCh == ')' || flags.foundPreCommandHeader))
 			{
 				// found a 'class' c'tor initializer
-				isInClassInitializer = true;
+				flags.isInClassInitializer = true;
 				registerContinuationIndentColon(line, i, tabIncrementIn);
 				if (i == 0)
 					indentCount += classInitializerIndents;
 			}
 
-			else if (isInClassHeader || isInObjCInterface)
+			else if (flags.isInClassHeader || flags.isInObjCInterface)
 			{
 				// is in a 'class A : public B' definition
-				isInClassHeaderTab = true;
+				flags.isInClassHeaderTab = true;
 				registerContinuationIndentColon(line, i, tabIncrementIn);
 			}
-			else if (isInAsm || isInAsmOneLine || isInAsmBlock)
+			else if (flags.isInAsm || flags.isInAsmOneLine || flags.isInAsmBlock)
 			{
 				// do nothing special
 			}
@@ -3411,17 +3392,17 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			{
 				// found a bit field - do nothing special
 			}
-			else if (isCStyle() && isInClass && prevNonSpaceCh != ')')
+			else if (isCStyle() && flags.isInClass && prevNonSpaceCh != ')')
 			{
 				// found a 'private:' or 'public:' inside a class definition
 				--indentCount;
-				if (modifierIndent)
+				if (options.modifierIndent)
 					spaceIndentCount += (indentLength / 2);
 			}
-			else if (isCStyle() && !isInClass
-			         && headerStack->size() >= 2
-			         && (*headerStack)[headerStack->size() - 2] == &AS_CLASS
-			         && (*headerStack)[headerStack->size() - 1] == &AS_OPEN_BRACE)
+			else if (isCStyle() && !flags.isInClass
+			         && headerStack.size() >= 2
+			         && headerStack[headerStack.size() - 2] == &AS_CLASS
+			         && headerStack[headerStack.size() - 1] == &AS_OPEN_BRACE)
 			{
 				// found a 'private:' or 'public:' inside a class definition
 				// and on the same line as the class opening brace
@@ -3433,7 +3414,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				// so do nothing special
 			}
 			// do not trigger this in class definitions https://gitlab.com/saalen/astyle/-/issues/4
-			else if (isInStruct && !isInCase)
+			else if (flags.isInStruct && !flags.isInCase)
 			{
 				if (i == 0)
 					indentCount += classInitializerIndents;
@@ -3442,33 +3423,33 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			{
 				currentNonSpaceCh = ';'; // so that braces after the ':' will appear as block-openers
 				char peekedChar = peekNextChar(line, i);
-				if (isInCase)
+				if (flags.isInCase)
 				{
-					isInCase = false;
+					flags.isInCase = false;
 					ch = ';'; // from here on, treat char as ';'
 				}
 				else if (isCStyle() || (isSharpStyle() && peekedChar == ';'))
 				{
 					// is in a label (e.g. 'label1:')
-					if (labelIndent)
+					if (options.labelIndent)
 						--indentCount; // unindent label by one indent
-					else if (!lineBeginsWithOpenBrace)
+					else if (!flags.lineBeginsWithOpenBrace)
 						indentCount = 0; // completely flush indent to left
 				}
 			}
 		}
 
-		if ((ch == ';' || (parenDepth > 0 && ch == ',')) && !continuationIndentStackSizeStack->empty()){
-			while ((int) continuationIndentStackSizeStack->back() + (parenDepth > 0 ? 1 : 0)
-			        < (int) continuationIndentStack->size())
-				continuationIndentStack->pop_back();
+		if ((ch == ';' || (parenDepth > 0 && ch == ',')) && !continuationIndentStackSizeStack.empty()){
+			while ((int) continuationIndentStackSizeStack.back() + (parenDepth > 0 ? 1 : 0)
+			        < (int) continuationIndentStack.size())
+				continuationIndentStack.pop_back();
 		}
-		else if (ch == ',' && (isInEnum || isInStruct) && isNonInStatementArray && !continuationIndentStack->empty())
-			continuationIndentStack->pop_back();
+		else if (ch == ',' && (flags.isInEnum || flags.isInStruct) && hints.isNonInStatementArray && !continuationIndentStack.empty())
+			continuationIndentStack.pop_back();
 
 		// handle commas
 		// previous "isInStatement" will be from an assignment operator or class initializer
-		if (ch == ',' && parenDepth == 0 && !isContinuation && !isNonInStatementArray)
+		if (ch == ',' && parenDepth == 0 && !flags.isContinuation && !hints.isNonInStatementArray)
 		{
 			// is comma at end of line
 			size_t nextChar = line.find_first_not_of(" \t", i + 1);
@@ -3482,29 +3463,29 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			if (nextChar == std::string::npos)
 			{
 				// register indent at previous word
-				if (isJavaStyle() && isInClassHeader)
+				if (isJavaStyle() && flags.isInClassHeader)
 				{
 					// do nothing for now
 				}
 				// register indent at second word on the line
-				else if (!isInTemplate && !isInClassHeaderTab && !isInClassInitializer)
+				else if (!flags.isInTemplate && !flags.isInClassHeaderTab && !flags.isInClassInitializer)
 				{
 					int prevWord = getContinuationIndentComma(line, i);
 					int continuationIndentCount = prevWord + spaceIndentCount + tabIncrementIn;
-					continuationIndentStack->emplace_back(continuationIndentCount);
-					isContinuation = true;
+					continuationIndentStack.emplace_back(continuationIndentCount);
+					flags.isContinuation = true;
 				}
 			}
 		}
 		// handle comma first initializers
-		if (ch == ',' && parenDepth == 0 && lineBeginsWithComma
-		        && (isInClassInitializer || isInClassHeaderTab))
+		if (ch == ',' && parenDepth == 0 && flags.lineBeginsWithComma
+		        && (flags.isInClassInitializer || flags.isInClassHeaderTab))
 			spaceIndentCount = 0;
 
 		// handle ends of statements
 		if ((ch == ';' && parenDepth == 0) || ch == '}')
 		{
-			isInAssignment = false;
+			flags.isInAssignment = false;
 
 			if (ch == '}')
 			{
@@ -3512,24 +3493,24 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				lambdaIndicator = false;
 
 				// first check if this '}' closes a previous block, or a static array...
-				if (braceBlockStateStack->size() > 1)
+				if (braceBlockStateStack.size() > 1)
 				{
-					bool braceBlockState = braceBlockStateStack->back();
-					braceBlockStateStack->pop_back();
+					bool braceBlockState = braceBlockStateStack.back();
+					braceBlockStateStack.pop_back();
 					if (!braceBlockState)
 					{
-						if (!continuationIndentStackSizeStack->empty())
+						if (!continuationIndentStackSizeStack.empty())
 						{
 							// this brace is a static array
 							popLastContinuationIndent();
 							parenDepth--;
 							if (i == 0)
-								shouldIndentBracedLine = false;
+								flags.shouldIndentBracedLine = false;
 
-							if (!parenIndentStack->empty())
+							if (!parenIndentStack.empty())
 							{
-								int poppedIndent = parenIndentStack->back();
-								parenIndentStack->pop_back();
+								int poppedIndent = parenIndentStack.back();
+								parenIndentStack.pop_back();
 								if (i == 0)
 									spaceIndentCount = poppedIndent;
 							}
@@ -3542,54 +3523,50 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 
 				++lineClosingBlocksNum;
 
-				if (!continuationIndentStackSizeStack->empty())
+				if (!continuationIndentStackSizeStack.empty())
 					popLastContinuationIndent();
 
-				if (!parenDepthStack->empty())
+				if (!parenDepthStack.empty())
 				{
-					parenDepth = parenDepthStack->back();
-					parenDepthStack->pop_back();
-					isContinuation = blockStatementStack->back();
-					blockStatementStack->pop_back();
+					parenDepth = parenDepthStack.back();
+					parenDepthStack.pop_back();
+					flags.isContinuation = blockStatementStack.back();
+					blockStatementStack.pop_back();
 
-					if (isContinuation)
+					if (flags.isContinuation)
 						blockTabCount--;
 				}
 
 				closingBraceReached = true;
 				if (i == 0)
 					spaceIndentCount = 0;
-				isInAsmBlock = false;
-				isInAsm = isInAsmOneLine = isInQuote = false;	// close these just in case
-				isInStruct = false;
+				flags.isInAsmBlock = false;
+				flags.isInAsm = flags.isInAsmOneLine = flags.isInQuote = false;	// close these just in case
+				flags.isInStruct = false;
 
-				int headerPlace = indexOf(*headerStack, &AS_OPEN_BRACE);
+				int headerPlace = indexOf(headerStack, &AS_OPEN_BRACE);
 				if (headerPlace != -1)
 				{
-					const std::string* popped = headerStack->back();
+					const std::string* popped = headerStack.back();
 					while (popped != &AS_OPEN_BRACE)
 					{
-						headerStack->pop_back();
-						popped = headerStack->back();
+						headerStack.pop_back();
+						popped = headerStack.back();
 					}
-					headerStack->pop_back();
+					headerStack.pop_back();
 
-					if (headerStack->empty())
-						g_preprocessorCppExternCBrace = 0;
+					if (headerStack.empty())
+						*cppExternCBrace = 0;
 
 					// do not indent namespace brace unless namespaces are indented
-					if (!namespaceIndent && !headerStack->empty()
-					        && ((*headerStack).back() == &AS_NAMESPACE
-					            || (*headerStack).back() == &AS_MODULE)
+					if (!options.namespaceIndent && !headerStack.empty()
+					        && (headerStack.back() == &AS_NAMESPACE
+					            || headerStack.back() == &AS_MODULE)
 					        && i == 0)		// must be the first brace on the line
-						shouldIndentBracedLine = false;
+						flags.shouldIndentBracedLine = false;
 
-					if (!tempStacks->empty())
-					{
-						std::vector<const std::string*>* temp = tempStacks->back();
-						tempStacks->pop_back();
-						delete temp;
-					}
+					if (!tempStacks.empty())
+						tempStacks.pop_back();
 				}
 
 				ch = ' '; // needed due to cases such as '}else{', so that headers ('else' in this case) will be identified...
@@ -3604,37 +3581,36 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			 * (such as a previous 'if' for an 'else' header) within the tempStacks,
 			 * and recreates the temporary snapshot by manipulating the tempStacks.
 			 */
-			if (!tempStacks->back()->empty())
-				while (!tempStacks->back()->empty())
-					tempStacks->back()->pop_back();
-			while (!headerStack->empty() && headerStack->back() != &AS_OPEN_BRACE)
+			if (!tempStacks.back().empty())
+				tempStacks.mutableBack().clear();
+			while (!headerStack.empty() && headerStack.back() != &AS_OPEN_BRACE)
 			{
-				tempStacks->back()->emplace_back(headerStack->back());
-				headerStack->pop_back();
+				tempStacks.mutableBack().emplace_back(headerStack.back());
+				headerStack.pop_back();
 			}
 
 			if (parenDepth == 0 && ch == ';')
 			{
-				isContinuation = false;
-				isInClassInitializer = false;
+				flags.isContinuation = false;
+				flags.isInClassInitializer = false;
 			}
 
-			if (isInObjCMethodDefinition)
+			if (flags.isInObjCMethodDefinition)
 			{
 				objCColonAlignSubsequent = 0;
-				isImmediatelyPostObjCMethodDefinition = true;
+				flags.isImmediatelyPostObjCMethodDefinition = true;
 			}
 
 			previousLastLineHeader = nullptr;
-			isInClassHeader = false;		// for 'friend' class
-			isInEnum = false;
-			isInEnumTypeID = false;
-
-			isInQuestion = false;
-			isInTemplate = false;
-			isInObjCInterface = false;
-			foundPreCommandHeader = false;
-			foundPreCommandMacro = false;
+			flags.isInClassHeader = false;		// for 'friend' class
+			flags.isInEnum = false;
+			flags.isInEnumTypeID = false;
+
+			flags.isInQuestion = false;
+			flags.isInTemplate = false;
+			flags.isInObjCInterface = false;
+			flags.foundPreCommandHeader = false;
+			flags.foundPreCommandMacro = false;
 			squareBracketCount = 0;
 
 			continue;
@@ -3644,7 +3620,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 		{
 			// check for preBlockStatements in C/C++ ONLY if not within parentheses
 			// (otherwise 'struct XXX' statements would be wrongly interpreted...)
-			if (!isInTemplate && !(isCStyle() && parenDepth > 0))
+			if (!flags.isInTemplate && !(isCStyle() && parenDepth > 0))
 			{
 				const std::string* newHeader = findHeader(line, i, preBlockStatements);
 				// CORBA IDL module
@@ -3655,37 +3631,37 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 						newHeader = nullptr;
 				}
 				if (newHeader != nullptr
-				        && !(isCStyle() && newHeader == &AS_CLASS && (isInEnum || isInStruct))	// is not 'enum class'
+				        && !(isCStyle() && newHeader == &AS_CLASS && (flags.isInEnum || flags.isInStruct))	// is not 'enum class'
 				        && !(isCStyle() && newHeader == &AS_INTERFACE			// CORBA IDL interface
-				             && (headerStack->empty()
-				                 || headerStack->back() != &AS_OPEN_BRACE)))
+				             && (headerStack.empty()
+				                 || headerStack.back() != &AS_OPEN_BRACE)))
 				{
 					if (!isSharpStyle())
-						headerStack->emplace_back(newHeader);
+						headerStack.emplace_back(newHeader);
 					// do not need 'where' in the headerStack
 					// do not need second 'class' statement in a row
 					else if (!(newHeader == &AS_WHERE
 					           || ((newHeader == &AS_CLASS || newHeader == &AS_STRUCT)
-					               && !headerStack->empty()
-					               && (headerStack->back() == &AS_CLASS
-					                   || headerStack->back() == &AS_STRUCT))))
-						headerStack->emplace_back(newHeader);
+					               && !headerStack.empty()
+					               && (headerStack.back() == &AS_CLASS
+					                   || headerStack.back() == &AS_STRUCT))))
+						headerStack.emplace_back(newHeader);
 
-					if (!headerStack->empty())
+					if (!headerStack.empty())
 					{
-						if ((*headerStack).back() == &AS_CLASS
-						        || (*headerStack).back() == &AS_STRUCT
-						        || (*headerStack).back() == &AS_INTERFACE)
+						if (headerStack.back() == &AS_CLASS
+						        || headerStack.back() == &AS_STRUCT
+						        || headerStack.back() == &AS_INTERFACE)
 						{
-							isInClassHeader = true;
+							flags.isInClassHeader = true;
 						}
-						else if ((*headerStack).back() == &AS_NAMESPACE
-						         || (*headerStack).back() == &AS_MODULE)
+						else if (headerStack.back() == &AS_NAMESPACE
+						         || headerStack.back() == &AS_MODULE)
 						{
 							// remove continuationIndent from namespace
-							if (!continuationIndentStack->empty())
-								continuationIndentStack->pop_back();
-							isContinuation = false;
+							if (!continuationIndentStack.empty())
+								continuationIndentStack.pop_back();
+							flags.isContinuation = false;
 						}
 					}
 
@@ -3699,10 +3675,10 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			{
 				// must bypass the header before registering the in statement
 				i += foundIndentableHeader->length() - 1;
-				if (!isInOperator && !isInTemplate && !isNonInStatementArray)
+				if (!isInOperator && !flags.isInTemplate && !hints.isNonInStatementArray)
 				{
 					registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, 0, false);
-					isContinuation = true;
+					flags.isContinuation = true;
 				}
 				continue;
 			}
@@ -3710,22 +3686,22 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			if (isCStyle() && findKeyword(line, i, AS_OPERATOR))
 				isInOperator = true;
 
-			if (g_preprocessorCppExternCBrace == 1 && findKeyword(line, i, AS_EXTERN))
-				++g_preprocessorCppExternCBrace;
+			if (*cppExternCBrace == 1 && findKeyword(line, i, AS_EXTERN))
+				++*cppExternCBrace;
 
-			if (g_preprocessorCppExternCBrace == 3)	// extern "C" is not followed by a '{'
-				g_preprocessorCppExternCBrace = 0;
+			if (*cppExternCBrace == 3)	// extern "C" is not followed by a '{'
+				*cppExternCBrace = 0;
 
 			// "new" operator is a pointer, not a calculation
 			if (findKeyword(line, i, AS_NEW))
 			{
-				if (isContinuation && !continuationIndentStack->empty() && prevNonSpaceCh == '=')
-					continuationIndentStack->back() = 0;
+				if (flags.isContinuation && !continuationIndentStack.empty() && prevNonSpaceCh == '=')
+					continuationIndentStack.mutableBack() = 0;
 			}
 
 			if (isCStyle() && findKeyword(line, i, AS_AUTO) && isTopLevel())
 			{
-				isInTrailingReturnType = true;
+				flags.isInTrailingReturnType = true;
 			}
 
 			if (isCStyle())
@@ -3733,7 +3709,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				if (findKeyword(line, i, AS_ASM)
 				        || findKeyword(line, i, AS__ASM__))
 				{
-					isInAsm = true;
+					flags.isInAsm = true;
 				}
 				else if (findKeyword(line, i, AS_MS_ASM)		// microsoft specific
 				         || findKeyword(line, i, AS_MS__ASM))
@@ -3744,9 +3720,9 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 
 					char peekedChar = peekNextChar(line, i + index);
 					if (peekedChar == '{' || peekedChar == ' ')
-						isInAsmBlock = true;
+						flags.isInAsmBlock = true;
 					else
-						isInAsmOneLine = true;
+						flags.isInAsmOneLine = true;
 				}
 			}
 
@@ -3767,16 +3743,16 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			std::string curWord = getCurrentWord(line, i + 1);
 			if (curWord == AS_INTERFACE || curWord == AS_AUTORELEASEPOOL)
 			{
-				isInObjCInterface = true;
+				flags.isInObjCInterface = true;
 				std::string name = '@' + curWord;
 				i += name.length() - 1;
 				continue;
 			}
 
-			if (isInObjCInterface)
+			if (flags.isInObjCInterface)
 			{
 				--indentCount;
-				isInObjCInterface = false;
+				flags.isInObjCInterface = false;
 			}
 
 			if (curWord == AS_PUBLIC
@@ -3784,7 +3760,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			        || curWord == AS_PROTECTED)
 			{
 				--indentCount;
-				if (modifierIndent)
+				if (options.modifierIndent)
 					spaceIndentCount += (indentLength / 2);
 				std::string name = '@' + curWord;
 				i += name.length() - 1;
@@ -3795,7 +3771,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			{
 				popLastContinuationIndent();
 				spaceIndentCount = 0;
-				isInObjCMethodDefinition = false;
+				flags.isInObjCMethodDefinition = false;
 				std::string name = '@' + curWord;
 				i += name.length() - 1;
 				continue;
@@ -3803,16 +3779,16 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 		}
 		else if ((ch == '-' || ch == '+')
 		         && (prevNonSpaceCh == ';' || prevNonSpaceCh == '{'
-		             || headerStack->empty() || isInObjCInterface)
+		             || headerStack.empty() || flags.isInObjCInterface)
 		         && ASBase::peekNextChar(line, i) != '-'
 		         && ASBase::peekNextChar(line, i) != '+'
 		         && isObjCStyle()
 		         && line.find_first_not_of(" \t") == i)
 		{
-			if (isInObjCInterface)
+			if (flags.isInObjCInterface)
 				--indentCount;
-			isInObjCInterface = false;
-			isInObjCMethodDefinition = true;
+			flags.isInObjCInterface = false;
+			flags.isInObjCMethodDefinition = true;
 			continue;
 		}
 
@@ -3829,8 +3805,8 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			if (foundNonAssignmentOp != nullptr)
 			{
 				if (foundNonAssignmentOp == &AS_LAMBDA)
-					foundPreCommandHeader = true;
-				if (isInTemplate && foundNonAssignmentOp == &AS_GR_GR)
+					flags.foundPreCommandHeader = true;
+				if (flags.isInTemplate && foundNonAssignmentOp == &AS_GR_GR)
 					foundNonAssignmentOp = nullptr;
 			}
 
@@ -3855,7 +3831,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 				// aligned, if we are not in a statement already and
 				// also not in the "operator<<(...)" header line
 				if (!isInOperator
-				        && continuationIndentStack->empty()
+				        && continuationIndentStack.empty()
 				        && isCStyle()
 				        && (foundNonAssignmentOp == &AS_GR_GR
 				            || foundNonAssignmentOp == &AS_LS_LS
@@ -3872,14 +3848,14 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 			else if (foundAssignmentOp != nullptr)
 			{
 
-				isInAssignment = true;
-				foundPreCommandHeader = false;		// clears this for array assignments
-				foundPreCommandMacro = false;
+				flags.isInAssignment = true;
+				flags.foundPreCommandHeader = false;		// clears this for array assignments
+				flags.foundPreCommandMacro = false;
 
 				if (foundAssignmentOp->length() > 1)
 					i += foundAssignmentOp->length() - 1;
 
-				if (!isInOperator && !isInTemplate && (!isNonInStatementArray || isInEnum || isInStruct))
+				if (!isInOperator && !flags.isInTemplate && (!hints.isNonInStatementArray || flags.isInEnum || flags.isInStruct))
 				{
 					// if multiple assignments, align on the previous word
 					if (foundAssignmentOp == &AS_ASSIGN
@@ -3893,16 +3869,16 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 							haveAssignmentThisLine = true;
 							int prevWordIndex = getContinuationIndentAssign(line, i);
 							int continuationIndentCount = prevWordIndex + spaceIndentCount + tabIncrementIn;
-							continuationIndentStack->emplace_back(continuationIndentCount);
-							isContinuation = true;
+							continuationIndentStack.emplace_back(continuationIndentCount);
+							flags.isContinuation = true;
 						}
 					}
 					// don't indent an assignment if 'let'
-					else if (isInLet)
+					else if (flags.isInLet)
 					{
-						isInLet = false;
+						flags.isInLet = false;
 					}
-					else if (!lineBeginsWithComma)
+					else if (!flags.lineBeginsWithComma)
 					{
 						if (i == 0 && spaceIndentCount == 0)
 							spaceIndentCount += indentLength;
@@ -3912,7 +3888,7 @@ void ASBeautifier::parseCurrentLine(const std::string& line)
 							spaceIndentCount = 0;
 
 						registerContinuationIndent(line, i, spaceIndentCount, tabIncrementIn, 0, false);
-						isContinuation = true;
+						flags.isContinuation = true;
 					}
 				}
 			}
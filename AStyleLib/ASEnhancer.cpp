@@ -34,7 +34,7 @@ void ASEnhancer::init(int  _fileType,
                       bool _preprocBlockIndent,
                       bool _preprocDefineIndent,
                       bool _emptyLineFill,
-                      std::vector<const std::pair<const std::string, const std::string>* >* _indentableMacros)
+                      const std::vector<const std::pair<const std::string, const std::string>* >* _indentableMacros)
 {
 	// formatting variables from ASFormatter and ASBeautifier
 	ASBase::init(_fileType);
@@ -145,6 +145,58 @@ void ASEnhancer::enhance(std::string& line, bool isInNamespace, bool isInPreproc
 		unindentLine(line, sw.unindentDepth);
 }
 
+/**
+ * compare the enhancer state with another enhancer,
+ * including the options and the switch stack.
+ * the line number is not compared.
+ *
+ * @param other      the enhancer to compare.
+ * @return           is the state the same.
+ */
+bool ASEnhancer::hasEqualState(const ASEnhancer& other) const
+{
+	if (indentLength != other.indentLength
+	        || tabLength != other.tabLength
+	        || useTabs != other.useTabs
+	        || forceTab != other.forceTab
+	        || namespaceIndent != other.namespaceIndent
+	        || caseIndent != other.caseIndent
+	        || preprocBlockIndent != other.preprocBlockIndent
+	        || preprocDefineIndent != other.preprocDefineIndent
+	        || emptyLineFill != other.emptyLineFill)
+		return false;
+
+	if (isInQuote != other.isInQuote
+	        || isInComment != other.isInComment
+	        || quoteChar != other.quoteChar
+	        || braceCount != other.braceCount
+	        || switchDepth != other.switchDepth
+	        || eventPreprocDepth != other.eventPreprocDepth
+	        || lookingForCaseBrace != other.lookingForCaseBrace
+	        || unindentNextLine != other.unindentNextLine
+	        || shouldUnindentLine != other.shouldUnindentLine
+	        || shouldUnindentComment != other.shouldUnindentComment
+	        || nextLineIsEventIndent != other.nextLineIsEventIndent
+	        || isInEventTable != other.isInEventTable
+	        || indentableMacros != other.indentableMacros
+	        || nextLineIsDeclareIndent != other.nextLineIsDeclareIndent
+	        || isInDeclareSection != other.isInDeclareSection)
+		return false;
+
+	if (switchStack.size() != other.switchStack.size())
+		return false;
+	for (size_t i = 0; i <= switchStack.size(); i++)
+	{
+		const SwitchVariables& a = (i < switchStack.size()) ? switchStack[i] : sw;
+		const SwitchVariables& b = (i < switchStack.size()) ? other.switchStack[i] : other.sw;
+		if (a.switchBraceCount != b.switchBraceCount
+		        || a.unindentDepth != b.unindentDepth
+		        || a.unindentCase != b.unindentCase)
+			return false;
+	}
+	return true;
+}
+
 /**
  * convert a force-tab indent to spaces
  *
@@ -25,17 +25,16 @@ namespace astyle {
 
 /**
  * Constructor of ASFormatter
+ * The enhancer is set by init(), it is zeroed so a formatter
+ * can be copied for a checkpoint before init().
  */
 ASFormatter::ASFormatter()
+	: enhancer()
 {
+	options = FormatterOptions();
+	flags = FormatterFlags();
 	sourceIterator = nullptr;
-	enhancer = new ASEnhancer;
-	preBraceHeaderStack = nullptr;
-	braceTypeStack = nullptr;
-	parenStack = nullptr;
-	structStack = nullptr;
-	questionMarkStack = nullptr;
-	lineCommentNoIndent = false;
+	flags.lineCommentNoIndent = false;
 	formattingStyle = STYLE_NONE;
 	braceFormatMode = NONE_MODE;
 	pointerAlignment = PTR_ALIGN_NONE;
@@ -43,65 +42,66 @@ ASFormatter::ASFormatter()
 	objCColonPadMode = COLON_PAD_NO_CHANGE;
 	lineEnd = LINEEND_DEFAULT;
 	maxCodeLength = std::string::npos;
-	isInStruct = false;
-	shouldPadCommas = false;
-	shouldPadOperators = false;
-	shouldPadParensOutside = false;
-	shouldPadFirstParen = false;
-	shouldPadEmptyParens = false;
-	shouldPadParensInside = false;
-	shouldPadHeader = false;
-	shouldStripCommentPrefix = false;
-	shouldUnPadParens = false;
-	attachClosingBraceMode = false;
-	shouldBreakOneLineBlocks = true;
-	shouldBreakOneLineHeaders = false;
-	shouldBreakOneLineStatements = true;
-	shouldConvertTabs = false;
-	shouldIndentCol1Comments = false;
-	shouldIndentPreprocBlock = false;
-	shouldCloseTemplates = false;
-	shouldAttachExternC = false;
-	shouldAttachNamespace = false;
-	shouldAttachClass = false;
-	shouldAttachClosingWhile = false;
-	shouldAttachInline = false;
-	shouldBreakBlocks = false;
-	shouldBreakClosingHeaderBlocks = false;
-	shouldBreakClosingHeaderBraces = false;
-	shouldDeleteEmptyLines = false;
-	shouldBreakReturnType = false;
-	shouldBreakReturnTypeDecl = false;
-	shouldAttachReturnType = false;
-	shouldAttachReturnTypeDecl = false;
-	shouldBreakElseIfs = false;
-	shouldBreakLineAfterLogical = false;
-	shouldAddBraces = false;
-	shouldAddOneLineBraces = false;
-	shouldRemoveBraces = false;
-	shouldPadMethodColon = false;
-	shouldPadMethodPrefix = false;
-	shouldUnPadMethodPrefix = false;
-	shouldPadReturnType = false;
-	shouldUnPadReturnType = false;
-	shouldPadParamType = false;
-	shouldUnPadParamType = false;
-	shouldPadBracketsOutside = false;
-	shouldPadBracketsInside = false;
-	shouldUnPadBrackets = false;
-
-	// initialize ASFormatter member std::vectors
+	squeezeEmptyLineNum = 0;
+	flags.isInStruct = false;
+	options.shouldPadCommas = false;
+	options.shouldPadOperators = false;
+	options.shouldPadParensOutside = false;
+	options.shouldPadFirstParen = false;
+	options.shouldPadEmptyParens = false;
+	options.shouldPadParensInside = false;
+	options.shouldPadHeader = false;
+	options.shouldStripCommentPrefix = false;
+	options.shouldUnPadParens = false;
+	options.attachClosingBraceMode = false;
+	options.shouldBreakOneLineBlocks = true;
+	options.shouldBreakOneLineHeaders = false;
+	options.shouldBreakOneLineStatements = true;
+	options.shouldConvertTabs = false;
+	options.shouldIndentCol1Comments = false;
+	options.shouldIndentPreprocBlock = false;
+	options.shouldCloseTemplates = false;
+	options.shouldAttachExternC = false;
+	options.shouldAttachNamespace = false;
+	options.shouldAttachClass = false;
+	options.shouldAttachClosingWhile = false;
+	options.shouldAttachInline = false;
+	options.shouldBreakBlocks = false;
+	options.shouldBreakClosingHeaderBlocks = false;
+	options.shouldBreakClosingHeaderBraces = false;
+	options.shouldDeleteEmptyLines = false;
+	options.shouldBreakReturnType = false;
+	options.shouldBreakReturnTypeDecl = false;
+	options.shouldAttachReturnType = false;
+	options.shouldAttachReturnTypeDecl = false;
+	options.shouldBreakElseIfs = false;
+	options.shouldBreakLineAfterLogical = false;
+	options.shouldAddBraces = false;
+	options.shouldAddOneLineBraces = false;
+	options.shouldRemoveBraces = false;
+	options.shouldPadMethodColon = false;
+	options.shouldPadMethodPrefix = false;
+	options.shouldUnPadMethodPrefix = false;
+	options.shouldPadReturnType = false;
+	options.shouldUnPadReturnType = false;
+	options.shouldPadParamType = false;
+	options.shouldUnPadParamType = false;
+	options.shouldPadBracketsOutside = false;
+	options.shouldPadBracketsInside = false;
+	options.shouldUnPadBrackets = false;
+	options.shouldCheckpointTopLevel = false;
+	checkpointInterval = 0;
+
+	// ASFormatter member std::vectors are set by buildLanguageVectors
 	formatterFileType = INVALID_TYPE;		// reset to an invalid type
-	headers = new std::vector<const std::string*>;
-	nonParenHeaders = new std::vector<const std::string*>;
-	preDefinitionHeaders = new std::vector<const std::string*>;
-	preCommandHeaders = new std::vector<const std::string*>;
-	operators = new std::vector<const std::string*>;
-	assignmentOperators = new std::vector<const std::string*>;
-	castOperators = new std::vector<const std::string*>;
-
-	// initialize ASEnhancer member std::vectors
-	indentableMacros = new std::vector<const std::pair<const std::string, const std::string>* >;
+	headers = nullptr;
+	nonParenHeaders = nullptr;
+	preDefinitionHeaders = nullptr;
+	preCommandHeaders = nullptr;
+	operators = nullptr;
+	assignmentOperators = nullptr;
+	castOperators = nullptr;
+	indentableMacros = nullptr;
 }
 
 /**
@@ -109,31 +109,8 @@ ASFormatter::ASFormatter()
  */
 ASFormatter::~ASFormatter()
 {
-	// delete ASFormatter stack std::vectors
-	deleteContainer(preBraceHeaderStack);
-	deleteContainer(braceTypeStack);
-	deleteContainer(parenStack);
-	deleteContainer(structStack);
-	deleteContainer(questionMarkStack);
-
-	// delete ASFormatter member std::vectors
-	formatterFileType = INVALID_TYPE;		// reset to an invalid type
-	delete headers;
-	delete nonParenHeaders;
-	delete preDefinitionHeaders;
-	delete preCommandHeaders;
-	delete operators;
-	delete assignmentOperators;
-	delete castOperators;
-
-	// delete ASEnhancer member std::vectors
-	delete indentableMacros;
-
-	// must be done when the ASFormatter object is deleted (not ASBeautifier)
-	// delete ASBeautifier member std::vectors
-	ASBeautifier::deleteBeautifierVectors();
-
-	delete enhancer;
+	// the beautifier state is in the arena, delete it before the arena
+	deleteBeautifierState();
 }
 
 /**
@@ -150,28 +127,29 @@ void ASFormatter::init(ASSourceIterator* si)
 {
 	buildLanguageVectors();
 	fixOptionVariableConflicts();
+	setArena(&sessionArena);
 	ASBeautifier::init(si);
 	sourceIterator = si;
 
-	enhancer->init(getFileType(),
-	               getIndentLength(),
-	               getTabLength(),
-	               getIndentString() == "\t",
-	               getForceTabIndentation(),
-	               getNamespaceIndent(),
-	               getCaseIndent(),
-	               shouldIndentPreprocBlock,
-	               getPreprocDefineIndent(),
-	               getEmptyLineFill(),
-	               indentableMacros);
-
-	initContainer(preBraceHeaderStack, new std::vector<const std::string*>);
-	initContainer(parenStack, new std::vector<int>);
-	initContainer(structStack, new std::vector<bool>);
-	initContainer(questionMarkStack, new std::vector<bool>);
-	parenStack->emplace_back(0);               // parenStack must contain this default entry
-	initContainer(braceTypeStack, new std::vector<BraceType>);
-	braceTypeStack->emplace_back(NULL_TYPE);   // braceTypeStack must contain this default entry
+	enhancer.init(getFileType(),
+	              getIndentLength(),
+	              getTabLength(),
+	              getIndentString() == "\t",
+	              getForceTabIndentation(),
+	              getNamespaceIndent(),
+	              getCaseIndent(),
+	              options.shouldIndentPreprocBlock,
+	              getPreprocDefineIndent(),
+	              getEmptyLineFill(),
+	              indentableMacros);
+
+	preBraceHeaderStack.clear();
+	parenStack.clear();
+	structStack.clear();
+	questionMarkStack.clear();
+	parenStack.emplace_back(0);               // parenStack must contain this default entry
+	braceTypeStack.clear();
+	braceTypeStack.emplace_back(NULL_TYPE);   // braceTypeStack must contain this default entry
 	clearFormattedLineSplitPoints();
 
 	currentHeader = nullptr;
@@ -198,6 +176,10 @@ void ASFormatter::init(ASSourceIterator* si)
 	methodAttachLineNum = 0;
 	methodBreakCharNum = std::string::npos;
 	methodBreakLineNum = 0;
+	sourceLineNum = 0;
+	outputLineNum = 0;
+	nextCheckpointLineNum = checkpointInterval;
+	checkpoints.items.clear();
 	nextLineSpacePadNum = 0;
 	objCColonAlign = 0;
 	templateDepth = 0;
@@ -209,117 +191,135 @@ void ASFormatter::init(ASSourceIterator* si)
 	tabIncrementIn = 0;
 	previousBraceType = NULL_TYPE;
 
-	isVirgin = true;
-	isInVirginLine = true;
-	isInLineComment = false;
-	isInComment = false;
-	isInCommentStartLine = false;
-	noTrimCommentContinuation = false;
-	isInPreprocessor = false;
-	isInPreprocessorDefineDef = false;
-	isInPreprocessorBeautify = false;
-	doesLineStartComment = false;
-	lineEndsInCommentOnly = false;
-	lineIsCommentOnly = false;
-	lineIsLineCommentOnly = false;
-	lineIsEmpty = false;
-	isImmediatelyPostCommentOnly = false;
-	isImmediatelyPostEmptyLine = false;
-	isInClassInitializer = false;
-	isInQuote = false;
-	isInVerbatimQuote = false;
-	checkInterpolation = false;
-	haveLineContinuationChar = false;
-	isInQuoteContinuation = false;
-	isHeaderInMultiStatementLine = false;
-	isSpecialChar = false;
-	isNonParenHeader = false;
-	foundNamespaceHeader = false;
-	foundClassHeader = false;
-	foundStructHeader = false;
-	foundInterfaceHeader = false;
-	foundPreDefinitionHeader = false;
-	foundPreCommandHeader = false;
-	foundPreCommandMacro = false;
-	foundTrailingReturnType = false;
-	foundCastOperator = false;
-	foundQuestionMark = false;
-	isInLineBreak = false;
-	endOfAsmReached = false;
-	endOfCodeReached = false;
-	isFormattingModeOff = false;
-	isInEnum = false;
-	isInContinuedPreProc = false;
-	isInStruct = false;
-	isInExecSQL = false;
-	isInAsm = false;
-	isInAsmOneLine = false;
-	isInAsmBlock = false;
-	isLineReady = false;
-	elseHeaderFollowsComments = false;
-	caseHeaderFollowsComments = false;
-	isPreviousBraceBlockRelated = false;
-	isInPotentialCalculation = false;
-	needHeaderOpeningBrace = false;
-	shouldBreakLineAtNextChar = false;
-	shouldKeepLineUnbroken = false;
-	shouldReparseCurrentChar = false;
-	passedSemicolon = false;
-	passedColon = false;
-	isImmediatelyPostNonInStmt = false;
-	isCharImmediatelyPostNonInStmt = false;
-	isInTemplate = false;
-	isImmediatelyPostComment = false;
-	isImmediatelyPostLineComment = false;
-	isImmediatelyPostEmptyBlock = false;
-	isImmediatelyPostObjCMethodPrefix = false;
-	isImmediatelyPostPreprocessor = false;
-	isImmediatelyPostReturn = false;
-	isImmediatelyPostThrow = false;
-	isImmediatelyPostNewDelete = false;
-	isImmediatelyPostOperator = false;
-	isImmediatelyPostTemplate = false;
-	isImmediatelyPostPointerOrReference = false;
-	isCharImmediatelyPostReturn = false;
-	isCharImmediatelyPostThrow = false;
-	isCharImmediatelyPostNewDelete = false;
-	isCharImmediatelyPostOperator = false;
-	isCharImmediatelyPostComment = false;
-	isPreviousCharPostComment = false;
-	isCharImmediatelyPostLineComment = false;
-	isCharImmediatelyPostOpenBlock = false;
-	isCharImmediatelyPostCloseBlock = false;
-	isCharImmediatelyPostTemplate = false;
-	isCharImmediatelyPostPointerOrReference = false;
-	isInObjCInterface = false;
-	isInObjCMethodDefinition = false;
-	isInObjCReturnType = false;
-	isInObjCParam = false;
-	isInObjCSelector = false;
-	breakCurrentOneLineBlock = false;
-	shouldRemoveNextClosingBrace = false;
-	isInBraceRunIn = false;
-	returnTypeChecked = false;
-	currentLineBeginsWithBrace = false;
-	isPrependPostBlockEmptyLineRequested = false;
-	isAppendPostBlockEmptyLineRequested = false;
-	isIndentablePreprocessor = false;
-	isIndentablePreprocessorBlck = false;
-	prependEmptyLine = false;
-	appendOpeningBrace = false;
-	foundClosingHeader = false;
-	isImmediatelyPostHeader = false;
-	isInHeader = false;
-	isInCase = false;
-    isInAllocator = false;
-
-	isFirstPreprocConditional = false;
-	processedFirstConditional = false;
-	isJavaStaticConstructor = false;
-}
-
-/**
- * build std::vectors for each programming language
+	flags.isVirgin = true;
+	flags.isInVirginLine = true;
+	flags.isInLineComment = false;
+	flags.isInComment = false;
+	flags.isInCommentStartLine = false;
+	flags.noTrimCommentContinuation = false;
+	flags.isInPreprocessor = false;
+	flags.isInPreprocessorDefineDef = false;
+	flags.isInPreprocessorBeautify = false;
+	flags.doesLineStartComment = false;
+	flags.lineEndsInCommentOnly = false;
+	flags.lineIsCommentOnly = false;
+	flags.lineIsLineCommentOnly = false;
+	flags.lineIsEmpty = false;
+	flags.isImmediatelyPostCommentOnly = false;
+	flags.isImmediatelyPostEmptyLine = false;
+	flags.isInClassInitializer = false;
+	flags.isInQuote = false;
+	flags.isInVerbatimQuote = false;
+	flags.checkInterpolation = false;
+	flags.haveLineContinuationChar = false;
+	flags.isInQuoteContinuation = false;
+	flags.isHeaderInMultiStatementLine = false;
+	flags.isSpecialChar = false;
+	flags.isNonParenHeader = false;
+	flags.foundNamespaceHeader = false;
+	flags.foundClassHeader = false;
+	flags.foundStructHeader = false;
+	flags.foundInterfaceHeader = false;
+	flags.foundPreDefinitionHeader = false;
+	flags.foundPreCommandHeader = false;
+	flags.foundPreCommandMacro = false;
+	flags.foundTrailingReturnType = false;
+	flags.foundCastOperator = false;
+	flags.foundQuestionMark = false;
+	flags.isInLineBreak = false;
+	flags.endOfAsmReached = false;
+	flags.endOfCodeReached = false;
+	flags.isFormattingModeOff = false;
+	flags.isInEnum = false;
+	flags.isInContinuedPreProc = false;
+	flags.isInStruct = false;
+	flags.isInExecSQL = false;
+	flags.isInAsm = false;
+	flags.isInAsmOneLine = false;
+	flags.isInAsmBlock = false;
+	flags.isLineReady = false;
+	flags.elseHeaderFollowsComments = false;
+	flags.caseHeaderFollowsComments = false;
+	flags.isPreviousBraceBlockRelated = false;
+	flags.isInPotentialCalculation = false;
+	flags.needHeaderOpeningBrace = false;
+	flags.shouldBreakLineAtNextChar = false;
+	flags.shouldKeepLineUnbroken = false;
+	flags.shouldReparseCurrentChar = false;
+	flags.passedSemicolon = false;
+	flags.passedColon = false;
+	flags.isImmediatelyPostNonInStmt = false;
+	flags.isCharImmediatelyPostNonInStmt = false;
+	flags.isInTemplate = false;
+	flags.isImmediatelyPostComment = false;
+	flags.isImmediatelyPostLineComment = false;
+	flags.isImmediatelyPostEmptyBlock = false;
+	flags.isImmediatelyPostObjCMethodPrefix = false;
+	flags.isImmediatelyPostPreprocessor = false;
+	flags.isImmediatelyPostReturn = false;
+	flags.isImmediatelyPostThrow = false;
+	flags.isImmediatelyPostNewDelete = false;
+	flags.isImmediatelyPostOperator = false;
+	flags.isImmediatelyPostTemplate = false;
+	flags.isImmediatelyPostPointerOrReference = false;
+	flags.isCharImmediatelyPostReturn = false;
+	flags.isCharImmediatelyPostThrow = false;
+	flags.isCharImmediatelyPostNewDelete = false;
+	flags.isCharImmediatelyPostOperator = false;
+	flags.isCharImmediatelyPostComment = false;
+	flags.isPreviousCharPostComment = false;
+	flags.isCharImmediatelyPostLineComment = false;
+	flags.isCharImmediatelyPostOpenBlock = false;
+	flags.isCharImmediatelyPostCloseBlock = false;
+	flags.isCharImmediatelyPostTemplate = false;
+	flags.isCharImmediatelyPostPointerOrReference = false;
+	flags.isInObjCInterface = false;
+	flags.isInObjCMethodDefinition = false;
+	flags.isInObjCReturnType = false;
+	flags.isInObjCParam = false;
+	flags.isInObjCSelector = false;
+	flags.breakCurrentOneLineBlock = false;
+	flags.shouldRemoveNextClosingBrace = false;
+	flags.isInBraceRunIn = false;
+	flags.returnTypeChecked = false;
+	flags.currentLineBeginsWithBrace = false;
+	flags.isPrependPostBlockEmptyLineRequested = false;
+	flags.isAppendPostBlockEmptyLineRequested = false;
+	flags.isIndentablePreprocessor = false;
+	flags.isIndentablePreprocessorBlck = false;
+	flags.prependEmptyLine = false;
+	flags.appendOpeningBrace = false;
+	flags.isAppendedBraceLine = false;
+	flags.isBreakAtLineStart = false;
+	flags.foundClosingHeader = false;
+	flags.isImmediatelyPostHeader = false;
+	flags.isInHeader = false;
+	flags.isInCase = false;
+    flags.isInAllocator = false;
+
+	flags.isFirstPreprocConditional = false;
+	flags.processedFirstConditional = false;
+	flags.isJavaStaticConstructor = false;
+}
+
+/**
+ * End the current session, keeping the options.
+ * The beautifier clones and the checkpoints are deleted, and the arena
+ * is released to its first block, so nothing references the source
+ * of the session. The containers keep their capacity for the next
+ * session. init() must be called before formatting again.
+ * Used by ASFormatterPool to reuse a configured formatter.
+ */
+void ASFormatter::reset()
+{
+	deleteBeautifierState();
+	sessionArena.release();
+	checkpoints.items.clear();
+	sourceIterator = nullptr;
+}
+
+/**
+ * set the std::vectors for each programming language
  * depending on the file extension.
  */
 void ASFormatter::buildLanguageVectors()
@@ -329,23 +329,15 @@ void ASFormatter::buildLanguageVectors()
 
 	formatterFileType = getFileType();
 
-	headers->clear();
-	nonParenHeaders->clear();
-	preDefinitionHeaders->clear();
-	preCommandHeaders->clear();
-	operators->clear();
-	assignmentOperators->clear();
-	castOperators->clear();
-	indentableMacros->clear();	// ASEnhancer
-
-	ASResource::buildHeaders(headers, getFileType());
-	ASResource::buildNonParenHeaders(nonParenHeaders, getFileType());
-	ASResource::buildPreDefinitionHeaders(preDefinitionHeaders, getFileType());
-	ASResource::buildPreCommandHeaders(preCommandHeaders, getFileType());
-	ASResource::buildOperators(operators, getFileType());
-	ASResource::buildAssignmentOperators(assignmentOperators);
-	ASResource::buildCastOperators(castOperators);
-	ASResource::buildIndentableMacros(indentableMacros);	//ASEnhancer
+	const ASLanguageVectors& languageVectors = ASLanguageVectors::get(formatterFileType);
+	headers = &languageVectors.headerSet;
+	nonParenHeaders = &languageVectors.nonParenHeaderSet;
+	preDefinitionHeaders = &languageVectors.preDefinitionHeaderSet;
+	preCommandHeaders = &languageVectors.preCommandHeaderSet;
+	operators = &languageVectors.operatorSet;
+	assignmentOperators = &languageVectors.assignmentOperators;
+	castOperators = &languageVectors.castOperatorSet;
+	indentableMacros = &languageVectors.indentableMacros;	// ASEnhancer
 }
 
 /**
@@ -438,8 +430,8 @@ void ASFormatter::fixOptionVariableConflicts()
 		setBreakOneLineStatementsMode(false);
 		// add-braces won't work for pico, but it could be fixed if necessary
 		// both options should be set to true
-		if (shouldAddBraces)
-			shouldAddOneLineBraces = true;
+		if (options.shouldAddBraces)
+			options.shouldAddOneLineBraces = true;
 	}
 	else if (formattingStyle == STYLE_LISP)
 	{
@@ -448,10 +440,10 @@ void ASFormatter::fixOptionVariableConflicts()
 		setBreakOneLineStatementsMode(false);
 		// add-one-line-braces won't work for lisp
 		// only shouldAddBraces should be set to true
-		if (shouldAddOneLineBraces)
+		if (options.shouldAddOneLineBraces)
 		{
-			shouldAddBraces = true;
-			shouldAddOneLineBraces = false;
+			options.shouldAddBraces = true;
+			options.shouldAddOneLineBraces = false;
 		}
 	}
 	setMinConditionalIndentLength();
@@ -459,16 +451,16 @@ void ASFormatter::fixOptionVariableConflicts()
 	if (getTabLength() == 0)
 		setDefaultTabLength();
 	// add-one-line-braces implies keep-one-line-blocks
-	if (shouldAddOneLineBraces)
+	if (options.shouldAddOneLineBraces)
 		setBreakOneLineBlocksMode(false);
 	// don't allow add-braces and remove-braces
-	if (shouldAddBraces || shouldAddOneLineBraces)
+	if (options.shouldAddBraces || options.shouldAddOneLineBraces)
 		setRemoveBracesMode(false);
 	// don't allow break-return-type and attach-return-type
-	if (shouldBreakReturnType)
-		shouldAttachReturnType = false;
-	if (shouldBreakReturnTypeDecl)
-		shouldAttachReturnTypeDecl = false;
+	if (options.shouldBreakReturnType)
+		options.shouldAttachReturnType = false;
+	if (options.shouldBreakReturnTypeDecl)
+		options.shouldAttachReturnTypeDecl = false;
 	// don't allow indent-classes and indent-modifiers
 	if (getClassIndent())
 		setModifierIndent(false);
@@ -482,19 +474,19 @@ void ASFormatter::fixOptionVariableConflicts()
 std::string ASFormatter::nextLine()
 {
 	const std::string* newHeader = nullptr;
-	isInVirginLine = isVirgin;
-	isCharImmediatelyPostComment = false;
-	isPreviousCharPostComment = false;
-	isCharImmediatelyPostLineComment = false;
-	isCharImmediatelyPostOpenBlock = false;
-	isCharImmediatelyPostCloseBlock = false;
-	isCharImmediatelyPostTemplate = false;
+	flags.isInVirginLine = flags.isVirgin;
+	flags.isCharImmediatelyPostComment = false;
+	flags.isPreviousCharPostComment = false;
+	flags.isCharImmediatelyPostLineComment = false;
+	flags.isCharImmediatelyPostOpenBlock = false;
+	flags.isCharImmediatelyPostCloseBlock = false;
+	flags.isCharImmediatelyPostTemplate = false;
 
 
-	while (!isLineReady)
+	while (!flags.isLineReady)
 	{
-		if (shouldReparseCurrentChar)
-			shouldReparseCurrentChar = false;
+		if (flags.shouldReparseCurrentChar)
+			flags.shouldReparseCurrentChar = false;
 		else if (!getNextChar())
 		{
 			breakLine();
@@ -503,86 +495,86 @@ std::string ASFormatter::nextLine()
 		else // stuff to do when reading a new character...
 		{
 			// make sure that a virgin '{' at the beginning of the file will be treated as a block...
-			if (isInVirginLine && currentChar == '{'
-			        && currentLineBeginsWithBrace
+			if (flags.isInVirginLine && currentChar == '{'
+			        && flags.currentLineBeginsWithBrace
 			        && previousCommandChar == ' ')
 				previousCommandChar = '{';
-			if (isInClassInitializer
-			        && isBraceType(braceTypeStack->back(), COMMAND_TYPE))
-				isInClassInitializer = false;
-			if (isInBraceRunIn)
-				isInLineBreak = false;
+			if (flags.isInClassInitializer
+			        && isBraceType(braceTypeStack.back(), COMMAND_TYPE))
+				flags.isInClassInitializer = false;
+			if (flags.isInBraceRunIn)
+				flags.isInLineBreak = false;
 			if (!isWhiteSpace(currentChar))
-				isInBraceRunIn = false;
-			isPreviousCharPostComment = isCharImmediatelyPostComment;
-			isCharImmediatelyPostComment = false;
-			isCharImmediatelyPostTemplate = false;
-			isCharImmediatelyPostReturn = false;
-			isCharImmediatelyPostThrow = false;
-			isCharImmediatelyPostNewDelete = false;
-			isCharImmediatelyPostOperator = false;
-			isCharImmediatelyPostPointerOrReference = false;
-			isCharImmediatelyPostOpenBlock = false;
-			isCharImmediatelyPostCloseBlock = false;
-		}
-
-		if ((lineIsLineCommentOnly || lineIsCommentOnly)
+				flags.isInBraceRunIn = false;
+			flags.isPreviousCharPostComment = flags.isCharImmediatelyPostComment;
+			flags.isCharImmediatelyPostComment = false;
+			flags.isCharImmediatelyPostTemplate = false;
+			flags.isCharImmediatelyPostReturn = false;
+			flags.isCharImmediatelyPostThrow = false;
+			flags.isCharImmediatelyPostNewDelete = false;
+			flags.isCharImmediatelyPostOperator = false;
+			flags.isCharImmediatelyPostPointerOrReference = false;
+			flags.isCharImmediatelyPostOpenBlock = false;
+			flags.isCharImmediatelyPostCloseBlock = false;
+		}
+
+		if ((flags.lineIsLineCommentOnly || flags.lineIsCommentOnly)
 		        && currentLine.find("*INDENT-ON*", charNum) != std::string::npos
-		        && isFormattingModeOff)
+		        && flags.isFormattingModeOff)
 		{
-			isFormattingModeOff = false;
+			flags.isFormattingModeOff = false;
 			breakLine();
 			formattedLine = currentLine;
 			charNum = (int) currentLine.length() - 1;
 			continue;
 		}
-		if (isFormattingModeOff)
+		if (flags.isFormattingModeOff)
 		{
 			breakLine();
 			formattedLine = currentLine;
 			charNum = (int) currentLine.length() - 1;
 			continue;
 		}
-		if ((lineIsLineCommentOnly || lineIsCommentOnly)
+		if ((flags.lineIsLineCommentOnly || flags.lineIsCommentOnly)
 		        && currentLine.find("*INDENT-OFF*", charNum) != std::string::npos)
 		{
-			isFormattingModeOff = true;
-			if (isInLineBreak)			// is true if not the first line
+			flags.isFormattingModeOff = true;
+			if (flags.isInLineBreak)			// is true if not the first line
 				breakLine();
 			formattedLine = currentLine;
 			charNum = (int) currentLine.length() - 1;
 			continue;
 		}
 
-		if (shouldBreakLineAtNextChar)
+		if (flags.shouldBreakLineAtNextChar)
 		{
-			if (isWhiteSpace(currentChar) && !lineIsEmpty)
+			if (isWhiteSpace(currentChar) && !flags.lineIsEmpty)
 				continue;
-			isInLineBreak = true;
-			shouldBreakLineAtNextChar = false;
+			flags.isInLineBreak = true;
+			flags.shouldBreakLineAtNextChar = false;
 		}
 
-		if (isInExecSQL && !passedSemicolon)
+		if (flags.isInExecSQL && !flags.passedSemicolon)
 		{
 			if (currentChar == ';')
-				passedSemicolon = true;
+				flags.passedSemicolon = true;
 			appendCurrentChar();
 			continue;
 		}
 
-		if (isInLineComment)
+		if (flags.isInLineComment)
 		{
 			formatLineCommentBody();
 			continue;
 		}
 
-		if (isInComment)
+		if (flags.isInComment)
 		{
 			formatCommentBody();
 			continue;
 		}
 
-		if (isInQuote)
+		if (flags.isInQuote)
 		{
 			formatQuoteBody();
 			continue;
@@ -614,7 +606,7 @@ std::string ASFormatter::nextLine()
 		if ((currentChar == '#')
 		        && currentLine.find_first_not_of(" \t") == (size_t) charNum)
 		{
-			isInContinuedPreProc = currentLine[currentLine.size() - 1] == '\\';
+			flags.isInContinuedPreProc = currentLine[currentLine.size() - 1] == '\\';
 
 			/*
 			std::string preproc = trim(currentLine.c_str() + charNum + 1);
@@ -631,34 +623,34 @@ std::string ASFormatter::nextLine()
 				// check for run-in
 				if (formattedLine.length() > 0 && formattedLine[0] == '{')
 				{
-					isInLineBreak = true;
-					isInBraceRunIn = false;
+					flags.isInLineBreak = true;
+					flags.isInBraceRunIn = false;
 				}
 				if (previousCommandChar == '}')
 					currentHeader = nullptr;
-				isInLineComment = true;
+				flags.isInLineComment = true;
 				appendCurrentChar();
 				continue;
 			}
 			*/
 		}
 
-		if (isInPreprocessor)
+		if (flags.isInPreprocessor)
 		{
 			appendCurrentChar();
 			continue;
 		}
 
-		if (isInTemplate && shouldCloseTemplates)
+		if (flags.isInTemplate && options.shouldCloseTemplates)
 		{
 			if (previousNonWSChar == '>' && isWhiteSpace(currentChar) && peekNextChar() == '>')
 				continue;
 		}
 
-		if (shouldRemoveNextClosingBrace && currentChar == '}')
+		if (flags.shouldRemoveNextClosingBrace && currentChar == '}')
 		{
 			currentLine[charNum] = currentChar = ' ';
-			shouldRemoveNextClosingBrace = false;
+			flags.shouldRemoveNextClosingBrace = false;
 			assert(adjustChecksumIn(-'}'));
 			if (isEmptyLine(currentLine))
 				continue;
@@ -678,39 +670,39 @@ std::string ASFormatter::nextLine()
 		//    of a new line in getnextChar()
 		if (currentChar == '#'
 		        && currentLine.find_first_not_of(" \t") == (size_t) charNum
-		        && !isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE))
+		        && !isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE))
 		{
-			isInPreprocessor = true;
+			flags.isInPreprocessor = true;
 			// check for run-in
 			if (formattedLine.length() > 0 && formattedLine[0] == '{')
 			{
-				isInLineBreak = true;
-				isInBraceRunIn = false;
+				flags.isInLineBreak = true;
+				flags.isInBraceRunIn = false;
 			}
 			processPreprocessor();
 			// if top level it is potentially indentable
-			if (shouldIndentPreprocBlock
-			        && (isBraceType(braceTypeStack->back(), NULL_TYPE)
-			            || isBraceType(braceTypeStack->back(), NAMESPACE_TYPE)
+			if (options.shouldIndentPreprocBlock
+			        && (isBraceType(braceTypeStack.back(), NULL_TYPE)
+			            || isBraceType(braceTypeStack.back(), NAMESPACE_TYPE)
 
 			            /* #521 enables preprocessor indent within { ... } block, but disables indent of code between #ifdefs  */
 			            //|| getFileType() == C_TYPE
 			           )
-			        && !foundClassHeader
-			        && !isInClassInitializer
+			        && !flags.foundClassHeader
+			        && !flags.isInClassInitializer
 			        && sourceIterator->tellg() > preprocBlockEnd)
 			{
 				// indent the #if preprocessor blocks
 				std::string preproc = ASBeautifier::extractPreprocessorStatement(currentLine);
 				if (preproc.length() >= 2 && preproc.substr(0, 2) == "if") // #if, #ifdef, #ifndef
 				{
-					if (isImmediatelyPostPreprocessor)
+					if (flags.isImmediatelyPostPreprocessor)
 						breakLine();
-					isIndentablePreprocessorBlck = isIndentablePreprocessorBlock(currentLine, charNum);
-					isIndentablePreprocessor = isIndentablePreprocessorBlck;
+					flags.isIndentablePreprocessorBlck = isIndentablePreprocessorBlock(currentLine, charNum);
+					flags.isIndentablePreprocessor = flags.isIndentablePreprocessorBlck;
 				}
 			}
-			if (isIndentablePreprocessorBlck
+			if (flags.isIndentablePreprocessorBlck
 			        && charNum < (int) currentLine.length() - 1
 			        && isWhiteSpace(currentLine[charNum + 1]))
 			{
@@ -718,131 +710,131 @@ std::string ASFormatter::nextLine()
 				if (nextText != std::string::npos)
 					currentLine.erase(charNum + 1, nextText - charNum - 1);
 			}
-			if (isIndentablePreprocessorBlck
+			if (flags.isIndentablePreprocessorBlck
 			        && sourceIterator->tellg() >= preprocBlockEnd)
-				isIndentablePreprocessorBlck = false;
+				flags.isIndentablePreprocessorBlck = false;
 			//  need to fall thru here to reset the variables
 		}
 
 		/* not in preprocessor ... */
 
-		if (isImmediatelyPostComment)
+		if (flags.isImmediatelyPostComment)
 		{
-			caseHeaderFollowsComments = false;
-			isImmediatelyPostComment = false;
-			isCharImmediatelyPostComment = true;
+			flags.caseHeaderFollowsComments = false;
+			flags.isImmediatelyPostComment = false;
+			flags.isCharImmediatelyPostComment = true;
 		}
 
-		if (isImmediatelyPostLineComment)
+		if (flags.isImmediatelyPostLineComment)
 		{
-			caseHeaderFollowsComments = false;
-			isImmediatelyPostLineComment = false;
-			isCharImmediatelyPostLineComment = true;
+			flags.caseHeaderFollowsComments = false;
+			flags.isImmediatelyPostLineComment = false;
+			flags.isCharImmediatelyPostLineComment = true;
 		}
 
-		if (isImmediatelyPostReturn)
+		if (flags.isImmediatelyPostReturn)
 		{
-			isImmediatelyPostReturn = false;
-			isCharImmediatelyPostReturn = true;
+			flags.isImmediatelyPostReturn = false;
+			flags.isCharImmediatelyPostReturn = true;
 		}
 
-		if (isImmediatelyPostThrow)
+		if (flags.isImmediatelyPostThrow)
 		{
-			isImmediatelyPostThrow = false;
-			isCharImmediatelyPostThrow = true;
+			flags.isImmediatelyPostThrow = false;
+			flags.isCharImmediatelyPostThrow = true;
 		}
 
-		if (isImmediatelyPostNewDelete)
+		if (flags.isImmediatelyPostNewDelete)
 		{
-			isImmediatelyPostNewDelete = false;
-			isCharImmediatelyPostNewDelete = true;
+			flags.isImmediatelyPostNewDelete = false;
+			flags.isCharImmediatelyPostNewDelete = true;
 		}
 
-		if (isImmediatelyPostOperator)
+		if (flags.isImmediatelyPostOperator)
 		{
-			isImmediatelyPostOperator = false;
-			isCharImmediatelyPostOperator = true;
+			flags.isImmediatelyPostOperator = false;
+			flags.isCharImmediatelyPostOperator = true;
 		}
-		if (isImmediatelyPostTemplate)
+		if (flags.isImmediatelyPostTemplate)
 		{
-			isImmediatelyPostTemplate = false;
-			isCharImmediatelyPostTemplate = true;
+			flags.isImmediatelyPostTemplate = false;
+			flags.isCharImmediatelyPostTemplate = true;
 		}
-		if (isImmediatelyPostPointerOrReference)
+		if (flags.isImmediatelyPostPointerOrReference)
 		{
-			isImmediatelyPostPointerOrReference = false;
-			isCharImmediatelyPostPointerOrReference = true;
+			flags.isImmediatelyPostPointerOrReference = false;
+			flags.isCharImmediatelyPostPointerOrReference = true;
 		}
 
 		// reset isImmediatelyPostHeader information
-		if (isImmediatelyPostHeader)
+		if (flags.isImmediatelyPostHeader)
 		{
 			// should braces be added
 			if (currentChar != '{'
-			        && shouldAddBraces
+			        && options.shouldAddBraces
 			        && currentChar != '#'	// don't add to preprocessor
-			        && (shouldBreakOneLineStatements || !isHeaderInMultiStatementLine)
-			        && isOkToBreakBlock(braceTypeStack->back()))
+			        && (options.shouldBreakOneLineStatements || !flags.isHeaderInMultiStatementLine)
+			        && isOkToBreakBlock(braceTypeStack.back()))
 			{
 				bool bracesAdded = addBracesToStatement();
-				if (bracesAdded && !shouldAddOneLineBraces)
+				if (bracesAdded && !options.shouldAddOneLineBraces)
 				{
 					size_t firstText = currentLine.find_first_not_of(" \t");
 					assert(firstText != std::string::npos);
-					if ((int) firstText == charNum || shouldBreakOneLineHeaders)
-						breakCurrentOneLineBlock = true;
+					if ((int) firstText == charNum || options.shouldBreakOneLineHeaders)
+						flags.breakCurrentOneLineBlock = true;
 				}
 			}
 			// should braces be removed
-			else if (currentChar == '{' && shouldRemoveBraces)
+			else if (currentChar == '{' && options.shouldRemoveBraces)
 			{
 				bool bracesRemoved = removeBracesFromStatement();
 				if (bracesRemoved)
 				{
-					shouldRemoveNextClosingBrace = true;
+					flags.shouldRemoveNextClosingBrace = true;
 					if (isBeforeAnyLineEndComment(charNum))
 						spacePadNum--;
-					else if (shouldBreakOneLineBlocks
-					         || (currentLineBeginsWithBrace
+					else if (options.shouldBreakOneLineBlocks
+					         || (flags.currentLineBeginsWithBrace
 					             && currentLine.find_first_not_of(" \t") != std::string::npos))
-						shouldBreakLineAtNextChar = true;
+						flags.shouldBreakLineAtNextChar = true;
 					continue;
 				}
 			}
 
 			// break 'else-if' if shouldBreakElseIfs is requested
-			if (shouldBreakElseIfs
+			if (options.shouldBreakElseIfs
 			        && currentHeader == &AS_ELSE
-			        && isOkToBreakBlock(braceTypeStack->back())
+			        && isOkToBreakBlock(braceTypeStack.back())
 			        && !isBeforeAnyComment()
-			        && (shouldBreakOneLineStatements || !isHeaderInMultiStatementLine))
+			        && (options.shouldBreakOneLineStatements || !flags.isHeaderInMultiStatementLine))
 			{
 				std::string nextText = peekNextText(currentLine.substr(charNum));
 				if (nextText.length() > 0
 				        && isCharPotentialHeader(nextText, 0)
 				        && ASBase::findHeader(nextText, 0, headers) == &AS_IF)
 				{
-					isInLineBreak = true;
+					flags.isInLineBreak = true;
 				}
 			}
 
 			// break a header (e.g. if, while, else) from the following statement
-			if (shouldBreakOneLineHeaders
+			if (options.shouldBreakOneLineHeaders
 			        && peekNextChar() != ' '
-			        && (shouldBreakOneLineStatements
-			            || (!isHeaderInMultiStatementLine
+			        && (options.shouldBreakOneLineStatements
+			            || (!flags.isHeaderInMultiStatementLine
 			                && !isMultiStatementLine()))
-			        && isOkToBreakBlock(braceTypeStack->back())
+			        && isOkToBreakBlock(braceTypeStack.back())
 			        && !isBeforeAnyComment())
 			{
 				if (currentChar == '{')
 				{
-					if (!currentLineBeginsWithBrace)
+					if (!flags.currentLineBeginsWithBrace)
 					{
 						if (isOneLineBlockReached(currentLine, charNum) == 3)
-							isInLineBreak = false;
+							flags.isInLineBreak = false;
 						else
-							breakCurrentOneLineBlock = true;
+							flags.breakCurrentOneLineBlock = true;
 					}
 				}
 				else if (currentHeader == &AS_ELSE)
@@ -852,27 +844,27 @@ std::string ASFormatter::nextLine()
 					        && ((isCharPotentialHeader(nextText, 0)
 					             && ASBase::findHeader(nextText, 0, headers) != &AS_IF)
 					            || nextText[0] == '{'))
-						isInLineBreak = true;
+						flags.isInLineBreak = true;
 				}
 				else
 				{
 					// GH16 only break if header is present
 					if (currentHeader)
-						isInLineBreak = true;
+						flags.isInLineBreak = true;
 				}
 			}
 
-			isImmediatelyPostHeader = false;
+			flags.isImmediatelyPostHeader = false;
 		}
 
-		if (passedSemicolon)    // need to break the formattedLine
+		if (flags.passedSemicolon)    // need to break the formattedLine
 		{
-			isInAllocator = false; // GH16
-			passedSemicolon = false;
-			if (parenStack->back() == 0 && !isCharImmediatelyPostComment && currentChar != ';') // allow ;;
+			flags.isInAllocator = false; // GH16
+			flags.passedSemicolon = false;
+			if (parenStack.back() == 0 && !flags.isCharImmediatelyPostComment && currentChar != ';') // allow ;;
 			{
 				// does a one-line block have ending comments?
-				if (isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE))
+				if (isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE))
 				{
 					size_t blockEnd = currentLine.rfind(AS_CLOSE_BRACE);
 					assert(blockEnd != std::string::npos);
@@ -890,7 +882,7 @@ std::string ASFormatter::nextLine()
 						while (charNum < (int) currentLine.length())
 						{
 							currentChar = currentLine[charNum];
-							if (currentChar == '\t' && shouldConvertTabs)
+							if (currentChar == '\t' && options.shouldConvertTabs)
 								convertTabToSpaces();
 							formattedLine.append(1, currentChar);
 							++charNum;
@@ -902,34 +894,34 @@ std::string ASFormatter::nextLine()
 						testForTimeToSplitFormattedLine();
 					}
 				}
-				isInExecSQL = false;
-				shouldReparseCurrentChar = true;
+				flags.isInExecSQL = false;
+				flags.shouldReparseCurrentChar = true;
 				if (formattedLine.find_first_not_of(" \t") != std::string::npos)
-					isInLineBreak = true;
-				if (needHeaderOpeningBrace)
+					flags.isInLineBreak = true;
+				if (flags.needHeaderOpeningBrace)
 				{
-					isCharImmediatelyPostCloseBlock = true;
-					needHeaderOpeningBrace = false;
+					flags.isCharImmediatelyPostCloseBlock = true;
+					flags.needHeaderOpeningBrace = false;
 				}
 				continue;
 			}
 		}
 
-		if (passedColon)
+		if (flags.passedColon)
 		{
-			passedColon = false;
-			if (parenStack->back() == 0
+			flags.passedColon = false;
+			if (parenStack.back() == 0
 			        && !isBeforeAnyComment()
 			        && (formattedLine.find_first_not_of(" \t") != std::string::npos))
 			{
-				shouldReparseCurrentChar = true;
-				isInLineBreak = true;
+				flags.shouldReparseCurrentChar = true;
+				flags.isInLineBreak = true;
 				continue;
 			}
 		}
 
 		// Check if in template declaration, e.g. foo<bar> or foo<bar,fig>
-		if (!isInTemplate && currentChar == '<')
+		if (!flags.isInTemplate && currentChar == '<')
 		{
 			checkIfTemplateOpener();
 		}
@@ -938,7 +930,7 @@ std::string ASFormatter::nextLine()
 		if ((size_t) charNum >= methodBreakCharNum && methodBreakLineNum == 0)
 		{
 			if ((size_t) charNum == methodBreakCharNum)
-				isInLineBreak = true;
+				flags.isInLineBreak = true;
 			methodBreakCharNum = std::string::npos;
 			methodBreakLineNum = 0;
 		}
@@ -951,7 +943,7 @@ std::string ASFormatter::nextLine()
 				int ra = referenceAlignment;
 				int itemAlignment = (previousNonWSChar == '*' || previousNonWSChar == '^')
 				                    ? pa : ((ra == REF_SAME_AS_PTR) ? pa : ra);
-				isInLineBreak = false;
+				flags.isInLineBreak = false;
 				if (previousNonWSChar == '*' || previousNonWSChar == '&' || previousNonWSChar == '^')
 				{
 					if (itemAlignment == REF_ALIGN_TYPE)
@@ -987,12 +979,12 @@ std::string ASFormatter::nextLine()
 		}
 
 		// handle parens
-		if (currentChar == '(' || currentChar == '[' || (isInTemplate && currentChar == '<'))
+		if (currentChar == '(' || currentChar == '[' || (flags.isInTemplate && currentChar == '<'))
 		{
 			// do not use emplace_back on std::vector<bool> until supported by macOS
-			questionMarkStack->push_back(foundQuestionMark);
-			foundQuestionMark = false;
-			parenStack->back()++;
+			questionMarkStack.push_back(flags.foundQuestionMark);
+			flags.foundQuestionMark = false;
+			parenStack.back()++;
 			if (currentChar == '[')
 			{
 				++squareBracketCount;
@@ -1005,35 +997,35 @@ std::string ASFormatter::nextLine()
 			}
 		}
 
-		else if (currentChar == ')' || currentChar == ']' || (isInTemplate && currentChar == '>'))
+		else if (currentChar == ')' || currentChar == ']' || (flags.isInTemplate && currentChar == '>'))
 		{
-			foundPreCommandHeader = false;
-			parenStack->back()--;
+			flags.foundPreCommandHeader = false;
+			parenStack.back()--;
 			// this can happen in preprocessor directives
-			if (parenStack->back() < 0)
-				parenStack->back() = 0;
-			if (!questionMarkStack->empty())
+			if (parenStack.back() < 0)
+				parenStack.back() = 0;
+			if (!questionMarkStack.empty())
 			{
-				foundQuestionMark = questionMarkStack->back();
-				questionMarkStack->pop_back();
+				flags.foundQuestionMark = questionMarkStack.back();
+				questionMarkStack.pop_back();
 			}
-			if (isInTemplate && currentChar == '>')
+			if (flags.isInTemplate && currentChar == '>')
 			{
 				templateDepth--;
 				if (templateDepth == 0)
 				{
-					isInTemplate = false;
-					isImmediatelyPostTemplate = true;
+					flags.isInTemplate = false;
+					flags.isImmediatelyPostTemplate = true;
 				}
 			}
 
 			// check if this parenthesis closes a header, e.g. if (...), while (...)
 			//GH16
-			if ( !(isSharpStyle() && peekNextChar() == ',') && isInHeader && parenStack->back() == 0)
+			if ( !(isSharpStyle() && peekNextChar() == ',') && flags.isInHeader && parenStack.back() == 0)
 			{
-				isInHeader = false;
-				isImmediatelyPostHeader = true;
-				foundQuestionMark = false;
+				flags.isInHeader = false;
+				flags.isImmediatelyPostHeader = true;
+				flags.foundQuestionMark = false;
 			}
 			if (currentChar == ']')
 			{
@@ -1049,9 +1041,9 @@ std::string ASFormatter::nextLine()
 			if (currentChar == ')')
 			{
 				--parenthesesCount;
-				foundCastOperator = false;
-				if (parenStack->back() == 0)
-					endOfAsmReached = true;
+				flags.foundCastOperator = false;
+				if (parenStack.back() == 0)
+					flags.endOfAsmReached = true;
 			}
 		}
 
@@ -1061,29 +1053,29 @@ std::string ASFormatter::nextLine()
 		if (currentChar == '{' || currentChar == '}')
 		{
 			// if appendOpeningBrace this was already done for the original brace
-			if (currentChar == '{' && !appendOpeningBrace)
+			if (currentChar == '{' && !flags.appendOpeningBrace)
 			{
 				BraceType newBraceType = getBraceType();
-				breakCurrentOneLineBlock = false;
-				foundNamespaceHeader = false;
-				foundClassHeader = false;
-				foundStructHeader = false;
-				foundInterfaceHeader = false;
-				foundPreDefinitionHeader = false;
-				foundPreCommandHeader = false;
-				foundPreCommandMacro = false;
-				foundTrailingReturnType = false;
-				isInPotentialCalculation = false;
-				isInObjCMethodDefinition = false;
-				isImmediatelyPostObjCMethodPrefix = false;
-				isInObjCInterface = false;
-				isInEnum = false;
-
-				isJavaStaticConstructor = false;
-				isCharImmediatelyPostNonInStmt = false;
-				needHeaderOpeningBrace = false;
-				shouldKeepLineUnbroken = false;
-				returnTypeChecked = false;
+				flags.breakCurrentOneLineBlock = false;
+				flags.foundNamespaceHeader = false;
+				flags.foundClassHeader = false;
+				flags.foundStructHeader = false;
+				flags.foundInterfaceHeader = false;
+				flags.foundPreDefinitionHeader = false;
+				flags.foundPreCommandHeader = false;
+				flags.foundPreCommandMacro = false;
+				flags.foundTrailingReturnType = false;
+				flags.isInPotentialCalculation = false;
+				flags.isInObjCMethodDefinition = false;
+				flags.isImmediatelyPostObjCMethodPrefix = false;
+				flags.isInObjCInterface = false;
+				flags.isInEnum = false;
+
+				flags.isJavaStaticConstructor = false;
+				flags.isCharImmediatelyPostNonInStmt = false;
+				flags.needHeaderOpeningBrace = false;
+				flags.shouldKeepLineUnbroken = false;
+				flags.returnTypeChecked = false;
 				objCColonAlign = 0;
 
 				methodBreakCharNum = std::string::npos;
@@ -1091,23 +1083,23 @@ std::string ASFormatter::nextLine()
 				methodAttachCharNum = std::string::npos;
 				methodAttachLineNum = 0;
 
-				isPreviousBraceBlockRelated = !isBraceType(newBraceType, ARRAY_TYPE);
-				braceTypeStack->emplace_back(newBraceType);
-				preBraceHeaderStack->emplace_back(currentHeader);
+				flags.isPreviousBraceBlockRelated = !isBraceType(newBraceType, ARRAY_TYPE);
+				braceTypeStack.emplace_back(newBraceType);
+				preBraceHeaderStack.emplace_back(currentHeader);
 				currentHeader = nullptr;
 				// do not use emplace_back on std::vector<bool> until supported by macOS
-				structStack->push_back(isInIndentableStruct);
+				structStack.push_back(hints.isInIndentableStruct);
 				if (isBraceType(newBraceType, STRUCT_TYPE) && isCStyle())
-					isInIndentableStruct = isStructAccessModified(currentLine, charNum);
+					hints.isInIndentableStruct = isStructAccessModified(currentLine, charNum);
 				else
-					isInIndentableStruct = false;
+					hints.isInIndentableStruct = false;
 			}
 
 			// this must be done before the braceTypeStack is popped
-			BraceType braceType = braceTypeStack->back();
+			BraceType braceType = braceTypeStack.back();
 			bool isOpeningArrayBrace = (isBraceType(braceType, ARRAY_TYPE)
-			                            && braceTypeStack->size() >= 2
-			                            && !isBraceType((*braceTypeStack)[braceTypeStack->size() - 2], ARRAY_TYPE)
+			                            && braceTypeStack.size() >= 2
+			                            && !isBraceType(braceTypeStack[braceTypeStack.size() - 2], ARRAY_TYPE)
 			                           );
 
 			if (currentChar == '}')
@@ -1115,59 +1107,59 @@ std::string ASFormatter::nextLine()
 				// if a request has been made to append a post block empty line,
 				// but the block exists immediately before a closing brace,
 				// then there is no need for the post block empty line.
-				isAppendPostBlockEmptyLineRequested = false;
-				if (isInAsm)
-					endOfAsmReached = true;
-				isInAsmOneLine = isInQuote = false;
-				shouldKeepLineUnbroken = false;
+				flags.isAppendPostBlockEmptyLineRequested = false;
+				if (flags.isInAsm)
+					flags.endOfAsmReached = true;
+				flags.isInAsmOneLine = flags.isInQuote = false;
+				flags.shouldKeepLineUnbroken = false;
 				squareBracketCount = 0;
-				isInAllocator = false;
+				flags.isInAllocator = false;
 
-				if (braceTypeStack->size() > 1)
+				if (braceTypeStack.size() > 1)
 				{
-					previousBraceType = braceTypeStack->back();
-					braceTypeStack->pop_back();
-					isPreviousBraceBlockRelated = !isBraceType(braceType, ARRAY_TYPE);
+					previousBraceType = braceTypeStack.back();
+					braceTypeStack.pop_back();
+					flags.isPreviousBraceBlockRelated = !isBraceType(braceType, ARRAY_TYPE);
 				}
 				else
 				{
 					previousBraceType = NULL_TYPE;
-					isPreviousBraceBlockRelated = false;
+					flags.isPreviousBraceBlockRelated = false;
 				}
 
-				if (!preBraceHeaderStack->empty())
+				if (!preBraceHeaderStack.empty())
 				{
-					currentHeader = preBraceHeaderStack->back();
-					preBraceHeaderStack->pop_back();
+					currentHeader = preBraceHeaderStack.back();
+					preBraceHeaderStack.pop_back();
 				}
 				else
 					currentHeader = nullptr;
 
-				if (!structStack->empty())
+				if (!structStack.empty())
 				{
-					isInIndentableStruct = structStack->back();
-					structStack->pop_back();
+					hints.isInIndentableStruct = structStack.back();
+					structStack.pop_back();
 				}
 				else
-					isInIndentableStruct = false;
+					hints.isInIndentableStruct = false;
 
-				if (isNonInStatementArray
-				        && (!isBraceType(braceTypeStack->back(), ARRAY_TYPE)	// check previous brace
+				if (hints.isNonInStatementArray
+				        && (!isBraceType(braceTypeStack.back(), ARRAY_TYPE)	// check previous brace
 				            || peekNextChar() == ';'))							// check for "};" added V2.01
-					isImmediatelyPostNonInStmt = true;
+					flags.isImmediatelyPostNonInStmt = true;
 
-				if (!shouldBreakOneLineStatements
+				if (!options.shouldBreakOneLineStatements
 				        && ASBeautifier::getNextWord(currentLine, charNum) == AS_ELSE)
 				{
 					// handle special case of "else" at the end of line
 					size_t nextText = currentLine.find_first_not_of(" \t", charNum + 1);
 					if (ASBeautifier::peekNextChar(currentLine, nextText + 3) == ' ')
-						shouldBreakLineAtNextChar = true;
+						flags.shouldBreakLineAtNextChar = true;
 				}
 			}
 
 			// format braces
-			appendOpeningBrace = false;
+			flags.appendOpeningBrace = false;
 			if (isBraceType(braceType, ARRAY_TYPE))
 			{
 				formatArrayBraces(braceType, isOpeningArrayBrace);
@@ -1183,7 +1175,7 @@ std::string ASFormatter::nextLine()
 		}
 
 		// #126
-		if ( currentChar == '*' && shouldPadOperators &&
+		if ( currentChar == '*' && options.shouldPadOperators &&
 			pointerAlignment != PTR_ALIGN_TYPE &&  // SF 557
 			( currentHeader == &AS_IF || currentHeader == &AS_WHILE || currentHeader == &AS_DO || currentHeader == &AS_FOR)
 			&& ( previousChar == ')' || std::isalpha(previousChar) )
@@ -1195,44 +1187,44 @@ std::string ASFormatter::nextLine()
 			continue;
 		}
 
-		if ((((previousCommandChar == '{' && isPreviousBraceBlockRelated)
+		if ((((previousCommandChar == '{' && flags.isPreviousBraceBlockRelated)
 		        || ((previousCommandChar == '}'
-		             && !isImmediatelyPostEmptyBlock
-		             && isPreviousBraceBlockRelated
-		             && !isPreviousCharPostComment       // Fixes wrongly appended newlines after '}' immediately after comments
+		             && !flags.isImmediatelyPostEmptyBlock
+		             && flags.isPreviousBraceBlockRelated
+		             && !flags.isPreviousCharPostComment       // Fixes wrongly appended newlines after '}' immediately after comments
 		             && peekNextChar() != ' '
 		             && !isBraceType(previousBraceType, DEFINITION_TYPE))
-		            && !isBraceType(braceTypeStack->back(), DEFINITION_TYPE)))
-		        && isOkToBreakBlock(braceTypeStack->back()))
+		            && !isBraceType(braceTypeStack.back(), DEFINITION_TYPE)))
+		        && isOkToBreakBlock(braceTypeStack.back()))
 		        // check for array
 		        || (previousCommandChar == '{'			// added 9/30/2010
-		            && isBraceType(braceTypeStack->back(), ARRAY_TYPE)
-		            && !isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE)
-		            && isNonInStatementArray)
+		            && isBraceType(braceTypeStack.back(), ARRAY_TYPE)
+		            && !isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE)
+		            && hints.isNonInStatementArray)
 		        // check for pico one line braces
 		        || (formattingStyle == STYLE_PICO
-		            && (previousCommandChar == '{' && isPreviousBraceBlockRelated)
-		            && isBraceType(braceTypeStack->back(), COMMAND_TYPE)
-		            && isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE)
+		            && (previousCommandChar == '{' && flags.isPreviousBraceBlockRelated)
+		            && isBraceType(braceTypeStack.back(), COMMAND_TYPE)
+		            && isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE)
 		            && braceFormatMode == RUN_IN_MODE)
 		   )
 		{
-			isCharImmediatelyPostOpenBlock = (previousCommandChar == '{');
-			isCharImmediatelyPostCloseBlock = (previousCommandChar == '}');
+			flags.isCharImmediatelyPostOpenBlock = (previousCommandChar == '{');
+			flags.isCharImmediatelyPostCloseBlock = (previousCommandChar == '}');
 
-			if (isCharImmediatelyPostOpenBlock
-			        && !isCharImmediatelyPostComment
-			        && !isCharImmediatelyPostLineComment)
+			if (flags.isCharImmediatelyPostOpenBlock
+			        && !flags.isCharImmediatelyPostComment
+			        && !flags.isCharImmediatelyPostLineComment)
 			{
 				previousCommandChar = ' ';
 
 				if (braceFormatMode == NONE_MODE)
 				{
-					if (isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE)
-					        && (isBraceType(braceTypeStack->back(), BREAK_BLOCK_TYPE)
-					            || shouldBreakOneLineBlocks))
-						isInLineBreak = true;
-					else if (currentLineBeginsWithBrace)
+					if (isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE)
+					        && (isBraceType(braceTypeStack.back(), BREAK_BLOCK_TYPE)
+					            || options.shouldBreakOneLineBlocks))
+						flags.isInLineBreak = true;
+					else if (flags.currentLineBeginsWithBrace)
 						formatRunIn();
 					else
 						breakLine();
@@ -1241,11 +1233,11 @@ std::string ASFormatter::nextLine()
 				         && currentChar != '#')
 					formatRunIn();
 				else
-					isInLineBreak = true;
+					flags.isInLineBreak = true;
 			}
-			else if (isCharImmediatelyPostCloseBlock
-			         && shouldBreakOneLineStatements
-			         && !isCharImmediatelyPostComment
+			else if (flags.isCharImmediatelyPostCloseBlock
+			         && options.shouldBreakOneLineStatements
+			         && !flags.isCharImmediatelyPostComment
 			         && ((isLegalNameChar(currentChar) && currentChar != '.')
 			             || currentChar == '+'
 			             || currentChar == '-'
@@ -1254,28 +1246,28 @@ std::string ASFormatter::nextLine()
 			             || currentChar == '('))
 			{
 				previousCommandChar = ' ';
-				isInLineBreak = true;
+				flags.isInLineBreak = true;
 			}
 		}
 
 		// reset block handling flags
-		isImmediatelyPostEmptyBlock = false;
+		flags.isImmediatelyPostEmptyBlock = false;
 
 		// Objective-C method prefix with no return type
-		if (isImmediatelyPostObjCMethodPrefix && currentChar != '(')
+		if (flags.isImmediatelyPostObjCMethodPrefix && currentChar != '(')
 		{
-			if (shouldPadMethodPrefix || shouldUnPadMethodPrefix)
+			if (options.shouldPadMethodPrefix || options.shouldUnPadMethodPrefix)
 				padObjCMethodPrefix();
-			isImmediatelyPostObjCMethodPrefix = false;
+			flags.isImmediatelyPostObjCMethodPrefix = false;
 		}
 
 		// look for headers
 		bool isPotentialHeader = isCharPotentialHeader(currentLine, charNum);
 
-		if (isPotentialHeader && !isInTemplate && squareBracketCount == 0)
+		if (isPotentialHeader && !flags.isInTemplate && squareBracketCount == 0)
 		{
-			isNonParenHeader = false;
-			foundClosingHeader = false;
+			flags.isNonParenHeader = false;
+			flags.foundClosingHeader = false;
 
 			newHeader = findHeader(headers);
 
@@ -1295,7 +1287,7 @@ std::string ASFormatter::nextLine()
 			        && (newHeader == &AS_SYNCHRONIZED))
 			{
 				// want synchronized statements not synchronized methods
-				if (!isBraceType(braceTypeStack->back(), COMMAND_TYPE))
+				if (!isBraceType(braceTypeStack.back(), COMMAND_TYPE))
 					newHeader = nullptr;
 			}
 			else if (newHeader == &AS_USING
@@ -1305,80 +1297,80 @@ std::string ASFormatter::nextLine()
 
 			if (newHeader != nullptr)
 			{
-				foundClosingHeader = isClosingHeader(newHeader);
+				flags.foundClosingHeader = isClosingHeader(newHeader);
 
-				if (!foundClosingHeader)
+				if (!flags.foundClosingHeader)
 				{
 					// these are closing headers
 					if ((newHeader == &AS_WHILE && currentHeader == &AS_DO)
 					        || (newHeader == &_AS_FINALLY && currentHeader == &_AS_TRY)
 					        || (newHeader == &_AS_EXCEPT && currentHeader == &_AS_TRY))
-						foundClosingHeader = true;
+						flags.foundClosingHeader = true;
 					// don't append empty block for these related headers
 					else if (isSharpStyle()
 					         && previousNonWSChar == '}'
 					         && ((newHeader == &AS_SET && currentHeader == &AS_GET)
 					             || (newHeader == &AS_REMOVE && currentHeader == &AS_ADD))
-					         && isOkToBreakBlock(braceTypeStack->back()))
-						isAppendPostBlockEmptyLineRequested = false;
+					         && isOkToBreakBlock(braceTypeStack.back()))
+						flags.isAppendPostBlockEmptyLineRequested = false;
 				}
 
 				const std::string* previousHeader = currentHeader;
 				currentHeader = newHeader;
-				needHeaderOpeningBrace = true;
+				flags.needHeaderOpeningBrace = true;
 
 				// is the previous statement on the same line?
 				if ((previousNonWSChar == ';' || previousNonWSChar == ':')
-				        && !isInLineBreak
-				        && isOkToBreakBlock(braceTypeStack->back()))
+				        && !flags.isInLineBreak
+				        && isOkToBreakBlock(braceTypeStack.back()))
 				{
 					// if breaking lines, break the line at the header
 					// except for multiple 'case' statements on a line
 					if (maxCodeLength != std::string::npos
 					        && previousHeader != &AS_CASE)
-						isInLineBreak = true;
+						flags.isInLineBreak = true;
 					else
-						isHeaderInMultiStatementLine = true;
+						flags.isHeaderInMultiStatementLine = true;
 				}
 
-				if (foundClosingHeader && previousNonWSChar == '}')
+				if (flags.foundClosingHeader && previousNonWSChar == '}')
 				{
-					if (isOkToBreakBlock(braceTypeStack->back()))
+					if (isOkToBreakBlock(braceTypeStack.back()))
 						isLineBreakBeforeClosingHeader();
 
 					// get the adjustment for a comment following the closing header
-					if (isInLineBreak)
+					if (flags.isInLineBreak)
 						nextLineSpacePadNum = getNextLineCommentAdjustment();
 					else
 						spacePadNum = getCurrentLineCommentAdjustment();
 				}
 
 				// check if the found header is non-paren header
-				isNonParenHeader = findHeader(nonParenHeaders) != nullptr;
+				flags.isNonParenHeader = findHeader(nonParenHeaders) != nullptr;
 
-				if (isNonParenHeader
+				if (flags.isNonParenHeader
 				        && (currentHeader == &AS_CATCH
 				            || currentHeader == &AS_CASE))
 				{
 					int startChar = charNum + currentHeader->length() - 1;
 					if (ASBeautifier::peekNextChar(currentLine, startChar) == '(')
-						isNonParenHeader = false;
+						flags.isNonParenHeader = false;
 				}
 
 				// join 'else if' statements
 				if (currentHeader == &AS_IF
 				        && previousHeader == &AS_ELSE
-				        && isInLineBreak
-				        && !shouldBreakElseIfs
-				        && !isCharImmediatelyPostLineComment
-				        && !isImmediatelyPostPreprocessor)
+				        && flags.isInLineBreak
+				        && !options.shouldBreakElseIfs
+				        && !flags.isCharImmediatelyPostLineComment
+				        && !flags.isImmediatelyPostPreprocessor)
 				{
 					// 'else' must be last thing on the line
 					size_t start = formattedLine.length() >= 6 ? formattedLine.length() - 6 : 0;
 					if (formattedLine.find(AS_ELSE, start) != std::string::npos)
 					{
 						appendSpacePad();
-						isInLineBreak = false;
+						flags.isInLineBreak = false;
 					}
 				}
 
@@ -1387,8 +1379,8 @@ std::string ASFormatter::nextLine()
 				// if a paren-header is found add a space after it, if needed
 				// this checks currentLine, appendSpacePad() checks formattedLine
 				// in 'case' and C# 'catch' can be either a paren or non-paren header
-				if (shouldPadHeader
-				        && !isNonParenHeader
+				if (options.shouldPadHeader
+				        && !flags.isNonParenHeader
 				        && charNum < (int) currentLine.length() - 1 && !isWhiteSpace(currentLine[charNum + 1]))
 					appendSpacePad();
 
@@ -1397,65 +1389,65 @@ std::string ASFormatter::nextLine()
 				//     as if it were NOT a header since a closing while()
 				//     should never have a block after it!
 				if (currentHeader != &AS_CASE && currentHeader != &AS_DEFAULT
-				        && !(foundClosingHeader && currentHeader == &AS_WHILE))
+				        && !(flags.foundClosingHeader && currentHeader == &AS_WHILE))
 				{
-					isInHeader = true;
+					flags.isInHeader = true;
 
 					// in C# 'catch' and 'delegate' can be a paren or non-paren header
-					if (isNonParenHeader && !isSharpStyleWithParen(currentHeader))
+					if (flags.isNonParenHeader && !isSharpStyleWithParen(currentHeader))
 					{
-						isImmediatelyPostHeader = true;
-						isInHeader = false;
+						flags.isImmediatelyPostHeader = true;
+						flags.isInHeader = false;
 					}
 				}
 
-				if (shouldBreakBlocks
-				        && isOkToBreakBlock(braceTypeStack->back())
-				        && !isHeaderInMultiStatementLine)
+				if (options.shouldBreakBlocks
+				        && isOkToBreakBlock(braceTypeStack.back())
+				        && !flags.isHeaderInMultiStatementLine)
 				{
 					if (previousHeader == nullptr
-					        && !foundClosingHeader
-					        && !isCharImmediatelyPostOpenBlock
-					        && !isImmediatelyPostCommentOnly)
+					        && !flags.foundClosingHeader
+					        && !flags.isCharImmediatelyPostOpenBlock
+					        && !flags.isImmediatelyPostCommentOnly)
 					{
-						isPrependPostBlockEmptyLineRequested = true;
+						flags.isPrependPostBlockEmptyLineRequested = true;
 					}
 
 					if (isClosingHeader(currentHeader)
-					        || foundClosingHeader)
+					        || flags.foundClosingHeader)
 					{
-						isPrependPostBlockEmptyLineRequested = false;
+						flags.isPrependPostBlockEmptyLineRequested = false;
 					}
 
-					if (shouldBreakClosingHeaderBlocks
-					        && isCharImmediatelyPostCloseBlock
-					        && !isImmediatelyPostCommentOnly
+					if (options.shouldBreakClosingHeaderBlocks
+					        && flags.isCharImmediatelyPostCloseBlock
+					        && !flags.isImmediatelyPostCommentOnly
 					        && !(currentHeader == &AS_WHILE			// do-while
-					             && foundClosingHeader))
+					             && flags.foundClosingHeader))
 					{
-						isPrependPostBlockEmptyLineRequested = true;
+						flags.isPrependPostBlockEmptyLineRequested = true;
 					}
 				}
 
 				if (currentHeader == &AS_CASE
 				        || currentHeader == &AS_DEFAULT)
-					isInCase = true;
+					flags.isInCase = true;
 
 				continue;
 			}
 			if ((newHeader = findHeader(preDefinitionHeaders)) != nullptr
-			        && parenStack->back() == 0
-			        && !isInEnum)		// not C++11 enum class
+			        && parenStack.back() == 0
+			        && !flags.isInEnum)		// not C++11 enum class
 			{
 				if (newHeader == &AS_NAMESPACE || newHeader == &AS_MODULE)
-					foundNamespaceHeader = true;
+					flags.foundNamespaceHeader = true;
 				if (newHeader == &AS_CLASS)
-					foundClassHeader = true;
+					flags.foundClassHeader = true;
 				if (newHeader == &AS_STRUCT)
-					foundStructHeader = true;
-				if (newHeader == &AS_INTERFACE && !foundNamespaceHeader && !foundClassHeader)
-					foundInterfaceHeader = true;
-				foundPreDefinitionHeader = true;
+					flags.foundStructHeader = true;
+				if (newHeader == &AS_INTERFACE && !flags.foundNamespaceHeader && !flags.foundClassHeader)
+					flags.foundInterfaceHeader = true;
+				flags.foundPreDefinitionHeader = true;
 				appendSequence(*newHeader);
 				goForward(newHeader->length() - 1);
 
@@ -1465,35 +1457,35 @@ std::string ASFormatter::nextLine()
 			{
 				// must be after function arguments
 				if (previousNonWSChar == ')')
-					foundPreCommandHeader = true;
+					flags.foundPreCommandHeader = true;
 			}
 			else if ((newHeader = findHeader(castOperators)) != nullptr)
 			{
-				foundCastOperator = true;
+				flags.foundCastOperator = true;
 				appendSequence(*newHeader);
 				goForward(newHeader->length() - 1);
 				continue;
 			}
 		}   // (isPotentialHeader && !isInTemplate)
 
-		if (isInLineBreak)          // OK to break line here
+		if (flags.isInLineBreak)          // OK to break line here
 		{
 			breakLine();
-			if (isInVirginLine)		// adjust for the first line
+			if (flags.isInVirginLine)		// adjust for the first line
 			{
-				lineCommentNoBeautify = lineCommentNoIndent;
-				lineCommentNoIndent = false;
-				if (isImmediatelyPostPreprocessor)
+				hints.lineCommentNoBeautify = flags.lineCommentNoIndent;
+				flags.lineCommentNoIndent = false;
+				if (flags.isImmediatelyPostPreprocessor)
 				{
-					isInIndentablePreproc = isIndentablePreprocessor;
-					isIndentablePreprocessor = false;
+					hints.isInIndentablePreproc = flags.isIndentablePreprocessor;
+					flags.isIndentablePreprocessor = false;
 				}
 			}
 		}
 
 		if (previousNonWSChar == '}' || currentChar == ';')
 		{
-			if (currentChar == ';' && !isInAsmBlock)
+			if (currentChar == ';' && !flags.isInAsmBlock)
 			{
 				squareBracketCount = 0;
 				//assert(methodBreakCharNum == std::string::npos);	// comment out
@@ -1503,37 +1495,37 @@ std::string ASFormatter::nextLine()
 				methodAttachCharNum = std::string::npos;
 				methodAttachLineNum = 0;
 
-				if (((shouldBreakOneLineStatements
-				        || isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE))
-				        && isOkToBreakBlock(braceTypeStack->back()))
-				        && !(attachClosingBraceMode && peekNextChar() == '}'))
+				if (((options.shouldBreakOneLineStatements
+				        || isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE))
+				        && isOkToBreakBlock(braceTypeStack.back()))
+				        && !(options.attachClosingBraceMode && peekNextChar() == '}'))
 				{
-					passedSemicolon = true;
+					flags.passedSemicolon = true;
 				}
-				else if (!shouldBreakOneLineStatements
+				else if (!options.shouldBreakOneLineStatements
 				         && ASBeautifier::getNextWord(currentLine, charNum) == AS_ELSE)
 				{
 					// handle special case of "else" at the end of line
 					size_t nextText = currentLine.find_first_not_of(" \t", charNum + 1);
 					if (ASBeautifier::peekNextChar(currentLine, nextText + 3) == ' ')
-						passedSemicolon = true;
+						flags.passedSemicolon = true;
 				}
 
 //is set in struct case? #518
-				if (shouldBreakBlocks
+				if (options.shouldBreakBlocks
 				        && currentHeader != nullptr
 				        && currentHeader != &AS_CASE
 				        && currentHeader != &AS_DEFAULT
-				        && !isHeaderInMultiStatementLine
-				        && parenStack->back() == 0
+				        && !flags.isHeaderInMultiStatementLine
+				        && parenStack.back() == 0
 				   )
 				{
-					isAppendPostBlockEmptyLineRequested = true;
+					flags.isAppendPostBlockEmptyLineRequested = true;
 				}
 			}
 			if (currentChar != ';'
-			        || foundStructHeader // #518
-			        || (needHeaderOpeningBrace && parenStack->back() == 0))
+			        || flags.foundStructHeader // #518
+			        || (flags.needHeaderOpeningBrace && parenStack.back() == 0))
 				currentHeader = nullptr;
 
 			resetEndOfStatement();
@@ -1543,46 +1535,46 @@ std::string ASFormatter::nextLine()
 		        && previousChar != ':'         // not part of '::'
 		        && peekNextChar() != ':')      // not part of '::'
 		{
-			if (isInCase)
+			if (flags.isInCase)
 			{
-				isInCase = false;
-				if (shouldBreakOneLineStatements)
-					passedColon = true;
+				flags.isInCase = false;
+				if (options.shouldBreakOneLineStatements)
+					flags.passedColon = true;
 			}
 			else if (isCStyle()                     // for C/C++ only
-			         && isOkToBreakBlock(braceTypeStack->back())
-			         && shouldBreakOneLineStatements
-			         && !foundQuestionMark          // not in a ?: sequence
-			         && !foundPreDefinitionHeader   // not in a definition block
+			         && isOkToBreakBlock(braceTypeStack.back())
+			         && options.shouldBreakOneLineStatements
+			         && !flags.foundQuestionMark          // not in a ?: sequence
+			         && !flags.foundPreDefinitionHeader   // not in a definition block
 			         && previousCommandChar != ')'  // not after closing paren of a method header
-			         && !foundPreCommandHeader      // not after a 'noexcept'
+			         && !flags.foundPreCommandHeader      // not after a 'noexcept'
 			         && squareBracketCount == 0     // not in objC method call
-			         && !isInObjCMethodDefinition   // not objC '-' or '+' method
-			         && !isInObjCInterface          // not objC @interface
-			         && !isInObjCSelector           // not objC @selector
+			         && !flags.isInObjCMethodDefinition   // not objC '-' or '+' method
+			         && !flags.isInObjCInterface          // not objC @interface
+			         && !flags.isInObjCSelector           // not objC @selector
 			         && !isDigit(peekNextChar())    // not a bit field
-			         && !isInEnum                   // not an enum with a base type
-			         && !isInStruct                 // not an struct
-			         && !isInContinuedPreProc           // not in preprocessor line
-			         && !isInAsm                    // not in extended assembler
-			         && !isInAsmOneLine             // not in extended assembler
-			         && !isInAsmBlock)              // not in extended assembler
+			         && !flags.isInEnum                   // not an enum with a base type
+			         && !flags.isInStruct                 // not an struct
+			         && !flags.isInContinuedPreProc           // not in preprocessor line
+			         && !flags.isInAsm                    // not in extended assembler
+			         && !flags.isInAsmOneLine             // not in extended assembler
+			         && !flags.isInAsmBlock)              // not in extended assembler
 			{
-				passedColon = true;
+				flags.passedColon = true;
 			}
 
 			if (isObjCStyle()
-			        && (squareBracketCount > 0 || isInObjCMethodDefinition || isInObjCSelector)
-			        && !foundQuestionMark)			// not in a ?: sequence
+			        && (squareBracketCount > 0 || flags.isInObjCMethodDefinition || flags.isInObjCSelector)
+			        && !flags.foundQuestionMark)			// not in a ?: sequence
 			{
-				isImmediatelyPostObjCMethodPrefix = false;
-				isInObjCReturnType = false;
-				isInObjCParam = true;
-				if (shouldPadMethodColon)
+				flags.isImmediatelyPostObjCMethodPrefix = false;
+				flags.isInObjCReturnType = false;
+				flags.isInObjCParam = true;
+				if (options.shouldPadMethodColon)
 					padObjCMethodColon();
 			}
 
-			if (isInObjCInterface)
+			if (flags.isInObjCInterface)
 			{
 				appendSpacePad();
 				if ((int) currentLine.length() > charNum + 1
@@ -1592,25 +1584,28 @@ std::string ASFormatter::nextLine()
 
 			if (isClassInitializer())
 			{
-				isInClassInitializer = true;
+				flags.isInClassInitializer = true;
 			}
 
 		}
 
 		if (currentChar == '?')
-			foundQuestionMark = true;
+			flags.foundQuestionMark = true;
 
-		if (isPotentialHeader && !isInTemplate)
+		if (isPotentialHeader && !flags.isInTemplate)
 		{
-			if (findKeyword(currentLine, charNum, AS_NEW)
-			        || findKeyword(currentLine, charNum, AS_DELETE))
+			// scan the word once for the keyword checks
+			const std::string* keyword = getKeyword(currentLine, charNum);
+
+			if (keyword == &AS_NEW
+			        || keyword == &AS_DELETE)
 			{
-				isInPotentialCalculation = false;
-				isImmediatelyPostNewDelete = true;
+				flags.isInPotentialCalculation = false;
+				flags.isImmediatelyPostNewDelete = true;
 			}
 
 			//https://sourceforge.net/p/astyle/bugs/464/ + GH16
-			if (isSharpStyle() && findKeyword(currentLine, charNum, AS_NEW)
+			if (isSharpStyle() && keyword == &AS_NEW
 								&& currentHeader != &AS_FOREACH
 								&& currentHeader != &AS_FOR
 								&& currentHeader != &AS_USING
@@ -1621,28 +1616,28 @@ std::string ASFormatter::nextLine()
 								&& currentLine.find(AS_PRIVATE) == std::string::npos
 								)
 			{
-				isInAllocator = true;
+				flags.isInAllocator = true;
 			}
 
-			if (findKeyword(currentLine, charNum, AS_RETURN))
+			if (keyword == &AS_RETURN)
 			{
-				isInPotentialCalculation = true;
-				isImmediatelyPostReturn = true;		// return is the same as an = sign
+				flags.isInPotentialCalculation = true;
+				flags.isImmediatelyPostReturn = true;		// return is the same as an = sign
 			}
 
-			if (findKeyword(currentLine, charNum, AS_OPERATOR))
-				isImmediatelyPostOperator = true;
+			if (keyword == &AS_OPERATOR)
+				flags.isImmediatelyPostOperator = true;
 
-			if (findKeyword(currentLine, charNum, AS_ENUM))
+			if (keyword == &AS_ENUM)
 			{
 				size_t firstNum = currentLine.find_first_of("(){},/");
 				if (firstNum == std::string::npos
 				        || currentLine[firstNum] == '{'
 				        || currentLine[firstNum] == '/')
-					isInEnum = true;
+					flags.isInEnum = true;
 			}
 
-			if (findKeyword(currentLine, charNum, AS_TYPEDEF_STRUCT) || findKeyword(currentLine, charNum, AS_STRUCT))
+			if (findKeyword(currentLine, charNum, AS_TYPEDEF_STRUCT) || keyword == &AS_STRUCT)
 			{
 				size_t firstNum = currentLine.find_first_of("(){},/");
 
@@ -1650,68 +1645,68 @@ std::string ASFormatter::nextLine()
 				        || currentLine[firstNum] == '{'
 				        || currentLine[firstNum] == '/')
 				{
-					isInStruct = true;
+					flags.isInStruct = true;
 				}
 			}
 
 			if (isCStyle()
-			        && findKeyword(currentLine, charNum, AS_THROW)
+			        && keyword == &AS_THROW
 			        && previousCommandChar != ')'
-			        && !foundPreCommandHeader)      // 'const' throw()
-				isImmediatelyPostThrow = true;
+			        && !flags.foundPreCommandHeader)      // 'const' throw()
+				flags.isImmediatelyPostThrow = true;
 
-			if (isCStyle() && findKeyword(currentLine, charNum, AS_EXTERN) && isExternC())
-				isInExternC = true;
+			if (isCStyle() && keyword == &AS_EXTERN && isExternC())
+				hints.isInExternC = true;
 
-			if (isCStyle() && findKeyword(currentLine, charNum, AS_AUTO)
-			        && (isBraceType(braceTypeStack->back(), NULL_TYPE)
-			            || isBraceType(braceTypeStack->back(), DEFINITION_TYPE))
+			if (isCStyle() && keyword == &AS_AUTO
+			        && (isBraceType(braceTypeStack.back(), NULL_TYPE)
+			            || isBraceType(braceTypeStack.back(), DEFINITION_TYPE))
 			        && (currentLine.find("(") != std::string::npos)) // #516 auto array initializer with braces should not be blocks
-				foundTrailingReturnType = true;
+				flags.foundTrailingReturnType = true;
 
 			// check for break/attach return type
-			if (shouldBreakReturnType || shouldBreakReturnTypeDecl
-			        || shouldAttachReturnType || shouldAttachReturnTypeDecl)
-			{
-				if ((isBraceType(braceTypeStack->back(), NULL_TYPE)
-				        || isBraceType(braceTypeStack->back(), DEFINITION_TYPE))
-				        && !returnTypeChecked
-				        && !foundNamespaceHeader
-				        && !foundClassHeader
-				        && !isInObjCMethodDefinition
+			if (options.shouldBreakReturnType || options.shouldBreakReturnTypeDecl
+			        || options.shouldAttachReturnType || options.shouldAttachReturnTypeDecl)
+			{
+				if ((isBraceType(braceTypeStack.back(), NULL_TYPE)
+				        || isBraceType(braceTypeStack.back(), DEFINITION_TYPE))
+				        && !flags.returnTypeChecked
+				        && !flags.foundNamespaceHeader
+				        && !flags.foundClassHeader
+				        && !flags.isInObjCMethodDefinition
 				        // bypass objective-C and java @ character
 				        && charNum == (int) currentLine.find_first_not_of(" \t")
 
 						// possibly related to #504
 				        && !(isCStyle() && isCharPotentialHeader(currentLine, charNum)
-				             && (findKeyword(currentLine, charNum, AS_PUBLIC)
-				                 || findKeyword(currentLine, charNum, AS_PRIVATE)
-				                 || findKeyword(currentLine, charNum, AS_PROTECTED)))
+				             && (keyword == &AS_PUBLIC
+				                 || keyword == &AS_PRIVATE
+				                 || keyword == &AS_PROTECTED))
 					)
 				{
 					findReturnTypeSplitPoint(currentLine);
-					returnTypeChecked = true;
+					flags.returnTypeChecked = true;
 				}
 			}
 
 			// Objective-C NSException macros are preCommandHeaders
-			if (isCStyle() && findKeyword(currentLine, charNum, AS_NS_DURING))
-				foundPreCommandMacro = true;
-			if (isCStyle() && findKeyword(currentLine, charNum, AS_NS_HANDLER))
-				foundPreCommandMacro = true;
+			if (isCStyle() && keyword == &AS_NS_DURING)
+				flags.foundPreCommandMacro = true;
+			if (isCStyle() && keyword == &AS_NS_HANDLER)
+				flags.foundPreCommandMacro = true;
 
 			if (isCStyle() && isExecSQL(currentLine, charNum))
-				isInExecSQL = true;
+				flags.isInExecSQL = true;
 
 			if (isCStyle())
 			{
-				if (findKeyword(currentLine, charNum, AS_ASM)
-				        || findKeyword(currentLine, charNum, AS__ASM__))
+				if (keyword == &AS_ASM
+				        || keyword == &AS__ASM__)
 				{
-					isInAsm = true;
+					flags.isInAsm = true;
 				}
-				else if (findKeyword(currentLine, charNum, AS_MS_ASM)		// microsoft specific
-				         || findKeyword(currentLine, charNum, AS_MS__ASM))
+				else if (keyword == &AS_MS_ASM		// microsoft specific
+				         || keyword == &AS_MS__ASM)
 				{
 					int index = 4;
 					if (peekNextChar() == '_')	// check for __asm
@@ -1719,28 +1714,28 @@ std::string ASFormatter::nextLine()
 
 					char peekedChar = ASBase::peekNextChar(currentLine, charNum + index);
 					if (peekedChar == '{' || peekedChar == ' ')
-						isInAsmBlock = true;
+						flags.isInAsmBlock = true;
 					else
-						isInAsmOneLine = true;
+						flags.isInAsmOneLine = true;
 				}
 			}
 
 			if (isJavaStyle()
-			        && (findKeyword(currentLine, charNum, AS_STATIC)
+			        && (keyword == &AS_STATIC
 			            && isNextCharOpeningBrace(charNum + 6)))
-				isJavaStaticConstructor = true;
+				flags.isJavaStaticConstructor = true;
 
 			if (isSharpStyle()
-			        && (findKeyword(currentLine, charNum, AS_DELEGATE)
-			            || findKeyword(currentLine, charNum, AS_UNCHECKED)))
-				isSharpDelegate = true;
+			        && (keyword == &AS_DELEGATE
+			            || keyword == &AS_UNCHECKED))
+				hints.isSharpDelegate = true;
 
 			// append the entire name
 			std::string name = getCurrentWord(currentLine, charNum);
 			// must pad the 'and' and 'or' operators if required
 			if (name == "and" || name == "or")
 			{
-				if (shouldPadOperators && previousNonWSChar != ':')
+				if (options.shouldPadOperators && previousNonWSChar != ':')
 				{
 					appendSpacePad();
 					appendOperator(name);
@@ -1774,9 +1769,9 @@ std::string ASFormatter::nextLine()
 		        && !isWhiteSpace(currentLine[charNum + 1])
 		        && isCharPotentialHeader(currentLine, charNum + 1)
 		        && findKeyword(currentLine, charNum + 1, AS_INTERFACE)
-		        && isBraceType(braceTypeStack->back(), NULL_TYPE))
+		        && isBraceType(braceTypeStack.back(), NULL_TYPE))
 		{
-			isInObjCInterface = true;
+			flags.isInObjCInterface = true;
 			std::string name = '@' + AS_INTERFACE;
 			appendSequence(name);
 			goForward(name.length() - 1);
@@ -1789,7 +1784,7 @@ std::string ASFormatter::nextLine()
 		        && isCharPotentialHeader(currentLine, charNum + 1)
 		        && findKeyword(currentLine, charNum + 1, AS_SELECTOR))
 		{
-			isInObjCSelector = true;
+			flags.isInObjCSelector = true;
 			std::string name = '@' + AS_SELECTOR;
 			appendSequence(name);
 			goForward(name.length() - 1);
@@ -1798,15 +1793,15 @@ std::string ASFormatter::nextLine()
 		if ((currentChar == '-' || currentChar == '+')
 		        && isCStyle()
 		        && (int) currentLine.find_first_not_of(" \t") == charNum
-		        && !isInPotentialCalculation
-		        && !isInObjCMethodDefinition
-		        && (isBraceType(braceTypeStack->back(), NULL_TYPE)
-		            || (isBraceType(braceTypeStack->back(), EXTERN_TYPE))))
-		{
-			isInObjCMethodDefinition = true;
-			isImmediatelyPostObjCMethodPrefix = true;
-			isInObjCParam = false;
-			isInObjCInterface = false;
+		        && !flags.isInPotentialCalculation
+		        && !flags.isInObjCMethodDefinition
+		        && (isBraceType(braceTypeStack.back(), NULL_TYPE)
+		            || (isBraceType(braceTypeStack.back(), EXTERN_TYPE))))
+		{
+			flags.isInObjCMethodDefinition = true;
+			flags.isImmediatelyPostObjCMethodPrefix = true;
+			flags.isInObjCParam = false;
+			flags.isInObjCInterface = false;
 			if (getAlignMethodColon())
 				objCColonAlign = findObjCColonAlignment();
 			appendCurrentChar();
@@ -1826,30 +1821,30 @@ std::string ASFormatter::nextLine()
 			if (newHeader != nullptr
 			        && newHeader == &AS_GCC_MIN_ASSIGN
 			        && isJavaStyle()
-			        && isInTemplate)
+			        && flags.isInTemplate)
 				newHeader = nullptr;
 
 			if (newHeader != nullptr)
 			{
 				if (newHeader == &AS_LAMBDA)
-					foundPreCommandHeader = true;
+					flags.foundPreCommandHeader = true;
 
 				// correct mistake of two >> closing a template
-				if (isInTemplate && (newHeader == &AS_GR_GR || newHeader == &AS_GR_GR_GR))
+				if (flags.isInTemplate && (newHeader == &AS_GR_GR || newHeader == &AS_GR_GR_GR))
 					newHeader = &AS_GR;
 
-				if (!isInPotentialCalculation)
+				if (!flags.isInPotentialCalculation)
 				{
 					// must determine if newHeader is an assignment operator
 					// do NOT use findOperator - the length must be exact!!!
 					if (find(begin(*assignmentOperators), end(*assignmentOperators), newHeader)
 					        != end(*assignmentOperators))
 					{
-						foundPreCommandHeader = false;
+						flags.foundPreCommandHeader = false;
 						char peekedChar = peekNextChar();
-						isInPotentialCalculation = !(newHeader == &AS_EQUAL && peekedChar == '*')
+						flags.isInPotentialCalculation = !(newHeader == &AS_EQUAL && peekedChar == '*')
 						                           && !(newHeader == &AS_EQUAL && peekedChar == '&')
-						                           && !isCharImmediatelyPostOperator;
+						                           && !flags.isCharImmediatelyPostOperator;
 					}
 				}
 			}
@@ -1875,11 +1870,11 @@ std::string ASFormatter::nextLine()
 				appendOperator(*newHeader);
 				goForward(newHeader->length() - 1);
 			}
-			isImmediatelyPostPointerOrReference = true;
+			flags.isImmediatelyPostPointerOrReference = true;
 			continue;
 		}
 
-		if (shouldPadOperators && newHeader != nullptr && !isOperatorPaddingDisabled())
+		if (options.shouldPadOperators && newHeader != nullptr && !isOperatorPaddingDisabled())
 		{
 			padOperators(newHeader);
 			continue;
@@ -1900,7 +1895,7 @@ std::string ASFormatter::nextLine()
 
 		// pad commas and semi-colons
 		if (currentChar == ';'
-		        || (currentChar == ',' && (shouldPadOperators || shouldPadCommas)))
+		        || (currentChar == ',' && (options.shouldPadOperators || options.shouldPadCommas)))
 		{
 			char nextChar = ' ';
 			if (charNum + 1 < (int) currentLine.length())
@@ -1925,43 +1920,43 @@ std::string ASFormatter::nextLine()
 		{
 			if (currentChar == '(')
 			{
-				if (shouldPadHeader
-				        && (isCharImmediatelyPostReturn
-				            || isCharImmediatelyPostThrow
-				            || isCharImmediatelyPostNewDelete))
+				if (options.shouldPadHeader
+				        && (flags.isCharImmediatelyPostReturn
+				            || flags.isCharImmediatelyPostThrow
+				            || flags.isCharImmediatelyPostNewDelete))
 					appendSpacePad();
 			}
 
-			if (shouldPadParensOutside || shouldPadParensInside || shouldUnPadParens || shouldPadFirstParen)
-				padParensOrBrackets('(', ')', shouldPadParensOutside, shouldPadParensInside, shouldUnPadParens, shouldPadFirstParen);
+			if (options.shouldPadParensOutside || options.shouldPadParensInside || options.shouldUnPadParens || options.shouldPadFirstParen)
+				padParensOrBrackets('(', ')', options.shouldPadParensOutside, options.shouldPadParensInside, options.shouldUnPadParens, options.shouldPadFirstParen);
 			else
 				appendCurrentChar();
 
-			if (isInObjCMethodDefinition)
+			if (flags.isInObjCMethodDefinition)
 			{
-				if (currentChar == '(' && isImmediatelyPostObjCMethodPrefix)
+				if (currentChar == '(' && flags.isImmediatelyPostObjCMethodPrefix)
 				{
-					if (shouldPadMethodPrefix || shouldUnPadMethodPrefix)
+					if (options.shouldPadMethodPrefix || options.shouldUnPadMethodPrefix)
 						padObjCMethodPrefix();
-					isImmediatelyPostObjCMethodPrefix = false;
-					isInObjCReturnType = true;
+					flags.isImmediatelyPostObjCMethodPrefix = false;
+					flags.isInObjCReturnType = true;
 				}
-				else if (currentChar == ')' && isInObjCReturnType)
+				else if (currentChar == ')' && flags.isInObjCReturnType)
 				{
-					if (shouldPadReturnType || shouldUnPadReturnType)
+					if (options.shouldPadReturnType || options.shouldUnPadReturnType)
 						padObjCReturnType();
-					isInObjCReturnType = false;
+					flags.isInObjCReturnType = false;
 				}
-				else if (isInObjCParam
-				         && (shouldPadParamType || shouldUnPadParamType))
+				else if (flags.isInObjCParam
+				         && (options.shouldPadParamType || options.shouldUnPadParamType))
 					padObjCParamType();
 			}
 			continue;
 		}
 
-		if ((currentChar == '[' || currentChar == ']' ) && (shouldPadBracketsOutside || shouldPadBracketsInside || shouldUnPadBrackets) )
+		if ((currentChar == '[' || currentChar == ']' ) && (options.shouldPadBracketsOutside || options.shouldPadBracketsInside || options.shouldUnPadBrackets) )
 		{
-			padParensOrBrackets('[', ']', shouldPadBracketsOutside, shouldPadBracketsInside, shouldUnPadBrackets, false);
+			padParensOrBrackets('[', ']', options.shouldPadBracketsOutside, options.shouldPadBracketsInside, options.shouldUnPadBrackets, false);
 			continue;
 		}
 
@@ -1981,46 +1976,49 @@ std::string ASFormatter::nextLine()
 
 	std::string beautifiedLine;
 	size_t readyFormattedLineLength = trim(readyFormattedLine).length();
-	bool isInNamespace = isBraceType(braceTypeStack->back(), NAMESPACE_TYPE);
+	bool isInNamespace = isBraceType(braceTypeStack.back(), NAMESPACE_TYPE);
 
-	if (prependEmptyLine		// prepend a blank line before this formatted line
+	if (flags.prependEmptyLine		// prepend a blank line before this formatted line
 	        && readyFormattedLineLength > 0
 	        && previousReadyFormattedLineLength > 0)
 	{
-		isLineReady = true;		// signal a waiting readyFormattedLine
+		flags.isLineReady = true;		// signal a waiting readyFormattedLine
 		beautifiedLine = beautify("");
 		previousReadyFormattedLineLength = 0;
 		// call the enhancer for new empty lines
-		enhancer->enhance(beautifiedLine, isInNamespace, isInPreprocessorBeautify, isInBeautifySQL);
+		enhancer.enhance(beautifiedLine, isInNamespace, flags.isInPreprocessorBeautify, hints.isInBeautifySQL);
 	}
 	else		// format the current formatted line
 	{
-		isLineReady = false;
+		flags.isLineReady = false;
 		runInIndentContinuation = runInIndentChars;
 		beautifiedLine = beautify(readyFormattedLine);
 		previousReadyFormattedLineLength = readyFormattedLineLength;
 		// the enhancer is not called for no-indent line comments
-		if (!lineCommentNoBeautify && !isFormattingModeOff)
-			enhancer->enhance(beautifiedLine, isInNamespace, isInPreprocessorBeautify, isInBeautifySQL);
+		if (!hints.lineCommentNoBeautify && !flags.isFormattingModeOff)
+			enhancer.enhance(beautifiedLine, isInNamespace, flags.isInPreprocessorBeautify, hints.isInBeautifySQL);
 		runInIndentChars = 0;
-		lineCommentNoBeautify = lineCommentNoIndent;
-		lineCommentNoIndent = false;
-		isInIndentablePreproc = isIndentablePreprocessor;
-		isIndentablePreprocessor = false;
-		isElseHeaderIndent = elseHeaderFollowsComments;
-		isCaseHeaderCommentIndent = caseHeaderFollowsComments;
+		hints.lineCommentNoBeautify = flags.lineCommentNoIndent;
+		flags.lineCommentNoIndent = false;
+		hints.isInIndentablePreproc = flags.isIndentablePreprocessor;
+		flags.isIndentablePreprocessor = false;
+		hints.isElseHeaderIndent = flags.elseHeaderFollowsComments;
+		hints.isCaseHeaderCommentIndent = flags.caseHeaderFollowsComments;
 		objCColonAlignSubsequent = objCColonAlign;
-		if (isCharImmediatelyPostNonInStmt)
+		if (flags.isCharImmediatelyPostNonInStmt)
 		{
-			isNonInStatementArray = false;
-			isCharImmediatelyPostNonInStmt = false;
+			hints.isNonInStatementArray = false;
+			flags.isCharImmediatelyPostNonInStmt = false;
 		}
-		isInPreprocessorBeautify = isInPreprocessor;	// used by ASEnhancer
-		isInBeautifySQL = isInExecSQL;					// used by ASEnhancer
+		flags.isInPreprocessorBeautify = flags.isInPreprocessor;	// used by ASEnhancer
+		hints.isInBeautifySQL = flags.isInExecSQL;					// used by ASEnhancer
 	}
 
-	prependEmptyLine = false;
+	flags.prependEmptyLine = false;
 	assert(computeChecksumOut(beautifiedLine));
+	outputLineNum++;
+	if (checkpointInterval > 0 && sourceLineNum >= nextCheckpointLineNum)
+		addAutomaticCheckpoint();
 	return beautifiedLine;
 }
 
@@ -2031,7 +2029,7 @@ std::string ASFormatter::nextLine()
  */
 bool ASFormatter::hasMoreLines() const
 {
-	return !endOfCodeReached;
+	return !flags.endOfCodeReached;
 }
 
 /**
@@ -2064,7 +2062,7 @@ void ASFormatter::setFormattingStyle(FormatStyle style)
  */
 void ASFormatter::setAddBracesMode(bool state)
 {
-	shouldAddBraces = state;
+	options.shouldAddBraces = state;
 }
 
 /**
@@ -2077,8 +2075,8 @@ void ASFormatter::setAddBracesMode(bool state)
  */
 void ASFormatter::setAddOneLineBracesMode(bool state)
 {
-	shouldAddBraces = state;
-	shouldAddOneLineBraces = state;
+	options.shouldAddBraces = state;
+	options.shouldAddOneLineBraces = state;
 }
 
 /**
@@ -2091,7 +2089,7 @@ void ASFormatter::setAddOneLineBracesMode(bool state)
  */
 void ASFormatter::setRemoveBracesMode(bool state)
 {
-	shouldRemoveBraces = state;
+	options.shouldRemoveBraces = state;
 }
 
 // retained for compatibility with release 2.06
@@ -2144,7 +2142,7 @@ void ASFormatter::setBraceFormatMode(BraceMode mode)
  */
 void ASFormatter::setBreakAfterMode(bool state)
 {
-	shouldBreakLineAfterLogical = state;
+	options.shouldBreakLineAfterLogical = state;
 }
 
 /**
@@ -2158,7 +2156,7 @@ void ASFormatter::setBreakAfterMode(bool state)
  */
 void ASFormatter::setBreakClosingHeaderBracesMode(bool state)
 {
-	shouldBreakClosingHeaderBraces = state;
+	options.shouldBreakClosingHeaderBraces = state;
 }
 
 /**
@@ -2171,7 +2169,7 @@ void ASFormatter::setBreakClosingHeaderBracesMode(bool state)
  */
 void ASFormatter::setBreakElseIfsMode(bool state)
 {
-	shouldBreakElseIfs = state;
+	options.shouldBreakElseIfs = state;
 }
 
 /**
@@ -2184,7 +2182,7 @@ void ASFormatter::setBreakElseIfsMode(bool state)
 */
 void ASFormatter::setCommaPaddingMode(bool state)
 {
-	shouldPadCommas = state;
+	options.shouldPadCommas = state;
 }
 
 /**
@@ -2207,7 +2205,7 @@ void ASFormatter::setMaxCodeLength(int max)
  */
 void ASFormatter::setOperatorPaddingMode(bool state)
 {
-	shouldPadOperators = state;
+	options.shouldPadOperators = state;
 }
 
 /**
@@ -2220,7 +2218,7 @@ void ASFormatter::setOperatorPaddingMode(bool state)
  */
 void ASFormatter::setParensOutsidePaddingMode(bool state)
 {
-	shouldPadParensOutside = state;
+	options.shouldPadParensOutside = state;
 }
 
 /**
@@ -2233,7 +2231,7 @@ void ASFormatter::setParensOutsidePaddingMode(bool state)
  */
 void ASFormatter::setParensInsidePaddingMode(bool state)
 {
-	shouldPadParensInside = state;
+	options.shouldPadParensInside = state;
 }
 
 /**
@@ -2246,7 +2244,7 @@ void ASFormatter::setParensInsidePaddingMode(bool state)
  */
 void ASFormatter::setBracketsOutsidePaddingMode(bool state)
 {
-	shouldPadBracketsOutside = state;
+	options.shouldPadBracketsOutside = state;
 }
 
 /**
@@ -2259,7 +2257,7 @@ void ASFormatter::setBracketsOutsidePaddingMode(bool state)
  */
 void ASFormatter::setBracketsInsidePaddingMode(bool state)
 {
-	shouldPadBracketsInside = state;
+	options.shouldPadBracketsInside = state;
 }
 
 /**
@@ -2272,7 +2270,7 @@ void ASFormatter::setBracketsInsidePaddingMode(bool state)
  */
 void ASFormatter::setParensFirstPaddingMode(bool state)
 {
-	shouldPadFirstParen = state;
+	options.shouldPadFirstParen = state;
 }
 
 /**
@@ -2285,7 +2283,7 @@ void ASFormatter::setParensFirstPaddingMode(bool state)
  */
 void ASFormatter::setEmptyParensPaddingMode(bool state)
 {
-	shouldPadEmptyParens = state;
+	options.shouldPadEmptyParens = state;
 }
 
 /**
@@ -2298,7 +2296,7 @@ void ASFormatter::setEmptyParensPaddingMode(bool state)
  */
 void ASFormatter::setParensHeaderPaddingMode(bool state)
 {
-	shouldPadHeader = state;
+	options.shouldPadHeader = state;
 }
 
 /**
@@ -2311,7 +2309,7 @@ void ASFormatter::setParensHeaderPaddingMode(bool state)
  */
 void ASFormatter::setParensUnPaddingMode(bool state)
 {
-	shouldUnPadParens = state;
+	options.shouldUnPadParens = state;
 }
 
 /**
@@ -2324,7 +2322,7 @@ void ASFormatter::setParensUnPaddingMode(bool state)
  */
 void ASFormatter::setBracketsUnPaddingMode(bool state)
 {
-	shouldUnPadBrackets = state;
+	options.shouldUnPadBrackets = state;
 }
 
 /**
@@ -2335,7 +2333,7 @@ void ASFormatter::setBracketsUnPaddingMode(bool state)
 */
 void ASFormatter::setPreprocBlockIndent(bool state)
 {
-	shouldIndentPreprocBlock = state;
+	options.shouldIndentPreprocBlock = state;
 }
 
 /**
@@ -2348,7 +2346,7 @@ void ASFormatter::setPreprocBlockIndent(bool state)
  */
 void ASFormatter::setStripCommentPrefix(bool state)
 {
-	shouldStripCommentPrefix = state;
+	options.shouldStripCommentPrefix = state;
 }
 
 /**
@@ -2361,7 +2359,7 @@ void ASFormatter::setStripCommentPrefix(bool state)
  */
 void ASFormatter::setMethodPrefixPaddingMode(bool state)
 {
-	shouldPadMethodPrefix = state;
+	options.shouldPadMethodPrefix = state;
 }
 
 /**
@@ -2374,31 +2372,31 @@ void ASFormatter::setMethodPrefixPaddingMode(bool state)
  */
 void ASFormatter::setMethodPrefixUnPaddingMode(bool state)
 {
-	shouldUnPadMethodPrefix = state;
+	options.shouldUnPadMethodPrefix = state;
 }
 
 // set objective-c '-' or '+' return type padding mode.
 void ASFormatter::setReturnTypePaddingMode(bool state)
 {
-	shouldPadReturnType = state;
+	options.shouldPadReturnType = state;
 }
 
 // set objective-c '-' or '+' return type unpadding mode.
 void ASFormatter::setReturnTypeUnPaddingMode(bool state)
 {
-	shouldUnPadReturnType = state;
+	options.shouldUnPadReturnType = state;
 }
 
 // set objective-c method parameter type padding mode.
 void ASFormatter::setParamTypePaddingMode(bool state)
 {
-	shouldPadParamType = state;
+	options.shouldPadParamType = state;
 }
 
 // set objective-c method parameter type unpadding mode.
 void ASFormatter::setParamTypeUnPaddingMode(bool state)
 {
-	shouldUnPadParamType = state;
+	options.shouldUnPadParamType = state;
 }
 
 /**
@@ -2408,7 +2406,7 @@ void ASFormatter::setParamTypeUnPaddingMode(bool state)
  */
 void ASFormatter::setObjCColonPaddingMode(ObjCColonPad mode)
 {
-	shouldPadMethodColon = true;
+	options.shouldPadMethodColon = true;
 	objCColonPadMode = mode;
 }
 
@@ -2419,7 +2417,7 @@ void ASFormatter::setObjCColonPaddingMode(ObjCColonPad mode)
  */
 void ASFormatter::setAttachClosingBraceMode(bool state)
 {
-	attachClosingBraceMode = state;
+	options.attachClosingBraceMode = state;
 }
 
 /**
@@ -2429,7 +2427,7 @@ void ASFormatter::setAttachClosingBraceMode(bool state)
  */
 void ASFormatter::setAttachClass(bool state)
 {
-	shouldAttachClass = state;
+	options.shouldAttachClass = state;
 }
 
 /**
@@ -2439,7 +2437,7 @@ void ASFormatter::setAttachClass(bool state)
  */
 void ASFormatter::setAttachExternC(bool state)
 {
-	shouldAttachExternC = state;
+	options.shouldAttachExternC = state;
 }
 
 /**
@@ -2449,7 +2447,7 @@ void ASFormatter::setAttachExternC(bool state)
  */
 void ASFormatter::setAttachNamespace(bool state)
 {
-	shouldAttachNamespace = state;
+	options.shouldAttachNamespace = state;
 }
 
 /**
@@ -2459,12 +2457,12 @@ void ASFormatter::setAttachNamespace(bool state)
  */
 void ASFormatter::setAttachInline(bool state)
 {
-	shouldAttachInline = state;
+	options.shouldAttachInline = state;
 }
 
 void ASFormatter::setAttachClosingWhile(bool state)
 {
-	shouldAttachClosingWhile = state;
+	options.shouldAttachClosingWhile = state;
 }
 
 /**
@@ -2474,7 +2472,7 @@ void ASFormatter::setAttachClosingWhile(bool state)
  */
 void ASFormatter::setBreakOneLineBlocksMode(bool state)
 {
-	shouldBreakOneLineBlocks = state;
+	options.shouldBreakOneLineBlocks = state;
 }
 
 /**
@@ -2482,7 +2480,7 @@ void ASFormatter::setBreakOneLineBlocksMode(bool state)
 */
 void ASFormatter::setBreakOneLineHeadersMode(bool state)
 {
-	shouldBreakOneLineHeaders = state;
+	options.shouldBreakOneLineHeaders = state;
 }
 
 /**
@@ -2492,12 +2490,12 @@ void ASFormatter::setBreakOneLineHeadersMode(bool state)
 */
 void ASFormatter::setBreakOneLineStatementsMode(bool state)
 {
-	shouldBreakOneLineStatements = state;
+	options.shouldBreakOneLineStatements = state;
 }
 
 void ASFormatter::setCloseTemplatesMode(bool state)
 {
-	shouldCloseTemplates = state;
+	options.shouldCloseTemplates = state;
 }
 
 /**
@@ -2507,7 +2505,7 @@ void ASFormatter::setCloseTemplatesMode(bool state)
  */
 void ASFormatter::setTabSpaceConversionMode(bool state)
 {
-	shouldConvertTabs = state;
+	options.shouldConvertTabs = state;
 }
 
 /**
@@ -2517,7 +2515,7 @@ void ASFormatter::setTabSpaceConversionMode(bool state)
  */
 void ASFormatter::setIndentCol1CommentsMode(bool state)
 {
-	shouldIndentCol1Comments = state;
+	options.shouldIndentCol1Comments = state;
 }
 
 /**
@@ -2537,7 +2535,7 @@ void ASFormatter::setLineEndFormat(LineEndFormat fmt)
  */
 void ASFormatter::setBreakBlocksMode(bool state)
 {
-	shouldBreakBlocks = state;
+	options.shouldBreakBlocks = state;
 }
 
 /**
@@ -2547,7 +2545,7 @@ void ASFormatter::setBreakBlocksMode(bool state)
  */
 void ASFormatter::setBreakClosingHeaderBlocksMode(bool state)
 {
-	shouldBreakClosingHeaderBlocks = state;
+	options.shouldBreakClosingHeaderBlocks = state;
 }
 
 /**
@@ -2557,27 +2555,27 @@ void ASFormatter::setBreakClosingHeaderBlocksMode(bool state)
  */
 void ASFormatter::setDeleteEmptyLinesMode(bool state)
 {
-	shouldDeleteEmptyLines = state;
+	options.shouldDeleteEmptyLines = state;
 }
 
 void ASFormatter::setBreakReturnType(bool state)
 {
-	shouldBreakReturnType = state;
+	options.shouldBreakReturnType = state;
 }
 
 void ASFormatter::setBreakReturnTypeDecl(bool state)
 {
-	shouldBreakReturnTypeDecl = state;
+	options.shouldBreakReturnTypeDecl = state;
 }
 
 void ASFormatter::setAttachReturnType(bool state)
 {
-	shouldAttachReturnType = state;
+	options.shouldAttachReturnType = state;
 }
 
 void ASFormatter::setAttachReturnTypeDecl(bool state)
 {
-	shouldAttachReturnTypeDecl = state;
+	options.shouldAttachReturnTypeDecl = state;
 }
 
 void ASFormatter::setSqueezeEmptyLinesNumber(int num)
@@ -2585,6 +2583,31 @@ void ASFormatter::setSqueezeEmptyLinesNumber(int num)
 	squeezeEmptyLineNum = num;
 }
 
+/**
+ * set the number of source lines between automatic checkpoints.
+ * the checkpoints are available from getCheckpoints().
+ *
+ * @param lines         the number of lines, 0 takes no checkpoints.
+ */
+void ASFormatter::setCheckpointInterval(int lines)
+{
+	checkpointInterval = lines > 0 ? static_cast<size_t>(lines) : 0;
+}
+
+/**
+ * set the top level checkpoint mode.
+ * options:
+ *    true     an automatic checkpoint waits for the next line boundary
+ *             between top level statements or declarations.
+ *    false    an automatic checkpoint is taken at the interval line.
+ *
+ * @param state         the top level checkpoint mode.
+ */
+void ASFormatter::setCheckpointTopLevelMode(bool state)
+{
+	options.shouldCheckpointTopLevel = state;
+}
+
 
 /**
  * set the pointer alignment.
@@ -2733,26 +2756,26 @@ bool ASFormatter::isBeforeMultipleLineEndComments(int startPos) const
  */
 bool ASFormatter::getNextChar()
 {
-	isInLineBreak = false;
+	flags.isInLineBreak = false;
 	previousChar = currentChar;
 
 	if (!isWhiteSpace(currentChar))
 	{
 		previousNonWSChar = currentChar;
-		if (!isInComment && !isInLineComment && !isInQuote
-		        && !isImmediatelyPostComment
-		        && !isImmediatelyPostLineComment
-		        && !isInPreprocessor
+		if (!flags.isInComment && !flags.isInLineComment && !flags.isInQuote
+		        && !flags.isImmediatelyPostComment
+		        && !flags.isImmediatelyPostLineComment
+		        && !flags.isInPreprocessor
 		        && !isSequenceReached("/*")
 		        && !isSequenceReached("//"))
 			previousCommandChar = currentChar;
 	}
 
 	if (charNum + 1 < (int) currentLine.length()
-	        && (!isWhiteSpace(peekNextChar()) || isInComment || isInLineComment))
+	        && (!isWhiteSpace(peekNextChar()) || flags.isInComment || flags.isInLineComment))
 	{
 		currentChar = currentLine[++charNum];
-		if (currentChar == '\t' && shouldConvertTabs)
+		if (currentChar == '\t' && options.shouldConvertTabs)
 			convertTabToSpaces();
 
 		return true;
@@ -2772,34 +2795,36 @@ bool ASFormatter::getNextLine(bool emptyLineWasDeleted /*false*/)
 {
 	if (!sourceIterator->hasMoreLines())
 	{
-		endOfCodeReached = true;
+		flags.endOfCodeReached = true;
 		return false;
 	}
-	if (appendOpeningBrace)
+	flags.isAppendedBraceLine = flags.appendOpeningBrace;
+	if (flags.appendOpeningBrace)
 		currentLine = "{";		// append brace that was removed from the previous line
 	else
 	{
 		currentLine = sourceIterator->nextLine(emptyLineWasDeleted);
+		sourceLineNum++;
 		assert(computeChecksumIn(currentLine));
 	}
 
 	// reset variables for new line
 	inLineNumber++;
-	if (endOfAsmReached)
-		endOfAsmReached = isInAsmBlock = isInAsm = false;
-	shouldKeepLineUnbroken = false;
-	isInCommentStartLine = false;
-	isInCase = false;
-	isInAsmOneLine = false;
-	isHeaderInMultiStatementLine = false;
-	isInQuoteContinuation = isInVerbatimQuote || haveLineContinuationChar;
-	haveLineContinuationChar = false;
-	isImmediatelyPostEmptyLine = lineIsEmpty;
+	if (flags.endOfAsmReached)
+		flags.endOfAsmReached = flags.isInAsmBlock = flags.isInAsm = false;
+	flags.shouldKeepLineUnbroken = false;
+	flags.isInCommentStartLine = false;
+	flags.isInCase = false;
+	flags.isInAsmOneLine = false;
+	flags.isHeaderInMultiStatementLine = false;
+	flags.isInQuoteContinuation = flags.isInVerbatimQuote || flags.haveLineContinuationChar;
+	flags.haveLineContinuationChar = false;
+	flags.isImmediatelyPostEmptyLine = flags.lineIsEmpty;
 	previousChar = ' ';
 
 	if (currentLine.length() == 0)
 	{
-		isInContinuedPreProc = false;
+		flags.isInContinuedPreProc = false;
 		currentLine = std::string(" ");        // a null is inserted if this is not done
 	}
 
@@ -2809,58 +2834,58 @@ bool ASFormatter::getNextLine(bool emptyLineWasDeleted /*false*/)
 		--methodAttachLineNum;
 
 	// unless reading in the first line of the file, break a new line.
-	if (!isVirgin)
-		isInLineBreak = true;
+	if (!flags.isVirgin)
+		flags.isInLineBreak = true;
 	else
-		isVirgin = false;
+		flags.isVirgin = false;
 
-	if (isImmediatelyPostNonInStmt)
+	if (flags.isImmediatelyPostNonInStmt)
 	{
-		isCharImmediatelyPostNonInStmt = true;
-		isImmediatelyPostNonInStmt = false;
+		flags.isCharImmediatelyPostNonInStmt = true;
+		flags.isImmediatelyPostNonInStmt = false;
 	}
 
 	// check if is in preprocessor before line trimming
 	// a blank line after a \ will remove the flag
-	isImmediatelyPostPreprocessor = isInPreprocessor;
-	if (!isInComment
+	flags.isImmediatelyPostPreprocessor = flags.isInPreprocessor;
+	if (!flags.isInComment
 	        && (previousNonWSChar != '\\'
 	            || isEmptyLine(currentLine)))
 	{
-		isInPreprocessor = false;
-		isInPreprocessorDefineDef = false;
+		flags.isInPreprocessor = false;
+		flags.isInPreprocessorDefineDef = false;
 	}
 
-	if (passedSemicolon)
-		isInExecSQL = false;
+	if (flags.passedSemicolon)
+		flags.isInExecSQL = false;
 	initNewLine();
 
 	currentChar = currentLine[charNum];
-	if (isInBraceRunIn && previousNonWSChar == '{' && !isInComment)
-		isInLineBreak = false;
-	isInBraceRunIn = false;
+	if (flags.isInBraceRunIn && previousNonWSChar == '{' && !flags.isInComment)
+		flags.isInLineBreak = false;
+	flags.isInBraceRunIn = false;
 
-	if (currentChar == '\t' && shouldConvertTabs)
+	if (currentChar == '\t' && options.shouldConvertTabs)
 		convertTabToSpaces();
 
 	// check for an empty line inside a command brace.
 	// if yes then read the next line (calls getNextLine recursively).
 	// must be after initNewLine.
-	if (shouldDeleteEmptyLines
-	        && lineIsEmpty
-	        && isBraceType((*braceTypeStack)[braceTypeStack->size() - 1], COMMAND_TYPE))
+	if (options.shouldDeleteEmptyLines
+	        && flags.lineIsEmpty
+	        && isBraceType(braceTypeStack[braceTypeStack.size() - 1], COMMAND_TYPE))
 	{
-		if (!shouldBreakBlocks || previousNonWSChar == '{' || !commentAndHeaderFollows())
+		if (!options.shouldBreakBlocks || previousNonWSChar == '{' || !commentAndHeaderFollows())
 		{
-			isInPreprocessor = isImmediatelyPostPreprocessor;		// restore
-			lineIsEmpty = false;
+			flags.isInPreprocessor = flags.isImmediatelyPostPreprocessor;		// restore
+			flags.lineIsEmpty = false;
 			return getNextLine(true);
 		}
 	}
 
-	if ( ++squeezeEmptyLineCount > squeezeEmptyLineNum && lineIsEmpty && isImmediatelyPostEmptyLine)
+	if ( ++squeezeEmptyLineCount > squeezeEmptyLineNum && flags.lineIsEmpty && flags.isImmediatelyPostEmptyLine)
 	{
-		isInPreprocessor = isImmediatelyPostPreprocessor;		// restore
+		flags.isInPreprocessor = flags.isImmediatelyPostPreprocessor;		// restore
 		return getNextLine(true);
 	}
 
@@ -2878,13 +2903,13 @@ void ASFormatter::initNewLine()
 	charNum = 0;
 
 	// don't trim these
-	if (isInQuoteContinuation
-	        || (isInPreprocessor && !getPreprocDefineIndent()))
+	if (flags.isInQuoteContinuation
+	        || (flags.isInPreprocessor && !getPreprocDefineIndent()))
 		return;
 
 	// SQL continuation lines must be adjusted so the leading spaces
 	// is equivalent to the opening EXEC SQL
-	if (isInExecSQL)
+	if (flags.isInExecSQL)
 	{
 		// replace leading tabs with spaces
 		// so that continuation indent will be spaces
@@ -2909,22 +2934,22 @@ void ASFormatter::initNewLine()
 
 	// comment continuation lines must be adjusted so the leading spaces
 	// is equivalent to the opening comment
-	if (isInComment)
+	if (flags.isInComment)
 	{
-		if (noTrimCommentContinuation)
+		if (flags.noTrimCommentContinuation)
 			leadingSpaces = tabIncrementIn = 0;
 		trimContinuationLine();
 		return;
 	}
 
 	// compute leading spaces
-	isImmediatelyPostCommentOnly = lineIsLineCommentOnly || lineEndsInCommentOnly;
-	lineIsCommentOnly = false;
-	lineIsLineCommentOnly = false;
-	lineEndsInCommentOnly = false;
-	doesLineStartComment = false;
-	currentLineBeginsWithBrace = false;
-	lineIsEmpty = false;
+	flags.isImmediatelyPostCommentOnly = flags.lineIsLineCommentOnly || flags.lineEndsInCommentOnly;
+	flags.lineIsCommentOnly = false;
+	flags.lineIsLineCommentOnly = false;
+	flags.lineEndsInCommentOnly = false;
+	flags.doesLineStartComment = false;
+	flags.currentLineBeginsWithBrace = false;
+	flags.lineIsEmpty = false;
 	currentLineFirstBraceNum = std::string::npos;
 	tabIncrementIn = 0;
 
@@ -2933,31 +2958,31 @@ void ASFormatter::initNewLine()
 	for (charNum = 0; isWhiteSpace(currentLine[charNum]) && charNum + 1 < (int) len; charNum++)
 	{
 		if (currentLine[charNum] == '\t'
-		        && (!isInPreprocessor || isInPreprocessorDefineDef))
+		        && (!flags.isInPreprocessor || flags.isInPreprocessorDefineDef))
 			tabIncrementIn += tabSize - 1 - ((tabIncrementIn + charNum) % tabSize);
 	}
 	leadingSpaces = charNum + tabIncrementIn;
 
 	if (isSequenceReached("/*"))
 	{
-		doesLineStartComment = true;
+		flags.doesLineStartComment = true;
 		if ((int) currentLine.length() > charNum + 2
 		        && currentLine.find("*/", charNum + 2) != std::string::npos)
-			lineIsCommentOnly = true;
+			flags.lineIsCommentOnly = true;
 	}
 	else if (isSequenceReached("//"))
 	{
-		lineIsLineCommentOnly = true;
+		flags.lineIsLineCommentOnly = true;
 	}
 	else if (isSequenceReached("{"))
 	{
-		currentLineBeginsWithBrace = true;
+		flags.currentLineBeginsWithBrace = true;
 		currentLineFirstBraceNum = charNum;
 		size_t firstText = currentLine.find_first_not_of(" \t", charNum + 1);
 		if (firstText != std::string::npos)
 		{
 			if (currentLine.compare(firstText, 2, "//") == 0)
-				lineIsLineCommentOnly = true;
+				flags.lineIsLineCommentOnly = true;
 			else if (currentLine.compare(firstText, 2, "/*") == 0
 			         || isExecSQL(currentLine, firstText))
 			{
@@ -2970,23 +2995,23 @@ void ASFormatter::initNewLine()
 				}
 				leadingSpaces = j + tabIncrementIn;
 				if (currentLine.compare(firstText, 2, "/*") == 0)
-					doesLineStartComment = true;
+					flags.doesLineStartComment = true;
 			}
 		}
 	}
 	else if (isWhiteSpace(currentLine[charNum]) && !(charNum + 1 < (int) currentLine.length()))
 	{
-		lineIsEmpty = true;
-		if (!isImmediatelyPostEmptyLine  )
+		flags.lineIsEmpty = true;
+		if (!flags.isImmediatelyPostEmptyLine  )
 		{
 			squeezeEmptyLineCount = 0;
 		}
 	}
 
 	// do not trim indented preprocessor define (except for comment continuation lines)
-	if (isInPreprocessor)
+	if (flags.isInPreprocessor)
 	{
-		if (!doesLineStartComment)
+		if (!flags.doesLineStartComment)
 			leadingSpaces = 0;
 		charNum = 0;
 	}
@@ -3001,11 +3026,11 @@ void ASFormatter::initNewLine()
  */
 void ASFormatter::appendChar(char ch, bool canBreakLine)
 {
-	if (canBreakLine && isInLineBreak)
+	if (canBreakLine && flags.isInLineBreak)
 		breakLine();
 
 	formattedLine.append(1, ch);
-	isImmediatelyPostCommentOnly = false;
+	flags.isImmediatelyPostCommentOnly = false;
 	if (maxCodeLength != std::string::npos)
 	{
 		// These compares reduce the frequency of function calls.
@@ -3026,7 +3051,7 @@ void ASFormatter::appendChar(char ch, bool canBreakLine)
  */
 void ASFormatter::appendSequence(const std::string& sequence, bool canBreakLine)
 {
-	if (canBreakLine && isInLineBreak)
+	if (canBreakLine && flags.isInLineBreak)
 		breakLine();
 	formattedLine.append(sequence);
 	if (formattedLine.length() > maxCodeLength)
@@ -3042,7 +3067,7 @@ void ASFormatter::appendSequence(const std::string& sequence, bool canBreakLine)
  */
 void ASFormatter::appendOperator(const std::string& sequence, bool canBreakLine)
 {
-	if (canBreakLine && isInLineBreak)
+	if (canBreakLine && flags.isInLineBreak)
 		breakLine();
 	formattedLine.append(sequence);
 	if (maxCodeLength != std::string::npos)
@@ -3104,27 +3129,32 @@ void ASFormatter::appendSpaceAfter()
  */
 void ASFormatter::breakLine(bool isSplitLine /*false*/)
 {
-	isLineReady = true;
-	isInLineBreak = false;
+	// the line break of a new source line, before any of it is appended
+	size_t firstChar = currentLine.find_first_not_of(" \t");
+	flags.isBreakAtLineStart = flags.isInLineBreak
+	                           && !flags.isAppendedBraceLine
+	                           && (firstChar == std::string::npos || charNum <= (int) firstChar);
+	flags.isLineReady = true;
+	flags.isInLineBreak = false;
 	spacePadNum = nextLineSpacePadNum;
 	nextLineSpacePadNum = 0;
 	readyFormattedLine = formattedLine;
 	formattedLine.erase();
 	// queue an empty line prepend request if one exists
-	prependEmptyLine = isPrependPostBlockEmptyLineRequested;
+	flags.prependEmptyLine = flags.isPrependPostBlockEmptyLineRequested;
 
 	if (!isSplitLine)
 	{
 		formattedLineCommentNum = std::string::npos;
 		clearFormattedLineSplitPoints();
 
-		if (isAppendPostBlockEmptyLineRequested)
+		if (flags.isAppendPostBlockEmptyLineRequested)
 		{
-			isAppendPostBlockEmptyLineRequested = false;
-			isPrependPostBlockEmptyLineRequested = true;
+			flags.isAppendPostBlockEmptyLineRequested = false;
+			flags.isPrependPostBlockEmptyLineRequested = true;
 		}
 		else
-			isPrependPostBlockEmptyLineRequested = false;
+			flags.isPrependPostBlockEmptyLineRequested = false;
 	}
 }
 
@@ -3146,23 +3176,23 @@ BraceType ASFormatter::getBraceType()
 	BraceType returnVal = NULL_TYPE;
 
 	if ((previousNonWSChar == '='
-	        || isBraceType(braceTypeStack->back(), ARRAY_TYPE))
+	        || isBraceType(braceTypeStack.back(), ARRAY_TYPE))
 	        && previousCommandChar != ')'
-	        && !isNonParenHeader)
+	        && !flags.isNonParenHeader)
 		returnVal = ARRAY_TYPE;
-	else if (foundPreDefinitionHeader && previousCommandChar != ')')
+	else if (flags.foundPreDefinitionHeader && previousCommandChar != ')')
 	{
 		returnVal = DEFINITION_TYPE;
-		if (foundNamespaceHeader)
+		if (flags.foundNamespaceHeader)
 			returnVal = (BraceType)(returnVal | NAMESPACE_TYPE);
-		else if (foundClassHeader)
+		else if (flags.foundClassHeader)
 			returnVal = (BraceType)(returnVal | CLASS_TYPE);
-		else if (foundStructHeader)
+		else if (flags.foundStructHeader)
 			returnVal = (BraceType)(returnVal | STRUCT_TYPE);
-		else if (foundInterfaceHeader)
+		else if (flags.foundInterfaceHeader)
 			returnVal = (BraceType)(returnVal | INTERFACE_TYPE);
 	}
-	else if (isInEnum)
+	else if (flags.isInEnum)
 	{
 		returnVal = (BraceType)(ARRAY_TYPE | ENUM_TYPE);
 	}
@@ -3175,30 +3205,30 @@ BraceType ASFormatter::getBraceType()
 	}
 	else
 	{
-		bool isCommandType = (foundPreCommandHeader
-		                      || foundPreCommandMacro
-		                      || (currentHeader != nullptr && isNonParenHeader)
-		                      || (previousCommandChar == ')' && !isInAllocator)
-		                      || (previousCommandChar == ':' && !foundQuestionMark)
+		bool isCommandType = (flags.foundPreCommandHeader
+		                      || flags.foundPreCommandMacro
+		                      || (currentHeader != nullptr && flags.isNonParenHeader)
+		                      || (previousCommandChar == ')' && !flags.isInAllocator)
+		                      || (previousCommandChar == ':' && !flags.foundQuestionMark)
 		                      || (previousCommandChar == ';')
 		                      || ((previousCommandChar == '{' || previousCommandChar == '}')
-		                          && isPreviousBraceBlockRelated)
-		                      || (isInClassInitializer
+		                          && flags.isPreviousBraceBlockRelated)
+		                      || (flags.isInClassInitializer
 		                          && ((!isLegalNameChar(previousNonWSChar) && previousNonWSChar != '(')
-		                              || foundPreCommandHeader))
-		                      || foundTrailingReturnType
-		                      || isInObjCMethodDefinition
-		                      || isInObjCInterface
-		                      || isJavaStaticConstructor
-		                      || isSharpDelegate);
+		                              || flags.foundPreCommandHeader))
+		                      || flags.foundTrailingReturnType
+		                      || flags.isInObjCMethodDefinition
+		                      || flags.isInObjCInterface
+		                      || flags.isJavaStaticConstructor
+		                      || hints.isSharpDelegate);
 		// C# methods containing 'get', 'set', 'add', and 'remove' do NOT end with parens
 		if (!isCommandType && isSharpStyle() && isNextWordSharpNonParenHeader(charNum + 1))
 		{
 			isCommandType = true;
-			isSharpAccessor = true;
+			hints.isSharpAccessor = true;
 		}
 
-		if (isInExternC)
+		if (hints.isInExternC)
 			returnVal = (isCommandType ? COMMAND_TYPE : EXTERN_TYPE);
 		else
 			returnVal = (isCommandType ? COMMAND_TYPE : ARRAY_TYPE);
@@ -3212,7 +3242,7 @@ BraceType ASFormatter::getBraceType()
 	if (foundOneLineBlock > 0)
 	{
 		returnVal = (BraceType) (returnVal | SINGLE_LINE_TYPE);
-		if (breakCurrentOneLineBlock)
+		if (flags.breakCurrentOneLineBlock)
 			returnVal = (BraceType) (returnVal | BREAK_BLOCK_TYPE);
 		if (foundOneLineBlock == 3)
 			returnVal = (BraceType)(returnVal | EMPTY_BLOCK_TYPE);
@@ -3223,8 +3253,8 @@ BraceType ASFormatter::getBraceType()
 		if (isNonInStatementArrayBrace())
 		{
 			returnVal = (BraceType)(returnVal | ARRAY_NIS_TYPE);
-			isNonInStatementArray = true;
-			isImmediatelyPostNonInStmt = false;		// in case of "},{"
+			hints.isNonInStatementArray = true;
+			flags.isImmediatelyPostNonInStmt = false;		// in case of "},{"
 			nonInStatementBrace = formattedLine.length() - 1;
 		}
 		if (isUniformInitializerBrace())
@@ -3278,22 +3308,22 @@ bool ASFormatter::isClassInitializer() const
 	// this should be similar to ASBeautifier::parseCurrentLine()
 	bool foundClassInitializer = false;
 
-	if (foundQuestionMark)
+	if (flags.foundQuestionMark)
 	{
 		// do nothing special
 	}
-	else if (parenStack->back() > 0)
+	else if (parenStack.back() > 0)
 	{
 		// found a 'for' loop or an objective-C statement
 		// so do nothing special
 	}
-	else if (isInEnum)
+	else if (flags.isInEnum)
 	{
 		// found an enum with a base-type
 	}
 	else if (isCStyle()
-	         && !isInCase
-	         && (previousCommandChar == ')' || foundPreCommandHeader))
+	         && !flags.isInCase
+	         && (previousCommandChar == ')' || flags.foundPreCommandHeader))
 	{
 		// found a 'class' c'tor initializer
 		foundClassInitializer = true;
@@ -3347,7 +3377,7 @@ bool ASFormatter::isPointerOrReference() const
 	if (isJavaStyle())
 		return false;
 
-	if (isCharImmediatelyPostOperator)
+	if (flags.isCharImmediatelyPostOperator)
 		return false;
 
 	// get the last legal word (may be a number)
@@ -3372,11 +3402,11 @@ bool ASFormatter::isPointerOrReference() const
 	        && !isPointerToPointer(currentLine, charNum))
 		return false;
 
-	if ((foundCastOperator && nextChar == '>')
+	if ((flags.foundCastOperator && nextChar == '>')
 	        || isPointerOrReferenceVariable(lastWord))
 		return true;
 
-	if (isInClassInitializer
+	if (flags.isInClassInitializer
 	        && previousNonWSChar != '('
 	        && previousNonWSChar != '{'
 	        && previousCommandChar != ','
@@ -3396,9 +3426,9 @@ bool ASFormatter::isPointerOrReference() const
 			followingText = peekNextText(currentLine.substr(charNum + 2));
 		if (followingText.length() > 0 && followingText[0] == ')')
 			return true;
-		if (currentHeader != nullptr || isInPotentialCalculation)
+		if (currentHeader != nullptr || flags.isInPotentialCalculation)
 			return false;
-		if (parenStack->back() > 0 && isBraceType(braceTypeStack->back(), COMMAND_TYPE))
+		if (parenStack.back() > 0 && isBraceType(braceTypeStack.back(), COMMAND_TYPE))
 			return false;
 		return true;
 	}
@@ -3406,15 +3436,15 @@ bool ASFormatter::isPointerOrReference() const
 	        || previousNonWSChar == '='
 	        || previousNonWSChar == '('
 	        || previousNonWSChar == '['
-	        || isCharImmediatelyPostReturn
-	        || isInTemplate
-	        || isCharImmediatelyPostTemplate
+	        || flags.isCharImmediatelyPostReturn
+	        || flags.isInTemplate
+	        || flags.isCharImmediatelyPostTemplate
 	        || currentHeader == &AS_CATCH
 	        || currentHeader == &AS_FOREACH
 	        || currentHeader == &AS_QFOREACH)
 		return true;
 
-	if (isBraceType(braceTypeStack->back(), ARRAY_TYPE)
+	if (isBraceType(braceTypeStack.back(), ARRAY_TYPE)
 	        && isLegalNameChar(lastWord[0])
 	        && isLegalNameChar(nextChar)
 	        && previousNonWSChar != ')')
@@ -3424,7 +3454,7 @@ bool ASFormatter::isPointerOrReference() const
 	}
 
 	// checks on operators in parens
-	if (parenStack->back() > 0
+	if (parenStack.back() > 0
 	        && isLegalNameChar(lastWord[0])
 	        && isLegalNameChar(nextChar))
 	{
@@ -3440,7 +3470,7 @@ bool ASFormatter::isPointerOrReference() const
 			return false;
 		}
 
-		if (isBraceType(braceTypeStack->back(), COMMAND_TYPE)
+		if (isBraceType(braceTypeStack.back(), COMMAND_TYPE)
 		        || squareBracketCount > 0)
 			return false;
 		return true;
@@ -3449,7 +3479,7 @@ bool ASFormatter::isPointerOrReference() const
 	// checks on operators in parens with following '('
 	std::set<char> disallowedChars = {',', '(', '!', '&', '*', '|'};
 
-	if (parenStack->back() > 0
+	if (parenStack.back() > 0
 	        && nextChar == '('
 	        && disallowedChars.find(previousNonWSChar) == disallowedChars.end())
 		return false;
@@ -3466,7 +3496,7 @@ bool ASFormatter::isPointerOrReference() const
 		}
 	}
 
-	bool isPR = (!isInPotentialCalculation
+	bool isPR = (!flags.isInPotentialCalculation
 	             || (!isLegalNameChar(previousNonWSChar)
 	                 && !(previousNonWSChar == ')' && nextChar == '(')
 	                 && !(previousNonWSChar == ')' && currentChar == '*' && !isImmediatelyPostCast())
@@ -3493,7 +3523,7 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 {
 	assert(currentChar == '*' || currentChar == '&' || currentChar == '^');
 
-	if (isCharImmediatelyPostTemplate)
+	if (flags.isCharImmediatelyPostTemplate)
 		return false;
 
 	// https://sourceforge.net/p/astyle/bugs/537/
@@ -3507,9 +3537,9 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 
 	if ( allowedChars.find(previousNonWSChar) != allowedChars.end()
 	        || (previousNonWSChar == ',' && currentChar == '&')  // #537, #552
-	        || isCharImmediatelyPostLineComment
-	        || isCharImmediatelyPostComment
-	        || isCharImmediatelyPostReturn)
+	        || flags.isCharImmediatelyPostLineComment
+	        || flags.isCharImmediatelyPostComment
+	        || flags.isCharImmediatelyPostReturn)
 		return true;
 
 	char nextChar = peekNextChar();
@@ -3524,7 +3554,7 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 
 	if (currentChar == '&' && nextChar == '&')
 	{
-		if (previousNonWSChar == '(' || isInTemplate)
+		if (previousNonWSChar == '(' || flags.isInTemplate)
 			return true;
 		if ((int) currentLine.length() < charNum + 2)
 			return true;
@@ -3533,8 +3563,8 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 
 	// check first char on the line
 	if (charNum == (int) currentLine.find_first_not_of(" \t")
-	        && (isBraceType(braceTypeStack->back(), COMMAND_TYPE)
-	            || parenStack->back() != 0))
+	        && (isBraceType(braceTypeStack.back(), COMMAND_TYPE)
+	            || parenStack.back() != 0))
 		return true;
 
 	std::string nextText = peekNextText(currentLine.substr(charNum + 1));
@@ -3551,8 +3581,8 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 	        || (previousNonWSChar == '*' && currentChar == '&'))
 		return false;
 
-	if (!isBraceType(braceTypeStack->back(), COMMAND_TYPE)
-	        && parenStack->back() == 0)
+	if (!isBraceType(braceTypeStack.back(), COMMAND_TYPE)
+	        && parenStack.back() == 0)
 		return false;
 	std::string lastWord = getPreviousWord(currentLine, charNum);
 	if (lastWord == "else" || lastWord == "delete")
@@ -3562,7 +3592,7 @@ bool ASFormatter::isDereferenceOrAddressOf() const
 	bool isDA = (!(isLegalNameChar(previousNonWSChar) || previousNonWSChar == '>')          // TODO GH14
 	             || (nextText.length() > 0 && !isLegalNameChar(nextText[0]) && nextText[0] != '/')
 	             || (ispunct((unsigned char)previousNonWSChar) && previousNonWSChar != '.') // TODO GH14
-	             || isCharImmediatelyPostReturn);
+	             || flags.isCharImmediatelyPostReturn);
 
 	return isDA;
 }
@@ -3702,7 +3732,7 @@ bool ASFormatter::isUnaryOperator() const
 		return true;
 	}
 
-	return ((isCharImmediatelyPostReturn || !isLegalNameChar(previousCommandChar))
+	return ((flags.isCharImmediatelyPostReturn || !isLegalNameChar(previousCommandChar))
 	        && previousCommandChar != '.'
 	        && previousCommandChar != '\"'
 	        && previousCommandChar != '\''
@@ -3716,10 +3746,10 @@ bool ASFormatter::isUnaryOperator() const
  */
 bool ASFormatter::isInSwitchStatement() const
 {
-	assert(isInLineComment || isInComment);
-	if (!preBraceHeaderStack->empty())
-		for (size_t i = 1; i < preBraceHeaderStack->size(); i++)
-			if (preBraceHeaderStack->at(i) == &AS_SWITCH)
+	assert(flags.isInLineComment || flags.isInComment);
+	if (!preBraceHeaderStack.empty())
+		for (size_t i = 1; i < preBraceHeaderStack.size(); i++)
+			if (preBraceHeaderStack.at(i) == &AS_SWITCH)
 				return true;
 	return false;
 }
@@ -3754,7 +3784,7 @@ bool ASFormatter::isNonInStatementArrayBrace() const
 	bool returnVal = false;
 	char nextChar = peekNextChar();
 	// if this opening brace begins the line there will be no inStatement indent
-	if (currentLineBeginsWithBrace
+	if (flags.currentLineBeginsWithBrace
 	        && (size_t) charNum == currentLineFirstBraceNum
 	        && nextChar != '}')
 		returnVal = true;
@@ -3846,7 +3876,7 @@ int ASFormatter::isOneLineBlockReached(const std::string& line, int startChar) c
 			if (braceCount == 0)
 			{
 				// is this an array?
-				if (parenStack->back() == 0 && prevCh != '}')
+				if (parenStack.back() == 0 && prevCh != '}')
 				{
 					size_t peekNum = line.find_first_not_of(" \t", i + 1);
 					if (peekNum != std::string::npos && line[peekNum] == ',')
@@ -3944,9 +3974,9 @@ bool ASFormatter::isOperatorPaddingDisabled() const
 */
 bool ASFormatter::isUniformInitializerBrace() const
 {
-	if (isCStyle() && !isInEnum && !isImmediatelyPostPreprocessor)
+	if (isCStyle() && !flags.isInEnum && !flags.isImmediatelyPostPreprocessor)
 	{
-		if (isInClassInitializer
+		if (flags.isInClassInitializer
 		        || isLegalNameChar(previousNonWSChar)
 		        || previousNonWSChar == '(')
 			return true;
@@ -3959,7 +3989,7 @@ bool ASFormatter::isUniformInitializerBrace() const
 */
 bool ASFormatter::isMultiStatementLine() const
 {
-	assert((isImmediatelyPostHeader || foundClosingHeader));
+	assert((flags.isImmediatelyPostHeader || flags.foundClosingHeader));
 	bool isInComment_ = false;
 	bool isInQuote_ = false;
 	int  semiCount_ = 0;
@@ -4179,8 +4209,8 @@ void ASFormatter::appendCharInsideComments()
 
 	if (isBeforeComment())
 		breakLine();
-	else if (isCharImmediatelyPostLineComment)
-		shouldBreakLineAtNextChar = true;
+	else if (flags.isCharImmediatelyPostLineComment)
+		flags.shouldBreakLineAtNextChar = true;
 }
 
 /**
@@ -4192,7 +4222,7 @@ void ASFormatter::appendCharInsideComments()
  */
 void ASFormatter::padOperators(const std::string* newOperator)
 {
-	assert(shouldPadOperators);
+	assert(options.shouldPadOperators);
 	assert(newOperator != nullptr);
 
 	char nextNonWSChar = ASBase::peekNextChar(currentLine, charNum);
@@ -4204,9 +4234,9 @@ void ASFormatter::padOperators(const std::string* newOperator)
 	                  && newOperator != &AS_NOT
 	                  && newOperator != &AS_BIT_NOT
 	                  && newOperator != &AS_ARROW
-	                  && !(newOperator == &AS_COLON && !foundQuestionMark			// objC methods
-	                       && (isInObjCMethodDefinition || isInObjCInterface
-	                           || isInObjCSelector || squareBracketCount != 0))
+	                  && !(newOperator == &AS_COLON && !flags.foundQuestionMark			// objC methods
+	                       && (flags.isInObjCMethodDefinition || flags.isInObjCInterface
+	                           || flags.isInObjCSelector || squareBracketCount != 0))
 	                  && !(newOperator == &AS_MINUS && isInExponent())
 	                  && !(newOperator == &AS_PLUS && isInExponent())
 	                  && !(newOperator == &AS_GR && previousChar == '-') //https://sourceforge.net/p/astyle/bugs/544/
@@ -4216,7 +4246,7 @@ void ASFormatter::padOperators(const std::string* newOperator)
 	                       && (previousNonWSChar == '.'
 	                           || previousNonWSChar == '>'))    // check for ->
 	                  && !(newOperator == &AS_MULT && peekNextChar() == '>')
-	                  && !((isInTemplate || isImmediatelyPostTemplate)
+	                  && !((flags.isInTemplate || flags.isImmediatelyPostTemplate)
 	                       && (newOperator == &AS_LS || newOperator == &AS_GR))
 	                  && !(newOperator == &AS_GCC_MIN_ASSIGN
 	                       && ASBase::peekNextChar(currentLine, charNum + 1) == '>')
@@ -4230,17 +4260,17 @@ void ASFormatter::padOperators(const std::string* newOperator)
 	                       && isSharpStyle()
 	                       && (nextNonWSChar == '.'
 	                           || nextNonWSChar == '['))
-	                  && !isCharImmediatelyPostOperator
-	                  && !isInCase
-	                  && !isInAsm
-	                  && !isInAsmOneLine
-	                  && !isInAsmBlock
+	                  && !flags.isCharImmediatelyPostOperator
+	                  && !flags.isInCase
+	                  && !flags.isInAsm
+	                  && !flags.isInAsmOneLine
+	                  && !flags.isInAsmBlock
 	                 );
 
 	// pad before operator
 	if (shouldPad
 	        && !(newOperator == &AS_COLON
-	             && (!foundQuestionMark && !isInEnum) && currentHeader != &AS_FOR)
+	             && (!flags.foundQuestionMark && !flags.isInEnum) && currentHeader != &AS_FOR)
 	        && !(newOperator == &AS_QUESTION && isSharpStyle() // check for C# nullable type (e.g. int?)
 	             && currentLine.find(':', charNum + 1) == std::string::npos)
 	   )
@@ -4584,7 +4614,7 @@ void ASFormatter::formatPointerOrReferenceToName()
 		for (size_t i = charNum + 1; i < currentLine.length() && isWhiteSpace(currentLine[i]); i++)
 		{
 			// if a padded paren follows don't move
-			if (shouldPadParensOutside && peekedChar == '(' && !isOldPRCentered)
+			if (options.shouldPadParensOutside && peekedChar == '(' && !isOldPRCentered)
 			{
 				// empty parens don't count
 				size_t start = currentLine.find_first_not_of("( \t", i);
@@ -4752,7 +4782,7 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 				// if last char is a brace the previous whitespace is an indent
 				if (formattedLine[i] == '{')
 					spacesOutsideToDelete = 0;
-				else if (isCharImmediatelyPostPointerOrReference)
+				else if (flags.isCharImmediatelyPostPointerOrReference)
 					spacesOutsideToDelete = 0;
 				else
 				{
@@ -4761,7 +4791,7 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 					// if previous word is a header, it will be a paren header
 					std::string prevWord = getPreviousWord(formattedLine, formattedLine.length());
 					const std::string* prevWordH = nullptr;
-					if (shouldPadHeader
+					if (options.shouldPadHeader
 					        && prevWord.length() > 0
 					        && isCharPotentialHeader(prevWord, 0))
 						prevWordH = ASBase::findHeader(prevWord, 0, headers);
@@ -4770,9 +4800,9 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 					else if (prevWord == AS_RETURN)
 						prevIsParenHeader = true;    // don't unpad
 					else if ((prevWord == AS_NEW || prevWord == AS_DELETE)
-					         && shouldPadHeader)
+					         && options.shouldPadHeader)
 						prevIsParenHeader = true;    // don't unpad
-					else if (isCStyle() && prevWord == AS_THROW && shouldPadHeader)
+					else if (isCStyle() && prevWord == AS_THROW && options.shouldPadHeader)
 						prevIsParenHeader = true;    // don't unpad
 					else if (prevWord == "and" || prevWord == "or" || prevWord == "in")
 						prevIsParenHeader = true;    // don't unpad
@@ -4788,7 +4818,7 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 			         || lastChar == '&'       // check for &&
 			         || lastChar == ','
 			         || (lastChar == openDelim && shouldPadParensInside)
-			         || (lastChar == '>' && !foundCastOperator)
+			         || (lastChar == '>' && !flags.foundCastOperator)
 			         || lastChar == '<'
 			         || lastChar == '?'
 			         || lastChar == ':'
@@ -4814,12 +4844,12 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 
 		// pad open paren outside
 		char peekedCharOutside = peekNextChar();
-		if (shouldPadFirstParen && ( (previousChar != openDelim && peekedCharOutside != closeDelim)  || shouldPadEmptyParens ) )
+		if (shouldPadFirstParen && ( (previousChar != openDelim && peekedCharOutside != closeDelim)  || options.shouldPadEmptyParens ) )
 			appendSpacePad();
 		else if (shouldPadParensOutside)
 		{
 			// GH19
-			if (!(currentChar == openDelim && peekedCharOutside == closeDelim) || shouldPadEmptyParens)
+			if (!(currentChar == openDelim && peekedCharOutside == closeDelim) || options.shouldPadEmptyParens)
 				appendSpacePad();
 		}
 
@@ -4839,7 +4869,7 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 				spacePadNum -= spacesInsideToDelete;
 			}
 			// convert tab to space if requested
-			if (shouldConvertTabs
+			if (options.shouldConvertTabs
 			        && (int) currentLine.length() > charNum + 1
 			        && currentLine[charNum + 1] == '\t')
 				currentLine[charNum + 1] = ' ';
@@ -4899,8 +4929,8 @@ void ASFormatter::padParensOrBrackets(char openDelim, char closeDelim, bool shou
 */
 void ASFormatter::padObjCMethodPrefix()
 {
-	assert(isInObjCMethodDefinition && isImmediatelyPostObjCMethodPrefix);
-	assert(shouldPadMethodPrefix || shouldUnPadMethodPrefix);
+	assert(flags.isInObjCMethodDefinition && flags.isImmediatelyPostObjCMethodPrefix);
+	assert(options.shouldPadMethodPrefix || options.shouldUnPadMethodPrefix);
 
 	size_t prefix = formattedLine.find_first_of("+-");
 	if (prefix == std::string::npos)
@@ -4910,7 +4940,7 @@ void ASFormatter::padObjCMethodPrefix()
 		firstChar = formattedLine.length();
 	int spaces = firstChar - prefix - 1;
 
-	if (shouldPadMethodPrefix)
+	if (options.shouldPadMethodPrefix)
 	{
 		if (spaces == 0)
 		{
@@ -4925,7 +4955,7 @@ void ASFormatter::padObjCMethodPrefix()
 		}
 	}
 	// this option will be ignored if used with pad-method-prefix
-	else if (shouldUnPadMethodPrefix)
+	else if (options.shouldUnPadMethodPrefix)
 	{
 		if (spaces > 0)
 		{
@@ -4942,15 +4972,15 @@ void ASFormatter::padObjCMethodPrefix()
 */
 void ASFormatter::padObjCReturnType()
 {
-	assert(currentChar == ')' && isInObjCReturnType);
-	assert(shouldPadReturnType || shouldUnPadReturnType);
+	assert(currentChar == ')' && flags.isInObjCReturnType);
+	assert(options.shouldPadReturnType || options.shouldUnPadReturnType);
 
 	size_t nextText = currentLine.find_first_not_of(" \t", charNum + 1);
 	if (nextText == std::string::npos)
 		return;
 	int spaces = nextText - charNum - 1;
 
-	if (shouldPadReturnType)
+	if (options.shouldPadReturnType)
 	{
 		if (spaces == 0)
 		{
@@ -4970,7 +5000,7 @@ void ASFormatter::padObjCReturnType()
 		}
 	}
 	// this option will be ignored if used with pad-return-type
-	else if (shouldUnPadReturnType)
+	else if (options.shouldUnPadReturnType)
 	{
 		// this will already be padded if pad-paren is used
 		if (formattedLine[formattedLine.length() - 1] == ' ')
@@ -4992,9 +5022,9 @@ void ASFormatter::padObjCReturnType()
 */
 void ASFormatter::padObjCParamType()
 {
-	assert((currentChar == '(' || currentChar == ')') && isInObjCMethodDefinition);
-	assert(!isImmediatelyPostObjCMethodPrefix && !isInObjCReturnType);
-	assert(shouldPadParamType || shouldUnPadParamType);
+	assert((currentChar == '(' || currentChar == ')') && flags.isInObjCMethodDefinition);
+	assert(!flags.isImmediatelyPostObjCMethodPrefix && !flags.isInObjCReturnType);
+	assert(options.shouldPadParamType || options.shouldUnPadParamType);
 
 	if (currentChar == '(')
 	{
@@ -5006,7 +5036,7 @@ void ASFormatter::padObjCParamType()
 			return;
 		int spaces = paramOpen - prevText - 1;
 
-		if (shouldPadParamType
+		if (options.shouldPadParamType
 		        || objCColonPadMode == COLON_PAD_ALL
 		        || objCColonPadMode == COLON_PAD_AFTER)
 		{
@@ -5023,7 +5053,7 @@ void ASFormatter::padObjCParamType()
 			}
 		}
 		// this option will be ignored if used with pad-param-type
-		else if (shouldUnPadParamType
+		else if (options.shouldUnPadParamType
 		         || objCColonPadMode == COLON_PAD_NONE
 		         || objCColonPadMode == COLON_PAD_BEFORE)
 		{
@@ -5041,7 +5071,7 @@ void ASFormatter::padObjCParamType()
 			return;
 		int spaces = nextText - charNum - 1;
 
-		if (shouldPadParamType)
+		if (options.shouldPadParamType)
 		{
 			if (spaces == 0)
 			{
@@ -5061,7 +5091,7 @@ void ASFormatter::padObjCParamType()
 			}
 		}
 		// this option will be ignored if used with pad-param-type
-		else if (shouldUnPadParamType)
+		else if (options.shouldUnPadParamType)
 		{
 			// this will already be padded if pad-paren is used
 			if (formattedLine[formattedLine.length() - 1] == ' ')
@@ -5093,7 +5123,7 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 	assert(!isBraceType(braceType, ARRAY_TYPE));
 	assert(currentChar == '{');
 
-	parenStack->emplace_back(0);
+	parenStack.emplace_back(0);
 
 	bool breakBrace = isCurrentBraceBroken();
 
@@ -5102,13 +5132,13 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 		if (isBeforeAnyComment() && isOkToBreakBlock(braceType) && sourceIterator->hasMoreLines())
 		{
 			// if comment is at line end leave the comment on this line
-			if (isBeforeAnyLineEndComment(charNum) && !currentLineBeginsWithBrace)
+			if (isBeforeAnyLineEndComment(charNum) && !flags.currentLineBeginsWithBrace)
 			{
 				currentChar = ' ';              // remove brace from current line
-				if (parenStack->size() > 1)
-					parenStack->pop_back();
+				if (parenStack.size() > 1)
+					parenStack.pop_back();
 				currentLine[charNum] = currentChar;
-				appendOpeningBrace = true;      // append brace to following line
+				flags.appendOpeningBrace = true;      // append brace to following line
 			}
 			// else put comment after the brace
 			else if (!isBeforeMultipleLineEndComments(charNum))
@@ -5119,10 +5149,10 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 			formattedLine = rtrim(formattedLine);
 			breakLine();
 		}
-		else if ((shouldBreakOneLineBlocks || isBraceType(braceType, BREAK_BLOCK_TYPE))
+		else if ((options.shouldBreakOneLineBlocks || isBraceType(braceType, BREAK_BLOCK_TYPE))
 		         && !isBraceType(braceType, EMPTY_BLOCK_TYPE))
 			breakLine();
-		else if (!isInLineBreak)
+		else if (!flags.isInLineBreak)
 			appendSpacePad();
 
 		appendCurrentChar();
@@ -5136,17 +5166,17 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 		        && (braceFormatMode == BREAK_MODE
 		            || braceFormatMode == LINUX_MODE))
 		{
-			shouldBreakLineAtNextChar = true;
+			flags.shouldBreakLineAtNextChar = true;
 		}
 	}
 	else    // attach brace
 	{
 		// are there comments before the brace?
-		if (isCharImmediatelyPostComment || isCharImmediatelyPostLineComment)
+		if (flags.isCharImmediatelyPostComment || flags.isCharImmediatelyPostLineComment)
 		{
 			if (isOkToBreakBlock(braceType)
-			        && !(isCharImmediatelyPostComment && isCharImmediatelyPostLineComment)	// don't attach if two comments on the line
-			        && !isImmediatelyPostPreprocessor
+			        && !(flags.isCharImmediatelyPostComment && flags.isCharImmediatelyPostLineComment)	// don't attach if two comments on the line
+			        && !flags.isImmediatelyPostPreprocessor
 //			        && peekNextChar() != '}'		// don't attach { }		// removed release 2.03
 			        && previousCommandChar != '{'	// don't attach { {
 			        && previousCommandChar != '}'	// don't attach } {
@@ -5160,7 +5190,7 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 			}
 		}
 		else if (previousCommandChar == '{'
-		         || (previousCommandChar == '}' && !isInClassInitializer)
+		         || (previousCommandChar == '}' && !flags.isInClassInitializer)
 		         || previousCommandChar == ';')		// '}' , ';' chars added for proper handling of '{' immediately after a '}' or ';'
 		{
 			appendCurrentChar();					// don't attach
@@ -5171,8 +5201,8 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 			if (isEmptyLine(formattedLine))
 				appendCurrentChar();				// don't attach
 			else if (isOkToBreakBlock(braceType)
-			         && !(isImmediatelyPostPreprocessor
-			              && currentLineBeginsWithBrace))
+			         && !(flags.isImmediatelyPostPreprocessor
+			              && flags.currentLineBeginsWithBrace))
 			{
 				if (!isBraceType(braceType, EMPTY_BLOCK_TYPE))
 				{
@@ -5183,23 +5213,23 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 					// insert spaces to reposition the comment
 					if (isBeforeComment()
 					        && !isBeforeMultipleLineEndComments(charNum)
-					        && (!isBeforeAnyLineEndComment(charNum)	|| currentLineBeginsWithBrace))
+					        && (!isBeforeAnyLineEndComment(charNum)	|| flags.currentLineBeginsWithBrace))
 					{
-						shouldBreakLineAtNextChar = true;
+						flags.shouldBreakLineAtNextChar = true;
 						currentLine.insert(charNum + 1, charNum + 1, ' ');
 					}
 					else if (!isBeforeAnyComment())		// added in release 2.03
 					{
-						shouldBreakLineAtNextChar = true;
+						flags.shouldBreakLineAtNextChar = true;
 					}
 				}
 				else
 				{
-					if (currentLineBeginsWithBrace && (size_t) charNum == currentLineFirstBraceNum)
+					if (flags.currentLineBeginsWithBrace && (size_t) charNum == currentLineFirstBraceNum)
 					{
 						appendSpacePad();
 						appendCurrentChar(false);		// attach
-						shouldBreakLineAtNextChar = true;
+						flags.shouldBreakLineAtNextChar = true;
 					}
 					else
 					{
@@ -5210,7 +5240,7 @@ void ASFormatter::formatOpeningBrace(BraceType braceType)
 			}
 			else
 			{
-				if (!isInLineBreak)
+				if (!flags.isInLineBreak)
 					appendSpacePad();
 				appendCurrentChar();				// don't attach
 			}
@@ -5231,21 +5261,21 @@ void ASFormatter::formatClosingBrace(BraceType braceType)
 	assert(currentChar == '}');
 
 	// parenStack must contain one entry
-	if (parenStack->size() > 1)
-		parenStack->pop_back();
+	if (parenStack.size() > 1)
+		parenStack.pop_back();
 
 	// mark state of immediately after empty block
 	// this state will be used for locating braces that appear immediately AFTER an empty block (e.g. '{} \n}').
 	if (previousCommandChar == '{')
-		isImmediatelyPostEmptyBlock = true;
+		flags.isImmediatelyPostEmptyBlock = true;
 
-	if (attachClosingBraceMode)
+	if (options.attachClosingBraceMode)
 	{
 		// for now, namespaces and classes will be attached. Uncomment the lines below to break.
 		if ((isEmptyLine(formattedLine)			// if a blank line precedes this
-		        || isCharImmediatelyPostLineComment
-		        || isCharImmediatelyPostComment
-		        || (isImmediatelyPostPreprocessor && (int) currentLine.find_first_not_of(" \t") == charNum)
+		        || flags.isCharImmediatelyPostLineComment
+		        || flags.isCharImmediatelyPostComment
+		        || (flags.isImmediatelyPostPreprocessor && (int) currentLine.find_first_not_of(" \t") == charNum)
 //		        || (isBraceType(braceType, CLASS_TYPE) && isOkToBreakBlock(braceType) && previousNonWSChar != '{')
 //		        || (isBraceType(braceType, NAMESPACE_TYPE) && isOkToBreakBlock(braceType) && previousNonWSChar != '{')
 		    )
@@ -5279,10 +5309,10 @@ void ASFormatter::formatClosingBrace(BraceType braceType)
 	if (isLegalNameChar(peekNextChar()))
 		appendSpaceAfter();
 
-	if (shouldBreakBlocks
+	if (options.shouldBreakBlocks
 	        && currentHeader != nullptr
-	        && !isHeaderInMultiStatementLine
-	        && parenStack->back() == 0)
+	        && !flags.isHeaderInMultiStatementLine
+	        && parenStack.back() == 0)
 	{
 		if (currentHeader == &AS_CASE || currentHeader == &AS_DEFAULT)
 		{
@@ -5290,11 +5320,11 @@ void ASFormatter::formatClosingBrace(BraceType braceType)
 			std::string nextText = peekNextText(currentLine.substr(charNum + 1));
 			if (nextText.length() > 0
 			        && nextText.substr(0, 5) != "break")
-				isAppendPostBlockEmptyLineRequested = true;
+				flags.isAppendPostBlockEmptyLineRequested = true;
 		}
 		else {
 			// GH18
-			isAppendPostBlockEmptyLineRequested = !(shouldBreakBlocks && shouldAttachClosingWhile)
+			flags.isAppendPostBlockEmptyLineRequested = !(options.shouldBreakBlocks && options.shouldAttachClosingWhile)
                                                     || currentHeader != &AS_DO;
 		}
 
@@ -5328,24 +5358,24 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 				if (isBraceType(braceType, ENUM_TYPE)
 				        && formattingStyle == STYLE_MOZILLA)
 				{
-					isInLineBreak = true;
+					flags.isInLineBreak = true;
 					appendCurrentChar();                // don't attach
 				}
 				// don't attach to a preprocessor directive or '\' line
-				else if ((isImmediatelyPostPreprocessor
+				else if ((flags.isImmediatelyPostPreprocessor
 				          || (formattedLine.length() > 0
 				              && formattedLine[formattedLine.length() - 1] == '\\'))
-				         && currentLineBeginsWithBrace)
+				         && flags.currentLineBeginsWithBrace)
 				{
-					isInLineBreak = true;
+					flags.isInLineBreak = true;
 					appendCurrentChar();                // don't attach
 				}
-				else if (isCharImmediatelyPostComment)
+				else if (flags.isCharImmediatelyPostComment)
 				{
 					// TODO: attach brace to line-end comment
 					appendCurrentChar();                // don't attach
 				}
-				else if (isCharImmediatelyPostLineComment && !isBraceType(braceType, SINGLE_LINE_TYPE))
+				else if (flags.isCharImmediatelyPostLineComment && !isBraceType(braceType, SINGLE_LINE_TYPE))
 				{
 					appendCharInsideComments();
 				}
@@ -5357,7 +5387,7 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 					else
 					{
 						// if brace is broken or not an assignment
-						if (currentLineBeginsWithBrace
+						if (flags.currentLineBeginsWithBrace
 						        && !isBraceType(braceType, SINGLE_LINE_TYPE))
 						{
 							appendSpacePad();
@@ -5365,9 +5395,9 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 							// TODO: debug the following line
 							testForTimeToSplitFormattedLine();		// line length will have changed
 
-							if (currentLineBeginsWithBrace
+							if (flags.currentLineBeginsWithBrace
 							        && currentLineFirstBraceNum == (size_t) charNum)
-								shouldBreakLineAtNextChar = true;
+								flags.shouldBreakLineAtNextChar = true;
 						}
 						else
 						{
@@ -5384,18 +5414,18 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 			}
 			else if (braceFormatMode == BREAK_MODE)
 			{
-				if (isWhiteSpace(peekNextChar()) && !isInVirginLine)
+				if (isWhiteSpace(peekNextChar()) && !flags.isInVirginLine)
 					breakLine();
 				else if (isBeforeAnyComment() && sourceIterator->hasMoreLines())
 				{
 					// do not break unless comment is at line end
-					if (isBeforeAnyLineEndComment(charNum) && !currentLineBeginsWithBrace)
+					if (isBeforeAnyLineEndComment(charNum) && !flags.currentLineBeginsWithBrace)
 					{
 						currentChar = ' ';            // remove brace from current line
-						appendOpeningBrace = true;    // append brace to following line
+						flags.appendOpeningBrace = true;    // append brace to following line
 					}
 				}
-				if (!isInLineBreak && previousNonWSChar != '(')
+				if (!flags.isInLineBreak && previousNonWSChar != '(')
 				{
 					// don't space pad C++11 uniform initialization
 					if (!isBraceType(braceType, INIT_TYPE))
@@ -5403,25 +5433,25 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 				}
 				appendCurrentChar();
 
-				if (currentLineBeginsWithBrace
+				if (flags.currentLineBeginsWithBrace
 				        && currentLineFirstBraceNum == (size_t) charNum
 				        && !isBraceType(braceType, SINGLE_LINE_TYPE))
-					shouldBreakLineAtNextChar = true;
+					flags.shouldBreakLineAtNextChar = true;
 			}
 			else if (braceFormatMode == RUN_IN_MODE)
 			{
-				if (isWhiteSpace(peekNextChar()) && !isInVirginLine)
+				if (isWhiteSpace(peekNextChar()) && !flags.isInVirginLine)
 					breakLine();
 				else if (isBeforeAnyComment() && sourceIterator->hasMoreLines())
 				{
 					// do not break unless comment is at line end
-					if (isBeforeAnyLineEndComment(charNum) && !currentLineBeginsWithBrace)
+					if (isBeforeAnyLineEndComment(charNum) && !flags.currentLineBeginsWithBrace)
 					{
 						currentChar = ' ';            // remove brace from current line
-						appendOpeningBrace = true;    // append brace to following line
+						flags.appendOpeningBrace = true;    // append brace to following line
 					}
 				}
-				if (!isInLineBreak && previousNonWSChar != '(')
+				if (!flags.isInLineBreak && previousNonWSChar != '(')
 				{
 					// don't space pad C++11 uniform initialization
 					if (!isBraceType(braceType, INIT_TYPE))
@@ -5431,7 +5461,7 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 			}
 			else if (braceFormatMode == NONE_MODE)
 			{
-				if (currentLineBeginsWithBrace
+				if (flags.currentLineBeginsWithBrace
 				        && (size_t) charNum == currentLineFirstBraceNum)
 				{
 					appendCurrentChar();                // don't attach
@@ -5453,16 +5483,16 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 			if (braceFormatMode == RUN_IN_MODE)
 			{
 				if (previousNonWSChar == '{'
-				        && braceTypeStack->size() > 2
-				        && !isBraceType((*braceTypeStack)[braceTypeStack->size() - 2],
+				        && braceTypeStack.size() > 2
+				        && !isBraceType(braceTypeStack[braceTypeStack.size() - 2],
 				                        SINGLE_LINE_TYPE))
 					formatArrayRunIn();
 			}
-			else if (!isInLineBreak
+			else if (!flags.isInLineBreak
 			         && !isWhiteSpace(peekNextChar())
 			         && previousNonWSChar == '{'
-			         && braceTypeStack->size() > 2
-			         && !isBraceType((*braceTypeStack)[braceTypeStack->size() - 2],
+			         && braceTypeStack.size() > 2
+			         && !isBraceType(braceTypeStack[braceTypeStack.size() - 2],
 			                         SINGLE_LINE_TYPE))
 				formatArrayRunIn();
 
@@ -5471,12 +5501,12 @@ void ASFormatter::formatArrayBraces(BraceType braceType, bool isOpeningArrayBrac
 	}
 	else if (currentChar == '}')
 	{
-		if (attachClosingBraceMode)
+		if (options.attachClosingBraceMode)
 		{
 			if (isEmptyLine(formattedLine)			// if a blank line precedes this
-			        || isImmediatelyPostPreprocessor
-			        || isCharImmediatelyPostLineComment
-			        || isCharImmediatelyPostComment)
+			        || flags.isImmediatelyPostPreprocessor
+			        || flags.isCharImmediatelyPostLineComment
+			        || flags.isCharImmediatelyPostComment)
 				appendCurrentChar();				// don't attach
 			else
 			{
@@ -5513,7 +5543,7 @@ void ASFormatter::formatRunIn()
 
 	// keep one line blocks returns true without indenting the run-in
 	if (formattingStyle != STYLE_PICO
-	        && !isOkToBreakBlock(braceTypeStack->back()))
+	        && !isOkToBreakBlock(braceTypeStack.back()))
 		return; // true;
 
 	// make sure the line begins with a brace
@@ -5525,19 +5555,19 @@ void ASFormatter::formatRunIn()
 	if (formattedLine.find_first_not_of(" \t{") != std::string::npos)
 		return; // false;
 
-	if (isBraceType(braceTypeStack->back(), NAMESPACE_TYPE))
+	if (isBraceType(braceTypeStack.back(), NAMESPACE_TYPE))
 		return; // false;
 
 	bool extraIndent = false;
 	bool extraHalfIndent = false;
-	isInLineBreak = true;
+	flags.isInLineBreak = true;
 
 	// cannot attach a class modifier without indent-classes
 	if (isCStyle()
 	        && isCharPotentialHeader(currentLine, charNum)
-	        && (isBraceType(braceTypeStack->back(), CLASS_TYPE)
-	            || (isBraceType(braceTypeStack->back(), STRUCT_TYPE)
-	                && isInIndentableStruct)))
+	        && (isBraceType(braceTypeStack.back(), CLASS_TYPE)
+	            || (isBraceType(braceTypeStack.back(), STRUCT_TYPE)
+	                && hints.isInIndentableStruct)))
 	{
 		if (findKeyword(currentLine, charNum, AS_PUBLIC)
 		        || findKeyword(currentLine, charNum, AS_PRIVATE)
@@ -5561,13 +5591,13 @@ void ASFormatter::formatRunIn()
 
 	// extra indent for switch statements
 	if (getSwitchIndent()
-	        && !preBraceHeaderStack->empty()
-	        && preBraceHeaderStack->back() == &AS_SWITCH
+	        && !preBraceHeaderStack.empty()
+	        && preBraceHeaderStack.back() == &AS_SWITCH
 	        && (isLegalNameChar(currentChar)
 	            && !findKeyword(currentLine, charNum, AS_CASE)))
 		extraIndent = true;
 
-	isInLineBreak = false;
+	flags.isInLineBreak = false;
 	// remove for extra whitespace
 	if (formattedLine.length() > lastText + 1
 	        && formattedLine.find_first_not_of(" \t", lastText + 1) == std::string::npos)
@@ -5617,7 +5647,7 @@ void ASFormatter::formatRunIn()
 			runInIndentChars += indentLength_;
 		}
 	}
-	isInBraceRunIn = true;
+	flags.isInBraceRunIn = true;
 }
 
 /**
@@ -5625,7 +5655,7 @@ void ASFormatter::formatRunIn()
  */
 void ASFormatter::formatArrayRunIn()
 {
-	assert(isBraceType(braceTypeStack->back(), ARRAY_TYPE));
+	assert(isBraceType(braceTypeStack.back(), ARRAY_TYPE));
 
 	// make sure the brace is broken
 	if (formattedLine.find_first_not_of(" \t{") != std::string::npos)
@@ -5651,64 +5681,8 @@ void ASFormatter::formatArrayRunIn()
 		formattedLine.append(indent - 1, ' ');
 		runInIndentChars = indent;
 	}
-	isInBraceRunIn = true;
-	isInLineBreak = false;
-}
-
-/**
- * delete a braceTypeStack std::vector object
- * BraceTypeStack did not work with the DeleteContainer template
- */
-void ASFormatter::deleteContainer(std::vector<BraceType>*& container)
-{
-	if (container != nullptr)
-	{
-		container->clear();
-		delete (container);
-		container = nullptr;
-	}
-}
-
-/**
- * delete a std::vector object
- * T is the type of std::vector
- * used for all std::vectors except braceTypeStack
- */
-template<typename T>
-void ASFormatter::deleteContainer(T& container)
-{
-	if (container != nullptr)
-	{
-		container->clear();
-		delete (container);
-		container = nullptr;
-	}
-}
-
-/**
- * initialize a braceType std::vector object
- * braceType did not work with the DeleteContainer template
- */
-void ASFormatter::initContainer(std::vector<BraceType>*& container, std::vector<BraceType>* value)
-{
-	if (container != nullptr)
-		deleteContainer(container);
-	container = value;
-}
-
-/**
- * initialize a std::vector object
- * T is the type of std::vector
- * used for all std::vectors except braceTypeStack
- */
-template<typename T>
-void ASFormatter::initContainer(T& container, T value)
-{
-	// since the ASFormatter object is never deleted,
-	// the existing std::vectors must be deleted before creating new ones
-	if (container != nullptr)
-		deleteContainer(container);
-	container = value;
+	flags.isInBraceRunIn = true;
+	flags.isInLineBreak = false;
 }
 
 /**
@@ -5724,7 +5698,7 @@ void ASFormatter::convertTabToSpaces()
 	assert(currentChar == '\t');
 
 	// do NOT replace if in quotes
-	if (isInQuote || isInQuoteContinuation)
+	if (flags.isInQuote || flags.isInQuoteContinuation)
 		return;
 
 	size_t tabSize = getTabLength();
@@ -5749,7 +5723,7 @@ bool ASFormatter::isOkToBreakBlock(BraceType braceType) const
 		return false;
 	if (!isBraceType(braceType, SINGLE_LINE_TYPE)
 	        || isBraceType(braceType, BREAK_BLOCK_TYPE)
-	        || shouldBreakOneLineBlocks)
+	        || options.shouldBreakOneLineBlocks)
 		return true;
 	return false;
 }
@@ -5771,8 +5745,8 @@ bool ASFormatter::isSharpStyleWithParen(const std::string* header) const
  */
 const std::string* ASFormatter::checkForHeaderFollowingComment(const std::string& firstLine) const
 {
-	assert(isInComment || isInLineComment);
-	assert(shouldBreakElseIfs || shouldBreakBlocks || isInSwitchStatement());
+	assert(flags.isInComment || flags.isInLineComment);
+	assert(options.shouldBreakElseIfs || options.shouldBreakBlocks || isInSwitchStatement());
 	// look ahead to find the next non-comment text
 	bool endOnEmptyLine = (currentHeader == nullptr);
 	if (isInSwitchStatement())
@@ -5802,7 +5776,7 @@ void ASFormatter::processPreprocessor()
 
 	if (currentLine.compare(preproc, 2, "if") == 0)
 	{
-		preprocBraceTypeStackSize = braceTypeStack->size();
+		preprocBraceTypeStackSize = braceTypeStack.size();
 	}
 	else if (currentLine.compare(preproc, 4, "else") == 0)
 	{
@@ -5810,13 +5784,13 @@ void ASFormatter::processPreprocessor()
 		// should be replaced by #else
 		if (preprocBraceTypeStackSize > 0)
 		{
-			int addedPreproc = braceTypeStack->size() - preprocBraceTypeStackSize;
+			int addedPreproc = braceTypeStack.size() - preprocBraceTypeStackSize;
 			for (int i = 0; i < addedPreproc; i++)
-				braceTypeStack->pop_back();
+				braceTypeStack.pop_back();
 		}
 	}
 	else if (currentLine.compare(preproc, 6, "define") == 0)
-		isInPreprocessorDefineDef = true;
+		flags.isInPreprocessorDefineDef = true;
 
 
 }
@@ -5828,7 +5802,7 @@ void ASFormatter::processPreprocessor()
 bool ASFormatter::commentAndHeaderFollows()
 {
 	// called ONLY IF shouldDeleteEmptyLines and shouldBreakBlocks are TRUE.
-	assert(shouldDeleteEmptyLines && shouldBreakBlocks);
+	assert(options.shouldDeleteEmptyLines && options.shouldBreakBlocks);
 
 	// is the next line a comment
 	auto stream = std::make_shared<ASPeekStream>(sourceIterator);
@@ -5852,9 +5826,9 @@ bool ASFormatter::commentAndHeaderFollows()
 		return false;
 
 	// if a closing header, reset break unless break is requested
-	if (isClosingHeader(newHeader) && !shouldBreakClosingHeaderBlocks)
+	if (isClosingHeader(newHeader) && !options.shouldBreakClosingHeaderBlocks)
 	{
-		isAppendPostBlockEmptyLineRequested = false;
+		flags.isAppendPostBlockEmptyLineRequested = false;
 		return false;
 	}
 
@@ -5869,45 +5843,45 @@ bool ASFormatter::commentAndHeaderFollows()
  */
 bool ASFormatter::isCurrentBraceBroken() const
 {
-	assert(braceTypeStack->size() > 1);
+	assert(braceTypeStack.size() > 1);
 
 	bool breakBrace = false;
-	size_t stackEnd = braceTypeStack->size() - 1;
+	size_t stackEnd = braceTypeStack.size() - 1;
 
 	// check brace modifiers
-	if (shouldAttachExternC
-	        && isBraceType((*braceTypeStack)[stackEnd], EXTERN_TYPE))
+	if (options.shouldAttachExternC
+	        && isBraceType(braceTypeStack[stackEnd], EXTERN_TYPE))
 	{
 		return false;
 	}
-	if (shouldAttachNamespace
-	        && isBraceType((*braceTypeStack)[stackEnd], NAMESPACE_TYPE))
+	if (options.shouldAttachNamespace
+	        && isBraceType(braceTypeStack[stackEnd], NAMESPACE_TYPE))
 	{
 		return false;
 	}
-	if (shouldAttachClass
-	        && (isBraceType((*braceTypeStack)[stackEnd], CLASS_TYPE)
-	            || isBraceType((*braceTypeStack)[stackEnd], INTERFACE_TYPE)))
+	if (options.shouldAttachClass
+	        && (isBraceType(braceTypeStack[stackEnd], CLASS_TYPE)
+	            || isBraceType(braceTypeStack[stackEnd], INTERFACE_TYPE)))
 	{
 		return false;
 	}
-	if (shouldAttachInline
+	if (options.shouldAttachInline
 	        && isCStyle()			// for C++ only
 	        && braceFormatMode != RUN_IN_MODE
-	        && !(currentLineBeginsWithBrace && peekNextChar() == '/')
-	        && isBraceType((*braceTypeStack)[stackEnd], COMMAND_TYPE))
+	        && !(flags.currentLineBeginsWithBrace && peekNextChar() == '/')
+	        && isBraceType(braceTypeStack[stackEnd], COMMAND_TYPE))
 	{
 		size_t i;
-		for (i = 1; i < braceTypeStack->size(); i++)
-			if (isBraceType((*braceTypeStack)[i], CLASS_TYPE)
-			        || isBraceType((*braceTypeStack)[i], STRUCT_TYPE))
+		for (i = 1; i < braceTypeStack.size(); i++)
+			if (isBraceType(braceTypeStack[i], CLASS_TYPE)
+			        || isBraceType(braceTypeStack[i], STRUCT_TYPE))
 				return false;
 	}
 
 	// check braces
-	if (isBraceType((*braceTypeStack)[stackEnd], EXTERN_TYPE))
+	if (isBraceType(braceTypeStack[stackEnd], EXTERN_TYPE))
 	{
-		if (currentLineBeginsWithBrace
+		if (flags.currentLineBeginsWithBrace
 		        || braceFormatMode == RUN_IN_MODE)
 		{
 			breakBrace = true;
@@ -5915,7 +5889,7 @@ bool ASFormatter::isCurrentBraceBroken() const
 	}
 	else if (braceFormatMode == NONE_MODE)
 	{
-		if (currentLineBeginsWithBrace
+		if (flags.currentLineBeginsWithBrace
 		        && currentLineFirstBraceNum == (size_t) charNum)
 			{
 				breakBrace = true;
@@ -5928,7 +5902,7 @@ bool ASFormatter::isCurrentBraceBroken() const
 	else if (braceFormatMode == LINUX_MODE)
 	{
 		// break a namespace
-		if (isBraceType((*braceTypeStack)[stackEnd], NAMESPACE_TYPE))
+		if (isBraceType(braceTypeStack[stackEnd], NAMESPACE_TYPE))
 		{
 			if (formattingStyle != STYLE_STROUSTRUP
 			        && formattingStyle != STYLE_MOZILLA
@@ -5938,8 +5912,8 @@ bool ASFormatter::isCurrentBraceBroken() const
 				}
 		}
 		// break a class or interface
-		else if (isBraceType((*braceTypeStack)[stackEnd], CLASS_TYPE)
-		         || isBraceType((*braceTypeStack)[stackEnd], INTERFACE_TYPE))
+		else if (isBraceType(braceTypeStack[stackEnd], CLASS_TYPE)
+		         || isBraceType(braceTypeStack[stackEnd], INTERFACE_TYPE))
 		{
 			if (formattingStyle != STYLE_STROUSTRUP
 			        && formattingStyle != STYLE_WEBKIT)
@@ -5948,7 +5922,7 @@ bool ASFormatter::isCurrentBraceBroken() const
 				}
 		}
 		// break a struct if mozilla - an enum is processed as an array brace
-		else if (isBraceType((*braceTypeStack)[stackEnd], STRUCT_TYPE))
+		else if (isBraceType(braceTypeStack[stackEnd], STRUCT_TYPE))
 		{
 			if (formattingStyle == STYLE_MOZILLA)
 				{
@@ -5956,7 +5930,7 @@ bool ASFormatter::isCurrentBraceBroken() const
 				}
 		}
 		// break the first brace if a function
-		else if (isBraceType((*braceTypeStack)[stackEnd], COMMAND_TYPE))
+		else if (isBraceType(braceTypeStack[stackEnd], COMMAND_TYPE))
 		{
 			if (stackEnd == 1)
 			{
@@ -5965,11 +5939,11 @@ bool ASFormatter::isCurrentBraceBroken() const
 			else if (stackEnd > 1)
 			{
 				// break the first brace after these if a function
-				if (isBraceType((*braceTypeStack)[stackEnd - 1], NAMESPACE_TYPE)
-				        || isBraceType((*braceTypeStack)[stackEnd - 1], CLASS_TYPE)
-				        || (isBraceType((*braceTypeStack)[stackEnd - 1], ARRAY_TYPE) && !lambdaIndicator)
-				        || isBraceType((*braceTypeStack)[stackEnd - 1], STRUCT_TYPE)
-				        || isBraceType((*braceTypeStack)[stackEnd - 1], EXTERN_TYPE)
+				if (isBraceType(braceTypeStack[stackEnd - 1], NAMESPACE_TYPE)
+				        || isBraceType(braceTypeStack[stackEnd - 1], CLASS_TYPE)
+				        || (isBraceType(braceTypeStack[stackEnd - 1], ARRAY_TYPE) && !lambdaIndicator)
+				        || isBraceType(braceTypeStack[stackEnd - 1], STRUCT_TYPE)
+				        || isBraceType(braceTypeStack[stackEnd - 1], EXTERN_TYPE)
 						)
 				{
 					breakBrace = true;
@@ -5988,7 +5962,7 @@ bool ASFormatter::isCurrentBraceBroken() const
  */
 void ASFormatter::formatCommentBody()
 {
-	assert(isInComment);
+	assert(flags.isInComment);
 
 	// append the comment
 	while (charNum < (int) currentLine.length())
@@ -5999,12 +5973,12 @@ void ASFormatter::formatCommentBody()
 			formatCommentCloser();
 			break;
 		}
-		if (currentChar == '\t' && shouldConvertTabs)
+		if (currentChar == '\t' && options.shouldConvertTabs)
 			convertTabToSpaces();
 		appendCurrentChar();
 		++charNum;
 	}
-	if (shouldStripCommentPrefix)
+	if (options.shouldStripCommentPrefix)
 		stripCommentPrefix();
 }
 
@@ -6017,8 +5991,8 @@ void ASFormatter::formatCommentOpener()
 {
 	assert(isSequenceReached("/*"));
 
-	isInComment = isInCommentStartLine = true;
-	isImmediatelyPostLineComment = false;
+	flags.isInComment = flags.isInCommentStartLine = true;
+	flags.isImmediatelyPostLineComment = false;
 	if (previousNonWSChar == '}')
 		resetEndOfStatement();
 
@@ -6026,42 +6000,42 @@ void ASFormatter::formatCommentOpener()
 	// For speed do not check multiple comment lines more than once.
 	// For speed do not check shouldBreakBlocks if previous line is empty, a comment, or a '{'.
 	const std::string* followingHeader = nullptr;
-	if ((doesLineStartComment
-	        && !isImmediatelyPostCommentOnly
-	        && isBraceType(braceTypeStack->back(), COMMAND_TYPE))
-	        && (shouldBreakElseIfs
+	if ((flags.doesLineStartComment
+	        && !flags.isImmediatelyPostCommentOnly
+	        && isBraceType(braceTypeStack.back(), COMMAND_TYPE))
+	        && (options.shouldBreakElseIfs
 	            || isInSwitchStatement()
-	            || (shouldBreakBlocks
-	                && !isImmediatelyPostEmptyLine
+	            || (options.shouldBreakBlocks
+	                && !flags.isImmediatelyPostEmptyLine
 	                && previousCommandChar != '{')))
 		followingHeader = checkForHeaderFollowingComment(currentLine.substr(charNum));
 
-	if (spacePadNum != 0 && !isInLineBreak)
+	if (spacePadNum != 0 && !flags.isInLineBreak)
 		adjustComments();
 	formattedLineCommentNum = formattedLine.length();
 
 	// must be done BEFORE appendSequence
 	if (previousCommandChar == '{'
-	        && !isImmediatelyPostComment
-	        && !isImmediatelyPostLineComment)
+	        && !flags.isImmediatelyPostComment
+	        && !flags.isImmediatelyPostLineComment)
 	{
-		if (isBraceType(braceTypeStack->back(), NAMESPACE_TYPE))
+		if (isBraceType(braceTypeStack.back(), NAMESPACE_TYPE))
 		{
 			// namespace run-in is always broken.
-			isInLineBreak = true;
+			flags.isInLineBreak = true;
 		}
 		else if (braceFormatMode == NONE_MODE)
 		{
 			// should a run-in statement be attached?
-			if (currentLineBeginsWithBrace)
+			if (flags.currentLineBeginsWithBrace)
 				formatRunIn();
 		}
 		else if (braceFormatMode == ATTACH_MODE)
 		{
 			// if the brace was not attached?
 			if (formattedLine.length() > 0 && formattedLine[0] == '{'
-			        && !isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE))
-				isInLineBreak = true;
+			        && !isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE))
+				flags.isInLineBreak = true;
 		}
 		else if (braceFormatMode == RUN_IN_MODE)
 		{
@@ -6070,14 +6044,14 @@ void ASFormatter::formatCommentOpener()
 				formatRunIn();
 		}
 	}
-	else if (!doesLineStartComment)
-		noTrimCommentContinuation = true;
+	else if (!flags.doesLineStartComment)
+		flags.noTrimCommentContinuation = true;
 
 	// ASBeautifier needs to know the following statements
-	if (shouldBreakElseIfs && followingHeader == &AS_ELSE)
-		elseHeaderFollowsComments = true;
+	if (options.shouldBreakElseIfs && followingHeader == &AS_ELSE)
+		flags.elseHeaderFollowsComments = true;
 	if (followingHeader == &AS_CASE || followingHeader == &AS_DEFAULT)
-		caseHeaderFollowsComments = true;
+		flags.caseHeaderFollowsComments = true;
 
 	// appendSequence will write the previous line
 	appendSequence(AS_OPEN_COMMENT);
@@ -6087,19 +6061,19 @@ void ASFormatter::formatCommentOpener()
 
 	// Break before the comment if a header follows the line comment.
 	// But not break if previous line is empty, a comment, or a '{'.
-	if (shouldBreakBlocks
+	if (options.shouldBreakBlocks
 	        && followingHeader != nullptr
-	        && !isImmediatelyPostEmptyLine
+	        && !flags.isImmediatelyPostEmptyLine
 	        && previousCommandChar != '{')
 	{
 		if (isClosingHeader(followingHeader))
 		{
-			if (!shouldBreakClosingHeaderBlocks)
-				isPrependPostBlockEmptyLineRequested = false;
+			if (!options.shouldBreakClosingHeaderBlocks)
+				flags.isPrependPostBlockEmptyLineRequested = false;
 		}
 		// if an opening header, break before the comment
 		else
-			isPrependPostBlockEmptyLineRequested = true;
+			flags.isPrependPostBlockEmptyLineRequested = true;
 	}
 
 	if (previousCommandChar == '}')
@@ -6113,22 +6087,22 @@ void ASFormatter::formatCommentOpener()
 void ASFormatter::formatCommentCloser()
 {
 	assert(isSequenceReached("*/"));
-	isInComment = false;
-	noTrimCommentContinuation = false;
-	isImmediatelyPostComment = true;
+	flags.isInComment = false;
+	flags.noTrimCommentContinuation = false;
+	flags.isImmediatelyPostComment = true;
 	appendSequence(AS_CLOSE_COMMENT);
 	goForward(1);
-	if (doesLineStartComment
+	if (flags.doesLineStartComment
 	        && (currentLine.find_first_not_of(" \t", charNum + 1) == std::string::npos))
-		lineEndsInCommentOnly = true;
+		flags.lineEndsInCommentOnly = true;
 	if (peekNextChar() == '}'
 	        && previousCommandChar != ';'
-	        && !isBraceType(braceTypeStack->back(), ARRAY_TYPE)
-	        && !isInPreprocessor
-	        && isOkToBreakBlock(braceTypeStack->back()))
+	        && !isBraceType(braceTypeStack.back(), ARRAY_TYPE)
+	        && !flags.isInPreprocessor
+	        && isOkToBreakBlock(braceTypeStack.back()))
 	{
-		isInLineBreak = true;
-		shouldBreakLineAtNextChar = true;
+		flags.isInLineBreak = true;
+		flags.shouldBreakLineAtNextChar = true;
 	}
 }
 
@@ -6138,14 +6112,14 @@ void ASFormatter::formatCommentCloser()
  */
 void ASFormatter::formatLineCommentBody()
 {
-	assert(isInLineComment);
+	assert(flags.isInLineComment);
 
 	// append the comment
 	while (charNum < (int) currentLine.length())
 //	        && !isLineReady	// commented out in release 2.04, unnecessary
 	{
 		currentChar = currentLine[charNum];
-		if (currentChar == '\t' && shouldConvertTabs)
+		if (currentChar == '\t' && options.shouldConvertTabs)
 			convertTabToSpaces();
 		appendCurrentChar();
 		++charNum;
@@ -6154,9 +6128,9 @@ void ASFormatter::formatLineCommentBody()
 	// explicitly break a line when a line comment's end is found.
 	if (charNum == (int) currentLine.length())
 	{
-		isInLineBreak = true;
-		isInLineComment = false;
-		isImmediatelyPostLineComment = true;
+		flags.isInLineBreak = true;
+		flags.isInLineComment = false;
+		flags.isImmediatelyPostLineComment = true;
 		currentChar = 0;  //make sure it is a neutral char.
 	}
 }
@@ -6172,10 +6146,10 @@ void ASFormatter::formatLineCommentOpener()
 
 	if ((int) currentLine.length() > charNum + 2
 	        && currentLine[charNum + 2] == '\xf2')     // check for windows line marker
-		isAppendPostBlockEmptyLineRequested = false;
+		flags.isAppendPostBlockEmptyLineRequested = false;
 
-	isInLineComment = true;
-	isCharImmediatelyPostComment = false;
+	flags.isInLineComment = true;
+	flags.isCharImmediatelyPostComment = false;
 	if (previousNonWSChar == '}')
 		resetEndOfStatement();
 
@@ -6183,66 +6157,66 @@ void ASFormatter::formatLineCommentOpener()
 	// For speed do not check multiple comment lines more than once.
 	// For speed do not check shouldBreakBlocks if previous line is empty, a comment, or a '{'.
 	const std::string* followingHeader = nullptr;
-	if ((lineIsLineCommentOnly
-	        && !isImmediatelyPostCommentOnly
-	        && isBraceType(braceTypeStack->back(), COMMAND_TYPE))
-	        && (shouldBreakElseIfs
+	if ((flags.lineIsLineCommentOnly
+	        && !flags.isImmediatelyPostCommentOnly
+	        && isBraceType(braceTypeStack.back(), COMMAND_TYPE))
+	        && (options.shouldBreakElseIfs
 	            || isInSwitchStatement()
-	            || (shouldBreakBlocks
-	                && !isImmediatelyPostEmptyLine
+	            || (options.shouldBreakBlocks
+	                && !flags.isImmediatelyPostEmptyLine
 	                && previousCommandChar != '{')))
 		followingHeader = checkForHeaderFollowingComment(currentLine.substr(charNum));
 
 	// do not indent if in column 1 or 2
 	// or in a namespace before the opening brace
-	if ((!shouldIndentCol1Comments && !lineCommentNoIndent)
-	        || foundNamespaceHeader)
+	if ((!options.shouldIndentCol1Comments && !flags.lineCommentNoIndent)
+	        || flags.foundNamespaceHeader)
 	{
 		if (charNum == 0)
-			lineCommentNoIndent = true;
+			flags.lineCommentNoIndent = true;
 		else if (charNum == 1 && currentLine[0] == ' ')
-			lineCommentNoIndent = true;
+			flags.lineCommentNoIndent = true;
 	}
 	// move comment if spaces were added or deleted
-	if (!lineCommentNoIndent && spacePadNum != 0 && !isInLineBreak)
+	if (!flags.lineCommentNoIndent && spacePadNum != 0 && !flags.isInLineBreak)
 		adjustComments();
 	formattedLineCommentNum = formattedLine.length();
 
 	// must be done BEFORE appendSequence
 	// check for run-in statement
 	if (previousCommandChar == '{'
-	        && !isImmediatelyPostComment
-	        && !isImmediatelyPostLineComment)
+	        && !flags.isImmediatelyPostComment
+	        && !flags.isImmediatelyPostLineComment)
 	{
 		if (braceFormatMode == NONE_MODE)
 		{
-			if (currentLineBeginsWithBrace)
+			if (flags.currentLineBeginsWithBrace)
 				formatRunIn();
 		}
 		else if (braceFormatMode == RUN_IN_MODE)
 		{
-			if (!lineCommentNoIndent)
+			if (!flags.lineCommentNoIndent)
 				formatRunIn();
 			else
-				isInLineBreak = true;
+				flags.isInLineBreak = true;
 		}
 		else if (braceFormatMode == BREAK_MODE)
 		{
 			if (formattedLine.length() > 0 && formattedLine[0] == '{')
-				isInLineBreak = true;
+				flags.isInLineBreak = true;
 		}
 		else
 		{
-			if (currentLineBeginsWithBrace)
-				isInLineBreak = true;
+			if (flags.currentLineBeginsWithBrace)
+				flags.isInLineBreak = true;
 		}
 	}
 
 	// ASBeautifier needs to know the following statements
-	if (shouldBreakElseIfs && followingHeader == &AS_ELSE)
-		elseHeaderFollowsComments = true;
+	if (options.shouldBreakElseIfs && followingHeader == &AS_ELSE)
+		flags.elseHeaderFollowsComments = true;
 	if (followingHeader == &AS_CASE || followingHeader == &AS_DEFAULT)
-		caseHeaderFollowsComments = true;
+		flags.caseHeaderFollowsComments = true;
 
 	// appendSequence will write the previous line
 	appendSequence(AS_OPEN_LINE_COMMENT);
@@ -6252,26 +6226,26 @@ void ASFormatter::formatLineCommentOpener()
 
 	// Break before the comment if a header follows the line comment.
 	// But do not break if previous line is empty, a comment, or a '{'.
-	if (shouldBreakBlocks
+	if (options.shouldBreakBlocks
 	        && followingHeader != nullptr
-	        && !isImmediatelyPostEmptyLine
+	        && !flags.isImmediatelyPostEmptyLine
 	        && previousCommandChar != '{')
 	{
 		if (isClosingHeader(followingHeader))
 		{
-			if (!shouldBreakClosingHeaderBlocks)
-				isPrependPostBlockEmptyLineRequested = false;
+			if (!options.shouldBreakClosingHeaderBlocks)
+				flags.isPrependPostBlockEmptyLineRequested = false;
 		}
 		// if an opening header, break before the comment
 		else
-			isPrependPostBlockEmptyLineRequested = true;
+			flags.isPrependPostBlockEmptyLineRequested = true;
 	}
 
 	if (previousCommandChar == '}')
 		currentHeader = nullptr;
 
 	// if tabbed input don't convert the immediately following tabs to spaces
-	if (getIndentString() == "\t" && lineCommentNoIndent)
+	if (getIndentString() == "\t" && flags.lineCommentNoIndent)
 	{
 		while (charNum + 1 < (int) currentLine.length()
 		        && currentLine[charNum + 1] == '\t')
@@ -6284,9 +6258,9 @@ void ASFormatter::formatLineCommentOpener()
 	// explicitly break a line when a line comment's end is found.
 	if (charNum + 1 == (int) currentLine.length())
 	{
-		isInLineBreak = true;
-		isInLineComment = false;
-		isImmediatelyPostLineComment = true;
+		flags.isInLineBreak = true;
+		flags.isInLineComment = false;
+		flags.isImmediatelyPostLineComment = true;
 		currentChar = 0;  //make sure it is a neutral char.
 	}
 }
@@ -6297,27 +6271,27 @@ void ASFormatter::formatLineCommentOpener()
  */
 void ASFormatter::formatQuoteBody()
 {
-	assert(isInQuote);
+	assert(flags.isInQuote);
 
 	int _braceCount = 0;
 
-	if (checkInterpolation && currentChar == '{')
+	if (flags.checkInterpolation && currentChar == '{')
 	{
 		++_braceCount;
 	}
 
-	if (isSpecialChar)
+	if (flags.isSpecialChar)
 	{
-		isSpecialChar = false;
+		flags.isSpecialChar = false;
 	}
-	else if (currentChar == '\\' && !isInVerbatimQuote)
+	else if (currentChar == '\\' && !flags.isInVerbatimQuote)
 	{
 		if (peekNextChar() == ' ')              // is this '\' at end of line
-			haveLineContinuationChar = true;
+			flags.haveLineContinuationChar = true;
 		else
-			isSpecialChar = true;
+			flags.isSpecialChar = true;
 	}
-	else if (isInVerbatimQuote && currentChar == '"' )
+	else if (flags.isInVerbatimQuote && currentChar == '"' )
 	{
 		if (isCStyle())
 		{
@@ -6325,9 +6299,9 @@ void ASFormatter::formatQuoteBody()
 			int delimStart = charNum - delim.length();
 			if (delimStart > 0 && currentLine.substr(delimStart, delim.length()) == delim)
 			{
-				isInQuote = false;
-				isInVerbatimQuote = false;
-				checkInterpolation = false;
+				flags.isInQuote = false;
+				flags.isInVerbatimQuote = false;
+				flags.checkInterpolation = false;
 			}
 		}
 		else if (isSharpStyle() )       // GH16
@@ -6341,25 +6315,25 @@ void ASFormatter::formatQuoteBody()
 			}
 
 			//if ( charNum>0 && currentLine[charNum - 1] != '\\')
-				isInQuote = false;
+				flags.isInQuote = false;
 
-			if (checkInterpolation)
-				isInVerbatimQuote = false;
+			if (flags.checkInterpolation)
+				flags.isInVerbatimQuote = false;
 
-			checkInterpolation = false;
+			flags.checkInterpolation = false;
 		}
 	}
 	else if (quoteChar == currentChar)
 	{
 		////do not quit if we have CS std::string with interpolation
-		isInQuote = false;
+		flags.isInQuote = false;
 	}
 
 	appendCurrentChar();
 
 	// append the text to the ending quoteChar or an escape sequence
 	// tabs in quotes are NOT changed by convert-tabs
-	if (isInQuote && currentChar != '\\')
+	if (flags.isInQuote && currentChar != '\\')
 	{
 		while (charNum + 1 < (int) currentLine.length()
 		        && ( currentLine[charNum + 1] != quoteChar || _braceCount > 0 )
@@ -6367,7 +6341,7 @@ void ASFormatter::formatQuoteBody()
 		{
 			currentChar = currentLine[++charNum];
 
-			if (checkInterpolation)
+			if (flags.checkInterpolation)
 			{
 				if (currentChar == '{')
 					++_braceCount;
@@ -6380,9 +6354,9 @@ void ASFormatter::formatQuoteBody()
 	}
 	if (charNum + 1 >= (int) currentLine.length()
 	        && currentChar != '\\'
-	        && !isInVerbatimQuote)
+	        && !flags.isInVerbatimQuote)
 	{
-		isInQuote = false;				// missing closing quote
+		flags.isInQuote = false;				// missing closing quote
 	}
 
 }
@@ -6397,35 +6371,35 @@ void ASFormatter::formatQuoteOpener()
 	assert(currentChar == '"'
 	       || (currentChar == '\'' && !isDigitSeparator(currentLine, charNum)));
 
-	isInQuote = true;
+	flags.isInQuote = true;
 	quoteChar = currentChar;
 	if (isCStyle() && previousChar == 'R')
 	{
 		int parenPos = currentLine.find('(', charNum);
 		if (parenPos != -1)
 		{
-			isInVerbatimQuote = true;
+			flags.isInVerbatimQuote = true;
 			verbatimDelimiter = currentLine.substr(charNum + 1, parenPos - charNum - 1);
 		}
 	}
 	else if (isSharpStyle() && (previousChar == '@' ))
 	{
-		isInVerbatimQuote = true;
-		checkInterpolation = true;
+		flags.isInVerbatimQuote = true;
+		flags.checkInterpolation = true;
 	}
 
 
 	// a quote following a brace is an array
 	if (previousCommandChar == '{'
-	        && !isImmediatelyPostComment
-	        && !isImmediatelyPostLineComment
-	        && isNonInStatementArray
-	        && !isBraceType(braceTypeStack->back(), SINGLE_LINE_TYPE)
+	        && !flags.isImmediatelyPostComment
+	        && !flags.isImmediatelyPostLineComment
+	        && hints.isNonInStatementArray
+	        && !isBraceType(braceTypeStack.back(), SINGLE_LINE_TYPE)
 	        && !isWhiteSpace(peekNextChar()))
 	{
 		if (braceFormatMode == NONE_MODE)
 		{
-			if (currentLineBeginsWithBrace)
+			if (flags.currentLineBeginsWithBrace)
 				formatRunIn();
 		}
 		else if (braceFormatMode == RUN_IN_MODE)
@@ -6435,12 +6409,12 @@ void ASFormatter::formatQuoteOpener()
 		else if (braceFormatMode == BREAK_MODE)
 		{
 			if (formattedLine.length() > 0 && formattedLine[0] == '{')
-				isInLineBreak = true;
+				flags.isInLineBreak = true;
 		}
 		else
 		{
-			if (currentLineBeginsWithBrace)
-				isInLineBreak = true;
+			if (flags.currentLineBeginsWithBrace)
+				flags.isInLineBreak = true;
 		}
 	}
 	previousCommandChar = ' ';
@@ -6454,7 +6428,7 @@ void ASFormatter::formatQuoteOpener()
  */
 int ASFormatter::getNextLineCommentAdjustment()
 {
-	assert(foundClosingHeader && previousNonWSChar == '}');
+	assert(flags.foundClosingHeader && previousNonWSChar == '}');
 	if (charNum < 1)			// "else" is in column 1
 		return 0;
 	size_t lastBrace = currentLine.rfind('}', charNum - 1);
@@ -6478,7 +6452,7 @@ LineEndFormat ASFormatter::getLineEndFormat() const
  */
 int ASFormatter::getCurrentLineCommentAdjustment()
 {
-	assert(foundClosingHeader && previousNonWSChar == '}');
+	assert(flags.foundClosingHeader && previousNonWSChar == '}');
 	if (charNum < 1)
 		return 2;
 	size_t lastBrace = currentLine.rfind('}', charNum - 1);
@@ -6521,9 +6495,9 @@ std::string ASFormatter::getPreviousWord(const std::string& line, int currPos) c
  */
 void ASFormatter::isLineBreakBeforeClosingHeader()
 {
-	assert(foundClosingHeader && previousNonWSChar == '}');
+	assert(flags.foundClosingHeader && previousNonWSChar == '}');
 
-	if (currentHeader == &AS_WHILE && shouldAttachClosingWhile)
+	if (currentHeader == &AS_WHILE && options.shouldAttachClosingWhile)
 	{
 		appendClosingHeader();
 		return;
@@ -6531,16 +6505,16 @@ void ASFormatter::isLineBreakBeforeClosingHeader()
 
 	if (braceFormatMode == BREAK_MODE
 	        || braceFormatMode == RUN_IN_MODE
-	        || attachClosingBraceMode)
+	        || options.attachClosingBraceMode)
 	{
-		isInLineBreak = true;
+		flags.isInLineBreak = true;
 	}
 	else if (braceFormatMode == NONE_MODE)
 	{
-		if (shouldBreakClosingHeaderBraces
+		if (options.shouldBreakClosingHeaderBraces
 		        || getBraceIndent() || getBlockIndent())
 		{
-			isInLineBreak = true;
+			flags.isInLineBreak = true;
 		}
 		else
 		{
@@ -6548,25 +6522,25 @@ void ASFormatter::isLineBreakBeforeClosingHeader()
 			// is closing brace broken?
 			size_t i = currentLine.find_first_not_of(" \t");
 			if (i != std::string::npos && currentLine[i] == '}')
-				isInLineBreak = false;
+				flags.isInLineBreak = false;
 
-			if (shouldBreakBlocks)
-				isAppendPostBlockEmptyLineRequested = false;
+			if (options.shouldBreakBlocks)
+				flags.isAppendPostBlockEmptyLineRequested = false;
 		}
 	}
 	// braceFormatMode == ATTACH_MODE, LINUX_MODE
 	else
 	{
-		if (shouldBreakClosingHeaderBraces
+		if (options.shouldBreakClosingHeaderBraces
 		        || getBraceIndent() || getBlockIndent())
 		{
-			isInLineBreak = true;
+			flags.isInLineBreak = true;
 		}
 		else
 		{
 			appendClosingHeader();
-			if (shouldBreakBlocks)
-				isAppendPostBlockEmptyLineRequested = false;
+			if (options.shouldBreakBlocks)
+				flags.isAppendPostBlockEmptyLineRequested = false;
 		}
 	}
 }
@@ -6586,7 +6560,7 @@ void ASFormatter::appendClosingHeader()
 	if (!previousLineIsEmpty
 	    && previousLineIsOneLineBlock == 0)
 	{
-		isInLineBreak = false;
+		flags.isInLineBreak = false;
 		appendSpacePad();
 		spacePadNum = 0;	// don't count as comment padding
 	}
@@ -6599,7 +6573,7 @@ void ASFormatter::appendClosingHeader()
  */
 bool ASFormatter::addBracesToStatement()
 {
-	assert(isImmediatelyPostHeader);
+	assert(flags.isImmediatelyPostHeader);
 
 	if (currentHeader != &AS_IF
 	        && currentHeader != &AS_ELSE
@@ -6612,7 +6586,7 @@ bool ASFormatter::addBracesToStatement()
 	        && currentHeader != &AS_FOREVER)
 		return false;
 
-	if (currentHeader == &AS_WHILE && foundClosingHeader)	// do-while
+	if (currentHeader == &AS_WHILE && flags.foundClosingHeader)	// do-while
 		return false;
 
 	// do not brace an empty statement
@@ -6641,9 +6615,9 @@ bool ASFormatter::addBracesToStatement()
 	assert(computeChecksumIn("{}"));
 	currentChar = '{';
 	if ((int) currentLine.find_first_not_of(" \t") == charNum)
-		currentLineBeginsWithBrace = true;
+		flags.currentLineBeginsWithBrace = true;
 	// remove extra spaces
-	if (!shouldAddOneLineBraces)
+	if (!options.shouldAddOneLineBraces)
 	{
 		size_t lastText = formattedLine.find_last_not_of(" \t");
 		if ((formattedLine.length() - 1) - lastText > 1)
@@ -6659,7 +6633,7 @@ bool ASFormatter::addBracesToStatement()
  */
 bool ASFormatter::removeBracesFromStatement()
 {
-	assert(isImmediatelyPostHeader);
+	assert(flags.isImmediatelyPostHeader);
 	assert(currentChar == '{');
 
 	if (currentHeader != &AS_IF
@@ -6669,13 +6643,13 @@ bool ASFormatter::removeBracesFromStatement()
 	        && currentHeader != &AS_FOREACH)
 		return false;
 
-	if (currentHeader == &AS_WHILE && foundClosingHeader)	// do-while
+	if (currentHeader == &AS_WHILE && flags.foundClosingHeader)	// do-while
 		return false;
 
 	bool isFirstLine = true;
 	std::string nextLine_;
 	// leave nextLine_ empty if end of line comment follows
-	if (!isBeforeAnyLineEndComment(charNum) || currentLineBeginsWithBrace)
+	if (!isBeforeAnyLineEndComment(charNum) || flags.currentLineBeginsWithBrace)
 		nextLine_ = currentLine.substr(charNum + 1);
 	size_t nextChar = 0;
 
@@ -6798,10 +6772,10 @@ size_t ASFormatter::findNextChar(const std::string& line, char searchChar, int s
  */
 void ASFormatter::findReturnTypeSplitPoint(const std::string& firstLine)
 {
-	assert((isBraceType(braceTypeStack->back(), NULL_TYPE)
-	        || isBraceType(braceTypeStack->back(), DEFINITION_TYPE)));
-	assert(shouldBreakReturnType || shouldBreakReturnTypeDecl
-	       || shouldAttachReturnType || shouldAttachReturnTypeDecl);
+	assert((isBraceType(braceTypeStack.back(), NULL_TYPE)
+	        || isBraceType(braceTypeStack.back(), DEFINITION_TYPE)));
+	assert(options.shouldBreakReturnType || options.shouldBreakReturnTypeDecl
+	       || options.shouldAttachReturnType || options.shouldAttachReturnTypeDecl);
 
 	bool isFirstLine     = true;
 	bool isInComment_    = false;
@@ -6838,7 +6812,7 @@ void ASFormatter::findReturnTypeSplitPoint(const std::string& firstLine)
 		if (line[firstCharNum] == '#')
 		{
 			// don't attach to a preprocessor
-			if (shouldAttachReturnType || shouldAttachReturnTypeDecl)
+			if (options.shouldAttachReturnType || options.shouldAttachReturnTypeDecl)
 				return;
 			continue;
 		}
@@ -6850,7 +6824,7 @@ void ASFormatter::findReturnTypeSplitPoint(const std::string& firstLine)
 				prevNonWSChar = currNonWSChar;
 				currNonWSChar = line[i];
 			}
-			else if (line[i] == '\t' && shouldConvertTabs)
+			else if (line[i] == '\t' && options.shouldConvertTabs)
 			{
 				size_t tabSize = getTabLength();
 				size_t numSpaces = tabSize - ((tabIncrementIn + i) % tabSize);
@@ -7039,13 +7013,13 @@ void ASFormatter::findReturnTypeSplitPoint(const std::string& firstLine)
 			}
 			if (line[i] == '{')
 			{
-				if (shouldBreakReturnType && foundSplitPoint && !isAlreadyBroken)
+				if (options.shouldBreakReturnType && foundSplitPoint && !isAlreadyBroken)
 				{
 					methodBreakCharNum = breakCharNum;
 					methodBreakLineNum = breakLineNum;
 				}
 
-				if (shouldAttachReturnType && foundSplitPoint && isAlreadyBroken)
+				if (options.shouldAttachReturnType && foundSplitPoint && isAlreadyBroken)
 				{
 					//https://sourceforge.net/p/astyle/bugs/545/
 					if ((maxCodeLength != std::string::npos && previousReadyFormattedLineLength < maxCodeLength) || maxCodeLength == std::string::npos)
@@ -7058,12 +7032,12 @@ void ASFormatter::findReturnTypeSplitPoint(const std::string& firstLine)
 			}
 			if (line[i] == ';')
 			{
-				if (shouldBreakReturnTypeDecl && foundSplitPoint && !isAlreadyBroken)
+				if (options.shouldBreakReturnTypeDecl && foundSplitPoint && !isAlreadyBroken)
 				{
 					methodBreakCharNum = breakCharNum;
 					methodBreakLineNum = breakLineNum;
 				}
-				if (shouldAttachReturnTypeDecl && foundSplitPoint && isAlreadyBroken)
+				if (options.shouldAttachReturnTypeDecl && foundSplitPoint && isAlreadyBroken)
 				{
 					methodAttachCharNum = breakCharNum;
 					methodAttachLineNum = breakLineNum;
@@ -7251,10 +7225,10 @@ bool ASFormatter::isIndentablePreprocessorBlock(const std::string& firstLine, si
 					numBlockIndents += 1;
 					isInIndentableBlock = true;
 					// flag first preprocessor conditional for header include guard check
-					if (!processedFirstConditional)
+					if (!flags.processedFirstConditional)
 					{
-						processedFirstConditional = true;
-						isFirstPreprocConditional = true;
+						flags.processedFirstConditional = true;
+						flags.isFirstPreprocConditional = true;
 						if (isNDefPreprocStatement(nextLine_, preproc))
 							isPotentialHeaderGuard = true;
 					}
@@ -7314,9 +7288,9 @@ EndOfWhileLoop:
 	// this WILL RESET the get pointer
 	std::string nextText = peekNextText("", false, stream);
 	// bypass header include guards
-	if (isFirstPreprocConditional)
+	if (flags.isFirstPreprocConditional)
 	{
-		isFirstPreprocConditional = false;
+		flags.isFirstPreprocConditional = false;
 		if (nextText.empty() && isPotentialHeaderGuard2)
 		{
 			isInIndentableBlock = false;
@@ -7481,7 +7455,7 @@ bool ASFormatter::isImmediatelyPostCast() const
  */
 void ASFormatter::checkIfTemplateOpener()
 {
-	assert(!isInTemplate && currentChar == '<');
+	assert(!flags.isInTemplate && currentChar == '<');
 
 	// find first char after the '<' operators
 	size_t firstChar = currentLine.find_first_not_of("< \t", charNum);
@@ -7489,7 +7463,7 @@ void ASFormatter::checkIfTemplateOpener()
 	        || currentLine[firstChar] == '=')
 	{
 		// this is not a template -> leave...
-		isInTemplate = false;
+		flags.isInTemplate = false;
 		return;
 	}
 
@@ -7568,7 +7542,7 @@ void ASFormatter::checkIfTemplateOpener()
 					if (parenDepth_ == 0)
 					{
 						// this is a template!
-						isInTemplate = true;
+						flags.isInTemplate = true;
 						templateDepth = maxTemplateDepth;
 					}
 					return;
@@ -7584,7 +7558,7 @@ void ASFormatter::checkIfTemplateOpener()
 				if (parenDepth_ >= 0)
 					continue;
 				// this is not a template -> leave...
-				isInTemplate = false;
+				flags.isInTemplate = false;
 				templateDepth = 0;
 				return;
 			}
@@ -7592,7 +7566,7 @@ void ASFormatter::checkIfTemplateOpener()
 			        || nextLine_.compare(i, 2, AS_OR) == 0)
 			{
 				// this is not a template -> leave...
-				isInTemplate = false;
+				flags.isInTemplate = false;
 				templateDepth = 0;
 				return;
 			}
@@ -7615,7 +7589,7 @@ void ASFormatter::checkIfTemplateOpener()
 			if (!isLegalNameChar(currentChar_))
 			{
 				// this is not a template -> leave...
-				isInTemplate = false;
+				flags.isInTemplate = false;
 				templateDepth = 0;
 				return;
 			}
@@ -7746,7 +7720,7 @@ void ASFormatter::updateFormattedLineSplitPointsOperator(const std::string& sequ
 	// check for logical conditional
 	if (sequence == "||" || sequence == "&&" || sequence == "or" || sequence == "and")
 	{
-		if (shouldBreakLineAfterLogical)
+		if (options.shouldBreakLineAfterLogical)
 		{
 			if (formattedLine.length() <= maxCodeLength)
 				maxAndOr = formattedLine.length();
@@ -7848,27 +7822,27 @@ bool ASFormatter::isOkToSplitFormattedLine()
 {
 	assert(maxCodeLength != std::string::npos);
 	// Is it OK to split the line?
-	if (shouldKeepLineUnbroken
-	        || isInLineComment
-	        || isInComment
-	        || isInQuote
-	        || isInCase
-	        || isInPreprocessor
-	        || isInExecSQL
-	        || isInAsm || isInAsmOneLine || isInAsmBlock
-	        || isInTemplate)
+	if (flags.shouldKeepLineUnbroken
+	        || flags.isInLineComment
+	        || flags.isInComment
+	        || flags.isInQuote
+	        || flags.isInCase
+	        || flags.isInPreprocessor
+	        || flags.isInExecSQL
+	        || flags.isInAsm || flags.isInAsmOneLine || flags.isInAsmBlock
+	        || flags.isInTemplate)
 		return false;
 
-	if (!isOkToBreakBlock(braceTypeStack->back()) && currentChar != '{')
+	if (!isOkToBreakBlock(braceTypeStack.back()) && currentChar != '{')
 	{
-		shouldKeepLineUnbroken = true;
+		flags.shouldKeepLineUnbroken = true;
 		clearFormattedLineSplitPoints();
 		return false;
 	}
-	if (isBraceType(braceTypeStack->back(), ARRAY_TYPE))
+	if (isBraceType(braceTypeStack.back(), ARRAY_TYPE))
 	{
-		shouldKeepLineUnbroken = true;
-		if (!isBraceType(braceTypeStack->back(), ARRAY_NIS_TYPE))
+		flags.shouldKeepLineUnbroken = true;
+		if (!isBraceType(braceTypeStack.back(), ARRAY_NIS_TYPE))
 			clearFormattedLineSplitPoints();
 		return false;
 	}
@@ -7881,7 +7855,7 @@ void ASFormatter::testForTimeToSplitFormattedLine()
 {
 	//	DO NOT ASSERT maxCodeLength HERE
 	// should the line be split
-	if (formattedLine.length() > maxCodeLength && !isLineReady)
+	if (formattedLine.length() > maxCodeLength && !flags.isLineReady)
 	{
 		size_t splitPoint = findFormattedLineSplitPoint();
 		if (splitPoint > 0 && splitPoint < formattedLine.length())
@@ -7892,14 +7866,14 @@ void ASFormatter::testForTimeToSplitFormattedLine()
 			formattedLine = splitLine;
 			// if break-blocks is requested and this is a one-line statement
 			std::string nextWord = ASBeautifier::getNextWord(currentLine, charNum - 1);
-			if (isAppendPostBlockEmptyLineRequested
+			if (flags.isAppendPostBlockEmptyLineRequested
 			        && (nextWord == "break" || nextWord == "continue"))
 			{
-				isAppendPostBlockEmptyLineRequested = false;
-				isPrependPostBlockEmptyLineRequested = true;
+				flags.isAppendPostBlockEmptyLineRequested = false;
+				flags.isPrependPostBlockEmptyLineRequested = true;
 			}
 			else
-				isPrependPostBlockEmptyLineRequested = false;
+				flags.isPrependPostBlockEmptyLineRequested = false;
 			// adjust max split points
 			maxAndOr = (maxAndOr > splitPoint) ? (maxAndOr - splitPoint) : 0;
 			maxSemi = (maxSemi > splitPoint) ? (maxSemi - splitPoint) : 0;
@@ -8096,7 +8070,36 @@ bool ASFormatter::computeChecksumOut(const std::string& beautifiedLine)
  */
 bool ASFormatter::getIsLineReady() const
 {
-	return isLineReady;
+	return flags.isLineReady;
+}
+
+/**
+ * get the state of the preprocessor block indentation option.
+ *
+ * @return   state of shouldIndentPreprocBlock option.
+ */
+bool ASFormatter::getPreprocBlockIndent() const
+{
+	return options.shouldIndentPreprocBlock;
+}
+
+/**
+ * Get the number of source lines read that are not in the lines
+ * returned by nextLine(). The following output starts with the
+ * next source line that is not in the returned lines.
+ * A line broken in the middle, or joined to the previous line,
+ * is partly in the returned lines.
+ * It should be called between calls to nextLine().
+ *
+ * @return        0 or 1, or -1 if a source line is partly returned.
+ */
+int ASFormatter::getPendingSourceLines() const
+{
+	if (flags.isLineReady || flags.appendOpeningBrace)
+		return -1;
+	if (flags.isVirgin || !hasMoreLines())
+		return 0;
+	return flags.isBreakAtLineStart ? 1 : -1;
 }
 
 /**
@@ -8118,6 +8121,224 @@ int ASFormatter::getChecksumDiff() const
 	return checksumOut - checksumIn;
 }
 
+/**
+ * Return the allocation statistics of the current init() session.
+ */
+const ASArenaStats& ASFormatter::getArenaStats() const
+{
+	return sessionArena.getStats();
+}
+
+/**
+ * Take a snapshot of the formatter state at the current line boundary.
+ * It should be called between calls to nextLine(). The state includes
+ * the options, the brace and beautifier stacks, the preprocessor
+ * beautifier clones, the enhancer switch stack and the source position.
+ *
+ * @return        the checkpoint.
+ */
+ASFormatterCheckpoint ASFormatter::createCheckpoint() const
+{
+	ASFormatter* state = new ASFormatter(*this);
+	// the copy must not reference this session, it is released by init()
+	state->copyBeautifierState(*this, &state->sessionArena, nullptr);
+	state->sourceIterator = nullptr;
+
+	ASFormatterCheckpoint checkpoint;
+	checkpoint.state.reset(state);
+	checkpoint.sourceLine = sourceLineNum;
+	checkpoint.outputLine = outputLineNum;
+	checkpoint.sourceOffset = getSourceOffset();
+	checkpoint.stateOffset = checkpoint.sourceOffset;
+	return checkpoint;
+}
+
+/**
+ * Return the automatic checkpoints of the current init() session,
+ * in source line order.
+ */
+const std::vector<ASFormatterCheckpoint>& ASFormatter::getCheckpoints() const
+{
+	return checkpoints.items;
+}
+
+/**
+ * Create a formatter that continues formatting from a checkpoint.
+ * The source iterator must return the same input as the one used
+ * when the checkpoint was taken, positioned at checkpoint.getSourceLine().
+ * ASBufferIterator::seekLine() will position a buffer iterator.
+ * The new formatter has the options of the checkpoint, init()
+ * must not be called before formatting.
+ *
+ * @param checkpoint    a valid checkpoint.
+ * @param si            the source iterator.
+ * @return              the new formatter.
+ */
+std::unique_ptr<ASFormatter> ASFormatter::resume(const ASFormatterCheckpoint& checkpoint,
+                                                 ASSourceIterator* si)
+{
+	assert(checkpoint.isValid());
+	const ASFormatter& state = *checkpoint.state;
+	std::unique_ptr<ASFormatter> formatter(new ASFormatter(state));
+	formatter->copyBeautifierState(state, &formatter->sessionArena, si);
+	formatter->sourceIterator = si;
+
+	// a shifted checkpoint continues at the shifted position
+	formatter->sourceLineNum = checkpoint.sourceLine;
+	formatter->outputLineNum = checkpoint.outputLine;
+	formatter->nextCheckpointLineNum = checkpoint.sourceLine
+	                                   + (state.nextCheckpointLineNum - state.sourceLineNum);
+	if (state.getPreprocBlockDistance(checkpoint.stateOffset) >= 0)
+		formatter->preprocBlockEnd += checkpoint.sourceOffset - checkpoint.stateOffset;
+	return formatter;
+}
+
+/**
+ * Check if the formatter has the state of a checkpoint.
+ * The position in the source and the line of the next automatic
+ * checkpoint are not compared, so equal states at
+ * the same source text after an edit mean the output after this
+ * point will be the same as the output after the checkpoint.
+ * It should be called between calls to nextLine().
+ * The bool variables are compared as the options and flags state
+ * blocks, the other variables are listed here.
+ *
+ * @param checkpoint    a valid checkpoint.
+ * @return              is the state the same.
+ */
+bool ASFormatter::hasCheckpointState(const ASFormatterCheckpoint& checkpoint) const
+{
+	assert(checkpoint.isValid());
+	const ASFormatter& other = *checkpoint.state;
+	if (!equalStateBlocks(options, other.options)
+	        || !equalStateBlocks(flags, other.flags)
+	        || preBraceHeaderStack != other.preBraceHeaderStack
+	        || braceTypeStack != other.braceTypeStack
+	        || parenStack != other.parenStack
+	        || structStack != other.structStack
+	        || questionMarkStack != other.questionMarkStack
+	        || currentLine != other.currentLine
+	        || formattedLine != other.formattedLine
+	        || readyFormattedLine != other.readyFormattedLine
+	        || verbatimDelimiter != other.verbatimDelimiter
+	        || currentHeader != other.currentHeader)
+		return false;
+
+	if (formatterFileType != other.formatterFileType
+	        || currentChar != other.currentChar
+	        || previousChar != other.previousChar
+	        || previousNonWSChar != other.previousNonWSChar
+	        || previousCommandChar != other.previousCommandChar
+	        || quoteChar != other.quoteChar
+	        || charNum != other.charNum
+	        || runInIndentChars != other.runInIndentChars
+	        || nextLineSpacePadNum != other.nextLineSpacePadNum
+	        || objCColonAlign != other.objCColonAlign
+	        || preprocBraceTypeStackSize != other.preprocBraceTypeStackSize
+	        || spacePadNum != other.spacePadNum
+	        || tabIncrementIn != other.tabIncrementIn
+	        || templateDepth != other.templateDepth
+	        || squareBracketCount != other.squareBracketCount
+	        || parenthesesCount != other.parenthesesCount
+	        || squeezeEmptyLineNum != other.squeezeEmptyLineNum
+	        || squeezeEmptyLineCount != other.squeezeEmptyLineCount)
+		return false;
+
+	if (currentLineFirstBraceNum != other.currentLineFirstBraceNum
+	        || formattedLineCommentNum != other.formattedLineCommentNum
+	        || leadingSpaces != other.leadingSpaces
+	        || maxCodeLength != other.maxCodeLength
+	        || methodAttachCharNum != other.methodAttachCharNum
+	        || methodAttachLineNum != other.methodAttachLineNum
+	        || methodBreakCharNum != other.methodBreakCharNum
+	        || methodBreakLineNum != other.methodBreakLineNum
+	        || checkpointInterval != other.checkpointInterval
+	        || maxSemi != other.maxSemi
+	        || maxAndOr != other.maxAndOr
+	        || maxComma != other.maxComma
+	        || maxParen != other.maxParen
+	        || maxWhiteSpace != other.maxWhiteSpace
+	        || maxSemiPending != other.maxSemiPending
+	        || maxAndOrPending != other.maxAndOrPending
+	        || maxCommaPending != other.maxCommaPending
+	        || maxParenPending != other.maxParenPending
+	        || maxWhiteSpacePending != other.maxWhiteSpacePending
+	        || previousReadyFormattedLineLength != other.previousReadyFormattedLineLength)
+		return false;
+
+	if (formattingStyle != other.formattingStyle
+	        || braceFormatMode != other.braceFormatMode
+	        || previousBraceType != other.previousBraceType
+	        || pointerAlignment != other.pointerAlignment
+	        || referenceAlignment != other.referenceAlignment
+	        || objCColonPadMode != other.objCColonPadMode
+	        || lineEnd != other.lineEnd)
+		return false;
+
+	// the preprocessor block end is an offset in the source
+	if (getPreprocBlockDistance(getSourceOffset())
+	        != other.getPreprocBlockDistance(checkpoint.stateOffset))
+		return false;
+
+	return enhancer.hasEqualState(other.enhancer) && hasEqualState(other);
+}
+
+/**
+ * Get the source iterator offset of the next line to be read.
+ * At the end of the source it is the source length.
+ */
+std::streamoff ASFormatter::getSourceOffset() const
+{
+	if (sourceIterator == nullptr)
+		return 0;
+	std::streamoff offset = sourceIterator->tellg();
+	if (offset < 0)
+		offset = sourceIterator->getStreamLength();
+	return offset;
+}
+
+/**
+ * Get the distance from a source offset to the end of the
+ * preprocessor block, or -1 if the block end has been passed.
+ * An end that has been passed does not need to be moved or compared.
+ */
+std::streamoff ASFormatter::getPreprocBlockDistance(std::streamoff offset) const
+{
+	if (preprocBlockEnd < offset)
+		return -1;
+	return preprocBlockEnd - offset;
+}
+
+/**
+ * Add an automatic checkpoint when the interval line has been reached.
+ * In top level mode it waits for a top level line boundary.
+ */
+void ASFormatter::addAutomaticCheckpoint()
+{
+	if (options.shouldCheckpointTopLevel && !isCheckpointBoundary())
+		return;
+	checkpoints.items.emplace_back(createCheckpoint());
+	nextCheckpointLineNum = sourceLineNum + checkpointInterval;
+}
+
+/**
+ * Check if the formatter is at a line boundary between top level
+ * statements or declarations.
+ *
+ * @return        is at a top level boundary.
+ */
+bool ASFormatter::isCheckpointBoundary() const
+{
+	return braceTypeStack.size() == 1
+	       && parenStack.size() == 1
+	       && parenStack.back() == 0
+	       && !flags.isLineReady
+	       && !flags.isInComment
+	       && !flags.isInQuote
+	       && !flags.isInPreprocessor
+	       && isTopLevelBoundary();
+}
+
 // for unit testing
 int ASFormatter::getFormatterFileType() const
 {
@@ -8158,7 +8379,7 @@ const std::string* ASFormatter::getFollowingOperator() const
 bool ASFormatter::isArrayOperator() const
 {
 	assert(currentChar == '*' || currentChar == '&' || currentChar == '^');
-	assert(isBraceType(braceTypeStack->back(), ARRAY_TYPE));
+	assert(isBraceType(braceTypeStack.back(), ARRAY_TYPE));
 
 	// find next word
 	size_t nextNum = currentLine.find_first_not_of(" \t", charNum + 1);
@@ -8189,32 +8410,32 @@ bool ASFormatter::isArrayOperator() const
 // Reset the flags that indicate various statement information.
 void ASFormatter::resetEndOfStatement()
 {
-	foundQuestionMark = false;
-	foundNamespaceHeader = false;
-	foundClassHeader = false;
-	foundStructHeader = false;
-	foundInterfaceHeader = false;
-	foundPreDefinitionHeader = false;
-	foundPreCommandHeader = false;
-	foundPreCommandMacro = false;
-	foundTrailingReturnType = false;
-	foundCastOperator = false;
-	isInPotentialCalculation = false;
-	isSharpAccessor = false;
-	isSharpDelegate = false;
-	isInObjCMethodDefinition = false;
-	isImmediatelyPostObjCMethodPrefix = false;
-	isInObjCReturnType = false;
-	isInObjCParam = false;
-	isInObjCInterface = false;
-	isInObjCSelector = false;
-	isInEnum = false;
-	isInExternC = false;
-	elseHeaderFollowsComments = false;
-	returnTypeChecked = false;
+	flags.foundQuestionMark = false;
+	flags.foundNamespaceHeader = false;
+	flags.foundClassHeader = false;
+	flags.foundStructHeader = false;
+	flags.foundInterfaceHeader = false;
+	flags.foundPreDefinitionHeader = false;
+	flags.foundPreCommandHeader = false;
+	flags.foundPreCommandMacro = false;
+	flags.foundTrailingReturnType = false;
+	flags.foundCastOperator = false;
+	flags.isInPotentialCalculation = false;
+	hints.isSharpAccessor = false;
+	hints.isSharpDelegate = false;
+	flags.isInObjCMethodDefinition = false;
+	flags.isImmediatelyPostObjCMethodPrefix = false;
+	flags.isInObjCReturnType = false;
+	flags.isInObjCParam = false;
+	flags.isInObjCInterface = false;
+	flags.isInObjCSelector = false;
+	flags.isInEnum = false;
+	hints.isInExternC = false;
+	flags.elseHeaderFollowsComments = false;
+	flags.returnTypeChecked = false;
 	nonInStatementBrace = 0;
-	while (!questionMarkStack->empty())
-		questionMarkStack->pop_back();
+	while (!questionMarkStack.empty())
+		questionMarkStack.pop_back();
 }
 
 // Find the colon alignment for Objective-C method definitions and method calls.
@@ -8316,7 +8537,7 @@ int ASFormatter::findObjCColonAlignment() const
 				}
 				haveFirstColon = true;
 				foundMethodColon = true;
-				if (isObjCStyle() && shouldPadMethodColon)
+				if (isObjCStyle() && options.shouldPadMethodColon)
 				{
 					int spacesStart;
 					for (spacesStart = i; spacesStart > 0; spacesStart--)
@@ -8420,7 +8641,7 @@ void ASFormatter::stripCommentPrefix()
 	if (firstChar < 0)
 		return;
 
-	if (isInCommentStartLine)
+	if (flags.isInCommentStartLine)
 	{
 		// comment opener must begin the line
 		if (formattedLine.compare(firstChar, 2, "/*") != 0)
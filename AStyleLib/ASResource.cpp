@@ -9,6 +9,8 @@
 
 #include "astyle.h"
 #include <algorithm>
+#include <climits>
+#include <cstdint>
 
 //-----------------------------------------------------------------------------
 // astyle namespace
@@ -627,49 +629,481 @@ void ASResource::buildPreDefinitionHeaders(std::vector<const std::string*>* preD
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- *                             ASBase Functions
+ *                        ASLanguageVectors Functions
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-// check if a specific line position contains a header.
-const std::string* ASBase::findHeader(const std::string& line, int i,
-                                      const std::vector<const std::string*>* possibleHeaders) const
+/**
+ * Get the vectors for a file type.
+ * The vectors for all file types are built on first use.
+ * Initialization of a local static is thread safe in C++11,
+ * so no locking is needed.
+ *
+ * @param fileType      a value from enum FileType.
+ */
+const ASLanguageVectors& ASLanguageVectors::get(int fileType)
 {
-	assert(isCharPotentialHeader(line, i));
-	// check the word
-	size_t maxHeaders = possibleHeaders->size();
-	for (size_t p = 0; p < maxHeaders; p++)
+	static const ASLanguageVectors languageVectors[] =
 	{
-		const std::string* header = (*possibleHeaders)[p];
-		const size_t wordEnd = i + header->length();
-		if (wordEnd > line.length())
-			continue;
-		int result = (line.compare(i, header->length(), *header));
-		if (result > 0)
-			continue;
-		if (result < 0)
+		ASLanguageVectors(C_TYPE),
+		ASLanguageVectors(JAVA_TYPE),
+		ASLanguageVectors(SHARP_TYPE),
+		ASLanguageVectors(JS_TYPE),
+		ASLanguageVectors(OBJC_TYPE)
+	};
+	assert(fileType >= C_TYPE && fileType <= OBJC_TYPE);
+	return languageVectors[fileType];
+}
+
+ASLanguageVectors::ASLanguageVectors(int fileType)
+{
+	buildHeaders(&headers, fileType);
+	buildNonParenHeaders(&nonParenHeaders, fileType);
+	buildPreDefinitionHeaders(&preDefinitionHeaders, fileType);
+	buildOperators(&operators, fileType);
+	buildCastOperators(&castOperators);
+
+	buildHeaders(&beautifierHeaders, fileType, true);
+	buildNonParenHeaders(&beautifierNonParenHeaders, fileType, true);
+	buildPreBlockStatements(&preBlockStatements, fileType);
+	buildNonAssignmentOperators(&nonAssignmentOperators);
+	buildIndentableHeaders(&indentableHeaders);
+
+	buildPreCommandHeaders(&preCommandHeaders, fileType);
+	buildAssignmentOperators(&assignmentOperators);
+
+	buildIndentableMacros(&indentableMacros);
+
+	operatorSet = getOperatorSet(operators);
+	nonAssignmentOperatorSet = getOperatorSet(nonAssignmentOperators);
+	assignmentOperatorSet = getOperatorSet(assignmentOperators);
+
+	headerSet = getKeywordSet(headers);
+	nonParenHeaderSet = getKeywordSet(nonParenHeaders);
+	preDefinitionHeaderSet = getKeywordSet(preDefinitionHeaders);
+	castOperatorSet = getKeywordSet(castOperators);
+	beautifierHeaderSet = getKeywordSet(beautifierHeaders);
+	preBlockStatementSet = getKeywordSet(preBlockStatements);
+	indentableHeaderSet = getKeywordSet(indentableHeaders);
+	preCommandHeaderSet = getKeywordSet(preCommandHeaders);
+}
+
+/**
+ * Perfect hash table of every word that can be returned by ASBase::getKeyword.
+ * These are the words in the header vectors of all file types, and the
+ * keywords the formatter checks for at the start of each word.
+ * The hash seed is chosen when the table is built so that no two words share
+ * a slot, and a lookup is a single probe and compare.
+ * The position of a word in the table is its id in an ASKeywordSet.
+ * The words are identified by address, so the ASResource strings must remain
+ * std::string objects. C++14 has no constexpr std::string, so each has a
+ * dynamic initializer. All except "reinterpret_cast" fit in the small string
+ * buffer of the supported compilers, so the initializers do not allocate.
+ * The table is built from the ASResource header vectors, not from
+ * ASLanguageVectors, because ASLanguageVectors builds its sets with it.
+ */
+class ASKeywordTable : protected ASResource
+{
+public:
+	ASKeywordTable();
+	ASKeywordSet getSet(const std::vector<const std::string*>& wordVector) const;
+	const std::string* lookup(const std::string& line, size_t index,
+	                          size_t& wordEnd, size_t& keywordId) const;
+
+private:
+	static const size_t TABLE_SIZE = 1024;	// must be a power of 2
+	void addWord(const std::string* word);
+	static bool isWordChar(char ch)
+	{ return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_'; }
+	static uint32_t hashChar(uint32_t hash, char ch)
+	{ return (hash ^ (unsigned char) ch) * 16777619U; }		// FNV-1a
+
+private:
+	std::vector<const std::string*> words;	// words[0] is unused
+	unsigned char slots[TABLE_SIZE];		// index into words, 0 is empty
+	size_t maxWordLength;
+	uint32_t seed;
+};
+
+ASKeywordTable::ASKeywordTable() : maxWordLength(0), seed(0)
+{
+	words.emplace_back(nullptr);
+	// keywords checked by ASFormatter::nextLine
+	const std::string* const keywords[] =
+	{
+		&ASResource::AS_NEW, &ASResource::AS_DELETE, &ASResource::AS_RETURN,
+		&ASResource::AS_OPERATOR, &ASResource::AS_ENUM, &ASResource::AS_STRUCT,
+		&ASResource::AS_THROW, &ASResource::AS_EXTERN, &ASResource::AS_AUTO,
+		&ASResource::AS_PUBLIC, &ASResource::AS_PRIVATE, &ASResource::AS_PROTECTED,
+		&ASResource::AS_NS_DURING, &ASResource::AS_NS_HANDLER,
+		&ASResource::AS_ASM, &ASResource::AS__ASM__, &ASResource::AS_MS_ASM, &ASResource::AS_MS__ASM,
+		&ASResource::AS_STATIC, &ASResource::AS_DELEGATE, &ASResource::AS_UNCHECKED
+	};
+	for (const std::string* keyword : keywords)
+		addWord(keyword);
+
+	const int fileTypes[] = { C_TYPE, JAVA_TYPE, SHARP_TYPE, JS_TYPE, OBJC_TYPE };
+	for (int fileType : fileTypes)
+	{
+		std::vector<const std::string*> wordVectors[9];
+		buildHeaders(&wordVectors[0], fileType);
+		buildNonParenHeaders(&wordVectors[1], fileType);
+		buildPreDefinitionHeaders(&wordVectors[2], fileType);
+		buildCastOperators(&wordVectors[3]);
+		buildHeaders(&wordVectors[4], fileType, true);
+		buildNonParenHeaders(&wordVectors[5], fileType, true);
+		buildPreBlockStatements(&wordVectors[6], fileType);
+		buildIndentableHeaders(&wordVectors[7]);
+		buildPreCommandHeaders(&wordVectors[8], fileType);
+		for (const std::vector<const std::string*>& wordVector : wordVectors)
+		{
+			for (const std::string* word : wordVector)
+				addWord(word);
+		}
+	}
+	assert(words.size() <= UCHAR_MAX);
+
+	// find a seed that gives each word its own slot
+	for (seed = 0; ; seed++)
+	{
+		std::fill(slots, slots + TABLE_SIZE, 0);
+		size_t w;
+		for (w = 1; w < words.size(); w++)
+		{
+			uint32_t hash = 2166136261U ^ seed;
+			for (char ch : *words[w])
+				hash = hashChar(hash, ch);
+			const size_t slot = hash & (TABLE_SIZE - 1);
+			if (slots[slot] != 0)
+				break;
+			slots[slot] = static_cast<unsigned char>(w);
+		}
+		if (w == words.size())
 			break;
-		// check that this is not part of a longer word
-		if (wordEnd == line.length())
-			return header;
-		if (isLegalNameChar(line[wordEnd]))
+	}
+}
+
+void ASKeywordTable::addWord(const std::string* word)
+{
+	if (find(words.begin(), words.end(), word) != words.end())
+		return;
+	// lookup() scans only word characters
+	assert(std::all_of(word->begin(), word->end(), isWordChar));
+	// the words are identified by address, so the text must be unique
+	assert(std::none_of(words.begin() + 1, words.end(),
+	                    [word](const std::string* w) { return *w == *word; }));
+	words.emplace_back(word);
+	maxWordLength = std::max(maxWordLength, word->length());
+}
+
+// Get the ids of the words in a header vector.
+ASKeywordSet ASKeywordTable::getSet(const std::vector<const std::string*>& wordVector) const
+{
+	ASKeywordSet keywordSet;
+	for (const std::string* word : wordVector)
+	{
+		auto entry = find(words.begin() + 1, words.end(), word);
+		assert(entry != words.end());
+		keywordSet.set(entry - words.begin());
+	}
+	return keywordSet;
+}
+
+// Find the keyword that starts at index.
+// wordEnd is set to the end of the word characters, which may not
+// be the end of the name if it contains digits or other name characters.
+// keywordId is set to the id of the keyword that is found.
+const std::string* ASKeywordTable::lookup(const std::string& line, size_t index,
+                                          size_t& wordEnd, size_t& keywordId) const
+{
+	uint32_t hash = 2166136261U ^ seed;
+	const size_t scanEnd = std::min(line.length(), index + maxWordLength + 1);
+	for (wordEnd = index; wordEnd < scanEnd && isWordChar(line[wordEnd]); wordEnd++)
+		hash = hashChar(hash, line[wordEnd]);
+	const size_t wordLength = wordEnd - index;
+	if (wordLength > maxWordLength)
+		return nullptr;
+	keywordId = slots[hash & (TABLE_SIZE - 1)];
+	const std::string* keyword = words[keywordId];
+	if (keyword == nullptr
+	        || keyword->length() != wordLength
+	        || line.compare(index, wordLength, *keyword) != 0)
+		return nullptr;
+	return keyword;
+}
+
+// The keyword table is built on first use and is shared by all threads.
+static const ASKeywordTable& getKeywordTable()
+{
+	static const ASKeywordTable keywordTable;
+	return keywordTable;
+}
+
+/**
+ * Get the set of the words in a header vector for findHeader.
+ * It is built once for each vector, by ASLanguageVectors.
+ *
+ * @param wordVector        the words built by ASResource.
+ * @return                  the word ids in the keyword table.
+ */
+ASKeywordSet ASResource::getKeywordSet(const std::vector<const std::string*>& wordVector)
+{
+	return getKeywordTable().getSet(wordVector);
+}
+
+/**
+ * Find a keyword in the perfect hash table.
+ *
+ * @param line          the line to check.
+ * @param index         the start of the word.
+ * @param wordEnd       set to the end of the word characters.
+ * @param keywordId     set to the id of the keyword in an ASKeywordSet.
+ * @return              the keyword string, or nullptr if the word is not in the table.
+ */
+const std::string* ASResource::lookupKeyword(const std::string& line, size_t index,
+                                             size_t& wordEnd, size_t& keywordId)
+{
+	return getKeywordTable().lookup(line, index, wordEnd, keywordId);
+}
+
+/**
+ * Table of every operator that can be returned by ASBase::findOperator,
+ * indexed by the first character.
+ * The operators for each character are sorted with the LONGEST first,
+ * so the first one that matches the line is the longest match.
+ * The position of an operator in the table is its id in an ASOperatorSet.
+ * The table is built from the ASResource operator vectors, not from
+ * ASLanguageVectors, because ASLanguageVectors builds its sets with it.
+ */
+class ASOperatorTable : protected ASResource
+{
+public:
+	ASOperatorTable();
+	ASOperatorSet getSet(const std::vector<const std::string*>& operatorVector) const;
+	const std::string* lookup(const std::string& line, size_t index,
+	                          const ASOperatorSet& possibleOperators) const;
+
+private:
+	static bool sortOnFirstChar(const std::string* a, const std::string* b);
+
+private:
+	std::vector<const std::string*> operators;
+	unsigned char firstOperator[UCHAR_MAX + 2];	// index into operators for each character
+};
+
+ASOperatorTable::ASOperatorTable()
+{
+	const int fileTypes[] = { C_TYPE, JAVA_TYPE, SHARP_TYPE, JS_TYPE, OBJC_TYPE };
+	for (int fileType : fileTypes)
+	{
+		std::vector<const std::string*> operatorVectors[3];
+		buildOperators(&operatorVectors[0], fileType);
+		buildAssignmentOperators(&operatorVectors[1]);
+		buildNonAssignmentOperators(&operatorVectors[2]);
+		for (const std::vector<const std::string*>& operatorVector : operatorVectors)
+		{
+			for (const std::string* op : operatorVector)
+			{
+				if (find(operators.begin(), operators.end(), op) == operators.end())
+					operators.emplace_back(op);
+			}
+		}
+	}
+	assert(operators.size() <= UCHAR_MAX);
+	sort(operators.begin(), operators.end(), sortOnFirstChar);
+
+	size_t op = 0;
+	for (size_t ch = 0; ch <= UCHAR_MAX + 1; ch++)
+	{
+		while (op < operators.size() && (unsigned char) (*operators[op])[0] < ch)
+			op++;
+		firstOperator[ch] = static_cast<unsigned char>(op);
+	}
+}
+
+// the operators with the same first character are sorted with the LONGEST first
+bool ASOperatorTable::sortOnFirstChar(const std::string* a, const std::string* b)
+{
+	if ((*a)[0] != (*b)[0])
+		return (unsigned char) (*a)[0] < (unsigned char) (*b)[0];
+	if (a->length() != b->length())
+		return a->length() > b->length();
+	return *a < *b;
+}
+
+// Get the ids of the operators in an operator vector.
+ASOperatorSet ASOperatorTable::getSet(const std::vector<const std::string*>& operatorVector) const
+{
+	ASOperatorSet operatorSet;
+	for (const std::string* op : operatorVector)
+	{
+		auto entry = find(operators.begin(), operators.end(), op);
+		assert(entry != operators.end());
+		operatorSet.set(entry - operators.begin());
+	}
+	return operatorSet;
+}
+
+// Find the longest operator in possibleOperators that starts at index.
+const std::string* ASOperatorTable::lookup(const std::string& line, size_t index,
+                                           const ASOperatorSet& possibleOperators) const
+{
+	const unsigned char ch = line[index];
+	const size_t remaining = line.length() - index;
+	for (size_t op = firstOperator[ch]; op < firstOperator[ch + 1]; op++)
+	{
+		const std::string& candidate = *operators[op];
+		if (candidate.length() > remaining
+		        || line.compare(index + 1, candidate.length() - 1, candidate, 1, std::string::npos) != 0)
 			continue;
-		const char peekChar = peekNextChar(line, wordEnd - 1);
-		// is not a header if part of a definition
-		if (peekChar == ',' || peekChar == ')')
-			break;
-		// the following accessor definitions are NOT headers
-		// goto default; is NOT a header
-		// default(int) keyword in C# is NOT a header
-		if ((header == &AS_GET
-		        || header == &AS_SET
-		        || header == &AS_DEFAULT)
-		        && (peekChar == '.' || peekChar == ';' || peekChar == '(' || peekChar == '='))
-			break;
-		return header;
+		if (possibleOperators.test(op))
+			return &candidate;
 	}
 	return nullptr;
 }
 
+// The operator table is built on first use and is shared by all threads.
+static const ASOperatorTable& getOperatorTable()
+{
+	static const ASOperatorTable operatorTable;
+	return operatorTable;
+}
+
+/**
+ * Get the set of the operators in an operator vector for lookupOperator.
+ * It is built once for each vector, by ASLanguageVectors.
+ *
+ * @param operatorVector        the operators built by ASResource.
+ * @return                      the operator ids in the operator table.
+ */
+ASOperatorSet ASResource::getOperatorSet(const std::vector<const std::string*>& operatorVector)
+{
+	return getOperatorTable().getSet(operatorVector);
+}
+
+/**
+ * Find an operator in the operator table.
+ *
+ * @param line                  the line to check.
+ * @param index                 the start of the operator.
+ * @param possibleOperators     the operators to accept.
+ * @return                      the longest operator, or nullptr if none is found.
+ */
+const std::string* ASResource::lookupOperator(const std::string& line, size_t index,
+                                              const ASOperatorSet& possibleOperators)
+{
+	return getOperatorTable().lookup(line, index, possibleOperators);
+}
+
+/**
+ * Character class table for one file type, built at compile time.
+ * Only ASCII characters have a class. The C locale is assumed.
+ */
+struct ASCharClassTable
+{
+	unsigned char classes[UCHAR_MAX + 1];
+
+	constexpr explicit ASCharClassTable(int fileType) : classes()
+	{
+		for (int ch = 0; ch <= UCHAR_MAX; ch++)
+			classes[ch] = getCharClass(ch, fileType);
+	}
+
+	static constexpr unsigned char getCharClass(int ch, int fileType)
+	{
+		if (ch == ' ' || ch == '\t')
+			return CHAR_WHITESPACE;
+		const bool isAlnum = (ch >= '0' && ch <= '9')
+		                     || (ch >= 'a' && ch <= 'z')
+		                     || (ch >= 'A' && ch <= 'Z');
+		const bool isName = isAlnum
+		                    || ch == '_'
+		                    || (fileType != SHARP_TYPE && ch == '.')
+		                    || (fileType == JAVA_TYPE && ch == '$')
+		                    || (fileType == SHARP_TYPE && ch == '@');  // may be used as a prefix
+		const bool isPunct = ch > ' ' && ch < 127 && !isAlnum;
+		const bool isOperator = isPunct
+		                        && ch != '{' && ch != '}'
+		                        && ch != '(' && ch != ')'
+		                        && ch != '[' && ch != ']'
+		                        && ch != ';' && ch != ','
+		                        && ch != '#' && ch != '\\'
+		                        && ch != '\'' && ch != '\"';
+		return static_cast<unsigned char>((isName ? CHAR_NAME : 0)
+		                                  | (isOperator ? CHAR_OPERATOR : 0));
+	}
+};
+
+// JavaScript and Objective-C have the same character classes as C.
+constexpr ASCharClassTable cCharClasses(C_TYPE);
+constexpr ASCharClassTable javaCharClasses(JAVA_TYPE);
+constexpr ASCharClassTable sharpCharClasses(SHARP_TYPE);
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                             ASBase Functions
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// get the character class table for a file type.
+const unsigned char* ASBase::getCharClasses(int fileType)
+{
+	if (fileType == JAVA_TYPE)
+		return javaCharClasses.classes;
+	if (fileType == SHARP_TYPE)
+		return sharpCharClasses.classes;
+	return cCharClasses.classes;
+}
+
+// check if a specific line position contains a header.
+const std::string* ASBase::findHeader(const std::string& line, int i,
+                                      const ASKeywordSet* possibleHeaders) const
+{
+	size_t headerId;
+	const std::string* header = getKeyword(line, i, headerId);
+	if (header == nullptr || !possibleHeaders->test(headerId))
+		return nullptr;
+	// the following accessor definitions are NOT headers
+	// goto default; is NOT a header
+	// default(int) keyword in C# is NOT a header
+	if (header == &AS_GET
+	        || header == &AS_SET
+	        || header == &AS_DEFAULT)
+	{
+		const char peekChar = peekNextChar(line, i + (int) header->length() - 1);
+		if (peekChar == '.' || peekChar == ';' || peekChar == '(' || peekChar == '=')
+			return nullptr;
+	}
+	return header;
+}
+
+// get the keyword at a specific line position.
+// The word is scanned once and looked up in the keyword table.
+// The tests are the same as findKeyword, so getKeyword(line, i) == &keyword
+// is the same as findKeyword(line, i, keyword) for the words in the table.
+const std::string* ASBase::getKeyword(const std::string& line, int i) const
+{
+	size_t keywordId;
+	return getKeyword(line, i, keywordId);
+}
+
+// get the keyword and its id in an ASKeywordSet at a specific line position.
+const std::string* ASBase::getKeyword(const std::string& line, int i, size_t& keywordId) const
+{
+	assert(isCharPotentialHeader(line, i));
+	size_t wordEnd;
+	const std::string* keyword = lookupKeyword(line, i, wordEnd, keywordId);
+	if (keyword == nullptr)
+		return nullptr;
+	// check that this is not part of a longer word
+	if (wordEnd == line.length())
+		return keyword;
+	if (isLegalNameChar(line[wordEnd]))
+		return nullptr;
+	// is not a keyword if part of a definition
+	const char peekChar = peekNextChar(line, (int) wordEnd - 1);
+	if (peekChar == ',' || peekChar == ')')
+		return nullptr;
+	return keyword;
+}
+
 // check if a specific line position contains a keyword.
 bool ASBase::findKeyword(const std::string& line, int i, const std::string& keyword) const
 {
@@ -701,22 +1135,10 @@ bool ASBase::findKeyword(const std::string& line, int i, const std::string& keyw
 
 // check if a specific line position contains an operator.
 const std::string* ASBase::findOperator(const std::string& line, int i,
-                                        const std::vector<const std::string*>* possibleOperators) const
+                                        const ASOperatorSet* possibleOperators) const
 {
 	assert(isCharPotentialOperator(line[i]));
-	// find the operator in the vector
-	// the vector contains the LONGEST operators first
-	// must loop thru the entire vector
-	size_t maxOperators = possibleOperators->size();
-	for (size_t p = 0; p < maxOperators; p++)
-	{
-		const size_t wordEnd = i + (*(*possibleOperators)[p]).length();
-		if (wordEnd > line.length())
-			continue;
-		if (line.compare(i, (*(*possibleOperators)[p]).length(), *(*possibleOperators)[p]) == 0)
-			return (*possibleOperators)[p];
-	}
-	return nullptr;
+	return lookupOperator(line, i, *possibleOperators);
 }
 
 // get the current word on a line
@@ -736,49 +1158,6 @@ std::string ASBase::getCurrentWord(const std::string& line, size_t index) const
 	return line.substr(index, i - index);
 }
 
-// check if a specific character can be used in a legal variable/method/class name
-bool ASBase::isLegalNameChar(char ch) const
-{
-	if (isWhiteSpace(ch))
-		return false;
-	if ((unsigned char) ch > 127)
-		return false;
-	return (isalnum((unsigned char) ch)
-            || ch == '_'
-            || (!isSharpStyle() && ch == '.' )
-	        || (isJavaStyle() && ch == '$')
-	        || (isSharpStyle() && ch == '@'));  // may be used as a prefix
-}
-
-// check if a specific character can be part of a header
-bool ASBase::isCharPotentialHeader(const std::string& line, size_t i) const
-{
-	assert(!isWhiteSpace(line[i]));
-	char prevCh = ' ';
-	if (i > 0)
-		prevCh = line[i - 1];
-	if (i > 1 && line[i - 2] == '\\')
-		prevCh = ' ';
-	if (!isLegalNameChar(prevCh) && isLegalNameChar(line[i]))
-		return true;
-	return false;
-}
-
-// check if a specific character can be part of an operator
-bool ASBase::isCharPotentialOperator(char ch) const
-{
-	assert(!isWhiteSpace(ch));
-	if ((unsigned) ch > 127)
-		return false;
-	return (ispunct((unsigned char) ch)
-	        && ch != '{' && ch != '}'
-	        && ch != '(' && ch != ')'
-	        && ch != '[' && ch != ']'
-	        && ch != ';' && ch != ','
-	        && ch != '#' && ch != '\\'
-	        && ch != '\'' && ch != '\"');
-}
-
 // check if a specific character is a digit
 // NOTE: Visual C isdigit() gives assert error if char > 256
 bool ASBase::isDigit(char ch) const
@@ -810,4 +1189,94 @@ char ASBase::peekNextChar(const std::string& line, int i) const
 	return ch;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                             ASArena Functions
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * ASArena constructor
+ * No memory is allocated until the first allocate call.
+ *
+ * @param blockSize_    the default capacity of a block.
+ */
+ASArena::ASArena(size_t blockSize_)
+{
+	block = nullptr;
+	blockCapacity = 0;
+	used = 0;
+	blockSize = blockSize_;
+	std::fill_n(freeLists, classCount, nullptr);
+	stats = ASArenaStats();
+}
+
+/**
+ * ASArena destructor
+ * Free all blocks.
+ */
+ASArena::~ASArena()
+{
+	while (block != nullptr)
+	{
+		Block* previous = block->previous;
+		::operator delete(block);
+		block = previous;
+	}
+}
+
+/**
+ * Add a new block when the current block is full.
+ * The unused end of the full block is not used again.
+ *
+ * @param bytes     the size of the request, at most maxClassBytes.
+ */
+void ASArena::addBlock(size_t bytes)
+{
+	size_t capacity = std::max(blockSize, bytes);
+	Block* newBlock = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+	newBlock->previous = block;
+	newBlock->capacity = capacity;
+	block = newBlock;
+	blockCapacity = capacity;
+	used = 0;
+	++stats.blocks;
+	stats.bytesReserved += capacity;
+}
+
+/**
+ * Allocate a request that is too large for a size class
+ * from the global heap. It is freed by deallocate.
+ */
+void* ASArena::allocateLarge(size_t bytes, size_t alignment)
+{
+	assert(alignment <= alignof(std::max_align_t));
+	(void) alignment;
+	++stats.allocations;
+	stats.bytesAllocated += bytes;
+	return ::operator new(bytes);
+}
+
+/**
+ * Release all memory allocated in the session.
+ * The objects in the arena must already be destroyed.
+ * The oldest block is kept for the next session.
+ */
+void ASArena::release()
+{
+	while (block != nullptr && block->previous != nullptr)
+	{
+		Block* previous = block->previous;
+		::operator delete(block);
+		block = previous;
+	}
+	std::fill_n(freeLists, classCount, nullptr);
+	stats = ASArenaStats();
+	if (block != nullptr)
+	{
+		blockCapacity = block->capacity;
+		stats.blocks = 1;
+		stats.bytesReserved = blockCapacity;
+	}
+	used = 0;
+}
+
 }   // end namespace astyle
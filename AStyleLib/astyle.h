@@ -17,16 +17,19 @@
 	#include <cassert>
 #endif
 
+#include <algorithm>
+#include <bitset>
 #include <cctype>
+#include <cstddef>
+#include <cstring>
 #include <iostream>		// for cout
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#ifdef __GNUC__
-	#include <cstring>              // need both string and cstring for GCC
-#endif
-
 //-----------------------------------------------------------------------------
 // declarations
 //-----------------------------------------------------------------------------
@@ -66,6 +69,14 @@ namespace astyle {
 
 enum FileType { C_TYPE = 0, JAVA_TYPE = 1, SHARP_TYPE = 2, JS_TYPE = 3, OBJC_TYPE = 4, INVALID_TYPE = -1 };
 
+// character class bits used by the ASBase character predicates
+enum CharClass : unsigned char
+{
+	CHAR_WHITESPACE = 1,
+	CHAR_NAME       = 2,	// legal in a variable/method/class name
+	CHAR_OPERATOR   = 4		// can be part of an operator
+};
+
 /* The enums below are not recognized by 'vectors' in Microsoft Visual C++
    V5 when they are part of a namespace!!!  Use Visual C++ V6 or higher.
 */
@@ -224,11 +235,415 @@ public:
 	{ needReset = true; return sourceIterator->peekNextLine(); }
 };
 
+//-----------------------------------------------------------------------------
+// State block functions
+// A state block is a trivially copyable struct of plain variables,
+// such as the bool options and flags of ASBeautifier and ASFormatter. It is
+// compared and hashed as raw bytes, so it must not have padding.
+//-----------------------------------------------------------------------------
+
+template<typename T>
+inline bool equalStateBlocks(const T& a, const T& b)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "state block must be trivially copyable");
+	return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// FNV-1a hash of the bytes of a state block
+template<typename T>
+inline size_t hashStateBlock(const T& block, size_t hash = 2166136261u)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "state block must be trivially copyable");
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&block);
+	for (size_t i = 0; i < sizeof(T); i++)
+		hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+// Class ASSmallVector
+// A vector with inline storage for the first N elements.
+// The formatter and beautifier stacks are almost always shallow, so
+// they are kept by value in an ASSmallVector and do not allocate unless
+// they grow past N elements. Only the functions used by the stacks are
+// provided.
+//-----------------------------------------------------------------------------
+
+template<typename T, size_t N>
+class ASSmallVector
+{
+	static_assert(N > 0, "ASSmallVector needs inline storage");
+
+public:
+	typedef T value_type;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	ASSmallVector() : elements(inlineElements()), count(0), capacity(N) {}
+
+	ASSmallVector(const ASSmallVector& other) : ASSmallVector()
+	{ assign(other.cbegin(), other.cend()); }
+
+	template<typename InputIt>
+	ASSmallVector(InputIt first, InputIt last) : ASSmallVector()
+	{ assign(first, last); }
+
+	ASSmallVector& operator=(const ASSmallVector& other)
+	{
+		if (this != &other)
+			assign(other.cbegin(), other.cend());
+		return *this;
+	}
+
+	~ASSmallVector()
+	{
+		clear();
+		if (elements != inlineElements())
+			::operator delete(elements);
+	}
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+	T& back() { return elements[count - 1]; }
+	const T& back() const { return elements[count - 1]; }
+	T& at(size_t i) { assert(i < count); return elements[i]; }
+	const T& at(size_t i) const { assert(i < count); return elements[i]; }
+	T& operator[](size_t i) { return elements[i]; }
+	const T& operator[](size_t i) const { return elements[i]; }
+	iterator begin() { return elements; }
+	iterator end() { return elements + count; }
+	const_iterator begin() const { return elements; }
+	const_iterator end() const { return elements + count; }
+	const_iterator cbegin() const { return elements; }
+	const_iterator cend() const { return elements + count; }
+
+	void push_back(const T& value) { emplace_back(value); }
+
+	template<typename... Args>
+	void emplace_back(Args&& ... args)
+	{
+		if (count == capacity)
+		{
+			// construct the new element first, args may refer to an element
+			// the inline capacity is the floor, so the size is never zero
+			size_t newCapacity = std::max<size_t>(capacity * 2, N);
+			T* newElements = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+			new (newElements + count) T(std::forward<Args>(args)...);
+			for (size_t i = 0; i < count; i++)
+			{
+				new (newElements + i) T(std::move(elements[i]));
+				elements[i].~T();
+			}
+			if (elements != inlineElements())
+				::operator delete(elements);
+			elements = newElements;
+			capacity = newCapacity;
+		}
+		else
+			new (elements + count) T(std::forward<Args>(args)...);
+		++count;
+	}
+
+	void pop_back()
+	{
+		assert(count > 0);
+		elements[--count].~T();
+	}
+
+	void clear()
+	{
+		while (count > 0)
+			elements[--count].~T();
+	}
+
+	bool operator==(const ASSmallVector& other) const
+	{
+		if (count != other.count)
+			return false;
+		for (size_t i = 0; i < count; i++)
+			if (!(elements[i] == other.elements[i]))
+				return false;
+		return true;
+	}
+	bool operator!=(const ASSmallVector& other) const { return !(*this == other); }
+
+private:
+	template<typename InputIt>
+	void assign(InputIt first, InputIt last)
+	{
+		clear();
+		for (; first != last; ++first)
+			emplace_back(*first);
+	}
+
+	T* inlineElements() { return reinterpret_cast<T*>(storage); }
+	const T* inlineElements() const { return reinterpret_cast<const T*>(storage); }
+
+	alignas(T) unsigned char storage[N * sizeof(T)];
+	T* elements;
+	size_t count;
+	size_t capacity;
+};
+
+//-----------------------------------------------------------------------------
+// Class ASArena
+// Functions definitions are in ASResource.cpp.
+//-----------------------------------------------------------------------------
+
+// allocation statistics for an ASArena session
+struct ASArenaStats
+{
+	size_t allocations;		// number of allocate calls
+	size_t deallocations;	// number of deallocate calls
+	size_t reuses;			// allocations from a free list
+	size_t bytesAllocated;	// bytes requested by allocate
+	size_t bytesReserved;	// bytes in the arena blocks
+	size_t blocks;			// number of arena blocks
+};
+
+// A memory arena for one formatting session.
+// ASFormatter::init starts a session. The beautifier clones and the
+// ASStack elements are allocated from the arena. A deallocated small
+// request is put on the free list of its size class and is reused by the
+// next request of the same class, so the clones made and deleted for
+// each preprocessor directive do not grow the arena. A large request is
+// allocated and freed with the global heap. The blocks are released in
+// one go at the end of the session. The first block is kept for the
+// next session.
+// A copy of an arena is a new empty arena with the same block size, so
+// a copy of an ASFormatter gets an arena of its own.
+class ASArena
+{
+public:
+	explicit ASArena(size_t blockSize_ = 32 * 1024);
+	ASArena(const ASArena& other) : ASArena(other.blockSize) {}
+	~ASArena();
+	ASArena& operator=(const ASArena&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment)
+	{
+		if (bytes > maxClassBytes || alignment > classGrain)
+			return allocateLarge(bytes, alignment);
+		size_t sizeClass = getSizeClass(bytes);
+		++stats.allocations;
+		stats.bytesAllocated += bytes;
+		FreeChunk* chunk = freeLists[sizeClass];
+		if (chunk != nullptr)
+		{
+			freeLists[sizeClass] = chunk->next;
+			++stats.reuses;
+			return chunk;
+		}
+		size_t classBytes = (sizeClass + 1) * classGrain;
+		if (block == nullptr || used + classBytes > blockCapacity)
+			addBlock(classBytes);
+		void* ptr = block->data() + used;
+		used += classBytes;
+		return ptr;
+	}
+
+	void deallocate(void* ptr, size_t bytes, size_t alignment)
+	{
+		++stats.deallocations;
+		if (bytes > maxClassBytes || alignment > classGrain)
+		{
+			::operator delete(ptr);
+			return;
+		}
+		size_t sizeClass = getSizeClass(bytes);
+		FreeChunk* chunk = static_cast<FreeChunk*>(ptr);
+		chunk->next = freeLists[sizeClass];
+		freeLists[sizeClass] = chunk;
+	}
+
+	const ASArenaStats& getStats() const { return stats; }
+	void release();
+
+private:
+	// the small requests are rounded up to a multiple of the grain,
+	// the grain is the alignment of every small request
+	static const size_t classGrain = 16;
+	static const size_t classCount = 128;
+	static const size_t maxClassBytes = classGrain * classCount;
+
+	// the block data follows the header, aligned to the grain
+	struct alignas(16) Block
+	{
+		Block* previous;
+		size_t capacity;
+		unsigned char* data() { return reinterpret_cast<unsigned char*>(this + 1); }
+	};
+	static_assert(sizeof(Block) % classGrain == 0, "the block data must be aligned to the grain");
+
+	// a deallocated small request on a free list
+	struct FreeChunk
+	{
+		FreeChunk* next;
+	};
+
+	static size_t getSizeClass(size_t bytes)
+	{ return bytes == 0 ? 0 : (bytes - 1) / classGrain; }
+
+	void addBlock(size_t bytes);
+	void* allocateLarge(size_t bytes, size_t alignment);
+
+	Block* block;			// the current block, the start of the block list
+	size_t blockCapacity;	// capacity of the current block
+	size_t used;			// bytes used in the current block
+	size_t blockSize;		// default capacity of a new block
+	FreeChunk* freeLists[classCount];
+	ASArenaStats stats;
+};
+
+// A standard allocator using an ASArena.
+// With a null arena it uses the global heap.
+template<typename T>
+class ASArenaAllocator
+{
+public:
+	typedef T value_type;
+
+	explicit ASArenaAllocator(ASArena* arena_) : arena(arena_) {}
+	template<typename U>
+	ASArenaAllocator(const ASArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t n)
+	{
+		if (arena == nullptr)
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_t n)
+	{
+		if (arena == nullptr)
+			::operator delete(ptr);
+		else
+			arena->deallocate(ptr, n * sizeof(T), alignof(T));
+	}
+
+	template<typename U>
+	bool operator==(const ASArenaAllocator<U>& other) const { return arena == other.arena; }
+	template<typename U>
+	bool operator!=(const ASArenaAllocator<U>& other) const { return arena != other.arena; }
+
+	ASArena* arena;
+};
+
+//-----------------------------------------------------------------------------
+// Class ASStack
+// A copy-on-write stack used for the ASBeautifier state stacks.
+// Copying an ASStack shares the elements with the original. The elements
+// are copied only when one of the sharing stacks is changed, so cloning
+// an ASBeautifier for a preprocessor directive costs nothing for the
+// stacks the clone never changes.
+// The read functions are const so a read never forces a copy. Writes are
+// done with the modifying functions or with mutableBack().
+// The shared elements are an ASSmallVector allocated with its control
+// block, so a shallow stack costs one allocation. It is allocated from
+// the ASArena of the formatting session, if there is one.
+//-----------------------------------------------------------------------------
+
+template<typename T>
+class ASStack
+{
+public:
+	typedef ASSmallVector<T, 16> Elements;
+
+	ASStack() : arena(nullptr) {}
+
+	bool empty() const { return items == nullptr || items->empty(); }
+	size_t size() const { return items == nullptr ? 0 : items->size(); }
+	const T& back() const { return items->back(); }
+	const T& operator[](size_t i) const { return (*items)[i]; }
+	typename Elements::const_iterator begin() const { return items == nullptr ? nullptr : items->cbegin(); }
+	typename Elements::const_iterator end() const { return items == nullptr ? nullptr : items->cend(); }
+
+	T& mutableBack() { return unshare().back(); }
+	void push_back(const T& value) { unshare().push_back(value); }
+	template<typename... Args>
+	void emplace_back(Args&& ... args) { unshare().emplace_back(std::forward<Args>(args)...); }
+
+	void pop_back()
+	{
+		// a shared stack copies only the elements that remain
+		if (items.use_count() > 1)
+			items = newElements(items->cbegin(), items->cend() - 1);
+		else
+			items->pop_back();
+	}
+
+	void clear()
+	{
+		if (items.use_count() > 1)
+			items.reset();
+		else if (items != nullptr)
+			items->clear();
+	}
+
+	// drop the elements and allocate from a new arena on the next write
+	void reset(ASArena* arena_)
+	{
+		items.reset();
+		arena = arena_;
+	}
+
+	// compare the elements, shared elements are equal without a compare
+	bool operator==(const ASStack& other) const
+	{
+		if (items == other.items)
+			return true;
+		if (size() != other.size())
+			return false;
+		return size() == 0 || *items == *other.items;
+	}
+	bool operator!=(const ASStack& other) const { return !(*this == other); }
+
+	// copy the elements into a new arena, nothing is shared after this
+	// the elements themselves are copied, so a nested stack is still shared
+	void rehome(ASArena* arena_)
+	{
+		arena = arena_;
+		if (items != nullptr)
+			items = newElements(items->cbegin(), items->cend());
+	}
+
+private:
+	template<typename... Args>
+	std::shared_ptr<Elements> newElements(Args&& ... args)
+	{
+		return std::allocate_shared<Elements>(ASArenaAllocator<Elements>(arena),
+		                                      std::forward<Args>(args)...);
+	}
+
+	Elements& unshare()
+	{
+		if (items == nullptr)
+			items = newElements();
+		else if (items.use_count() > 1)
+			items = newElements(*items);
+		return *items;
+	}
+
+	std::shared_ptr<Elements> items;	// nullptr until the first write
+	ASArena* arena;						// nullptr uses the global heap
+};
+
 
 //-----------------------------------------------------------------------------
 // Class ASResource
 //-----------------------------------------------------------------------------
 
+// The operators of an operator vector as flags indexed by the operator id
+// in the operator table, so a lookup tests a flag instead of the vector.
+typedef std::bitset<256> ASOperatorSet;
+
+// The words of a header vector as flags indexed by the word id
+// in the keyword table, so a lookup tests a flag instead of the vector.
+typedef std::bitset<256> ASKeywordSet;
+
 class ASResource
 {
 public:
@@ -243,6 +658,12 @@ public:
 	void buildPreBlockStatements(std::vector<const std::string*>* preBlockStatements, int fileType);
 	void buildPreCommandHeaders(std::vector<const std::string*>* preCommandHeaders, int fileType);
 	void buildPreDefinitionHeaders(std::vector<const std::string*>* preDefinitionHeaders, int fileType);
+	static ASKeywordSet getKeywordSet(const std::vector<const std::string*>& wordVector);
+	static const std::string* lookupKeyword(const std::string& line, size_t index,
+	                                        size_t& wordEnd, size_t& keywordId);
+	static ASOperatorSet getOperatorSet(const std::vector<const std::string*>& operatorVector);
+	static const std::string* lookupOperator(const std::string& line, size_t index,
+	                                         const ASOperatorSet& possibleOperators);
 
 public:
 	static const std::string AS_IF, AS_ELSE;
@@ -289,6 +710,55 @@ public:
 	static const std::string AS_NS_DURING, AS_NS_HANDLER;
 };  // Class ASResource
 
+//-----------------------------------------------------------------------------
+// Class ASLanguageVectors
+// Functions definitions are in ASResource.cpp.
+//-----------------------------------------------------------------------------
+
+// The header and operator vectors for one file type.
+// They are built once and shared by all ASFormatter, ASBeautifier
+// and ASEnhancer objects, so they are only used as const.
+class ASLanguageVectors : protected ASResource
+{
+public:
+	static const ASLanguageVectors& get(int fileType);
+
+private:
+	explicit ASLanguageVectors(int fileType);
+
+public:
+	// used by ASFormatter
+	std::vector<const std::string*> headers;
+	std::vector<const std::string*> nonParenHeaders;
+	std::vector<const std::string*> preDefinitionHeaders;
+	std::vector<const std::string*> operators;
+	std::vector<const std::string*> castOperators;
+	// used by ASBeautifier
+	std::vector<const std::string*> beautifierHeaders;
+	std::vector<const std::string*> beautifierNonParenHeaders;
+	std::vector<const std::string*> preBlockStatements;
+	std::vector<const std::string*> nonAssignmentOperators;
+	std::vector<const std::string*> indentableHeaders;
+	// used by both
+	std::vector<const std::string*> preCommandHeaders;
+	std::vector<const std::string*> assignmentOperators;
+	// used by ASEnhancer
+	std::vector<const std::pair<const std::string, const std::string>* > indentableMacros;
+	// the operator vectors as sets for ASBase::findOperator
+	ASOperatorSet operatorSet;
+	ASOperatorSet nonAssignmentOperatorSet;
+	ASOperatorSet assignmentOperatorSet;
+	// the header vectors as sets for ASBase::findHeader
+	ASKeywordSet headerSet;
+	ASKeywordSet nonParenHeaderSet;
+	ASKeywordSet preDefinitionHeaderSet;
+	ASKeywordSet castOperatorSet;
+	ASKeywordSet beautifierHeaderSet;
+	ASKeywordSet preBlockStatementSet;
+	ASKeywordSet indentableHeaderSet;
+	ASKeywordSet preCommandHeaderSet;
+};  // Class ASLanguageVectors
+
 //-----------------------------------------------------------------------------
 // Class ASBase
 // Functions definitions are at the end of ASResource.cpp.
@@ -299,33 +769,52 @@ class ASBase : protected ASResource
 private:
 	// all variables should be set by the "init" function
 	int baseFileType = C_TYPE;      // a value from enum FileType
+	const unsigned char* charClasses = getCharClasses(C_TYPE);
 
 protected:
 	ASBase() = default;
 
 protected:  // inline functions
-	void init(int fileTypeArg) { baseFileType = fileTypeArg; }
+	void init(int fileTypeArg) { baseFileType = fileTypeArg; charClasses = getCharClasses(fileTypeArg); }
 	bool isCStyle() const { return baseFileType == C_TYPE || baseFileType == OBJC_TYPE; }
 	bool isJavaStyle() const { return baseFileType == JAVA_TYPE; }
 	bool isSharpStyle() const { return baseFileType == SHARP_TYPE; }
 	bool isJSStyle() const { return baseFileType == JS_TYPE; }
 	bool isObjCStyle() const { return baseFileType == OBJC_TYPE; }
 
-	bool isWhiteSpace(char ch) const { return (ch == ' ' || ch == '\t'); }
+	bool isWhiteSpace(char ch) const { return (charClasses[(unsigned char) ch] & CHAR_WHITESPACE) != 0; }
+	// check if a specific character can be used in a legal variable/method/class name
+	bool isLegalNameChar(char ch) const { return (charClasses[(unsigned char) ch] & CHAR_NAME) != 0; }
+	// check if a specific character can be part of an operator
+	bool isCharPotentialOperator(char ch) const
+	{
+		assert(!isWhiteSpace(ch));
+		return (charClasses[(unsigned char) ch] & CHAR_OPERATOR) != 0;
+	}
+	// check if a specific character can be part of a header
+	bool isCharPotentialHeader(const std::string& line, size_t i) const
+	{
+		assert(!isWhiteSpace(line[i]));
+		if (!isLegalNameChar(line[i]))
+			return false;
+		if (i == 0 || (i > 1 && line[i - 2] == '\\'))
+			return true;
+		return !isLegalNameChar(line[i - 1]);
+	}
 
 protected:  // functions definitions are at the end of ASResource.cpp
 	const std::string* findHeader(const std::string& line, int i,
-	                              const std::vector<const std::string*>* possibleHeaders) const;
+	                              const ASKeywordSet* possibleHeaders) const;
 	bool findKeyword(const std::string& line, int i, const std::string& keyword) const;
+	const std::string* getKeyword(const std::string& line, int i) const;
+	const std::string* getKeyword(const std::string& line, int i, size_t& keywordId) const;
 	const std::string* findOperator(const std::string& line, int i,
-	                                const std::vector<const std::string*>* possibleOperators) const;
+	                                const ASOperatorSet* possibleOperators) const;
 	std::string getCurrentWord(const std::string& line, size_t index) const;
 	bool isDigit(char ch) const;
-	bool isLegalNameChar(char ch) const;
-	bool isCharPotentialHeader(const std::string& line, size_t i) const;
-	bool isCharPotentialOperator(char ch) const;
 	bool isDigitSeparator(const std::string& line, int i) const;
 	char peekNextChar(const std::string& line, int i) const;
+	static const unsigned char* getCharClasses(int fileType);
 
 };  // Class ASBase
 
@@ -390,35 +879,46 @@ public:
 	bool getModeManuallySet() const;
 	bool getModifierIndent() const;
 	bool getNamespaceIndent() const;
+	bool getPreprocConditionalIndent() const;
 	bool getPreprocDefineIndent() const;
 	bool getSwitchIndent() const;
 
 protected:
-	void deleteBeautifierVectors();
 	int  getNextProgramCharDistance(const std::string& line, int i) const;
-	int  indexOf(const std::vector<const std::string*>& container, const std::string* element) const;
+	template<typename T> int indexOf(const T& container, const std::string* element) const;
 	void setBlockIndent(bool state);
 	void setBraceIndent(bool state);
 	void setBraceIndentVtk(bool state);
 	std::string extractPreprocessorStatement(const std::string& line) const;
 	std::string trim(const std::string& str) const;
 	std::string rtrim(const std::string& str) const;
+	void deleteBeautifierState();
+	void copyBeautifierState(const ASBeautifier& other, ASArena* arena_, ASSourceIterator* iter);
+	bool hasEqualState(const ASBeautifier& other) const;
+	void setArena(ASArena* arena_);
+	bool isTopLevelBoundary() const;
 
 	// variables set by ASFormatter - must be updated in activeBeautifierStack
 	int  inLineNumber;
 	int  runInIndentContinuation;
 	int  nonInStatementBrace;
 	int  objCColonAlignSubsequent;		// for subsequent lines not counting indent
-	bool lineCommentNoBeautify;
-	bool isElseHeaderIndent;
-	bool isCaseHeaderCommentIndent;
-	bool isNonInStatementArray;
-	bool isSharpAccessor;
-	bool isSharpDelegate;
-	bool isInExternC;
-	bool isInBeautifySQL;
-	bool isInIndentableStruct;
-	bool isInIndentablePreproc;
+
+	// the bool variables set by ASFormatter in one state block
+	struct BeautifierHints
+	{
+		bool lineCommentNoBeautify;
+		bool isElseHeaderIndent;
+		bool isCaseHeaderCommentIndent;
+		bool isNonInStatementArray;
+		bool isSharpAccessor;
+		bool isSharpDelegate;
+		bool isInExternC;
+		bool isInBeautifySQL;
+		bool isInIndentableStruct;
+		bool isInIndentablePreproc;
+	};
+	BeautifierHints hints;
 	bool lambdaIndicator;
 
 
@@ -434,11 +934,10 @@ private:  // functions
 	                                int tabIncrementIn, int minIndent, bool updateParenStack);
 	void registerContinuationIndentColon(const std::string& line, int i, int tabIncrementIn);
 	void initVectors();
-	void initTempStacksContainer(std::vector<std::vector<const std::string*>*>*& container,
-	                             std::vector<std::vector<const std::string*>*>* value);
 	void clearObjCMethodDefinitionAlignment();
-	void deleteBeautifierContainer(std::vector<ASBeautifier*>*& container);
-	void deleteTempStacksContainer(std::vector<std::vector<const std::string*>*>*& container);
+	void deleteBeautifierContainer(ASSmallVector<ASBeautifier*, 8>& container);
+	void deleteBeautifierClone(ASBeautifier* beautifier) const;
+	ASBeautifier* newBeautifierClone(const ASBeautifier& other) const;
 	int  adjustIndentCountForBreakElseIfComments() const;
 	int  computeObjCColonAlignment(const std::string& line, int colonAlignPosition) const;
 	int  convertTabToSpaces(int i, int tabIncrementIn) const;
@@ -455,35 +954,37 @@ private:  // functions
 	const std::string& getIndentedLineReturn(const std::string& newLine, const std::string& originalLine) const;
 	std::string getIndentedSpaceEquivalent(const std::string& line_) const;
 	std::string preLineWS(int lineIndentCount, int lineSpaceIndentCount) const;
-	template<typename T> void deleteContainer(T& container);
-	template<typename T> void initContainer(T& container, T value);
-	std::vector<std::vector<const std::string*>*>* copyTempStacks(const ASBeautifier& other) const;
 	std::pair<int, int> computePreprocessorIndent();
 
 private:  // variables
+	// A new bool variable is added to a state block (BeautifierOptions,
+	// BeautifierFlags or BeautifierHints). Any other new variable must be
+	// copied in the copy constructor and compared in hasEqualState, or the
+	// incremental formatting of ASFormatter will resume from a wrong state.
+	ASArena* arena;			// nullptr uses the global heap
 	int beautifierFileType;
-	std::vector<const std::string*>* headers;
-	std::vector<const std::string*>* nonParenHeaders;
-	std::vector<const std::string*>* preBlockStatements;
-	std::vector<const std::string*>* preCommandHeaders;
-	std::vector<const std::string*>* assignmentOperators;
-	std::vector<const std::string*>* nonAssignmentOperators;
-	std::vector<const std::string*>* indentableHeaders;
-
-	std::vector<ASBeautifier*>* waitingBeautifierStack;
-	std::vector<ASBeautifier*>* activeBeautifierStack;
-	std::vector<size_t>* waitingBeautifierStackLengthStack;
-	std::vector<size_t>* activeBeautifierStackLengthStack;
-	std::vector<const std::string*>* headerStack;
-	std::vector<std::vector<const std::string*>* >* tempStacks;
-	std::vector<int>* parenDepthStack;
-	std::vector<bool>* blockStatementStack;
-	std::vector<bool>* parenStatementStack;
-	std::vector<bool>* braceBlockStateStack;
-	std::vector<int>* continuationIndentStack;
-	std::vector<size_t>* continuationIndentStackSizeStack;
-	std::vector<int>* parenIndentStack;
-	std::vector<std::pair<int, int> >* preprocIndentStack;
+	const ASKeywordSet* headers;
+	const std::vector<const std::string*>* nonParenHeaders;
+	const ASKeywordSet* preBlockStatements;
+	const ASKeywordSet* preCommandHeaders;
+	const ASOperatorSet* assignmentOperators;
+	const ASOperatorSet* nonAssignmentOperators;
+	const ASKeywordSet* indentableHeaders;
+
+	ASSmallVector<ASBeautifier*, 8> waitingBeautifierStack;
+	ASSmallVector<ASBeautifier*, 8> activeBeautifierStack;
+	ASSmallVector<size_t, 8> waitingBeautifierStackLengthStack;
+	ASSmallVector<size_t, 8> activeBeautifierStackLengthStack;
+	ASStack<const std::string*> headerStack;
+	ASStack<ASStack<const std::string*> > tempStacks;
+	ASStack<int> parenDepthStack;
+	ASStack<bool> blockStatementStack;
+	ASStack<bool> parenStatementStack;
+	ASStack<bool> braceBlockStateStack;
+	ASStack<int> continuationIndentStack;
+	ASStack<size_t> continuationIndentStackSizeStack;
+	ASStack<int> parenIndentStack;
+	ASStack<std::pair<int, int> > preprocIndentStack;
 	std::vector<std::pair<size_t, size_t> > squeezeWSStack;
 
 	ASSourceIterator* sourceIterator;
@@ -493,82 +994,99 @@ private:  // variables
 	const std::string* lastLineHeader;
 	std::string indentString;
 	std::string verbatimDelimiter;
-	bool isInQuote;
-	bool isInVerbatimQuote;
-	bool haveLineContinuationChar;
-	bool isInAsm;
-	bool isInAsmOneLine;
-	bool isInAsmBlock;
-	bool isInComment;
-	bool isInPreprocessorComment;
-	bool isInRunInComment;
-	bool isInCase;
-	bool isInQuestion;
-	bool isContinuation;
-	bool isInHeader;
-	bool isInTemplate;
-	bool isInDefine;
-	bool isInDefineDefinition;
-	bool classIndent;
-	bool isIndentModeOff;
-	bool isInClassHeader;			// is in a class before the opening brace
-	bool isInClassHeaderTab;		// is in an indentable class header line
-	bool isInClassInitializer;		// is in a class after the ':' initializer
-	bool isInClass;					// is in a class after the opening brace
-	bool isInObjCMethodDefinition;
-	bool isInObjCMethodCall;
-	bool isInObjCMethodCallFirst;
-	bool isImmediatelyPostObjCMethodDefinition;
-	bool isImmediatelyPostObjCMethodCall;
-	bool isInIndentablePreprocBlock;
-	bool isInObjCInterface;
-	bool isInEnum;
-	bool isInEnumTypeID;
-	bool isInStruct;
-	bool isInLet;
-	bool isInTrailingReturnType;
-	bool modifierIndent;
-	bool switchIndent;
-	bool caseIndent;
-	bool namespaceIndent;
-	bool blockIndent;
-	bool braceIndent;
-	bool braceIndentVtk;
-	bool shouldIndentAfterParen;
-	bool labelIndent;
-	bool shouldIndentPreprocDefine;
-	bool isInConditional;
-	bool isModeManuallySet;
-	bool shouldForceTabIndentation;
-	bool emptyLineFill;
-	bool backslashEndsPrevLine;
-	bool lineOpensWithLineComment;
-	bool lineOpensWithComment;
-	bool lineStartsInComment;
-	bool blockCommentNoIndent;
-	bool blockCommentNoBeautify;
-	bool previousLineProbationTab;
-	bool lineBeginsWithOpenBrace;
-	bool lineBeginsWithCloseBrace;
-	bool lineBeginsWithComma;
-	bool lineIsCommentOnly;
-	bool lineIsLineCommentOnly;
-	bool shouldIndentBracedLine;
-	bool isInSwitch;
-	bool foundPreCommandHeader;
-	bool foundPreCommandMacro;
-	bool shouldAlignMethodColon;
-	bool shouldIndentPreprocConditional;
-	bool squeezeWhitespace;
-	bool attemptLambdaIndentation;
-
-	bool isInAssignment;
+
+	// The bool options are set before a file is formatted and are not
+	// changed by the beautifier. They are a state block of their own,
+	// apart from the parse flags of the file being beautified.
+	struct BeautifierOptions
+	{
+		bool classIndent;
+		bool modifierIndent;
+		bool switchIndent;
+		bool caseIndent;
+		bool namespaceIndent;
+		bool blockIndent;
+		bool braceIndent;
+		bool braceIndentVtk;
+		bool shouldIndentAfterParen;
+		bool labelIndent;
+		bool shouldIndentPreprocDefine;
+		bool isModeManuallySet;
+		bool shouldForceTabIndentation;
+		bool emptyLineFill;
+		bool shouldAlignMethodColon;
+		bool shouldIndentPreprocConditional;
+		bool squeezeWhitespace;
+		bool attemptLambdaIndentation;
+	};
+	BeautifierOptions options;
+
+	// The bool parse flags are kept together in one trivially copyable block.
+	// A clone copies them with one memcpy, and the block can be compared
+	// and hashed as raw bytes with equalStateBlocks and hashStateBlock.
+	struct BeautifierFlags
+	{
+		bool isInQuote;
+		bool isInVerbatimQuote;
+		bool haveLineContinuationChar;
+		bool isInAsm;
+		bool isInAsmOneLine;
+		bool isInAsmBlock;
+		bool isInComment;
+		bool isInPreprocessorComment;
+		bool isInRunInComment;
+		bool isInCase;
+		bool isInQuestion;
+		bool isContinuation;
+		bool isInHeader;
+		bool isInTemplate;
+		bool isInDefine;
+		bool isInDefineDefinition;
+		bool isIndentModeOff;
+		bool isInClassHeader;			// is in a class before the opening brace
+		bool isInClassHeaderTab;		// is in an indentable class header line
+		bool isInClassInitializer;		// is in a class after the ':' initializer
+		bool isInClass;					// is in a class after the opening brace
+		bool isInObjCMethodDefinition;
+		bool isInObjCMethodCall;
+		bool isInObjCMethodCallFirst;
+		bool isImmediatelyPostObjCMethodDefinition;
+		bool isImmediatelyPostObjCMethodCall;
+		bool isInIndentablePreprocBlock;
+		bool isInObjCInterface;
+		bool isInEnum;
+		bool isInEnumTypeID;
+		bool isInStruct;
+		bool isInLet;
+		bool isInTrailingReturnType;
+		bool isInConditional;
+		bool backslashEndsPrevLine;
+		bool lineOpensWithLineComment;
+		bool lineOpensWithComment;
+		bool lineStartsInComment;
+		bool blockCommentNoIndent;
+		bool blockCommentNoBeautify;
+		bool previousLineProbationTab;
+		bool lineBeginsWithOpenBrace;
+		bool lineBeginsWithCloseBrace;
+		bool lineBeginsWithComma;
+		bool lineIsCommentOnly;
+		bool lineIsLineCommentOnly;
+		bool shouldIndentBracedLine;
+		bool isInSwitch;
+		bool foundPreCommandHeader;
+		bool foundPreCommandMacro;
+
+		bool isInAssignment;
+	};
+	BeautifierFlags flags;
 
 	int  indentCount;
 	int  spaceIndentCount;
 	int  spaceIndentObjCMethodAlignment;
 	int  bracePosObjCMethodAlignment;
 	int  colonIndentObjCMethodAlignment;
+	int  keywordIndentObjCMethodAlignment;
 	int  lineOpeningBlocksNum;
 	int  lineClosingBlocksNum;
 	int  fileType;
@@ -587,6 +1105,8 @@ private:  // variables
 	int  prevFinalLineIndentCount;
 	int  defineIndentCount;
 	int  preprocBlockIndent;
+	int  cppExternCBraceState;	// the extern "C" state, used by a beautifier that is not a clone
+	int* cppExternCBrace;		// the extern "C" state shared with the clones
 	char quoteChar;
 	char prevNonSpaceCh;
 	char currentNonSpaceCh;
@@ -603,8 +1123,9 @@ class ASEnhancer : protected ASBase
 public:  // functions
 	ASEnhancer() = default;
 	void init(int, int, int, bool, bool, bool, bool, bool, bool, bool,
-	          std::vector<const std::pair<const std::string, const std::string>* >*);
+	          const std::vector<const std::pair<const std::string, const std::string>* >*);
 	void enhance(std::string& line, bool isInNamespace, bool isInPreprocessor, bool isInSQL);
+	bool hasEqualState(const ASEnhancer& other) const;
 
 private:  // functions
 	void   convertForceTabIndentToSpaces(std::string&  line) const;
@@ -660,7 +1181,7 @@ private:
 	// event table variables
 	bool nextLineIsEventIndent;             // begin event table indent is reached
 	bool isInEventTable;                    // need to indent an event table
-	std::vector<const std::pair<const std::string, const std::string>* >* indentableMacros;
+	const std::vector<const std::pair<const std::string, const std::string>* >* indentableMacros;
 
 	// SQL variables
 	bool nextLineIsDeclareIndent;           // begin declare section indent is reached
@@ -668,6 +1189,45 @@ private:
 
 };  // Class ASEnhancer
 
+//-----------------------------------------------------------------------------
+// Class ASFormatterCheckpoint
+// A snapshot of the ASFormatter state at a line boundary, taken by
+// ASFormatter::createCheckpoint or automatically at the checkpoint
+// interval. ASFormatter::resume continues formatting from it with a
+// source iterator positioned at getSourceLine(). The snapshot has its
+// own copy of the state, it remains valid after the formatter that took
+// it is deleted or starts a new session. Copies share the snapshot.
+// After an edit before the checkpoint, shift() moves the position to
+// the same source text in the edited input.
+//-----------------------------------------------------------------------------
+
+class ASFormatter;
+
+class ASFormatterCheckpoint
+{
+public:
+	ASFormatterCheckpoint() : sourceLine(0), outputLine(0), sourceOffset(0), stateOffset(0) {}
+	bool isValid() const { return state != nullptr; }
+	size_t getSourceLine() const { return sourceLine; }
+	size_t getOutputLine() const { return outputLine; }
+
+	// move the position by the lines and bytes added by an edit, negative if removed
+	void shift(std::ptrdiff_t sourceLines, std::ptrdiff_t outputLines, std::streamoff bytes)
+	{
+		sourceLine += sourceLines;
+		outputLine += outputLines;
+		sourceOffset += bytes;
+	}
+
+private:
+	friend class ASFormatter;
+	std::shared_ptr<const ASFormatter> state;
+	size_t sourceLine;				// lines read from the source iterator
+	size_t outputLine;				// lines returned by ASFormatter::nextLine
+	std::streamoff sourceOffset;	// source iterator offset of the next line
+	std::streamoff stateOffset;		// the offset when the state was taken, not shifted
+};
+
 //-----------------------------------------------------------------------------
 // Class ASFormatter
 //-----------------------------------------------------------------------------
@@ -677,16 +1237,18 @@ class ASFormatter : public ASBeautifier
 public:	// functions
 	ASFormatter();
 	~ASFormatter() override;
-	ASFormatter(const ASFormatter&)            = delete;
 	ASFormatter& operator=(ASFormatter const&) = delete;
 	ASFormatter(ASFormatter&&)                 = delete;
 	ASFormatter& operator=(ASFormatter&&)      = delete;
 	void init(ASSourceIterator* si) override;
+	void reset();
 
 	bool hasMoreLines() const;
 	std::string nextLine();
 	LineEndFormat getLineEndFormat() const;
 	bool getIsLineReady() const;
+	bool getPreprocBlockIndent() const;
+	int  getPendingSourceLines() const;
 	void setFormattingStyle(FormatStyle style);
 	void setAddBracesMode(bool state);
 	void setAddOneLineBracesMode(bool state);
@@ -745,6 +1307,13 @@ public:	// functions
 	size_t getChecksumOut() const;
 	int  getChecksumDiff() const;
 	int  getFormatterFileType() const;
+	const ASArenaStats& getArenaStats() const;
+	ASFormatterCheckpoint createCheckpoint() const;
+	const std::vector<ASFormatterCheckpoint>& getCheckpoints() const;
+	void setCheckpointInterval(int lines);
+	void setCheckpointTopLevelMode(bool state);
+	bool hasCheckpointState(const ASFormatterCheckpoint& checkpoint) const;
+	static std::unique_ptr<ASFormatter> resume(const ASFormatterCheckpoint& checkpoint, ASSourceIterator* si);
 	// retained for compatibility with release 2.06
 	// "Brackets" have been changed to "Braces" in 3.0
 	// they are referenced only by the old "bracket" options
@@ -755,8 +1324,7 @@ public:	// functions
 	void setSqueezeEmptyLinesNumber(int);
 
 private:  // functions
-	template<typename T> void deleteContainer(T& container);
-	template<typename T> void initContainer(T& container, T value);
+	ASFormatter(const ASFormatter& other) = default;	// used only for checkpoints
 	char peekNextChar() const;
 	BraceType getBraceType();
 	bool adjustChecksumIn(int adjustment);
@@ -767,6 +1335,8 @@ private:  // functions
 	bool commentAndHeaderFollows();
 	bool getNextChar();
 	bool getNextLine(bool emptyLineWasDeleted = false);
+	std::streamoff getSourceOffset() const;
+	std::streamoff getPreprocBlockDistance(std::streamoff offset) const;
 	bool isArrayOperator() const;
 	bool isBeforeComment() const;
 	bool isBeforeAnyComment() const;
@@ -775,6 +1345,7 @@ private:  // functions
 	bool isBraceType(BraceType a, BraceType b) const;
 	bool isClassInitializer() const;
 	bool isClosingHeader(const std::string* header) const;
+	bool isCheckpointBoundary() const;
 	bool isCurrentBraceBroken() const;
 	bool isDereferenceOrAddressOf() const;
 	bool isExecSQL(const std::string& line, size_t index) const;
@@ -814,6 +1385,7 @@ private:  // functions
 	void appendSequence(const std::string& sequence, bool canBreakLine = true);
 	void appendSpacePad();
 	void appendSpaceAfter();
+	void addAutomaticCheckpoint();
 	void breakLine(bool isSplitLine = false);
 	void buildLanguageVectors();
 	void updateFormattedLineSplitPoints(char appendedChar);
@@ -821,7 +1393,6 @@ private:  // functions
 	void checkIfTemplateOpener();
 	void clearFormattedLineSplitPoints();
 	void convertTabToSpaces();
-	void deleteContainer(std::vector<BraceType>*& container);
 	void findReturnTypeSplitPoint(const std::string& firstLine);
 	void formatArrayRunIn();
 	void formatRunIn();
@@ -843,7 +1414,6 @@ private:  // functions
 	void fixOptionVariableConflicts();
 	void goForward(int i);
 	void isLineBreakBeforeClosingHeader();
-	void initContainer(std::vector<BraceType>*& container, std::vector<BraceType>* value);
 	void initNewLine();
 	void padObjCMethodColon();
 	void padObjCMethodPrefix();
@@ -868,24 +1438,41 @@ private:  // functions
 	                         const std::shared_ptr<ASPeekStream>& streamArg = nullptr) const;
 
 private:  // variables
+	// A new bool variable is added to a state block (FormatterOptions or
+	// FormatterFlags). Any other new variable must be compared in
+	// hasCheckpointState, unless it is a position in the source.
+	// The copy constructor is the default, so it copies every variable.
 	int formatterFileType;
-	std::vector<const std::string*>* headers;
-	std::vector<const std::string*>* nonParenHeaders;
-	std::vector<const std::string*>* preDefinitionHeaders;
-	std::vector<const std::string*>* preCommandHeaders;
-	std::vector<const std::string*>* operators;
-	std::vector<const std::string*>* assignmentOperators;
-	std::vector<const std::string*>* castOperators;
-	std::vector<const std::pair<const std::string, const std::string>* >* indentableMacros;	// for ASEnhancer
+	const ASKeywordSet* headers;
+	const ASKeywordSet* nonParenHeaders;
+	const ASKeywordSet* preDefinitionHeaders;
+	const ASKeywordSet* preCommandHeaders;
+	const ASOperatorSet* operators;
+	const std::vector<const std::string*>* assignmentOperators;
+	const ASKeywordSet* castOperators;
+	const std::vector<const std::pair<const std::string, const std::string>* >* indentableMacros;	// for ASEnhancer
 
 	ASSourceIterator* sourceIterator;
-	ASEnhancer* enhancer;
+	ASEnhancer enhancer;
+	ASArena sessionArena;		// memory for the clones and stacks of one init() session
+
+	// The checkpoints taken in this session.
+	// A copy of the formatter is the state of a checkpoint,
+	// it starts with an empty list.
+	struct CheckpointList
+	{
+		CheckpointList() = default;
+		CheckpointList(const CheckpointList&) {}
+		CheckpointList& operator=(const CheckpointList&) = delete;
+		std::vector<ASFormatterCheckpoint> items;
+	};
+	CheckpointList checkpoints;
 
-	std::vector<const std::string*>* preBraceHeaderStack;
-	std::vector<BraceType>* braceTypeStack;
-	std::vector<int>* parenStack;
-	std::vector<bool>* structStack;
-	std::vector<bool>* questionMarkStack;
+	ASSmallVector<const std::string*, 16> preBraceHeaderStack;
+	ASSmallVector<BraceType, 32> braceTypeStack;
+	ASSmallVector<int, 16> parenStack;
+	ASSmallVector<bool, 16> structStack;
+	ASSmallVector<bool, 16> questionMarkStack;
 
 	std::string currentLine;
 	std::string formattedLine;
@@ -921,6 +1508,10 @@ private:  // variables
 	size_t methodAttachLineNum;
 	size_t methodBreakCharNum;
 	size_t methodBreakLineNum;
+	size_t sourceLineNum;			// lines read from the source iterator
+	size_t outputLineNum;			// lines returned by nextLine()
+	size_t checkpointInterval;		// lines between automatic checkpoints, 0 is none
+	size_t nextCheckpointLineNum;	// source line for the next automatic checkpoint
 
 	// possible split points
 	size_t maxSemi;			// probably a 'for' statement
@@ -942,159 +1533,174 @@ private:  // variables
 	ReferenceAlign referenceAlignment;
 	ObjCColonPad objCColonPadMode;
 	LineEndFormat lineEnd;
-	bool isVirgin;
-	bool isInVirginLine;
-	bool shouldPadCommas;
-	bool shouldPadOperators;
-	bool shouldPadParensOutside;
-	bool shouldPadFirstParen;
-
-	bool shouldPadEmptyParens;
-	bool shouldPadParensInside;
-	bool shouldPadHeader;
-	bool shouldStripCommentPrefix;
-	bool shouldUnPadParens;
-	bool shouldConvertTabs;
-	bool shouldIndentCol1Comments;
-	bool shouldIndentPreprocBlock;
-	bool shouldCloseTemplates;
-	bool shouldAttachExternC;
-	bool shouldAttachNamespace;
-	bool shouldAttachClass;
-	bool shouldAttachClosingWhile;
-	bool shouldAttachInline;
-	bool isInLineComment;
-	bool isInComment;
-	bool isInCommentStartLine;
-	bool noTrimCommentContinuation;
-	bool isInPreprocessor;
-	bool isInPreprocessorDefineDef;
-	bool isInPreprocessorBeautify;
-	bool isInTemplate;
-	bool doesLineStartComment;
-	bool lineEndsInCommentOnly;
-	bool lineIsCommentOnly;
-	bool lineIsLineCommentOnly;
-	bool lineIsEmpty;
-	bool isImmediatelyPostCommentOnly;
-	bool isImmediatelyPostEmptyLine;
-	bool isInClassInitializer;
-	bool isInQuote;
-	bool isInVerbatimQuote;
-	bool checkInterpolation;
-	bool haveLineContinuationChar;
-	bool isInQuoteContinuation;
-	bool isHeaderInMultiStatementLine;
-	bool isSpecialChar;
-	bool isNonParenHeader;
-	bool foundQuestionMark;
-	bool foundPreDefinitionHeader;
-	bool foundNamespaceHeader;
-	bool foundClassHeader;
-	bool foundStructHeader;
-	bool foundInterfaceHeader;
-	bool foundPreCommandHeader;
-	bool foundPreCommandMacro;
-	bool foundTrailingReturnType;
-	bool foundCastOperator;
-	bool isInLineBreak;
-	bool endOfAsmReached;
-	bool endOfCodeReached;
-	bool lineCommentNoIndent;
-	bool isFormattingModeOff;
-	bool isInEnum;
-	bool isInStruct;
-	bool isInContinuedPreProc;
-	bool isInExecSQL;
-	bool isInAsm;
-	bool isInAsmOneLine;
-	bool isInAsmBlock;
-	bool isLineReady;
-	bool elseHeaderFollowsComments;
-	bool caseHeaderFollowsComments;
-	bool isPreviousBraceBlockRelated;
-	bool isInPotentialCalculation;
-	bool isCharImmediatelyPostComment;
-	bool isPreviousCharPostComment;
-	bool isCharImmediatelyPostLineComment;
-	bool isCharImmediatelyPostOpenBlock;
-	bool isCharImmediatelyPostCloseBlock;
-	bool isCharImmediatelyPostTemplate;
-	bool isCharImmediatelyPostReturn;
-	bool isCharImmediatelyPostThrow;
-	bool isCharImmediatelyPostNewDelete;
-	bool isCharImmediatelyPostOperator;
-	bool isCharImmediatelyPostPointerOrReference;
-	bool isInObjCMethodDefinition;
-	bool isInObjCInterface;
-	bool isInObjCReturnType;
-	bool isInObjCParam;
-	bool isInObjCSelector;
-	bool breakCurrentOneLineBlock;
-	bool shouldRemoveNextClosingBrace;
-	bool isInBraceRunIn;
-	bool returnTypeChecked;
-	bool currentLineBeginsWithBrace;
-	bool attachClosingBraceMode;
-	bool shouldBreakOneLineBlocks;
-	bool shouldBreakOneLineHeaders;
-	bool shouldBreakOneLineStatements;
-	bool shouldBreakClosingHeaderBraces;
-	bool shouldBreakElseIfs;
-	bool shouldBreakLineAfterLogical;
-	bool shouldAddBraces;
-	bool shouldAddOneLineBraces;
-	bool shouldRemoveBraces;
-	bool shouldPadMethodColon;
-	bool shouldPadMethodPrefix;
-	bool shouldReparseCurrentChar;
-	bool shouldUnPadMethodPrefix;
-	bool shouldPadReturnType;
-	bool shouldUnPadReturnType;
-	bool shouldPadParamType;
-	bool shouldUnPadParamType;
-	bool shouldDeleteEmptyLines;
-	bool shouldBreakReturnType;
-	bool shouldBreakReturnTypeDecl;
-	bool shouldAttachReturnType;
-	bool shouldAttachReturnTypeDecl;
-	bool shouldPadBracketsOutside;
-	bool shouldPadBracketsInside;
-	bool shouldUnPadBrackets;
-	bool needHeaderOpeningBrace;
-	bool shouldBreakLineAtNextChar;
-	bool shouldKeepLineUnbroken;
-	bool passedSemicolon;
-	bool passedColon;
-	bool isImmediatelyPostNonInStmt;
-	bool isCharImmediatelyPostNonInStmt;
-	bool isImmediatelyPostComment;
-	bool isImmediatelyPostLineComment;
-	bool isImmediatelyPostEmptyBlock;
-	bool isImmediatelyPostObjCMethodPrefix;
-	bool isImmediatelyPostPreprocessor;
-	bool isImmediatelyPostReturn;
-	bool isImmediatelyPostThrow;
-	bool isImmediatelyPostNewDelete;
-	bool isImmediatelyPostOperator;
-	bool isImmediatelyPostTemplate;
-	bool isImmediatelyPostPointerOrReference;
-	bool shouldBreakBlocks;
-	bool shouldBreakClosingHeaderBlocks;
-	bool isPrependPostBlockEmptyLineRequested;
-	bool isAppendPostBlockEmptyLineRequested;
-	bool isIndentablePreprocessor;
-	bool isIndentablePreprocessorBlck;
-	bool prependEmptyLine;
-	bool appendOpeningBrace;
-	bool foundClosingHeader;
-	bool isInHeader;
-	bool isImmediatelyPostHeader;
-	bool isInCase;
-	bool isFirstPreprocConditional;
-	bool processedFirstConditional;
-	bool isJavaStaticConstructor;
-	bool isInAllocator;
+
+	// The bool options, set by the ASFormatter set functions and by fixOptionVariableConflicts.
+	struct FormatterOptions
+	{
+		bool shouldPadCommas;
+		bool shouldPadOperators;
+		bool shouldPadParensOutside;
+		bool shouldPadFirstParen;
+		bool shouldPadEmptyParens;
+		bool shouldPadParensInside;
+		bool shouldPadHeader;
+		bool shouldStripCommentPrefix;
+		bool shouldUnPadParens;
+		bool shouldConvertTabs;
+		bool shouldIndentCol1Comments;
+		bool shouldIndentPreprocBlock;
+		bool shouldCloseTemplates;
+		bool shouldAttachExternC;
+		bool shouldAttachNamespace;
+		bool shouldAttachClass;
+		bool shouldAttachClosingWhile;
+		bool shouldAttachInline;
+		bool attachClosingBraceMode;
+		bool shouldBreakOneLineBlocks;
+		bool shouldBreakOneLineHeaders;
+		bool shouldBreakOneLineStatements;
+		bool shouldBreakClosingHeaderBraces;
+		bool shouldBreakElseIfs;
+		bool shouldBreakLineAfterLogical;
+		bool shouldAddBraces;
+		bool shouldAddOneLineBraces;
+		bool shouldRemoveBraces;
+		bool shouldPadMethodColon;
+		bool shouldPadMethodPrefix;
+		bool shouldUnPadMethodPrefix;
+		bool shouldPadReturnType;
+		bool shouldUnPadReturnType;
+		bool shouldPadParamType;
+		bool shouldUnPadParamType;
+		bool shouldDeleteEmptyLines;
+		bool shouldBreakReturnType;
+		bool shouldBreakReturnTypeDecl;
+		bool shouldAttachReturnType;
+		bool shouldAttachReturnTypeDecl;
+		bool shouldPadBracketsOutside;
+		bool shouldPadBracketsInside;
+		bool shouldUnPadBrackets;
+		bool shouldCheckpointTopLevel;
+		bool shouldBreakBlocks;
+		bool shouldBreakClosingHeaderBlocks;
+	};
+	FormatterOptions options;
+
+	// The bool parse flags in one state block.
+	struct FormatterFlags
+	{
+		bool isVirgin;
+		bool isInVirginLine;
+
+		bool isInLineComment;
+		bool isInComment;
+		bool isInCommentStartLine;
+		bool noTrimCommentContinuation;
+		bool isInPreprocessor;
+		bool isInPreprocessorDefineDef;
+		bool isInPreprocessorBeautify;
+		bool isInTemplate;
+		bool doesLineStartComment;
+		bool lineEndsInCommentOnly;
+		bool lineIsCommentOnly;
+		bool lineIsLineCommentOnly;
+		bool lineIsEmpty;
+		bool isImmediatelyPostCommentOnly;
+		bool isImmediatelyPostEmptyLine;
+		bool isInClassInitializer;
+		bool isInQuote;
+		bool isInVerbatimQuote;
+		bool checkInterpolation;
+		bool haveLineContinuationChar;
+		bool isInQuoteContinuation;
+		bool isHeaderInMultiStatementLine;
+		bool isSpecialChar;
+		bool isNonParenHeader;
+		bool foundQuestionMark;
+		bool foundPreDefinitionHeader;
+		bool foundNamespaceHeader;
+		bool foundClassHeader;
+		bool foundStructHeader;
+		bool foundInterfaceHeader;
+		bool foundPreCommandHeader;
+		bool foundPreCommandMacro;
+		bool foundTrailingReturnType;
+		bool foundCastOperator;
+		bool isInLineBreak;
+		bool endOfAsmReached;
+		bool endOfCodeReached;
+		bool lineCommentNoIndent;
+		bool isFormattingModeOff;
+		bool isInEnum;
+		bool isInStruct;
+		bool isInContinuedPreProc;
+		bool isInExecSQL;
+		bool isInAsm;
+		bool isInAsmOneLine;
+		bool isInAsmBlock;
+		bool isLineReady;
+		bool elseHeaderFollowsComments;
+		bool caseHeaderFollowsComments;
+		bool isPreviousBraceBlockRelated;
+		bool isInPotentialCalculation;
+		bool isCharImmediatelyPostComment;
+		bool isPreviousCharPostComment;
+		bool isCharImmediatelyPostLineComment;
+		bool isCharImmediatelyPostOpenBlock;
+		bool isCharImmediatelyPostCloseBlock;
+		bool isCharImmediatelyPostTemplate;
+		bool isCharImmediatelyPostReturn;
+		bool isCharImmediatelyPostThrow;
+		bool isCharImmediatelyPostNewDelete;
+		bool isCharImmediatelyPostOperator;
+		bool isCharImmediatelyPostPointerOrReference;
+		bool isInObjCMethodDefinition;
+		bool isInObjCInterface;
+		bool isInObjCReturnType;
+		bool isInObjCParam;
+		bool isInObjCSelector;
+		bool breakCurrentOneLineBlock;
+		bool shouldRemoveNextClosingBrace;
+		bool isInBraceRunIn;
+		bool returnTypeChecked;
+		bool currentLineBeginsWithBrace;
+		bool shouldReparseCurrentChar;
+		bool needHeaderOpeningBrace;
+		bool shouldBreakLineAtNextChar;
+		bool shouldKeepLineUnbroken;
+		bool passedSemicolon;
+		bool passedColon;
+		bool isImmediatelyPostNonInStmt;
+		bool isCharImmediatelyPostNonInStmt;
+		bool isImmediatelyPostComment;
+		bool isImmediatelyPostLineComment;
+		bool isImmediatelyPostEmptyBlock;
+		bool isImmediatelyPostObjCMethodPrefix;
+		bool isImmediatelyPostPreprocessor;
+		bool isImmediatelyPostReturn;
+		bool isImmediatelyPostThrow;
+		bool isImmediatelyPostNewDelete;
+		bool isImmediatelyPostOperator;
+		bool isImmediatelyPostTemplate;
+		bool isImmediatelyPostPointerOrReference;
+		bool isPrependPostBlockEmptyLineRequested;
+		bool isAppendPostBlockEmptyLineRequested;
+		bool isIndentablePreprocessor;
+		bool isIndentablePreprocessorBlck;
+		bool prependEmptyLine;
+		bool appendOpeningBrace;
+		bool isAppendedBraceLine;
+		bool isBreakAtLineStart;
+		bool foundClosingHeader;
+		bool isInHeader;
+		bool isImmediatelyPostHeader;
+		bool isInCase;
+		bool isFirstPreprocConditional;
+		bool processedFirstConditional;
+		bool isJavaStaticConstructor;
+		bool isInAllocator;
+	};
+	FormatterFlags flags;
 
 private:  // inline functions
 	// append the CURRENT character (curentChar) to the current formatted line.
@@ -1106,11 +1712,11 @@ private:  // inline functions
 	{ return currentLine.compare(charNum, strlen(sequence), sequence) == 0; }
 
 	// call ASBase::findHeader for the current character
-	const std::string* findHeader(const std::vector<const std::string*>* headers_)
+	const std::string* findHeader(const ASKeywordSet* headers_)
 	{ return ASBase::findHeader(currentLine, charNum, headers_); }
 
 	// call ASBase::findOperator for the current character
-	const std::string* findOperator(const std::vector<const std::string*>* operators_)
+	const std::string* findOperator(const ASOperatorSet* operators_)
 	{ return ASBase::findOperator(currentLine, charNum, operators_); }
 };  // Class ASFormatter
 
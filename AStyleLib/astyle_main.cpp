@@ -10,9 +10,15 @@
  *   ---------------------------------------
  *   namespace astyle {
  *   ASStreamIterator methods
+ *   ASBufferIterator methods
+ *   ASChunkIterator methods
+ *   ASOutputSink methods
  *   ASConsole methods
  *      // Windows specific
  *      // Linux specific
+ *   ASMappedFile methods
+ *      // Windows specific
+ *      // Linux specific
  *   ASLibrary methods
  *      // Windows specific
  *      // Linux specific
@@ -37,19 +43,42 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <climits>
 #include <clocale>		// needed by some compilers
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
 
+// vector instructions for splitting the input into lines
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define ASTYLE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define ASTYLE_SSE2
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>		// _BitScanForward
+#endif
+
 // includes for recursive getFileNames() function
 #ifdef _WIN32
 	#undef UNICODE		// use ASCII windows functions
 	#include <Windows.h>
+	#include <io.h>
 #else
 	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
 	#include <sys/stat.h>
 	#include <unistd.h>
+	#ifdef __linux__
+		#include <linux/fs.h>		// FICLONE
+		#include <sys/ioctl.h>
+		#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+			#define ASTYLE_COPY_FILE_RANGE
+		#endif
+	#endif
 	#ifdef __VMS
 		#include <unixlib.h>
 		#include <rms.h>
@@ -88,10 +117,15 @@ namespace astyle {
 #endif	// ASTYLE_LIB
 
 // java library build variables
+// the error handler has no user data, it uses the java call on the current thread
 #ifdef ASTYLE_JNI
-	JNIEnv*   g_env;
-	jobject   g_obj;
-	jmethodID g_mid;
+	struct JavaCall
+	{
+		JNIEnv*   env;
+		jobject   obj;
+		jmethodID mid;
+	};
+	thread_local JavaCall* g_javaCall = nullptr;
 #endif
 
 const char* g_version = ASTYLE_VERSION;
@@ -131,196 +165,1832 @@ ASStreamIterator<T>::~ASStreamIterator() = default;
 template<typename T>
 int ASStreamIterator<T>::getStreamLength() const
 {
-	return static_cast<int>(streamLength);
+	return static_cast<int>(streamLength);
+}
+
+/**
+ * read the input stream, delete any end of line characters,
+ *     and build a string that contains the input line.
+ *
+ * @return        string containing the next input line minus any end of line characters
+ */
+template<typename T>
+std::string ASStreamIterator<T>::nextLine(bool emptyLineWasDeleted)
+{
+	// verify that the current position is correct
+	assert(peekStart == 0);
+
+	// a deleted line may be replaced if break-blocks is requested
+	// this sets up the compare to check for a replaced empty line
+	if (prevLineDeleted)
+	{
+		prevLineDeleted = false;
+		checkForEmptyLine = true;
+	}
+	if (!emptyLineWasDeleted)
+		prevBuffer = buffer;
+	else
+		prevLineDeleted = true;
+
+	// read the next record
+	buffer.clear();
+	char ch;
+	inStream->get(ch);
+
+	while (!inStream->eof() && ch != '\n' && ch != '\r')
+	{
+		buffer.append(1, ch);
+		inStream->get(ch);
+	}
+
+	if (inStream->eof())
+	{
+		return buffer;
+	}
+
+	int peekCh = inStream->peek();
+
+	// find input end-of-line characters
+	if (!inStream->eof())
+	{
+		if (ch == '\r')         // CR+LF is windows otherwise Mac OS 9
+		{
+			if (peekCh == '\n')
+			{
+				inStream->get();
+				eolWindows++;
+			}
+			else
+				eolMacOld++;
+		}
+		else                    // LF is Linux, allow for improbable LF/CR
+		{
+			if (peekCh == '\r')
+			{
+				inStream->get();
+				eolWindows++;
+			}
+			else
+				eolLinux++;
+		}
+	}
+	else
+	{
+		inStream->clear();
+	}
+
+	// has not detected an input end of line
+	if (!eolWindows && !eolLinux && !eolMacOld)
+	{
+#ifdef _WIN32
+		eolWindows++;
+#else
+		eolLinux++;
+#endif
+	}
+
+	// set output end of line characters
+	if (eolWindows >= eolLinux)
+	{
+		if (eolWindows >= eolMacOld)
+			outputEOL = "\r\n";     // Windows (CR+LF)
+		else
+			outputEOL = "\r";       // MacOld (CR)
+	}
+	else if (eolLinux >= eolMacOld)
+		outputEOL = "\n";           // Linux (LF)
+	else
+		outputEOL = "\r";           // MacOld (CR)
+
+	return buffer;
+}
+
+// save the current position and get the next line
+// this can be called for multiple reads
+// when finished peeking you MUST call peekReset()
+// call this function from ASFormatter ONLY
+template<typename T>
+std::string ASStreamIterator<T>::peekNextLine()
+{
+	assert(hasMoreLines());
+	std::string nextLine_;
+	char ch;
+
+	if (!peekStart)
+		peekStart = inStream->tellg();
+
+	// read the next record
+	inStream->get(ch);
+	while (!inStream->eof() && ch != '\n' && ch != '\r')
+	{
+		nextLine_.append(1, ch);
+		inStream->get(ch);
+	}
+
+	if (inStream->eof())
+	{
+		return nextLine_;
+	}
+
+	int peekCh = inStream->peek();
+
+	// remove end-of-line characters
+	if (!inStream->eof())
+	{
+		if ((peekCh == '\n' || peekCh == '\r') && peekCh != ch)
+			inStream->get();
+	}
+
+	return nextLine_;
+}
+
+// reset current position and EOF for peekNextLine()
+template<typename T>
+void ASStreamIterator<T>::peekReset()
+{
+	assert(peekStart != 0);
+	inStream->clear();
+	inStream->seekg(peekStart);
+	peekStart = 0;
+}
+
+// save the last input line after input has reached EOF
+template<typename T>
+void ASStreamIterator<T>::saveLastInputLine()
+{
+	assert(inStream->eof());
+	prevBuffer = buffer;
+}
+
+// return position of the get pointer
+template<typename T>
+std::streamoff ASStreamIterator<T>::tellg()
+{
+	return inStream->tellg();
+}
+
+// check for a change in line ends
+template<typename T>
+bool ASStreamIterator<T>::getLineEndChange(int lineEndFormat) const
+{
+	assert(lineEndFormat == LINEEND_DEFAULT
+	       || lineEndFormat == LINEEND_WINDOWS
+	       || lineEndFormat == LINEEND_LINUX
+	       || lineEndFormat == LINEEND_MACOLD);
+
+	bool lineEndChange = false;
+	if (lineEndFormat == LINEEND_WINDOWS)
+		lineEndChange = (eolLinux + eolMacOld != 0);
+	else if (lineEndFormat == LINEEND_LINUX)
+		lineEndChange = (eolWindows + eolMacOld != 0);
+	else if (lineEndFormat == LINEEND_MACOLD)
+		lineEndChange = (eolWindows + eolLinux != 0);
+	else
+	{
+		if (eolWindows > 0)
+			lineEndChange = (eolLinux + eolMacOld != 0);
+		else if (eolLinux > 0)
+			lineEndChange = (eolWindows + eolMacOld != 0);
+		else if (eolMacOld > 0)
+			lineEndChange = (eolWindows + eolLinux != 0);
+	}
+	return lineEndChange;
+}
+
+// the stringstream iterator is no longer used internally
+// it is instantiated here for the plug-ins that still use it
+template class ASStreamIterator<std::stringstream>;
+
+//-----------------------------------------------------------------------------
+// ASBufferIterator class
+// reads a contiguous buffer without copying it to a stream
+//-----------------------------------------------------------------------------
+
+ASBufferIterator::ASBufferIterator(const char* data, size_t length)
+{
+	inBuffer = data;
+	inLength = length;
+	inPos = 0;
+	lineNum = 0;
+	peekLine = 0;
+	linesExamined = 0;
+	buffer.reserve(200);
+	eolWindows = 0;
+	eolLinux = 0;
+	eolMacOld = 0;
+	totalWindows = 0;
+	totalLinux = 0;
+	totalMacOld = 0;
+	peekStart = 0;
+	inEOF = false;
+	prevLineDeleted = false;
+	checkForEmptyLine = false;
+	if (inBuffer == nullptr)
+		inLength = 0;
+	splitLines();
+}
+
+ASBufferIterator::~ASBufferIterator() = default;
+
+/**
+ * split the buffer into lines and count the line ends.
+ * the buffer is searched for CR and LF several bytes at a time
+ * when the compiler targets SSE2 or AVX2.
+ * the counts are the totals that nextLine() will have after
+ * reading the last line, including the default for a buffer
+ * that has only a final end of line.
+ */
+void ASBufferIterator::splitLines()
+{
+	lineStarts.reserve(inLength / 32 + 1);
+	lineEnds.reserve(inLength / 32 + 1);
+	lineStarts.emplace_back(0);
+	size_t lineStart = 0;		// start of the line being split
+	size_t pos = 0;
+#if defined(ASTYLE_AVX2)
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	for (; pos + 32 <= inLength; pos += 32)
+	{
+		const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuffer + pos));
+		unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+		                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, lf))));
+		while (mask != 0)
+		{
+			size_t eol = pos + getLowestBit(mask);
+			mask &= mask - 1;
+			if (eol >= lineStart)		// not the second char of a CRLF
+				lineStart = addLineEnd(eol);
+		}
+	}
+#elif defined(ASTYLE_SSE2)
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	for (; pos + 16 <= inLength; pos += 16)
+	{
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuffer + pos));
+		unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+		                    _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf))));
+		while (mask != 0)
+		{
+			size_t eol = pos + getLowestBit(mask);
+			mask &= mask - 1;
+			if (eol >= lineStart)		// not the second char of a CRLF
+				lineStart = addLineEnd(eol);
+		}
+	}
+#endif
+	// scalar search for the remainder of the buffer
+	for (; pos < inLength; pos++)
+	{
+		if ((inBuffer[pos] == '\r' || inBuffer[pos] == '\n') && pos >= lineStart)
+			lineStart = addLineEnd(pos);
+	}
+	lineEnds.emplace_back(LINE_END_NONE);
+
+	// has not detected an input end of line
+	if (!totalWindows && !totalLinux && !totalMacOld
+	        && lineEnds.size() > 1)
+	{
+#ifdef _WIN32
+		totalWindows++;
+#else
+		totalLinux++;
+#endif
+	}
+	if (lineEnds.size() > 1)
+		inputEOL = selectOutputEOL(totalWindows, totalLinux, totalMacOld);
+}
+
+/**
+ * add the end of line at 'pos' to the line index.
+ *
+ * @return     start of the following line.
+ */
+size_t ASBufferIterator::addLineEnd(size_t pos)
+{
+	char ch = inBuffer[pos];
+	size_t next = pos + 1;
+	if (next == inLength)
+		lineEnds.emplace_back(LINE_END_FINAL);
+	else if (inBuffer[next] == (ch == '\r' ? '\n' : '\r'))
+	{
+		// CR+LF is windows, allow for improbable LF/CR
+		next++;
+		lineEnds.emplace_back(LINE_END_CRLF);
+		totalWindows++;
+	}
+	else if (ch == '\r')
+	{
+		lineEnds.emplace_back(LINE_END_CR);
+		totalMacOld++;
+	}
+	else
+	{
+		lineEnds.emplace_back(LINE_END_LF);
+		totalLinux++;
+	}
+	lineStarts.emplace_back(next);
+	return next;
+}
+
+// start of the line following 'line', or the end of the buffer
+size_t ASBufferIterator::getNextLineStart(size_t line) const
+{
+	return line + 1 < lineStarts.size() ? lineStarts[line + 1] : inLength;
+}
+
+// length of 'line' without the end of line
+size_t ASBufferIterator::getLineLength(size_t line) const
+{
+	size_t length = getNextLineStart(line) - lineStarts[line];
+	if (lineEnds[line] == LINE_END_CRLF)
+		return length - 2;
+	if (lineEnds[line] != LINE_END_NONE)
+		return length - 1;
+	return length;
+}
+
+// index of the lowest set bit in a search mask, the mask must not be zero
+int ASBufferIterator::getLowestBit(unsigned mask)
+{
+	assert(mask != 0);
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<int>(index);
+#elif defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int index = 0;
+	while ((mask & 1) == 0)
+	{
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+// the end of line used most often, Windows wins a tie
+const char* ASBufferIterator::selectOutputEOL(int crlf, int lf, int cr)
+{
+	if (crlf >= lf)
+	{
+		if (crlf >= cr)
+			return "\r\n";      // Windows (CR+LF)
+		return "\r";            // MacOld (CR)
+	}
+	if (lf >= cr)
+		return "\n";            // Linux (LF)
+	return "\r";                // MacOld (CR)
+}
+
+/**
+* get the length of the input buffer.
+*
+* @return     length of the input buffer, converted to an int.
+*/
+int ASBufferIterator::getStreamLength() const
+{
+	return static_cast<int>(inLength);
+}
+
+/**
+ * get the next line from the line index.
+ *
+ * @return        string containing the next input line minus any end of line characters
+ */
+std::string ASBufferIterator::nextLine(bool emptyLineWasDeleted)
+{
+	// verify that the current position is correct
+	assert(peekStart == 0);
+	assert(lineNum < lineEnds.size());
+
+	// a deleted line may be replaced if break-blocks is requested
+	// this sets up the compare to check for a replaced empty line
+	if (prevLineDeleted)
+	{
+		prevLineDeleted = false;
+		checkForEmptyLine = true;
+	}
+	if (!emptyLineWasDeleted)
+		prevBuffer = buffer;
+	else
+		prevLineDeleted = true;
+
+	// read the next line
+	size_t line = lineNum++;
+	buffer.assign(inBuffer + lineStarts[line], getLineLength(line));
+	inPos = getNextLineStart(line);
+
+	if (lineEnds[line] == LINE_END_NONE)
+	{
+		inEOF = true;
+		return buffer;
+	}
+
+	countLineEnd(line);
+	return buffer;
+}
+
+/**
+ * count the input end of line of a line that has been read
+ * and set the output end of line characters.
+ */
+void ASBufferIterator::countLineEnd(size_t line)
+{
+	// count the input end-of-line characters
+	// an end of line that ends the buffer is not counted
+	if (lineEnds[line] == LINE_END_CRLF)
+		eolWindows++;
+	else if (lineEnds[line] == LINE_END_LF)
+		eolLinux++;
+	else if (lineEnds[line] == LINE_END_CR)
+		eolMacOld++;
+
+	// has not detected an input end of line
+	if (!eolWindows && !eolLinux && !eolMacOld)
+	{
+#ifdef _WIN32
+		eolWindows++;
+#else
+		eolLinux++;
+#endif
+	}
+
+	// set output end of line characters, usually unchanged
+	const char* newEOL = selectOutputEOL(eolWindows, eolLinux, eolMacOld);
+	if (outputEOL != newEOL)
+		outputEOL = newEOL;
+}
+
+// save the current position and get the next line
+// this can be called for multiple reads
+// when finished peeking you MUST call peekReset()
+// call this function from ASFormatter ONLY
+std::string ASBufferIterator::peekNextLine()
+{
+	assert(hasMoreLines());
+
+	if (!peekStart)
+	{
+		peekStart = inPos;
+		peekLine = lineNum;
+	}
+
+	// read the next line
+	size_t line = peekLine++;
+	if (peekLine > linesExamined)
+		linesExamined = peekLine;
+	inPos = getNextLineStart(line);
+	if (lineEnds[line] == LINE_END_NONE || lineEnds[line] == LINE_END_FINAL)
+		inEOF = true;
+	return std::string(inBuffer + lineStarts[line], getLineLength(line));
+}
+
+// reset current position and EOF for peekNextLine()
+void ASBufferIterator::peekReset()
+{
+	assert(peekStart != 0);
+	inEOF = false;
+	inPos = peekStart;
+	peekStart = 0;
+}
+
+// save the last input line after input has reached EOF
+void ASBufferIterator::saveLastInputLine()
+{
+	assert(inEOF);
+	prevBuffer = buffer;
+}
+
+/**
+ * position the iterator as if 'line' lines had been read by nextLine().
+ * used to resume formatting from an ASFormatterCheckpoint.
+ * the end of line counts are recomputed for the lines before 'line'.
+ * a deleted empty line before 'line' is not remembered.
+ *
+ * @param line     the number of lines read, the next line returned.
+ */
+void ASBufferIterator::seekLine(size_t line)
+{
+	assert(peekStart == 0);
+	assert(line <= lineEnds.size());
+
+	eolWindows = 0;
+	eolLinux = 0;
+	eolMacOld = 0;
+	outputEOL.clear();
+	for (size_t i = 0; i < line && lineEnds[i] != LINE_END_NONE; i++)
+		countLineEnd(i);
+
+	lineNum = line;
+	peekLine = line;
+	linesExamined = line;
+	inEOF = (line == lineEnds.size());
+	inPos = (line > 0) ? getNextLineStart(line - 1) : 0;
+	buffer.clear();
+	prevBuffer.clear();
+	if (line > 0)
+		buffer.assign(inBuffer + lineStarts[line - 1], getLineLength(line - 1));
+	if (line > 1)
+		prevBuffer.assign(inBuffer + lineStarts[line - 2], getLineLength(line - 2));
+	prevLineDeleted = false;
+	checkForEmptyLine = false;
+}
+
+// return position of the get pointer
+// like a stream, the position is invalid after the end has been read
+std::streamoff ASBufferIterator::tellg()
+{
+	if (inEOF)
+		return -1;
+	return static_cast<std::streamoff>(inPos);
+}
+
+// check for a change in line ends anywhere in the buffer
+bool ASBufferIterator::getLineEndChange(int lineEndFormat) const
+{
+	assert(lineEndFormat == LINEEND_DEFAULT
+	       || lineEndFormat == LINEEND_WINDOWS
+	       || lineEndFormat == LINEEND_LINUX
+	       || lineEndFormat == LINEEND_MACOLD);
+
+	bool lineEndChange = false;
+	if (lineEndFormat == LINEEND_WINDOWS)
+		lineEndChange = (totalLinux + totalMacOld != 0);
+	else if (lineEndFormat == LINEEND_LINUX)
+		lineEndChange = (totalWindows + totalMacOld != 0);
+	else if (lineEndFormat == LINEEND_MACOLD)
+		lineEndChange = (totalWindows + totalLinux != 0);
+	else
+	{
+		if (totalWindows > 0)
+			lineEndChange = (totalLinux + totalMacOld != 0);
+		else if (totalLinux > 0)
+			lineEndChange = (totalWindows + totalMacOld != 0);
+		else if (totalMacOld > 0)
+			lineEndChange = (totalWindows + totalLinux != 0);
+	}
+	return lineEndChange;
+}
+
+//-----------------------------------------------------------------------------
+// ASChunkIterator class
+// reads a stream in chunks without keeping the whole input
+//-----------------------------------------------------------------------------
+
+ASChunkIterator::ASChunkIterator(std::istream* in)
+{
+	inStream = in;
+	windowStart = 0;
+	inPos = 0;
+	peekStart = 0;
+	buffer.reserve(200);
+	eolWindows = 0;
+	eolLinux = 0;
+	eolMacOld = 0;
+	streamEnd = false;
+	inEOF = false;
+}
+
+ASChunkIterator::~ASChunkIterator() = default;
+
+/**
+ * append the next chunk of the stream to the window.
+ *
+ * @return     true if more input was read.
+ */
+bool ASChunkIterator::readChunk()
+{
+	if (streamEnd)
+		return false;
+	size_t windowLength = window.length();
+	window.resize(windowLength + CHUNK_SIZE);
+	inStream->read(&window[windowLength], CHUNK_SIZE);
+	size_t readLength = static_cast<size_t>(inStream->gcount());
+	window.resize(windowLength + readLength);
+	if (readLength < CHUNK_SIZE)
+		streamEnd = true;
+	return readLength > 0;
+}
+
+/**
+ * get the line that starts at stream position 'start',
+ * reading from the stream until the end of the line is known.
+ * a CR or LF at the end of the window needs the following character.
+ *
+ * @return     stream position of the following line.
+ */
+std::streamoff ASChunkIterator::getLine(std::streamoff start, std::string& line, LineEnd& lineEnd)
+{
+	assert(start >= windowStart);
+	size_t lineStart = static_cast<size_t>(start - windowStart);
+	size_t searchStart = lineStart;
+	size_t eol;
+	for (;;)
+	{
+		eol = window.find_first_of("\r\n", searchStart);
+		if (eol != std::string::npos && eol + 1 < window.length())
+			break;
+		// search the new chunk, or check the end of line again
+		searchStart = (eol == std::string::npos) ? window.length() : eol;
+		if (!readChunk())
+			break;
+	}
+
+	if (eol == std::string::npos)
+	{
+		line.assign(window, lineStart, std::string::npos);
+		lineEnd = LINE_END_NONE;
+		return windowStart + static_cast<std::streamoff>(window.length());
+	}
+	line.assign(window, lineStart, eol - lineStart);
+	char ch = window[eol];
+	size_t next = eol + 1;
+	if (next == window.length())
+		lineEnd = LINE_END_FINAL;
+	else if (window[next] == (ch == '\r' ? '\n' : '\r'))
+	{
+		// CR+LF is windows, allow for improbable LF/CR
+		next++;
+		lineEnd = LINE_END_CRLF;
+	}
+	else
+		lineEnd = (ch == '\r') ? LINE_END_CR : LINE_END_LF;
+	return windowStart + static_cast<std::streamoff>(next);
+}
+
+/**
+* get the length of the input that has been read.
+* this is the length of the stream after a read has reached the end.
+*
+* @return     length of the input read, converted to an int.
+*/
+int ASChunkIterator::getStreamLength() const
+{
+	return static_cast<int>(windowStart + static_cast<std::streamoff>(window.length()));
+}
+
+/**
+ * read the input stream, delete any end of line characters,
+ *     and build a string that contains the input line.
+ *
+ * @return        string containing the next input line minus any end of line characters
+ */
+std::string ASChunkIterator::nextLine(bool /*emptyLineWasDeleted*/)
+{
+	// verify that the current position is correct
+	assert(peekStart == 0);
+
+	LineEnd lineEnd;
+	inPos = getLine(inPos, buffer, lineEnd);
+
+	// discard the consumed input once there is a chunk of it
+	size_t consumed = static_cast<size_t>(inPos - windowStart);
+	if (consumed >= CHUNK_SIZE)
+	{
+		window.erase(0, consumed);
+		windowStart = inPos;
+	}
+
+	if (lineEnd == LINE_END_NONE)
+	{
+		inEOF = true;
+		return buffer;
+	}
+
+	// find input end-of-line characters
+	// an end of line that ends the input is not counted
+	if (lineEnd == LINE_END_CRLF)
+		eolWindows++;
+	else if (lineEnd == LINE_END_LF)
+		eolLinux++;
+	else if (lineEnd == LINE_END_CR)
+		eolMacOld++;
+
+	// has not detected an input end of line
+	if (!eolWindows && !eolLinux && !eolMacOld)
+	{
+#ifdef _WIN32
+		eolWindows++;
+#else
+		eolLinux++;
+#endif
+	}
+
+	// set output end of line characters
+	if (eolWindows >= eolLinux)
+	{
+		if (eolWindows >= eolMacOld)
+			outputEOL = "\r\n";     // Windows (CR+LF)
+		else
+			outputEOL = "\r";       // MacOld (CR)
+	}
+	else if (eolLinux >= eolMacOld)
+		outputEOL = "\n";           // Linux (LF)
+	else
+		outputEOL = "\r";           // MacOld (CR)
+
+	return buffer;
+}
+
+// save the current position and get the next line
+// this can be called for multiple reads
+// when finished peeking you MUST call peekReset()
+// call this function from ASFormatter ONLY
+// the peeked lines stay in the window until they are consumed
+std::string ASChunkIterator::peekNextLine()
+{
+	assert(hasMoreLines());
+
+	if (!peekStart)
+		peekStart = inPos;
+
+	std::string nextLine_;
+	LineEnd lineEnd;
+	inPos = getLine(inPos, nextLine_, lineEnd);
+	if (lineEnd == LINE_END_NONE || lineEnd == LINE_END_FINAL)
+		inEOF = true;
+	return nextLine_;
+}
+
+// reset current position and EOF for peekNextLine()
+void ASChunkIterator::peekReset()
+{
+	assert(peekStart != 0);
+	inEOF = false;
+	inPos = peekStart;
+	peekStart = 0;
+}
+
+// return position of the get pointer
+// like a stream, the position is invalid after the end has been read
+std::streamoff ASChunkIterator::tellg()
+{
+	if (inEOF)
+		return -1;
+	return inPos;
+}
+
+//-----------------------------------------------------------------------------
+// ASOutputSink classes
+// receive the formatted output
+//-----------------------------------------------------------------------------
+
+void ASStringSink::write(const char* data, size_t length)
+{
+	text.append(data, length);
+}
+
+ASArraySink::ASArraySink(char* buffer, size_t capacity)
+{
+	outBuffer = buffer;
+	outCapacity = (buffer == nullptr) ? 0 : capacity;
+	outLength = 0;
+}
+
+// write as much as fits, the length counts everything written
+void ASArraySink::write(const char* data, size_t length)
+{
+	if (outLength < outCapacity)
+	{
+		size_t copyLength = std::min(length, outCapacity - outLength);
+		memcpy(outBuffer + outLength, data, copyLength);
+	}
+	outLength += length;
+}
+
+ASFileSink::ASFileSink(int fd)
+{
+	outFd = fd;
+	outBuffer.reserve(BUFFER_SIZE);
+	writeError = false;
+}
+
+ASFileSink::~ASFileSink()
+{
+	flush();
+}
+
+/**
+ * write the buffered output to the file descriptor.
+ *
+ * @return     false if a write has failed.
+ */
+bool ASFileSink::flush()
+{
+	if (!outBuffer.empty())
+	{
+		writeAll(outBuffer.data(), outBuffer.length());
+		outBuffer.clear();
+	}
+	return !writeError;
+}
+
+void ASFileSink::write(const char* data, size_t length)
+{
+	if (outBuffer.length() + length > BUFFER_SIZE)
+	{
+		flush();
+		// a large write does not need the buffer
+		if (length >= BUFFER_SIZE)
+		{
+			writeAll(data, length);
+			return;
+		}
+	}
+	outBuffer.append(data, length);
+}
+
+// write to the file descriptor until done or an error occurs
+bool ASFileSink::writeAll(const char* data, size_t length)
+{
+	while (length > 0 && !writeError)
+	{
+		unsigned int request = static_cast<unsigned int>(std::min(length, static_cast<size_t>(INT_MAX)));
+#ifdef _WIN32
+		int written = _write(outFd, data, request);
+#else
+		ssize_t written = ::write(outFd, data, request);
+		if (written < 0 && errno == EINTR)
+			continue;
+#endif
+		if (written <= 0)
+		{
+			writeError = true;
+			break;
+		}
+		data += written;
+		length -= static_cast<size_t>(written);
+	}
+	return !writeError;
+}
+
+ASCallbackSink::ASCallbackSink(WriteFunction writeFunction, void* userData)
+{
+	outFunction = writeFunction;
+	outUserData = userData;
+}
+
+void ASCallbackSink::write(const char* data, size_t length)
+{
+	if (length > 0)
+		outFunction(data, length, outUserData);
+}
+
+//-----------------------------------------------------------------------------
+// ASIncrementalFormatter class
+// formats an edited buffer again from the cached checkpoints
+//-----------------------------------------------------------------------------
+
+/**
+ * the formatter has the options for all of the calls.
+ * it must stay valid while this object is used.
+ *
+ * @param formatter_            the formatter with the options set.
+ * @param checkpointInterval    the source lines between checkpoints.
+ */
+ASIncrementalFormatter::ASIncrementalFormatter(ASFormatter& formatter_, int checkpointInterval)
+	: formatter(formatter_)
+{
+	formatter.setCheckpointInterval(checkpointInterval);
+	sourceLength = 0;
+	sourceLineCount = 0;
+	linesFormatted = 0;
+	sourceEOLChange = false;
+}
+
+/**
+ * format a new buffer in full and cache the output and the checkpoints.
+ * the buffer is not needed after the call.
+ */
+void ASIncrementalFormatter::format(const char* data, size_t length)
+{
+	ASBufferIterator streamIterator(data, length);
+	formatter.init(&streamIterator);
+
+	outputLines.clear();
+	checkpoints.clear();
+	// a checkpoint at the start, so any edit has a checkpoint before it
+	checkpoints.push_back(Checkpoint {formatter.createCheckpoint(), 0});
+	formatLines(formatter, streamIterator, outputLines, checkpoints, 0, 0, 0);
+
+	sourceEOL = streamIterator.getInputEOL();
+	sourceEOLChange = streamIterator.getLineEndChange(LINEEND_DEFAULT);
+	sourceLength = length;
+	sourceLineCount = streamIterator.getLineCount();
+	linesFormatted = sourceLineCount;
+}
+
+/**
+ * format an edited buffer again.
+ * lines [firstLine, firstLine + oldLineCount) of the previous buffer were
+ * replaced by lines [firstLine, firstLine + newLineCount) of the new one.
+ * the other lines, including their line ends, must not have changed.
+ * formatting starts at the last checkpoint that does not depend on the
+ * edited lines. it stops when the state is the state of a previous
+ * checkpoint after the edit and the rest of the previous output is kept.
+ * the buffer is formatted in full if there is no previous output or the
+ * line ends are mixed.
+ */
+void ASIncrementalFormatter::reformat(const char* data, size_t length,
+                                      size_t firstLine, size_t oldLineCount, size_t newLineCount)
+{
+	ASBufferIterator streamIterator(data, length);
+	if (checkpoints.empty()
+	        || sourceEOLChange
+	        || firstLine + oldLineCount > sourceLineCount
+	        || streamIterator.getLineCount() != sourceLineCount - oldLineCount + newLineCount
+	        || streamIterator.getLineEndChange(LINEEND_DEFAULT)
+	        || streamIterator.getInputEOL() != sourceEOL)
+	{
+		format(data, length);
+		return;
+	}
+
+	// the last checkpoint that did not examine the edited lines
+	size_t startIndex = 0;
+	while (startIndex + 1 < checkpoints.size()
+	        && checkpoints[startIndex + 1].linesExamined <= firstLine)
+		startIndex++;
+	const ASFormatterCheckpoint& start = checkpoints[startIndex].checkpoint;
+
+	streamIterator.seekLine(start.getSourceLine());
+	std::unique_ptr<ASFormatter> runFormatter = ASFormatter::resume(start, &streamIterator);
+	std::vector<std::string> lines;
+	std::vector<Checkpoint> newCheckpoints;
+	std::ptrdiff_t lineDelta = static_cast<std::ptrdiff_t>(newLineCount) - static_cast<std::ptrdiff_t>(oldLineCount);
+	size_t converged = formatLines(*runFormatter, streamIterator, lines, newCheckpoints,
+	                               startIndex + 1, lineDelta, firstLine + newLineCount);
+	linesFormatted = streamIterator.getLinesRead() - start.getSourceLine();
+
+	// splice the new lines into the previous output
+	size_t outputStart = start.getOutputLine();
+	size_t outputEnd = outputLines.size();
+	size_t checkpointEnd = checkpoints.size();
+	if (converged != std::string::npos)
+	{
+		outputEnd = checkpoints[converged].checkpoint.getOutputLine();
+		checkpointEnd = converged;
+		std::ptrdiff_t outputDelta = static_cast<std::ptrdiff_t>(outputStart + lines.size())
+		                             - static_cast<std::ptrdiff_t>(outputEnd);
+		std::streamoff byteDelta = static_cast<std::streamoff>(length) - static_cast<std::streamoff>(sourceLength);
+		for (size_t i = converged; i < checkpoints.size(); i++)
+		{
+			checkpoints[i].checkpoint.shift(lineDelta, outputDelta, byteDelta);
+			checkpoints[i].linesExamined += lineDelta;
+		}
+		// a new checkpoint may have been taken at the converged line
+		while (!newCheckpoints.empty()
+		        && newCheckpoints.back().checkpoint.getSourceLine() >= checkpoints[converged].checkpoint.getSourceLine())
+			newCheckpoints.pop_back();
+	}
+	outputLines.erase(outputLines.begin() + outputStart, outputLines.begin() + outputEnd);
+	outputLines.insert(outputLines.begin() + outputStart,
+	                   std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+	checkpoints.erase(checkpoints.begin() + startIndex + 1, checkpoints.begin() + checkpointEnd);
+	checkpoints.insert(checkpoints.begin() + startIndex + 1, newCheckpoints.begin(), newCheckpoints.end());
+
+	sourceLength = length;
+	sourceLineCount = streamIterator.getLineCount();
+}
+
+/**
+ * write the output of the last call.
+ */
+void ASIncrementalFormatter::writeOutput(ASOutputSink& out) const
+{
+	for (const std::string& line : outputLines)
+		out.write(line);
+}
+
+/**
+ * format lines until the end of the source, or until the state is the
+ * state of a previous checkpoint at the same source text after an edit.
+ * the lines are written as by AStyleMain, with the end of line appended.
+ *
+ * @param previous      the first previous checkpoint to compare.
+ * @param lineDelta     the lines added by the edit, negative if removed.
+ * @param editEnd       the first source line after the edit, 0 is no edit.
+ * @return              the index of the converged previous checkpoint,
+ *                      or std::string::npos if the end was reached.
+ */
+size_t ASIncrementalFormatter::formatLines(ASFormatter& runFormatter, ASBufferIterator& streamIterator,
+                                           std::vector<std::string>& lines, std::vector<Checkpoint>& newCheckpoints,
+                                           size_t previous, std::ptrdiff_t lineDelta, size_t editEnd) const
+{
+	size_t taken = runFormatter.getCheckpoints().size();
+	while (runFormatter.hasMoreLines())
+	{
+		lines.emplace_back(runFormatter.nextLine());
+		if (runFormatter.hasMoreLines())
+			lines.back().append(streamIterator.getOutputEOL());
+		else if (runFormatter.getIsLineReady())
+		{
+			// this can happen if the file if missing a closing brace and break-blocks is requested
+			lines.back().append(streamIterator.getOutputEOL());
+			lines.emplace_back(runFormatter.nextLine());
+		}
+
+		// the automatic checkpoints taken by nextLine()
+		const std::vector<ASFormatterCheckpoint>& formatterCheckpoints = runFormatter.getCheckpoints();
+		for (; taken < formatterCheckpoints.size(); taken++)
+			newCheckpoints.push_back(Checkpoint {formatterCheckpoints[taken], streamIterator.getLinesExamined()});
+
+		// compare with the previous checkpoint at the same source text
+		if (editEnd == 0 || !runFormatter.hasMoreLines()
+		        || streamIterator.getLinesRead() < editEnd)
+			continue;
+		size_t previousLine = static_cast<size_t>(static_cast<std::ptrdiff_t>(streamIterator.getLinesRead()) - lineDelta);
+		while (previous < checkpoints.size()
+		        && checkpoints[previous].checkpoint.getSourceLine() < previousLine)
+			previous++;
+		if (previous < checkpoints.size()
+		        && checkpoints[previous].checkpoint.getSourceLine() == previousLine
+		        && runFormatter.hasCheckpointState(checkpoints[previous].checkpoint))
+			return previous;
+	}
+	return std::string::npos;
+}
+
+//-----------------------------------------------------------------------------
+// ASRangeFormatter class
+// formats a range of lines without formatting the source before it
+//-----------------------------------------------------------------------------
+
+/**
+ * the formatter has the options for all of the calls.
+ * it must stay valid while this object is used.
+ */
+ASRangeFormatter::ASRangeFormatter(ASFormatter& formatter_)
+	: formatter(formatter_)
+{
+	rangeFirstLine = 0;
+	rangeLastLine = 0;
+	rangeStart = 0;
+	rangeEnd = 0;
+	contextLine = 0;
+}
+
+/**
+ * format lines [firstLine, lastLine] of a buffer, the lines are zero based.
+ * formatting starts at the nearest top level line at or before firstLine.
+ * the buffer is not needed after the call.
+ *
+ * @return      false if the lines are not in the buffer.
+ */
+bool ASRangeFormatter::format(const char* data, size_t length, size_t firstLine, size_t lastLine)
+{
+	ASBufferIterator streamIterator(data, length);
+	if (firstLine > lastLine || lastLine >= streamIterator.getLineCount())
+		return false;
+
+	contextLine = findTopLevelLine(data, length, firstLine);
+	streamIterator.seekLine(contextLine);
+	formatter.init(&streamIterator);
+	return formatRange(formatter, streamIterator, firstLine, lastLine);
+}
+
+/**
+ * format lines [firstLine, lastLine] of a buffer starting at a checkpoint
+ * taken from the same source at or before firstLine. a checkpoint of an
+ * ASIncrementalFormatter or a previous format gives the exact context.
+ * the options are the options of the checkpoint. if the checkpoint is
+ * in the middle of a line the range is formatted without it.
+ *
+ * @return      false if the lines are not in the buffer or are before the checkpoint.
+ */
+bool ASRangeFormatter::format(const char* data, size_t length, size_t firstLine, size_t lastLine,
+                              const ASFormatterCheckpoint& context)
+{
+	ASBufferIterator streamIterator(data, length);
+	if (firstLine > lastLine || lastLine >= streamIterator.getLineCount()
+	        || !context.isValid() || context.getSourceLine() > firstLine)
+		return false;
+
+	contextLine = context.getSourceLine();
+	streamIterator.seekLine(contextLine);
+	std::unique_ptr<ASFormatter> runFormatter = ASFormatter::resume(context, &streamIterator);
+	if (!formatRange(*runFormatter, streamIterator, firstLine, lastLine))
+		return format(data, length, firstLine, lastLine);
+	return true;
+}
+
+/**
+ * write the output of the last call.
+ * it replaces the source from getSourceStart() to getSourceEnd().
+ */
+void ASRangeFormatter::writeOutput(ASOutputSink& out) const
+{
+	out.write(output);
+}
+
+/**
+ * format from the context line until the output is past lastLine.
+ * the output is kept from the last source line start in the output at
+ * or before firstLine, to the first one after lastLine.
+ * the lines are written as by AStyleMain, with the end of line appended.
+ *
+ * @return      false if there is no source line start at or before firstLine.
+ */
+bool ASRangeFormatter::formatRange(ASFormatter& runFormatter, ASBufferIterator& streamIterator,
+                                   size_t firstLine, size_t lastLine)
+{
+	// a checkpoint may have a source line that is read but not written
+	int pendingLines = runFormatter.getPendingSourceLines();
+	bool hasFirstLine = (pendingLines >= 0);
+	output.clear();
+	rangeFirstLine = contextLine - std::max(pendingLines, 0);
+	rangeLastLine = streamIterator.getLineCount() - 1;
+	while (runFormatter.hasMoreLines())
+	{
+		output.append(runFormatter.nextLine());
+		if (runFormatter.hasMoreLines())
+			output.append(streamIterator.getOutputEOL());
+		else if (runFormatter.getIsLineReady())
+		{
+			// this can happen if the file if missing a closing brace and break-blocks is requested
+			output.append(streamIterator.getOutputEOL());
+			output.append(runFormatter.nextLine());
+		}
+
+		int pendingLines = runFormatter.getPendingSourceLines();
+		if (pendingLines < 0)
+			continue;
+		size_t sourceLine = streamIterator.getLinesRead() - pendingLines;
+		if (sourceLine <= firstLine)
+		{
+			output.clear();
+			rangeFirstLine = sourceLine;
+			hasFirstLine = true;
+		}
+		else if (sourceLine > lastLine)
+		{
+			rangeLastLine = sourceLine - 1;
+			break;
+		}
+	}
+	rangeStart = streamIterator.getLineStart(rangeFirstLine);
+	rangeEnd = streamIterator.getLineStart(rangeLastLine + 1);
+	return hasFirstLine;
+}
+
+/**
+ * find the nearest line at or before 'line' that starts a top level
+ * statement or declaration. the source is scanned from the start for
+ * braces, parens, comments, quotes and preprocessor statements, it is
+ * not formatted. the line must follow a ';' or a '}' with no open
+ * braces or parens. a line in a preprocessor #else is not top level,
+ * and a conditional with unbalanced braces stops the scan. a line after
+ * an #if for __cplusplus is not used until the statement following it,
+ * the beautifier needs the #if to recognize an extern "C" block.
+ *
+ * @return      the line where formatting starts, 0 if none was found.
+ */
+size_t ASRangeFormatter::findTopLevelLine(const char* data, size_t length, size_t line) const
+{
+	// the depths at a preprocessor #if and at the end of its first branch
+	struct Conditional
+	{
+		int ifBraces;
+		int ifParens;
+		int endBraces;
+		int endParens;
+		bool hasElse;
+	};
+
+	int fileType = formatter.getFileType();
+	bool hasPreprocessor = (fileType == C_TYPE || fileType == OBJC_TYPE || fileType == SHARP_TYPE);
+	bool isIndentedConditional = formatter.getPreprocConditionalIndent() || formatter.getPreprocBlockIndent();
+	std::vector<Conditional> conditionals;
+	std::string rawDelimiter;		// ends a C++ raw string
+	size_t topLevelLine = 0;
+	size_t elseBranches = 0;		// conditionals in an #else or #elif
+	size_t pos = 0;
+	int braceDepth = 0;
+	int parenDepth = 0;
+	char lastCodeChar = ';';		// the start is top level
+	char quoteChar = ' ';			// ' ' if not in a quote
+	bool isMultiLineQuote = false;	// a verbatim, template or text block quote
+	bool isInComment = false;
+	bool isInPreprocessor = false;
+	bool isCplusplusConditional = false;	// the extern "C" block may follow
+
+	for (size_t lineNum = 0; lineNum <= line && pos <= length; lineNum++)
+	{
+		size_t lineEnd = pos;
+		while (lineEnd < length && data[lineEnd] != '\r' && data[lineEnd] != '\n')
+			lineEnd++;
+		size_t textStart = pos;
+		while (textStart < lineEnd && (data[textStart] == ' ' || data[textStart] == '\t'))
+			textStart++;
+
+		// an empty line is not used, the empty lines before it may be squeezed
+		if (braceDepth == 0 && parenDepth == 0
+		        && textStart < lineEnd
+		        && !isInComment
+		        && !isInPreprocessor
+		        && quoteChar == ' '
+		        && rawDelimiter.empty()
+		        && (lastCodeChar == ';' || lastCodeChar == '}')
+		        && elseBranches == 0
+		        && !isCplusplusConditional
+		        && (conditionals.empty() || !isIndentedConditional))
+			topLevelLine = lineNum;
+
+		// a preprocessor statement, braces in it are not counted
+		if (hasPreprocessor && !isInPreprocessor && !isInComment && quoteChar == ' '
+		        && rawDelimiter.empty() && textStart < lineEnd && data[textStart] == '#')
+		{
+			isInPreprocessor = true;
+			size_t word = textStart + 1;
+			while (word < lineEnd && (data[word] == ' ' || data[word] == '\t'))
+				word++;
+			std::string preproc(data + word, lineEnd - word);
+			if (preproc.compare(0, 2, "if") == 0)
+			{
+				conditionals.push_back(Conditional {braceDepth, parenDepth, braceDepth, parenDepth, false});
+				if (preproc.find("__cplusplus") != std::string::npos)
+					isCplusplusConditional = true;
+			}
+			else if (!conditionals.empty()
+			         && (preproc.compare(0, 4, "else") == 0 || preproc.compare(0, 4, "elif") == 0))
+			{
+				// each branch starts with the depths at the #if
+				Conditional& conditional = conditionals.back();
+				if (!conditional.hasElse)
+				{
+					conditional.endBraces = braceDepth;
+					conditional.endParens = parenDepth;
+					conditional.hasElse = true;
+					elseBranches++;
+				}
+				braceDepth = conditional.ifBraces;
+				parenDepth = conditional.ifParens;
+			}
+			else if (!conditionals.empty() && preproc.compare(0, 5, "endif") == 0)
+			{
+				// the beautifier continues with the depths of the first branch
+				Conditional conditional = conditionals.back();
+				conditionals.pop_back();
+				if (conditional.hasElse)
+				{
+					if (conditional.endBraces != braceDepth || conditional.endParens != parenDepth)
+						return topLevelLine;
+					elseBranches--;
+				}
+			}
+		}
+
+		for (size_t i = textStart; i < lineEnd; i++)
+		{
+			char ch = data[i];
+			char prevCh = (i > pos) ? data[i - 1] : ' ';
+			if (isInComment)
+			{
+				if (ch == '*' && i + 1 < lineEnd && data[i + 1] == '/')
+				{
+					isInComment = false;
+					i++;
+				}
+				continue;
+			}
+			if (!rawDelimiter.empty())
+			{
+				if (ch == ')' && std::string(data + i, std::min(rawDelimiter.length(), lineEnd - i)) == rawDelimiter)
+				{
+					i += rawDelimiter.length() - 1;
+					rawDelimiter.clear();
+					lastCodeChar = '"';
+				}
+				continue;
+			}
+			if (quoteChar != ' ')
+			{
+				if (ch == '\\' && !(isMultiLineQuote && quoteChar == '"' && fileType == SHARP_TYPE))
+					i++;
+				else if (ch == quoteChar)
+				{
+					// a verbatim quote is escaped by doubling it
+					if (isMultiLineQuote && fileType == SHARP_TYPE && i + 1 < lineEnd && data[i + 1] == '"')
+						i++;
+					// a Java text block ends with three quotes
+					else if (isMultiLineQuote && fileType == JAVA_TYPE)
+					{
+						if (i + 2 < lineEnd && data[i + 1] == '"' && data[i + 2] == '"')
+						{
+							quoteChar = ' ';
+							i += 2;
+						}
+					}
+					else
+						quoteChar = ' ';
+				}
+				continue;
+			}
+			if (ch == '/' && i + 1 < lineEnd && data[i + 1] == '/')
+				break;
+			if (ch == '/' && i + 1 < lineEnd && data[i + 1] == '*')
+			{
+				isInComment = true;
+				i++;
+				continue;
+			}
+			if (ch == '"' || ch == '\'' || (ch == '`' && fileType == JS_TYPE))
+			{
+				// a digit separator
+				if (ch == '\'' && (fileType == C_TYPE || fileType == OBJC_TYPE)
+				        && isxdigit((unsigned char) prevCh)
+				        && i + 1 < lineEnd && isxdigit((unsigned char) data[i + 1]))
+					continue;
+				lastCodeChar = ch;
+				if (ch == '"' && prevCh == 'R' && (fileType == C_TYPE || fileType == OBJC_TYPE))
+				{
+					size_t paren = i + 1;
+					while (paren < lineEnd && data[paren] != '(' && paren - i <= 17)
+						paren++;
+					if (paren < lineEnd && data[paren] == '(')
+					{
+						rawDelimiter = ")" + std::string(data + i + 1, paren - i - 1) + "\"";
+						i = paren;
+						continue;
+					}
+				}
+				quoteChar = ch;
+				isMultiLineQuote = (ch == '`')
+				                   || (ch == '"' && fileType == SHARP_TYPE && prevCh == '@')
+				                   || (ch == '"' && fileType == SHARP_TYPE && prevCh == '$' && i > pos + 1 && data[i - 2] == '@');
+				if (ch == '"' && fileType == JAVA_TYPE && i + 2 < lineEnd && data[i + 1] == '"' && data[i + 2] == '"')
+				{
+					isMultiLineQuote = true;
+					i += 2;
+				}
+				continue;
+			}
+			if (isInPreprocessor || ch == ' ' || ch == '\t')
+				continue;
+			if (ch == '{')
+				braceDepth++;
+			else if (ch == '}' && braceDepth > 0)
+				braceDepth--;
+			else if (ch == '(' || ch == '[')
+				parenDepth++;
+			else if ((ch == ')' || ch == ']') && parenDepth > 0)
+				parenDepth--;
+			if (ch == ';' || ch == '{' || ch == '}')
+				isCplusplusConditional = false;
+			lastCodeChar = ch;
+		}
+
+		// a line continuation continues a preprocessor statement or a quote
+		bool isContinued = (lineEnd > pos && data[lineEnd - 1] == '\\');
+		if (!isContinued)
+		{
+			isInPreprocessor = false;
+			if (!isMultiLineQuote)
+				quoteChar = ' ';
+		}
+
+		// the end of line, CR+LF or LF+CR is one end
+		pos = lineEnd + 1;
+		if (lineEnd + 1 < length && data[lineEnd + 1] == (data[lineEnd] == '\r' ? '\n' : '\r'))
+			pos++;
+	}
+	return topLevelLine;
+}
+
+//-----------------------------------------------------------------------------
+// ASIndentQuery class
+// gets the indent of a source line from the saved formatter states
+//-----------------------------------------------------------------------------
+
+/**
+ * the options are copied from the formatter, which is not changed
+ * and is not used after this. a change of the options needs a new
+ * ASIndentQuery.
+ *
+ * @param formatter_            the formatter with the options set.
+ * @param checkpointInterval_   the source lines between saved states.
+ */
+ASIndentQuery::ASIndentQuery(const ASFormatter& formatter_, int checkpointInterval_)
+	: formatter(ASFormatter::resume(formatter_.createCheckpoint(), nullptr))
+{
+	formatter->setCheckpointInterval(checkpointInterval_);
+	current.offset = 0;
+	current.linesExamined = 0;
+	linesFormatted = 0;
+}
+
+/**
+ * get the indent of a source line, the leading whitespace of the first
+ * output line of the source line when the source is formatted. an empty
+ * line gets the indent of a statement at the line.
+ * the lines before it must not have been changed since the last call,
+ * unless invalidate() was called for the change.
+ *
+ * @param data      the source, it is not needed after the call.
+ * @param length    the length of the source.
+ * @param line      the zero based line, a line after the end is empty.
+ * @return          the indent string.
+ */
+std::string ASIndentQuery::getIndent(const char* data, size_t length, size_t line)
+{
+	return getIndentFrom(data, length, line, nullptr);
+}
+
+/**
+ * get the indent of a source line starting at a checkpoint taken from the
+ * same source, if it is closer to the line than the saved states.
+ * the checkpoint of an ASIncrementalFormatter or a previous format avoids
+ * formatting the source before it. it should have the options of the
+ * formatter. the states taken after it are saved as the other states are.
+ */
+std::string ASIndentQuery::getIndent(const char* data, size_t length, size_t line,
+                                     const ASFormatterCheckpoint& context)
+{
+	if (!context.isValid() || context.getSourceLine() > line)
+		return getIndentFrom(data, length, line, nullptr);
+	return getIndentFrom(data, length, line, &context);
+}
+
+/**
+ * drop the saved states that depend on the source from firstLine on.
+ * it must be called after an edit, with the first edited line,
+ * before the next call with the edited source.
+ */
+void ASIndentQuery::invalidate(size_t firstLine)
+{
+	while (!states.empty() && states.back().linesExamined > firstLine)
+		states.pop_back();
+	if (current.checkpoint.isValid() && current.linesExamined > firstLine)
+		current.checkpoint = ASFormatterCheckpoint();
+}
+
+/**
+ * drop all of the saved states.
+ */
+void ASIndentQuery::clear()
+{
+	states.clear();
+	current.checkpoint = ASFormatterCheckpoint();
+}
+
+/**
+ * format from the nearest saved state to the line, then format the line
+ * and return the indent of its first output line. the last state before
+ * the formatter reads the line is kept as the current state.
+ */
+std::string ASIndentQuery::getIndentFrom(const char* data, size_t length, size_t line,
+                                         const ASFormatterCheckpoint* context)
+{
+	SavedState start = startAt(data, length, line);
+
+	// a checkpoint after the start replaces it,
+	// the lines before the checkpoint are read but not formatted
+	if (context != nullptr && context->getSourceLine() > start.checkpoint.getSourceLine())
+	{
+		LineIterator lineIterator(data, length, start.offset, start.checkpoint.getSourceLine(), line);
+		while (lineIterator.getLinesRead() < context->getSourceLine())
+			lineIterator.nextLine(false);
+		start.checkpoint = *context;
+		start.offset = lineIterator.getLineStart(context->getSourceLine());
+		start.linesExamined = context->getSourceLine();
+	}
+
+	LineIterator lineIterator(data, length, start.offset, start.checkpoint.getSourceLine(), line);
+	std::unique_ptr<ASFormatter> runFormatter = ASFormatter::resume(start.checkpoint, &lineIterator);
+	std::string outputLine;
+	size_t taken = 0;
+	bool isLineNext = false;
+	while (true)
+	{
+		// the last state before the line is read starts a query at a following line,
+		// the formatter reads a line ahead, so it is taken one line early
+		if (lineIterator.getLinesRead() + 1 >= line
+		        && lineIterator.getLinesExamined() <= line
+		        && !lineIterator.hasReadPastEnd())
+		{
+			current.checkpoint = runFormatter->createCheckpoint();
+			current.offset = lineIterator.getLineStart(lineIterator.getLinesRead());
+			current.linesExamined = lineIterator.getLinesExamined();
+		}
+
+		// the source line that starts the next output line, if there is one
+		int pendingLines = runFormatter->getPendingSourceLines();
+		if (pendingLines >= 0 && lineIterator.getLinesRead() - pendingLines >= line)
+		{
+			isLineNext = (lineIterator.getLinesRead() - pendingLines == line);
+			break;
+		}
+		if (!runFormatter->hasMoreLines())
+			break;
+		outputLine = runFormatter->nextLine();
+		saveCheckpoints(*runFormatter, lineIterator, taken, line);
+	}
+
+	// a line joined to the previous output line has the indent of that line,
+	// an empty line added before the line is skipped
+	if (isLineNext)
+	{
+		do
+			outputLine = runFormatter->nextLine();
+		while (outputLine.find_first_not_of(" \t") == std::string::npos
+		        && runFormatter->hasMoreLines());
+	}
+	linesFormatted = lineIterator.getLinesRead() - start.checkpoint.getSourceLine();
+	return outputLine.substr(0, outputLine.find_first_not_of(" \t"));
+}
+
+/**
+ * save the automatic checkpoints taken by the formatter since the last call.
+ * a checkpoint is saved only if the formatter has not read or peeked at
+ * the queried line, which is changed if it is empty, or past the buffer.
+ *
+ * @param taken     the checkpoints of the formatter already saved.
+ */
+void ASIndentQuery::saveCheckpoints(const ASFormatter& runFormatter, const LineIterator& lineIterator,
+                                    size_t& taken, size_t line)
+{
+	const std::vector<ASFormatterCheckpoint>& formatterCheckpoints = runFormatter.getCheckpoints();
+	for (; taken < formatterCheckpoints.size(); taken++)
+	{
+		if (lineIterator.getLinesExamined() > line || lineIterator.hasReadPastEnd())
+			continue;
+		SavedState state;
+		state.checkpoint = formatterCheckpoints[taken];
+		state.offset = lineIterator.getLineStart(state.checkpoint.getSourceLine());
+		state.linesExamined = lineIterator.getLinesExamined();
+		saveState(std::move(state));
+	}
+}
+
+/**
+ * save a state in source line order, unless there is one at its line.
+ */
+void ASIndentQuery::saveState(SavedState state)
+{
+	auto next = std::upper_bound(states.begin(), states.end(), state.checkpoint.getSourceLine(),
+	                             [](size_t lineNum, const SavedState& saved)
+	{
+		return lineNum < saved.checkpoint.getSourceLine();
+	});
+	if (next != states.begin()
+	        && (next - 1)->checkpoint.getSourceLine() == state.checkpoint.getSourceLine())
+		return;
+	states.insert(next, std::move(state));
+}
+
+/**
+ * get the nearest saved state at or before the line that has not read
+ * the line, or the current state if it is nearer. the first saved
+ * state, at line 0, is made by an init() of the formatter.
+ */
+const ASIndentQuery::SavedState& ASIndentQuery::startAt(const char* data, size_t length, size_t line)
+{
+	if (states.empty())
+	{
+		LineIterator lineIterator(data, length, 0, 0, line);
+		formatter->init(&lineIterator);
+		SavedState first;
+		first.checkpoint = formatter->createCheckpoint();
+		first.offset = 0;
+		first.linesExamined = 0;
+		formatter->reset();
+		states.emplace_back(std::move(first));
+	}
+
+	auto nearest = std::upper_bound(states.cbegin(), states.cend(), line,
+	                                [](size_t lineNum, const SavedState& state)
+	{
+		return lineNum < state.checkpoint.getSourceLine();
+	});
+	--nearest;
+	while (nearest != states.cbegin() && nearest->linesExamined > line)
+		--nearest;
+	if (current.checkpoint.isValid()
+	        && current.linesExamined <= line
+	        && current.checkpoint.getSourceLine() >= nearest->checkpoint.getSourceLine())
+		return current;
+	return *nearest;
+}
+
+/**
+ * the iterator starts at a saved state.
+ *
+ * @param offset        the start of the line in the buffer.
+ * @param line          the line at the offset.
+ * @param targetLine_   the queried line.
+ */
+ASIndentQuery::LineIterator::LineIterator(const char* data, size_t length, size_t offset,
+                                          size_t line, size_t targetLine_)
+{
+	inBuffer = data;
+	inLength = (data == nullptr) ? 0 : length;
+	inPos = offset;
+	firstLine = line;
+	lineNum = line;
+	peekLine = line;
+	linesExamined = line;
+	peekStart = 0;
+	targetLine = targetLine_;
+	inEOF = false;
+	isPastEnd = false;
+}
+
+int ASIndentQuery::LineIterator::getStreamLength() const
+{
+	return static_cast<int>(inLength);
+}
+
+/**
+ * get the next line.
+ *
+ * @return        the line without the end of line.
+ */
+std::string ASIndentQuery::LineIterator::nextLine(bool /*emptyLineWasDeleted*/)
+{
+	assert(peekStart == 0);
+	lineStarts.emplace_back(std::min(inPos, inLength));
+	bool isLast;
+	bool endsBuffer;
+	std::string sourceLine = readLine(inPos, lineNum, isLast, endsBuffer);
+	lineNum++;
+	inEOF = isLast;
+	return sourceLine;
+}
+
+/**
+ * save the current position and get the next line,
+ * as ASBufferIterator::peekNextLine does.
+ */
+std::string ASIndentQuery::LineIterator::peekNextLine()
+{
+	assert(hasMoreLines());
+
+	if (!peekStart)
+	{
+		peekStart = inPos;
+		peekLine = lineNum;
+	}
+	bool isLast;
+	bool endsBuffer;
+	std::string sourceLine = readLine(inPos, peekLine, isLast, endsBuffer);
+	peekLine++;
+	if (peekLine > linesExamined)
+		linesExamined = peekLine;
+	if (isLast || endsBuffer)
+		inEOF = true;
+	return sourceLine;
+}
+
+// reset current position and EOF for peekNextLine()
+void ASIndentQuery::LineIterator::peekReset()
+{
+	assert(peekStart != 0);
+	inEOF = false;
+	inPos = peekStart;
+	peekStart = 0;
+}
+
+// return position of the get pointer
+// like a stream, the position is invalid after the end has been read
+std::streamoff ASIndentQuery::LineIterator::tellg()
+{
+	if (inEOF)
+		return -1;
+	return static_cast<std::streamoff>(std::min(inPos, inLength));
 }
 
 /**
- * read the input stream, delete any end of line characters,
- *     and build a string that contains the input line.
+ * read a line and move the position to the following line.
+ * an end of line of CR+LF or LF+CR is one end. the lines after the
+ * buffer are empty, up to the queried line. the queried line is
+ * read as a placeholder statement if it is empty.
  *
- * @return        string containing the next input line minus any end of line characters
+ * @param pos           the start of the line, past the length after the buffer.
+ * @param isLast        set to true if there are no more lines.
+ * @param endsBuffer    set to true if the end of line is the last character,
+ *                      a peek stops at it as with ASBufferIterator.
+ * @return              the line without the end of line.
  */
-template<typename T>
-std::string ASStreamIterator<T>::nextLine(bool emptyLineWasDeleted)
+std::string ASIndentQuery::LineIterator::readLine(size_t& pos, size_t line, bool& isLast, bool& endsBuffer)
 {
-	// verify that the current position is correct
-	assert(peekStart == 0);
-
-	// a deleted line may be replaced if break-blocks is requested
-	// this sets up the compare to check for a replaced empty line
-	if (prevLineDeleted)
+	std::string sourceLine;
+	endsBuffer = false;
+	if (pos > inLength)
 	{
-		prevLineDeleted = false;
-		checkForEmptyLine = true;
+		isPastEnd = true;
+		isLast = (line >= targetLine);
 	}
-	if (!emptyLineWasDeleted)
-		prevBuffer = buffer;
 	else
-		prevLineDeleted = true;
-
-	// read the next record
-	buffer.clear();
-	char ch;
-	inStream->get(ch);
-
-	while (!inStream->eof() && ch != '\n' && ch != '\r')
-	{
-		buffer.append(1, ch);
-		inStream->get(ch);
-	}
-
-	if (inStream->eof())
-	{
-		return buffer;
-	}
-
-	int peekCh = inStream->peek();
-
-	// find input end-of-line characters
-	if (!inStream->eof())
 	{
-		if (ch == '\r')         // CR+LF is windows otherwise Mac OS 9
+		size_t lineEnd = pos;
+		while (lineEnd < inLength && inBuffer[lineEnd] != '\n' && inBuffer[lineEnd] != '\r')
+			lineEnd++;
+		sourceLine.assign(inBuffer + pos, lineEnd - pos);
+		if (lineEnd == inLength)
 		{
-			if (peekCh == '\n')
-			{
-				inStream->get();
-				eolWindows++;
-			}
-			else
-				eolMacOld++;
+			pos = inLength + 1;
+			isLast = (line >= targetLine);
 		}
-		else                    // LF is Linux, allow for improbable LF/CR
+		else
 		{
-			if (peekCh == '\r')
-			{
-				inStream->get();
-				eolWindows++;
-			}
+			pos = lineEnd + 1;
+			if (pos < inLength && inBuffer[pos] == (inBuffer[lineEnd] == '\r' ? '\n' : '\r'))
+				pos++;
 			else
-				eolLinux++;
+				endsBuffer = (pos == inLength && line + 1 >= targetLine);
+			isLast = false;
 		}
 	}
-	else
-	{
-		inStream->clear();
-	}
-
-	// has not detected an input end of line
-	if (!eolWindows && !eolLinux && !eolMacOld)
-	{
-#ifdef _WIN32
-		eolWindows++;
-#else
-		eolLinux++;
-#endif
-	}
+	if (line == targetLine && sourceLine.find_first_not_of(" \t") == std::string::npos)
+		sourceLine = "x";
+	return sourceLine;
+}
 
-	// set output end of line characters
-	if (eolWindows >= eolLinux)
-	{
-		if (eolWindows >= eolMacOld)
-			outputEOL = "\r\n";     // Windows (CR+LF)
-		else
-			outputEOL = "\r";       // MacOld (CR)
-	}
-	else if (eolLinux >= eolMacOld)
-		outputEOL = "\n";           // Linux (LF)
-	else
-		outputEOL = "\r";           // MacOld (CR)
+//-----------------------------------------------------------------------------
+// ASFormatterPool class
+// reuses configured formatters, it may be used by several threads
+//-----------------------------------------------------------------------------
 
-	return buffer;
+ASFormatterPool::ASFormatterPool(size_t maxIdle_)
+	: maxIdle(maxIdle_)
+{
 }
 
-// save the current position and get the next line
-// this can be called for multiple reads
-// when finished peeking you MUST call peekReset()
-// call this function from ASFormatter ONLY
-template<typename T>
-std::string ASStreamIterator<T>::peekNextLine()
+/**
+ * delete the idle formatters.
+ * used when the options of the keys have changed.
+ * leased formatters are returned to the pool when the lease ends.
+ */
+void ASFormatterPool::clear()
 {
-	assert(hasMoreLines());
-	std::string nextLine_;
-	char ch;
-
-	if (!peekStart)
-		peekStart = inStream->tellg();
-
-	// read the next record
-	inStream->get(ch);
-	while (!inStream->eof() && ch != '\n' && ch != '\r')
-	{
-		nextLine_.append(1, ch);
-		inStream->get(ch);
-	}
-
-	if (inStream->eof())
-	{
-		return nextLine_;
-	}
+	std::lock_guard<std::mutex> lock(poolMutex);
+	idle.clear();
+}
 
-	int peekCh = inStream->peek();
+size_t ASFormatterPool::getIdleCount() const
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return idle.size();
+}
 
-	// remove end-of-line characters
-	if (!inStream->eof())
+/**
+ * remove the most recently used idle formatter for the key.
+ *
+ * @return      the formatter, or nullptr if there is none.
+ */
+std::unique_ptr<ASFormatter> ASFormatterPool::take(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	for (auto entry = idle.begin(); entry != idle.end(); ++entry)
 	{
-		if ((peekCh == '\n' || peekCh == '\r') && peekCh != ch)
-			inStream->get();
+		if (entry->first == key)
+		{
+			std::unique_ptr<ASFormatter> formatter = std::move(entry->second);
+			idle.erase(entry);
+			return formatter;
+		}
 	}
-
-	return nextLine_;
+	return nullptr;
 }
 
-// reset current position and EOF for peekNextLine()
-template<typename T>
-void ASStreamIterator<T>::peekReset()
+/**
+ * return a formatter to the pool, ending the session of its job.
+ * the least recently used formatter is deleted if the pool is full.
+ */
+void ASFormatterPool::release(const std::string& key, std::unique_ptr<ASFormatter> formatter)
 {
-	assert(peekStart != 0);
-	inStream->clear();
-	inStream->seekg(peekStart);
-	peekStart = 0;
+	formatter->reset();
+	std::unique_ptr<ASFormatter> evicted;	// deleted after the lock is released
+	std::lock_guard<std::mutex> lock(poolMutex);
+	idle.emplace_front(key, std::move(formatter));
+	if (idle.size() > maxIdle)
+	{
+		evicted = std::move(idle.back().second);
+		idle.pop_back();
+	}
 }
 
-// save the last input line after input has reached EOF
-template<typename T>
-void ASStreamIterator<T>::saveLastInputLine()
+ASFormatterPool::Lease::Lease(ASFormatterPool* pool_, const std::string& key_,
+                              std::unique_ptr<ASFormatter> formatter_, bool isReusable_)
+	: pool(pool_), key(key_), formatter(std::move(formatter_)), isReusable(isReusable_)
 {
-	assert(inStream->eof());
-	prevBuffer = buffer;
 }
 
-// return position of the get pointer
-template<typename T>
-std::streamoff ASStreamIterator<T>::tellg()
+ASFormatterPool::Lease::Lease(Lease&& other) noexcept
+	: pool(other.pool), key(std::move(other.key)), formatter(std::move(other.formatter)),
+	  isReusable(other.isReusable)
 {
-	return inStream->tellg();
+	other.pool = nullptr;
 }
 
-// check for a change in line ends
-template<typename T>
-bool ASStreamIterator<T>::getLineEndChange(int lineEndFormat) const
+ASFormatterPool::Lease::~Lease()
 {
-	assert(lineEndFormat == LINEEND_DEFAULT
-	       || lineEndFormat == LINEEND_WINDOWS
-	       || lineEndFormat == LINEEND_LINUX
-	       || lineEndFormat == LINEEND_MACOLD);
-
-	bool lineEndChange = false;
-	if (lineEndFormat == LINEEND_WINDOWS)
-		lineEndChange = (eolLinux + eolMacOld != 0);
-	else if (lineEndFormat == LINEEND_LINUX)
-		lineEndChange = (eolWindows + eolMacOld != 0);
-	else if (lineEndFormat == LINEEND_MACOLD)
-		lineEndChange = (eolWindows + eolLinux != 0);
-	else
-	{
-		if (eolWindows > 0)
-			lineEndChange = (eolLinux + eolMacOld != 0);
-		else if (eolLinux > 0)
-			lineEndChange = (eolWindows + eolMacOld != 0);
-		else if (eolMacOld > 0)
-			lineEndChange = (eolWindows + eolLinux != 0);
-	}
-	return lineEndChange;
+	if (pool != nullptr && isReusable)
+		pool->release(key, std::move(formatter));
 }
 
 //-----------------------------------------------------------------------------
@@ -338,6 +2008,7 @@ ASConsole::ASConsole(ASFormatter& formatterArg) : formatter(formatterArg)
 	isDryRun = false;
 	noBackup = false;
 	preserveDate = false;
+	syncFiles = false;
 	isVerbose = false;
 	isQuiet = false;
 	isFormattedOnly = false;
@@ -356,93 +2027,6 @@ ASConsole::ASConsole(ASFormatter& formatterArg) : formatter(formatterArg)
 	linesOut = 0;
 }
 
-// rewrite a stringstream converting the line ends
-void ASConsole::convertLineEnds(std::ostringstream& out, int lineEnd)
-{
-	assert(lineEnd == LINEEND_WINDOWS || lineEnd == LINEEND_LINUX || lineEnd == LINEEND_MACOLD);
-	const std::string& inStr = out.str();	// avoids strange looking syntax
-	std::string outStr;						// the converted output
-	int inLength = (int) inStr.length();
-	for (int pos = 0; pos < inLength; pos++)
-	{
-		if (inStr[pos] == '\r')
-		{
-			if (inStr[pos + 1] == '\n')
-			{
-				// CRLF
-				if (lineEnd == LINEEND_CR)
-				{
-					outStr += inStr[pos];		// Delete the LF
-					pos++;
-					continue;
-				}
-				if (lineEnd == LINEEND_LF)
-				{
-					outStr += inStr[pos + 1];	// Delete the CR
-					pos++;
-					continue;
-				}
-				outStr += inStr[pos];			// Do not change
-				outStr += inStr[pos + 1];
-				pos++;
-				continue;
-			}
-			else                                // NOLINT
-			{
-				// CR
-				if (lineEnd == LINEEND_CRLF)
-				{
-					outStr += inStr[pos];		// Insert the CR
-					outStr += '\n';				// Insert the LF
-					continue;
-				}
-				if (lineEnd == LINEEND_LF)
-				{
-					outStr += '\n';				// Insert the LF
-					continue;
-				}
-				outStr += inStr[pos];		// Do not change
-				continue;
-			}
-		}
-		else if (inStr[pos] == '\n')
-		{
-			// LF
-			if (lineEnd == LINEEND_CRLF)
-			{
-				outStr += '\r';				// Insert the CR
-				outStr += inStr[pos];		// Insert the LF
-				continue;
-			}
-			if (lineEnd == LINEEND_CR)
-			{
-				outStr += '\r';				// Insert the CR
-				continue;
-			}
-			outStr += inStr[pos];		// Do not change
-			continue;
-		}
-		else
-		{
-			outStr += inStr[pos];		// Write the current char
-		}
-	}
-	// replace the stream
-	out.str(outStr);
-}
-
-void ASConsole::correctMixedLineEnds(std::ostringstream& out)
-{
-	LineEndFormat lineEndFormat = LINEEND_DEFAULT;
-	if (outputEOL == "\r\n")
-		lineEndFormat = LINEEND_WINDOWS;
-	if (outputEOL == "\n")
-		lineEndFormat = LINEEND_LINUX;
-	if (outputEOL == "\r")
-		lineEndFormat = LINEEND_MACOLD;
-	convertLineEnds(out, lineEndFormat);
-}
-
 // check files for 16 or 32 bit encoding
 // the file must have a Byte Order Mark (BOM)
 // NOTE: some string functions don't work with NULLs (e.g. length())
@@ -517,18 +2101,9 @@ void ASConsole::formatCinToCout()
 	// The Windows problem occurs when the input is not Windows line-ends.
 	// The tellg() will be out of sequence with the get() statements.
 	// The Linux cin.tellg() will return -1 (invalid).
-	// Copying the input sequentially to a stringstream before
-	// formatting solves the problem for both.
-	std::istream* inStream = &std::cin;
-	std::stringstream outStream;
-	char ch;
-	inStream->get(ch);
-	while (!inStream->eof() && !inStream->fail())
-	{
-		outStream.put(ch);
-		inStream->get(ch);
-	}
-	ASStreamIterator<std::stringstream> streamIterator(&outStream);
+	// The chunk iterator keeps its own positions and reads cin in chunks,
+	// so only the lines needed by the formatter are held in memory.
+	ASChunkIterator streamIterator(&std::cin);
 	// Windows pipe or redirection always outputs Windows line-ends.
 	// Linux pipe or redirection will output any line end.
 #ifdef _WIN32
@@ -538,14 +2113,16 @@ void ASConsole::formatCinToCout()
 #endif // _WIN32
 	initializeOutputEOL(lineEndFormat);
 	formatter.init(&streamIterator);
+	fflush(stdout);
+	ASFileSink out(fileno(stdout));
 
 	while (formatter.hasMoreLines())
 	{
-		std::cout << formatter.nextLine();
+		out.write(formatter.nextLine());
 		if (formatter.hasMoreLines())
 		{
 			setOutputEOL(lineEndFormat, streamIterator.getOutputEOL());
-			std::cout << outputEOL;
+			out.write(outputEOL);
 		}
 		else
 		{
@@ -553,12 +2130,13 @@ void ASConsole::formatCinToCout()
 			if (formatter.getIsLineReady())
 			{
 				setOutputEOL(lineEndFormat, streamIterator.getOutputEOL());
-				std::cout << outputEOL;
-				std::cout << formatter.nextLine();
+				out.write(outputEOL);
+				out.write(formatter.nextLine());
 			}
 		}
 	}
-	std::cout.flush();
+	if (!out.flush())
+		error("Cannot write output file", stdPathOut.empty() ? "stdout" : stdPathOut.c_str());
 }
 
 /**
@@ -568,9 +2146,12 @@ void ASConsole::formatCinToCout()
  */
 void ASConsole::formatFile(const std::string& fileName_)
 {
-	std::stringstream in;
-	std::ostringstream out;
-	FileEncoding encoding = readFile(fileName_, in);
+	ASMappedFile mappedIn;			// the input file if it can be mapped
+	std::string in;					// the input file if it cannot be mapped
+	ASStringSink out;
+	FileEncoding encoding = mapFile(fileName_, mappedIn);
+	if (!mappedIn.isOpen())
+		encoding = readFile(fileName_, in);
 
 	// Unless a specific language mode has been set, set the language mode
 	// according to the file's suffix.
@@ -590,19 +2171,26 @@ void ASConsole::formatFile(const std::string& fileName_)
 	LineEndFormat lineEndFormat = formatter.getLineEndFormat();
 	initializeOutputEOL(lineEndFormat);
 	// do this AFTER setting the file mode
-	ASStreamIterator<std::stringstream> streamIterator(&in);
+	ASBufferIterator streamIterator(mappedIn.isOpen() ? mappedIn.getData() : in.data(),
+	                                mappedIn.isOpen() ? mappedIn.getSize() : in.length());
 	formatter.init(&streamIterator);
+	// the line ends of the whole file are known before formatting
+	// a file without an end of line has none to compare
+	if (!streamIterator.getInputEOL().empty())
+		setOutputEOL(lineEndFormat, streamIterator.getInputEOL());
+
+	std::string readEOL;			// line end of the lines read when the last line end was written
 
 	// format the file
 	while (formatter.hasMoreLines())
 	{
 		nextLine = formatter.nextLine();
-		out << nextLine;
+		out.write(nextLine);
 		linesOut++;
 		if (formatter.hasMoreLines())
 		{
-			setOutputEOL(lineEndFormat, streamIterator.getOutputEOL());
-			out << outputEOL;
+			out.write(outputEOL);
+			readEOL = streamIterator.getOutputEOL();
 		}
 		else
 		{
@@ -610,10 +2198,10 @@ void ASConsole::formatFile(const std::string& fileName_)
 			// this can happen if the file if missing a closing brace and break-blocks is requested
 			if (formatter.getIsLineReady())
 			{
-				setOutputEOL(lineEndFormat, streamIterator.getOutputEOL());
-				out << outputEOL;
+				out.write(outputEOL);
+				readEOL = streamIterator.getOutputEOL();
 				nextLine = formatter.nextLine();
-				out << nextLine;
+				out.write(nextLine);
 				linesOut++;
 				streamIterator.saveLastInputLine();
 			}
@@ -631,10 +2219,16 @@ void ASConsole::formatFile(const std::string& fileName_)
 			streamIterator.checkForEmptyLine = false;
 		}
 	}
-	// correct for mixed line ends
-	if (lineEndsMixed)
+	// the input is not needed after formatting
+	// it must be unmapped before the file can be replaced
+	mappedIn.close();
+
+	// a mixed file is written with the line end selected from the lines read
+	// when the last line end was written, the lines after it are not counted
+	// the line end of the whole file differs only if they change the selection
+	if (lineEndFormat == LINEEND_DEFAULT && !readEOL.empty() && readEOL != outputEOL)
 	{
-		correctMixedLineEnds(out);
+		replaceLineEnds(out.getText(), outputEOL, readEOL);
 		filesAreIdentical = false;
 	}
 
@@ -649,7 +2243,7 @@ void ASConsole::formatFile(const std::string& fileName_)
 	if (!filesAreIdentical || streamIterator.getLineEndChange(lineEndFormat))
 	{
 		if (!isDryRun)
-			writeFile(fileName_, encoding, out);
+			writeFile(fileName_, encoding, out.getText());
 		printMsg(_("Formatted  %s\n"), displayName);
 		filesFormatted++;
 	}
@@ -822,6 +2416,9 @@ std::string ASConsole::getOrigSuffix() const
 bool ASConsole::getPreserveDate() const
 { return preserveDate; }
 
+bool ASConsole::getSyncFiles() const
+{ return syncFiles; }
+
 // for unit testing
 std::string ASConsole::getProjectOptionFileName() const
 {
@@ -932,8 +2529,21 @@ void ASConsole::initializeOutputEOL(LineEndFormat lineEndFormat)
 		outputEOL.clear();
 }
 
-// read a file into the stringstream 'in'
-FileEncoding ASConsole::readFile(const std::string& fileName_, std::stringstream& in) const
+// map a file for reading
+// only 8 bit encodings can be formatted directly from the mapped file
+// mappedFile is not open on return if the file must be read by readFile()
+FileEncoding ASConsole::mapFile(const std::string& fileName_, ASMappedFile& mappedFile) const
+{
+	if (!mappedFile.open(fileName_))
+		return ENCODING_8BIT;
+	FileEncoding encoding = detectEncoding(mappedFile.getData(), mappedFile.getSize());
+	if (encoding != ENCODING_8BIT && encoding != UTF_8BOM)
+		mappedFile.close();
+	return encoding;
+}
+
+// read a file into the string 'in'
+FileEncoding ASConsole::readFile(const std::string& fileName_, std::string& in) const
 {
 	const int blockSize = 65536;	// 64 KB
 	std::ifstream fin(fileName_.c_str(), std::ios::binary);
@@ -963,11 +2573,11 @@ FileEncoding ASConsole::readFile(const std::string& fileName_, std::stringstream
 				error("Cannot allocate memory for utf-8 conversion", fileName_.c_str());
 			size_t utf8Len = encode.utf16ToUtf8(data, dataSize, isBigEndian, firstBlock, utf8Out);
 			assert(utf8Len <= utf8Size);
-			in << std::string(utf8Out, utf8Len);
+			in.append(utf8Out, utf8Len);
 			delete[] utf8Out;
 		}
 		else
-			in << std::string(data, dataSize);
+			in.append(data, dataSize);
 		fin.read(data, blockSize);
 		if (fin.bad())
 			error("Cannot read file", fileName_.c_str());
@@ -1012,6 +2622,9 @@ void ASConsole::setOrigSuffix(const std::string& suffix)
 void ASConsole::setPreserveDate(bool state)
 { preserveDate = state; }
 
+void ASConsole::setSyncFiles(bool state)
+{ syncFiles = state; }
+
 void ASConsole::setProjectOptionFileName(const std::string& optfilepath)
 { projectOptionFileName = optfilepath; }
 
@@ -1022,6 +2635,10 @@ void ASConsole::setStdPathOut(const std::string& path)
 { stdPathOut = path; }
 
 // set outputEOL variable
+// formatFile passes the line end for the whole file so the output is
+// written with a single line end, it is replaced only if the last lines
+// change the selection, see replaceLineEnds()
+// formatCinToCout passes the line end for the lines read so far
 void ASConsole::setOutputEOL(LineEndFormat lineEndFormat, const std::string& currentEOL)
 {
 	if (lineEndFormat == LINEEND_DEFAULT)
@@ -1288,14 +2905,89 @@ void ASConsole::launchDefaultBrowser(const char* filePathIn /*nullptr*/) const
 	printf(_("Opening HTML documentation %s\n"), htmlFilePath.c_str());
 	if (!bypassBrowserOpen)
 	{
-		int ret = ShellExecuteEx(&sei);
-		if (!ret)
-			error(_("Command execute failure"), htmlFilePath.c_str());
+		int ret = ShellExecuteEx(&sei);
+		if (!ret)
+			error(_("Command execute failure"), htmlFilePath.c_str());
+	}
+}
+
+#else  // Linux specific
+
+/**
+ * LINUX function to create a backup of a file that will be replaced.
+ * The backup is a hard link to the original file. If the file system
+ * does not support links the file is copied, and if that fails the
+ * original file is renamed.
+ *
+ * @param fileName_     The path and name of the file to be backed up.
+ * @param stBuf         The status of the file.
+ */
+void ASConsole::backupFile(const std::string& fileName_, const struct stat& stBuf) const
+{
+	std::string origFileName = fileName_ + origSuffix;
+	removeFile(origFileName.c_str(), "Cannot remove pre-existing backup file");
+	if (link(fileName_.c_str(), origFileName.c_str()) == 0)
+		return;
+	errno = 0;
+	if (copyFile(fileName_, origFileName, stBuf))
+		return;
+	renameFile(fileName_.c_str(), origFileName.c_str(), "Cannot create backup file");
+}
+
+/**
+ * LINUX function to copy a file for a backup.
+ * A reflink shares the data blocks on file systems that support it,
+ * otherwise copy_file_range copies the data within the kernel.
+ *
+ * @param fromName      The path and name of the file to be copied.
+ * @param toName        The path and name of the new file.
+ * @param stBuf         The status of the file to be copied.
+ * @return              true if the file has been copied.
+ */
+bool ASConsole::copyFile(const std::string& fromName, const std::string& toName,
+                         const struct stat& stBuf) const
+{
+	int fromFd = ::open(fromName.c_str(), O_RDONLY);
+	if (fromFd < 0)
+	{
+		errno = 0;
+		return false;
+	}
+	int toFd = ::open(toName.c_str(), O_WRONLY | O_CREAT | O_EXCL, stBuf.st_mode & 07777);
+	if (toFd < 0)
+	{
+		::close(fromFd);
+		errno = 0;
+		return false;
+	}
+	bool isCopied = false;
+#ifdef FICLONE
+	isCopied = (ioctl(toFd, FICLONE, fromFd) == 0);
+#endif
+#ifdef ASTYLE_COPY_FILE_RANGE
+	if (!isCopied)
+	{
+		off_t remaining = stBuf.st_size;
+		while (remaining > 0)
+		{
+			ssize_t copied = copy_file_range(fromFd, nullptr, toFd, nullptr,
+			                                 static_cast<size_t>(remaining), 0);
+			if (copied <= 0)
+				break;
+			remaining -= copied;
+		}
+		isCopied = (remaining == 0);
 	}
+#endif
+	::close(fromFd);
+	if (::close(toFd) != 0)
+		isCopied = false;
+	if (!isCopied)
+		::unlink(toName.c_str());
+	errno = 0;
+	return isCopied;
 }
 
-#else  // Linux specific
-
 /**
  * LINUX function to get the current directory.
  * This is done if the fileName does not contain a path.
@@ -1601,6 +3293,93 @@ void ASConsole::launchDefaultBrowser(const char* filePathIn /*nullptr*/) const
 	}
 }
 
+/**
+ * LINUX function to replace a file with new contents.
+ * The output is written to a temporary file in the same directory,
+ * which is renamed over the original, so the file is never partly
+ * written. Links, files with several names and files whose owner
+ * cannot be kept are not replaced, they are rewritten in place.
+ *
+ * @param fileName_     The path and name of the file to be replaced.
+ * @param stBuf         The status of the original file.
+ * @param data          The new contents.
+ * @param length        The length of the new contents.
+ * @return              false if the file was not replaced and must be rewritten.
+ */
+bool ASConsole::replaceFile(const std::string& fileName_, const struct stat& stBuf,
+                            const char* data, size_t length) const
+{
+	struct stat linkBuf;
+	if (lstat(fileName_.c_str(), &linkBuf) != 0
+	        || !S_ISREG(linkBuf.st_mode)
+	        || linkBuf.st_nlink > 1)
+	{
+		errno = 0;
+		return false;
+	}
+
+	// create the temporary file with the mode and owner of the original
+	std::string tempFileName = fileName_ + ".astyle-XXXXXX";
+	int fd = mkstemp(&tempFileName[0]);
+	if (fd < 0)
+	{
+		errno = 0;
+		return false;
+	}
+	if (fchmod(fd, stBuf.st_mode & 07777) != 0
+	        || ((stBuf.st_uid != geteuid() || stBuf.st_gid != getegid())
+	            && fchown(fd, stBuf.st_uid, stBuf.st_gid) != 0))
+	{
+		::close(fd);
+		::unlink(tempFileName.c_str());
+		errno = 0;
+		return false;
+	}
+
+	// write the file
+	bool isWritten;
+	{
+		ASFileSink out(fd);
+		out.write(data, length);
+		isWritten = out.flush();
+	}
+	if (isWritten && syncFiles)
+		isWritten = (fsync(fd) == 0);
+	if (::close(fd) != 0)
+		isWritten = false;
+	if (!isWritten)
+	{
+		perror("errno message");
+		::unlink(tempFileName.c_str());
+		error("Cannot write output file", fileName_.c_str());
+	}
+
+	// create a backup and replace the original
+	if (!noBackup)
+		backupFile(fileName_, stBuf);
+	if (rename(tempFileName.c_str(), fileName_.c_str()) != 0)
+	{
+		perror("errno message");
+		::unlink(tempFileName.c_str());
+		error("Cannot replace output file", fileName_.c_str());
+	}
+	if (syncFiles)
+	{
+		// the rename is durable when the directory is synced
+		size_t separator = fileName_.find_last_of(g_fileSeparator);
+		std::string directory = (separator == std::string::npos)
+		                        ? std::string(".")
+		                        : fileName_.substr(0, separator + 1);
+		int dirFd = ::open(directory.c_str(), O_RDONLY);
+		if (dirFd >= 0)
+		{
+			fsync(dirFd);
+			::close(dirFd);
+		}
+	}
+	return true;
+}
+
 #endif  // _WIN32
 
 /**
@@ -2290,6 +4069,11 @@ void ASConsole::printHelp() const
 	std::cout << "    Preserve the original file's date and time modified. The time\n";
 	std::cout << "     modified will be changed a few micro seconds to force a compile.\n";
 	std::cout << std::endl;
+	std::cout << "    --sync-files\n";
+	std::cout << "    Flush each formatted file to disk before it replaces the\n";
+	std::cout << "    original file. This is slower, but a formatted file is complete\n";
+	std::cout << "    after a system failure. It is not used on Windows.\n";
+	std::cout << std::endl;
 	std::cout << "    --verbose  OR  -v\n";
 	std::cout << "    Verbose mode. Extra informational messages will be displayed.\n";
 	std::cout << std::endl;
@@ -2542,10 +4326,11 @@ void ASConsole::processOptions(const std::vector<std::string>& argvOptions)
 	ASOptions options(formatter, *this);
 	if (!optionFileName.empty())
 	{
-		std::stringstream optionsIn;
+		std::string optionsText;
 		if (!fileExists(optionFileName.c_str()))
 			error(_("Cannot open default option file"), optionFileName.c_str());
-		FileEncoding encoding = readFile(optionFileName, optionsIn);
+		FileEncoding encoding = readFile(optionFileName, optionsText);
+		std::stringstream optionsIn(optionsText);
 		// bypass a BOM, all BOMs have been converted to utf-8
 		if (encoding == UTF_8BOM || encoding == UTF_16LE || encoding == UTF_16BE)
 		{
@@ -2569,10 +4354,11 @@ void ASConsole::processOptions(const std::vector<std::string>& argvOptions)
 
 	if (!projectOptionFileName.empty())
 	{
-		std::stringstream projectOptionsIn;
+		std::string projectOptionsText;
 		if (!fileExists(projectOptionFileName.c_str()))
 			error(_("Cannot open project option file"), projectOptionFileName.c_str());
-		FileEncoding encoding = readFile(projectOptionFileName, projectOptionsIn);
+		FileEncoding encoding = readFile(projectOptionFileName, projectOptionsText);
+		std::stringstream projectOptionsIn(projectOptionsText);
 		// bypass a BOM, all BOMs have been converted to utf-8
 		if (encoding == UTF_8BOM || encoding == UTF_16LE || encoding == UTF_16BE)
 		{
@@ -2618,6 +4404,22 @@ void ASConsole::removeFile(const char* fileName_, const char* errMsg) const
 	}
 }
 
+// replace the line ends of an output that has only 'fromEOL' line ends
+void ASConsole::replaceLineEnds(std::string& text, const std::string& fromEOL, const std::string& toEOL) const
+{
+	std::string replaced;
+	replaced.reserve(text.length() + text.length() / 16);
+	size_t start = 0;
+	for (size_t eol = text.find(fromEOL); eol != std::string::npos; eol = text.find(fromEOL, start))
+	{
+		replaced.append(text, start, eol - start);
+		replaced.append(toEOL);
+		start = eol + fromEOL.length();
+	}
+	replaced.append(text, start, std::string::npos);
+	text.swap(replaced);
+}
+
 // rename a file and check for an error
 void ASConsole::renameFile(const char* oldFileName, const char* newFileName, const char* errMsg) const
 {
@@ -2895,7 +4697,7 @@ int ASConsole::wildcmp(const char* wild, const char* data) const
 	return !*wild;
 }
 
-void ASConsole::writeFile(const std::string& fileName_, FileEncoding encoding, std::ostringstream& out) const
+void ASConsole::writeFile(const std::string& fileName_, FileEncoding encoding, const std::string& out) const
 {
 	// save date accessed and date modified of original file
 	struct stat stBuf;
@@ -2903,34 +4705,44 @@ void ASConsole::writeFile(const std::string& fileName_, FileEncoding encoding, s
 	if (stat(fileName_.c_str(), &stBuf) == -1)
 		statErr = true;
 
-	// create a backup
-	if (!noBackup)
-	{
-		std::string origFileName = fileName_ + origSuffix;
-		removeFile(origFileName.c_str(), "Cannot remove pre-existing backup file");
-		renameFile(fileName_.c_str(), origFileName.c_str(), "Cannot create backup file");
-	}
-
-	// write the output file
-	std::ofstream fout(fileName_.c_str(), std::ios::binary | std::ios::trunc);
-	if (!fout)
-		error("Cannot open output file", fileName_.c_str());
+	const char* outData = out.data();
+	size_t outLength = out.length();
+	std::unique_ptr<char[]> utf16Out;
 	if (encoding == UTF_16LE || encoding == UTF_16BE)
 	{
 		// convert utf-8 to utf-16
 		bool isBigEndian = (encoding == UTF_16BE);
-		size_t utf16Size = encode.utf16LengthFromUtf8(out.str().c_str(), out.str().length());
-		char* utf16Out = new char[utf16Size];
-		size_t utf16Len = encode.utf8ToUtf16(const_cast<char*>(out.str().c_str()),
-		                                     out.str().length(), isBigEndian, utf16Out);
-		assert(utf16Len <= utf16Size);
-		fout << std::string(utf16Out, utf16Len);
-		delete[] utf16Out;
+		size_t utf16Size = encode.utf16LengthFromUtf8(out.c_str(), out.length());
+		utf16Out.reset(new char[utf16Size]);
+		outLength = encode.utf8ToUtf16(const_cast<char*>(out.c_str()),
+		                               out.length(), isBigEndian, utf16Out.get());
+		assert(outLength <= utf16Size);
+		outData = utf16Out.get();
 	}
-	else
-		fout << out.str();
 
-	fout.close();
+#ifdef _WIN32
+	bool isReplaced = false;
+#else
+	// write a new file and rename it over the original
+	bool isReplaced = !statErr && replaceFile(fileName_, stBuf, outData, outLength);
+#endif
+	if (!isReplaced)
+	{
+		// create a backup
+		if (!noBackup)
+		{
+			std::string origFileName = fileName_ + origSuffix;
+			removeFile(origFileName.c_str(), "Cannot remove pre-existing backup file");
+			renameFile(fileName_.c_str(), origFileName.c_str(), "Cannot create backup file");
+		}
+
+		// write the output file
+		std::ofstream fout(fileName_.c_str(), std::ios::binary | std::ios::trunc);
+		if (!fout)
+			error("Cannot open output file", fileName_.c_str());
+		fout.write(outData, static_cast<std::streamsize>(outLength));
+		fout.close();
+	}
 
 	// change date modified to original file date
 	// Embarcadero must be linked with cw32mt not cw32
@@ -2954,6 +4766,119 @@ void ASConsole::writeFile(const std::string& fileName_, FileEncoding encoding, s
 	}
 }
 
+//-----------------------------------------------------------------------------
+// ASMappedFile class
+// used by ASConsole to read input files
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32  // Windows specific
+
+/**
+ * WINDOWS function to map a file for reading.
+ * Only regular disk files that are not empty can be mapped.
+ *
+ * @param fileName_     The path and name of the file to be mapped.
+ * @return              true if the file has been mapped.
+ */
+bool ASMappedFile::open(const std::string& fileName_)
+{
+	close();
+	HANDLE hFile = CreateFile(fileName_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+	                          OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (GetFileType(hFile) != FILE_TYPE_DISK
+	        || !GetFileSizeEx(hFile, &fileSize)
+	        || fileSize.QuadPart <= 0
+	        || static_cast<unsigned long long>(fileSize.QuadPart) > INT_MAX)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	// the view keeps the mapping and the file open
+	HANDLE hMapping = CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(hFile);
+	if (hMapping == nullptr)
+		return false;
+	void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping);
+	if (view == nullptr)
+		return false;
+	mapData = static_cast<const char*>(view);
+	mapSize = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+/**
+ * WINDOWS function to unmap a file.
+ */
+void ASMappedFile::close()
+{
+	if (mapData == nullptr)
+		return;
+	UnmapViewOfFile(mapData);
+	mapData = nullptr;
+	mapSize = 0;
+}
+
+#else  // Linux specific
+
+/**
+ * LINUX function to map a file for reading.
+ * Only regular files that are not empty can be mapped.
+ *
+ * @param fileName_     The path and name of the file to be mapped.
+ * @return              true if the file has been mapped.
+ */
+bool ASMappedFile::open(const std::string& fileName_)
+{
+	close();
+	int fd = ::open(fileName_.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		errno = 0;
+		return false;
+	}
+	struct stat stBuf;
+	if (fstat(fd, &stBuf) == -1
+	        || !S_ISREG(stBuf.st_mode)
+	        || stBuf.st_size <= 0
+	        || static_cast<unsigned long long>(stBuf.st_size) > INT_MAX)
+	{
+		::close(fd);
+		errno = 0;
+		return false;
+	}
+	// the mapping keeps the file open
+	size_t fileSize = static_cast<size_t>(stBuf.st_size);
+	void* view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED)
+	{
+		errno = 0;
+		return false;
+	}
+	posix_madvise(view, fileSize, POSIX_MADV_SEQUENTIAL);
+	mapData = static_cast<const char*>(view);
+	mapSize = fileSize;
+	return true;
+}
+
+/**
+ * LINUX function to unmap a file.
+ */
+void ASMappedFile::close()
+{
+	if (mapData == nullptr)
+		return;
+	munmap(const_cast<char*>(mapData), mapSize);
+	mapData = nullptr;
+	mapSize = 0;
+}
+
+#endif  // _WIN32
+
 #else	// ASTYLE_LIB
 
 //-----------------------------------------------------------------------------
@@ -3707,6 +5632,10 @@ bool ASOptions::parseOptionContinued(const std::string& arg, const std::string&
 	{
 		console.setPreserveDate(true);
 	}
+	else if (isOption(arg, "sync-files"))
+	{
+		console.setSyncFiles(true);
+	}
 	else if (isOption(arg, "v", "verbose"))
 	{
 		console.setIsVerbose(true);
@@ -4054,9 +5983,7 @@ size_t ASEncoding::utf16ToUtf8(char* utf16In, size_t inLen, bool isBigEndian,
 	ubyte* pCur = reinterpret_cast<ubyte*>(utf8Out);
 	const ubyte* pEnd = pRead + inLen;
 	const ubyte* pCurStart = pCur;
-	static eState state = eStart;	// state is retained for subsequent blocks
-	if (firstBlock)
-		state = eStart;
+	eState state = firstBlock ? eStart : utf16State;
 
 	// the BOM will automatically be converted to utf-8
 	while (pRead < pEnd)
@@ -4134,6 +6061,7 @@ size_t ASEncoding::utf16ToUtf8(char* utf16In, size_t inLen, bool isBigEndian,
 		}
 		*pCur++ = static_cast<ubyte>(nCur);
 	}
+	utf16State = state;
 	return pCur - pCurStart;
 }
 
@@ -4167,15 +6095,16 @@ jstring STDCALL Java_AStyleInterface_AStyleMain(JNIEnv* env,
                                                 jstring textInJava,
                                                 jstring optionsJava)
 {
-	g_env = env;                                // make object available globally
-	g_obj = obj;                                // make object available globally
+	JavaCall javaCall;
+	javaCall.env = env;
+	javaCall.obj = obj;
 
 	jstring textErr = env->NewStringUTF("");    // zero length text returned if an error occurs
 
 	// get the method ID
 	jclass cls = env->GetObjectClass(obj);
-	g_mid = env->GetMethodID(cls, "ErrorHandler", "(ILjava/lang/String;)V");
-	if (g_mid == nullptr)
+	javaCall.mid = env->GetMethodID(cls, "ErrorHandler", "(ILjava/lang/String;)V");
+	if (javaCall.mid == nullptr)
 	{
 		std::cout << "Cannot find java method ErrorHandler" << std::endl;
 		return textErr;
@@ -4185,8 +6114,10 @@ jstring STDCALL Java_AStyleInterface_AStyleMain(JNIEnv* env,
 	const char* textIn = env->GetStringUTFChars(textInJava, nullptr);
 	const char* options = env->GetStringUTFChars(optionsJava, nullptr);
 
-	// call the C++ formatting function
+	// call the C++ formatting function, the error handler is called on this thread
+	g_javaCall = &javaCall;
 	char* textOut = AStyleMain(textIn, options, javaErrorHandler, javaMemoryAlloc);
+	g_javaCall = nullptr;
 	// if an error message occurred it was displayed by errorHandler
 	if (textOut == nullptr)
 		return textErr;
@@ -4203,8 +6134,8 @@ jstring STDCALL Java_AStyleInterface_AStyleMain(JNIEnv* env,
 // Call the Java error handler
 void STDCALL javaErrorHandler(int errorNumber, const char* errorMessage)
 {
-	jstring errorMessageJava = g_env->NewStringUTF(errorMessage);
-	g_env->CallVoidMethod(g_obj, g_mid, errorNumber, errorMessageJava);
+	jstring errorMessageJava = g_javaCall->env->NewStringUTF(errorMessage);
+	g_javaCall->env->CallVoidMethod(g_javaCall->obj, g_javaCall->mid, errorNumber, errorMessageJava);
 }
 
 // Allocate memory for the formatted text
@@ -4229,7 +6160,9 @@ char* STDCALL javaMemoryAlloc(unsigned long memoryNeeded)
 /*
 * IMPORTANT Visual C DLL linker for WIN32 must have the additional options:
 *           /EXPORT:AStyleMain=_AStyleMain@16
+*           /EXPORT:AStyleMainToBuffer=_AStyleMainToBuffer@20
 *           /EXPORT:AStyleMainUtf16=_AStyleMainUtf16@16
+*           /EXPORT:AStyleMainRange=_AStyleMainRange@24
 *           /EXPORT:AStyleGetVersion=_AStyleGetVersion@0
 * No /EXPORT is required for x64
 */
@@ -4271,13 +6204,108 @@ extern "C" EXPORT char16_t* STDCALL AStyleMainUtf16(const char16_t* pSourceIn,	/
 	return utf16Out;
 }
 
+//----------------------------------------------------------------------------
+// ASTYLE_LIB formatting for the char entry points
+//----------------------------------------------------------------------------
+
+/**
+ * estimate the formatted size of the source.
+ * formatting usually changes the size by a few percent, the estimate
+ * allows for added indentation so the output is seldom reallocated.
+ *
+ * @return     the estimated output length.
+ */
+static size_t estimateOutputSize(const ASFormatter& formatter, size_t sourceLength)
+{
+	size_t estimate = sourceLength + sourceLength / 8 + 256;
+	// wide space indents can grow each tab or short indent in the source
+	if (formatter.getIndentString().length() > 4)
+		estimate += sourceLength / 8;
+	return estimate;
+}
+
+// set the formatter options, errors are reported to the error handler
+static bool setFormatterOptions(const char* pOptions, fpError fpErrorHandler, ASFormatter& formatter)
+{
+	ASOptions options(formatter);
+
+	std::vector<std::string> optionsVector;
+	std::stringstream opt(pOptions);
+
+	options.importOptions(opt, optionsVector);
+
+	bool ok = options.parseOptions(optionsVector, "Invalid Artistic Style options:");
+	if (!ok)
+		fpErrorHandler(130, options.getOptionErrors().c_str());
+	return ok;
+}
+
+// the formatters of the library entry points, keyed by the options
+static ASFormatterPool& getFormatterPool()
+{
+	static ASFormatterPool formatterPool;
+	return formatterPool;
+}
+
+// lease a formatter with the options from the pool,
+// one with option errors is not reused so the errors are reported on each call
+static ASFormatterPool::Lease leaseFormatter(const char* pOptions, fpError fpErrorHandler)
+{
+	return getFormatterPool().acquire(pOptions, [&](ASFormatter& formatter)
+	{
+		return setFormatterOptions(pOptions, fpErrorHandler, formatter);
+	});
+}
+
+// format the source into an output sink
+static void formatToSink(const char* pSourceIn, size_t sourceLength, ASFormatter& formatter, ASOutputSink& out)
+{
+	ASBufferIterator streamIterator(pSourceIn, sourceLength);
+	formatter.init(&streamIterator);
+
+	while (formatter.hasMoreLines())
+	{
+		out.write(formatter.nextLine());
+		if (formatter.hasMoreLines())
+			out.write(streamIterator.getOutputEOL());
+		else
+		{
+			// this can happen if the file if missing a closing brace and break-blocks is requested
+			if (formatter.getIsLineReady())
+			{
+				out.write(streamIterator.getOutputEOL());
+				out.write(formatter.nextLine());
+			}
+		}
+	}
+}
+
+// report a checksum error after the output has been returned
+static void checkFormatterChecksum(const ASFormatter& formatter, fpError fpErrorHandler)
+{
+#ifndef NDEBUG
+	// The checksum is an assert in the console build and ASFormatter.
+	// This error returns the incorrectly formatted file to the editor.
+	// This is done to allow the file to be saved for debugging purposes.
+	if (formatter.getChecksumDiff() != 0)
+		fpErrorHandler(220,
+		               "Checksum error.\n"
+		               "The incorrectly formatted file will be returned for debugging.");
+#else
+	(void) formatter;
+	(void) fpErrorHandler;
+#endif
+}
+
 //----------------------------------------------------------------------------
 // ASTYLE_LIB entry point for library builds
 //----------------------------------------------------------------------------
 /*
  * IMPORTANT Visual C DLL linker for WIN32 must have the additional options:
  *           /EXPORT:AStyleMain=_AStyleMain@16
+ *           /EXPORT:AStyleMainToBuffer=_AStyleMainToBuffer@20
  *           /EXPORT:AStyleMainUtf16=_AStyleMainUtf16@16
+ *           /EXPORT:AStyleMainRange=_AStyleMainRange@24
  *           /EXPORT:AStyleGetVersion=_AStyleGetVersion@0
  * No /EXPORT is required for x64
  */
@@ -4305,40 +6333,125 @@ extern "C" EXPORT char* STDCALL AStyleMain(const char* pSourceIn,		// the source
 		return nullptr;
 	}
 
-	ASFormatter formatter;
-	ASOptions options(formatter);
+	// format into one buffer, then allocate the exact output size
+	ASFormatterPool::Lease formatter = leaseFormatter(pOptions, fpErrorHandler);
+	size_t sourceLength = strlen(pSourceIn);
+	ASStringSink out;
+	out.reserve(estimateOutputSize(*formatter, sourceLength));
+	formatToSink(pSourceIn, sourceLength, *formatter, out);
 
-	std::vector<std::string> optionsVector;
-	std::stringstream opt(pOptions);
+	size_t textSizeOut = out.getLength();
+	char* pTextOut = fpMemoryAlloc((long) textSizeOut + 1);     // call memory allocation function
+	if (pTextOut == nullptr)
+	{
+		fpErrorHandler(120, "Allocation failure on output.");
+		return nullptr;
+	}
 
-	options.importOptions(opt, optionsVector);
+	memcpy(pTextOut, out.getData(), textSizeOut + 1);
+	checkFormatterChecksum(*formatter, fpErrorHandler);
+	return pTextOut;
+}
 
-	bool ok = options.parseOptions(optionsVector, "Invalid Artistic Style options:");
-	if (!ok)
-		fpErrorHandler(130, options.getOptionErrors().c_str());
+//----------------------------------------------------------------------------
+// ASTYLE_LIB entry point for library builds with a caller buffer
+//----------------------------------------------------------------------------
+/*
+ * The output is formatted directly into the caller buffer.
+ * The return value is the size needed, including the terminating null.
+ * The output is valid only if this is not more than the buffer size.
+ * Otherwise the buffer contents are undefined and the call can be
+ * repeated with a buffer of the returned size.
+ * Zero is returned if there is an error in the arguments.
+ */
+extern "C" EXPORT unsigned long STDCALL AStyleMainToBuffer(const char* pSourceIn,	// the source to be formatted
+                                                           const char* pOptions,	// AStyle options
+                                                           fpError fpErrorHandler,	// error handler function
+                                                           char* pBufferOut,		// buffer for the output
+                                                           unsigned long bufferSize)	// size of the buffer
+{
+	if (fpErrorHandler == nullptr)         // cannot display a message if no error handler
+		return 0;
 
-	std::stringstream in(pSourceIn);
-	ASStreamIterator<std::stringstream> streamIterator(&in);
-	std::ostringstream out;
-	formatter.init(&streamIterator);
+	if (pSourceIn == nullptr)
+	{
+		fpErrorHandler(101, "No pointer to source input.");
+		return 0;
+	}
+	if (pOptions == nullptr)
+	{
+		fpErrorHandler(102, "No pointer to AStyle options.");
+		return 0;
+	}
+	if (pBufferOut == nullptr && bufferSize != 0)
+	{
+		fpErrorHandler(105, "No pointer to output buffer.");
+		return 0;
+	}
 
-	while (formatter.hasMoreLines())
+	ASFormatterPool::Lease formatter = leaseFormatter(pOptions, fpErrorHandler);
+	ASArraySink out(pBufferOut, bufferSize);
+	formatToSink(pSourceIn, strlen(pSourceIn), *formatter, out);
+	out.write("", 1);                   // terminating null
+	if (!out.isOverflow())
+		checkFormatterChecksum(*formatter, fpErrorHandler);
+	return static_cast<unsigned long>(out.getLength());
+}
+
+//----------------------------------------------------------------------------
+// ASTYLE_LIB entry point for formatting a range of lines
+//----------------------------------------------------------------------------
+/*
+ * Only the lines *pFirstLine to *pLastLine are formatted, zero based.
+ * The source before them is scanned, not formatted, for a top level
+ * line to start at. The output replaces the source lines, including
+ * the end of line of the last one. On return the line numbers are the
+ * lines replaced, which may include a few more lines than requested
+ * if the formatting breaks or joins lines at the ends of the range.
+ */
+extern "C" EXPORT char* STDCALL AStyleMainRange(const char* pSourceIn,	// the source to be formatted
+                                                const char* pOptions,	// AStyle options
+                                                int* pFirstLine,		// first line to format
+                                                int* pLastLine,			// last line to format
+                                                fpError fpErrorHandler,	// error handler function
+                                                fpAlloc fpMemoryAlloc)	// memory allocation function
+{
+	if (fpErrorHandler == nullptr)         // cannot display a message if no error handler
+		return nullptr;
+
+	if (pSourceIn == nullptr)
 	{
-		out << formatter.nextLine();
-		if (formatter.hasMoreLines())
-			out << streamIterator.getOutputEOL();
-		else
-		{
-			// this can happen if the file if missing a closing brace and break-blocks is requested
-			if (formatter.getIsLineReady())
-			{
-				out << streamIterator.getOutputEOL();
-				out << formatter.nextLine();
-			}
-		}
+		fpErrorHandler(101, "No pointer to source input.");
+		return nullptr;
+	}
+	if (pOptions == nullptr)
+	{
+		fpErrorHandler(102, "No pointer to AStyle options.");
+		return nullptr;
+	}
+	if (fpMemoryAlloc == nullptr)
+	{
+		fpErrorHandler(103, "No pointer to memory allocation function.");
+		return nullptr;
 	}
+	if (pFirstLine == nullptr || pLastLine == nullptr
+	        || *pFirstLine < 0 || *pLastLine < *pFirstLine)
+	{
+		fpErrorHandler(106, "Invalid line range.");
+		return nullptr;
+	}
+
+	ASFormatterPool::Lease formatter = leaseFormatter(pOptions, fpErrorHandler);
+	ASRangeFormatter rangeFormatter(*formatter);
+	if (!rangeFormatter.format(pSourceIn, strlen(pSourceIn), *pFirstLine, *pLastLine))
+	{
+		fpErrorHandler(106, "Invalid line range.");
+		return nullptr;
+	}
+	ASStringSink out;
+	rangeFormatter.writeOutput(out);
 
-	size_t textSizeOut = out.str().length();
+	size_t textSizeOut = out.getLength();
 	char* pTextOut = fpMemoryAlloc((long) textSizeOut + 1);     // call memory allocation function
 	if (pTextOut == nullptr)
 	{
@@ -4346,16 +6459,9 @@ extern "C" EXPORT char* STDCALL AStyleMain(const char* pSourceIn,		// the source
 		return nullptr;
 	}
 
-	strcpy(pTextOut, out.str().c_str());
-#ifndef NDEBUG
-	// The checksum is an assert in the console build and ASFormatter.
-	// This error returns the incorrectly formatted file to the editor.
-	// This is done to allow the file to be saved for debugging purposes.
-	if (formatter.getChecksumDiff() != 0)
-		fpErrorHandler(220,
-		               "Checksum error.\n"
-		               "The incorrectly formatted file will be returned for debugging.");
-#endif
+	memcpy(pTextOut, out.getData(), textSizeOut + 1);
+	*pFirstLine = static_cast<int>(rangeFormatter.getFirstLine());
+	*pLastLine = static_cast<int>(rangeFormatter.getLastLine());
 	return pTextOut;
 }
 
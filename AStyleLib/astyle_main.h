@@ -13,6 +13,8 @@
 #include "astyle.h"
 
 #include <ctime>
+#include <list>
+#include <mutex>
 #include <sstream>
 
 #if defined(__BORLANDC__) && __BORLANDC__ < 0x0650
@@ -136,6 +138,477 @@ public:	// inline functions
 	bool hasMoreLines() const override { return !inStream->eof(); }
 };
 
+//----------------------------------------------------------------------------
+// ASBufferIterator class
+// reads lines directly from a contiguous buffer owned by the caller
+// the buffer must remain valid until formatting is finished
+// line ends are reported exactly as with ASStreamIterator
+// the whole buffer is split into lines by a single pass when the
+// iterator is created, which also counts the line ends of each type
+//----------------------------------------------------------------------------
+
+class ASBufferIterator : public ASSourceIterator
+{
+public:
+	bool checkForEmptyLine;
+
+public:	// function declarations
+	ASBufferIterator(const char* data, size_t length);
+	~ASBufferIterator() override;
+	bool getLineEndChange(int lineEndFormat) const;
+	int  getStreamLength() const override;
+	std::string nextLine(bool emptyLineWasDeleted) override;
+	std::string peekNextLine() override;
+	void peekReset() override;
+	void saveLastInputLine();
+	void seekLine(size_t line);
+	std::streamoff tellg() override;
+
+private:
+	// how a line in the index is terminated
+	enum LineEnd
+	{
+		LINE_END_NONE,      // last line, no end of line
+		LINE_END_FINAL,     // end of line is the last character, not counted
+		LINE_END_CRLF,      // CR+LF or LF+CR
+		LINE_END_LF,
+		LINE_END_CR
+	};
+
+private:
+	size_t addLineEnd(size_t pos);
+	void countLineEnd(size_t line);
+	size_t getLineLength(size_t line) const;
+	static int getLowestBit(unsigned mask);
+	size_t getNextLineStart(size_t line) const;
+	static const char* selectOutputEOL(int crlf, int lf, int cr);
+	void splitLines();
+
+private:
+	const char* inBuffer;        // pointer to the input buffer, not owned
+	size_t inLength;             // length of the input buffer
+	size_t inPos;                // current read position in the buffer
+	std::vector<size_t> lineStarts;      // start of each line in the buffer
+	std::vector<unsigned char> lineEnds; // LineEnd of each line
+	size_t lineNum;              // line returned by the next nextLine()
+	size_t peekLine;             // line returned by the next peekNextLine()
+	size_t linesExamined;        // lines returned by nextLine() or peekNextLine()
+	std::string buffer;          // current input line
+	std::string prevBuffer;      // previous input line
+	std::string outputEOL;       // next output end of line char
+	std::string inputEOL;        // output end of line for the whole buffer
+	int eolWindows;         // number of Windows line endings, CRLF
+	int eolLinux;           // number of Linux line endings, LF
+	int eolMacOld;          // number of old Mac line endings. CR
+	int totalWindows;       // Windows line endings in the whole buffer
+	int totalLinux;         // Linux line endings in the whole buffer
+	int totalMacOld;        // old Mac line endings in the whole buffer
+	size_t peekStart;       // starting position for peekNextLine
+	bool inEOF;             // a read has reached the end of the buffer
+	bool prevLineDeleted;   // the previous input line was deleted
+
+public:	// inline functions
+	bool compareToInputBuffer(const std::string& nextLine_) const
+	{ return (nextLine_ == prevBuffer); }
+	const std::string& getInputEOL() const { return inputEOL; }
+	const std::string& getOutputEOL() const { return outputEOL; }
+	size_t getLineCount() const { return lineEnds.size(); }
+	size_t getLineStart(size_t line) const { return line < lineStarts.size() ? lineStarts[line] : inLength; }
+	size_t getLinesExamined() const { return lineNum > linesExamined ? lineNum : linesExamined; }
+	size_t getLinesRead() const { return lineNum; }
+	std::streamoff getPeekStart() const override { return static_cast<std::streamoff>(peekStart); }
+	bool hasMoreLines() const override { return !inEOF; }
+};
+
+//----------------------------------------------------------------------------
+// ASChunkIterator class
+// reads lines from an input stream that cannot seek, such as cin
+// the stream is read in chunks into a window that holds the current
+// line and the lines read by peekNextLine, consumed input is discarded
+// memory is bounded by the formatter lookahead instead of the input size
+// line ends are reported exactly as with ASStreamIterator
+//----------------------------------------------------------------------------
+
+class ASChunkIterator : public ASSourceIterator
+{
+public:	// function declarations
+	explicit ASChunkIterator(std::istream* in);
+	~ASChunkIterator() override;
+	int  getStreamLength() const override;
+	std::string nextLine(bool emptyLineWasDeleted) override;
+	std::string peekNextLine() override;
+	void peekReset() override;
+	std::streamoff tellg() override;
+
+private:
+	// how a line is terminated
+	enum LineEnd
+	{
+		LINE_END_NONE,      // last line, no end of line
+		LINE_END_FINAL,     // end of line is the last character, not counted
+		LINE_END_CRLF,      // CR+LF or LF+CR
+		LINE_END_LF,
+		LINE_END_CR
+	};
+	static const size_t CHUNK_SIZE = 65536;
+
+private:
+	std::streamoff getLine(std::streamoff start, std::string& line, LineEnd& lineEnd);
+	bool readChunk();
+
+private:
+	std::istream* inStream;      // pointer to the input stream
+	std::string window;          // input that has been read but not discarded
+	std::streamoff windowStart;  // stream position of the start of the window
+	std::streamoff inPos;        // current read position in the stream
+	std::streamoff peekStart;    // starting position for peekNextLine
+	std::string buffer;          // current input line
+	std::string outputEOL;       // next output end of line char
+	int eolWindows;         // number of Windows line endings, CRLF
+	int eolLinux;           // number of Linux line endings, LF
+	int eolMacOld;          // number of old Mac line endings. CR
+	bool streamEnd;         // the stream has been read to the end
+	bool inEOF;             // a read has reached the end of the input
+
+public:	// inline functions
+	const std::string& getOutputEOL() const { return outputEOL; }
+	std::streamoff getPeekStart() const override { return peekStart; }
+	bool hasMoreLines() const override { return !inEOF; }
+};
+
+//----------------------------------------------------------------------------
+// ASOutputSink class
+// receives the formatted output, the drivers write each line once
+// ASStringSink appends to a growable buffer owned by the sink
+// ASArraySink writes to a caller buffer and reports the size needed
+// ASFileSink writes to a file descriptor through a small buffer
+// ASCallbackSink passes the output to a function
+//----------------------------------------------------------------------------
+
+class ASOutputSink
+{
+public:
+	virtual ~ASOutputSink() = default;
+	virtual void write(const char* data, size_t length) = 0;
+	void write(const std::string& text) { write(text.data(), text.length()); }
+};
+
+class ASStringSink : public ASOutputSink
+{
+public:
+	ASStringSink() = default;
+	void write(const char* data, size_t length) override;
+	using ASOutputSink::write;
+
+private:
+	std::string text;            // the output
+
+public:	// inline functions
+	const char* getData() const { return text.c_str(); }
+	size_t getLength() const { return text.length(); }
+	std::string& getText() { return text; }
+	void reserve(size_t length) { text.reserve(length); }
+};
+
+class ASArraySink : public ASOutputSink
+{
+public:
+	ASArraySink(char* buffer, size_t capacity);
+	void write(const char* data, size_t length) override;
+	using ASOutputSink::write;
+
+private:
+	char* outBuffer;             // pointer to the caller buffer, not owned
+	size_t outCapacity;          // size of the caller buffer
+	size_t outLength;            // length of the output, may exceed the capacity
+
+public:	// inline functions
+	size_t getLength() const { return outLength; }
+	bool isOverflow() const { return outLength > outCapacity; }
+};
+
+class ASFileSink : public ASOutputSink
+{
+public:
+	explicit ASFileSink(int fd);
+	~ASFileSink() override;
+	ASFileSink(const ASFileSink&)            = delete;
+	ASFileSink& operator=(ASFileSink const&) = delete;
+	bool flush();
+	void write(const char* data, size_t length) override;
+	using ASOutputSink::write;
+
+private:
+	static const size_t BUFFER_SIZE = 65536;
+	bool writeAll(const char* data, size_t length);
+
+private:
+	int outFd;                   // the file descriptor, not closed by the sink
+	std::string outBuffer;       // output not yet written
+	bool writeError;             // a write has failed
+
+public:	// inline functions
+	bool hasError() const { return writeError; }
+};
+
+class ASCallbackSink : public ASOutputSink
+{
+public:
+	typedef void (* WriteFunction)(const char* data, size_t length, void* userData);
+	ASCallbackSink(WriteFunction writeFunction, void* userData);
+	void write(const char* data, size_t length) override;
+	using ASOutputSink::write;
+
+private:
+	WriteFunction outFunction;   // function called with the output
+	void* outUserData;           // passed to the function
+};
+
+//----------------------------------------------------------------------------
+// ASIncrementalFormatter class
+// formats a buffer and keeps the output lines and the formatter
+// checkpoints, so the buffer can be formatted again after an edit
+// starting from the last checkpoint that does not depend on the edit
+// the new run stops where its state is the state of a checkpoint of
+// the previous run at the same source text, the rest of the previous
+// output is kept
+// a buffer with mixed line ends is always formatted in full
+//----------------------------------------------------------------------------
+
+class ASIncrementalFormatter
+{
+public:
+	explicit ASIncrementalFormatter(ASFormatter& formatter_, int checkpointInterval = 64);
+	void format(const char* data, size_t length);
+	void reformat(const char* data, size_t length,
+	              size_t firstLine, size_t oldLineCount, size_t newLineCount);
+	void writeOutput(ASOutputSink& out) const;
+
+private:
+	// a checkpoint and the source lines it depends on
+	struct Checkpoint
+	{
+		ASFormatterCheckpoint checkpoint;
+		size_t linesExamined;    // lines read or peeked before it was taken
+	};
+
+private:
+	size_t formatLines(ASFormatter& runFormatter, ASBufferIterator& streamIterator,
+	                   std::vector<std::string>& lines, std::vector<Checkpoint>& newCheckpoints,
+	                   size_t previous, std::ptrdiff_t lineDelta, size_t editEnd) const;
+
+private:
+	ASFormatter& formatter;      // has the options, formats a new buffer
+	std::vector<std::string> outputLines;    // each line with the end of line written after it
+	std::vector<Checkpoint> checkpoints;     // in source line order, the first is at line 0
+	std::string sourceEOL;       // input end of line of the formatted buffer
+	size_t sourceLength;         // length of the formatted buffer
+	size_t sourceLineCount;      // lines in the formatted buffer
+	size_t linesFormatted;       // source lines formatted by the last call
+	bool sourceEOLChange;        // the formatted buffer has mixed line ends
+
+public:	// inline functions
+	size_t getLinesFormatted() const { return linesFormatted; }
+};
+
+//----------------------------------------------------------------------------
+// ASRangeFormatter class
+// formats a range of source lines and keeps the output for the range
+// formatting starts at a checkpoint, or at the nearest top level line
+// before the range found by a scan of the braces, comments and quotes,
+// so the source before it is not formatted
+// the output replaces source lines getFirstLine() to getLastLine(),
+// the range is extended when a line break or a line join crosses an end
+//----------------------------------------------------------------------------
+
+class ASRangeFormatter
+{
+public:
+	explicit ASRangeFormatter(ASFormatter& formatter_);
+	bool format(const char* data, size_t length, size_t firstLine, size_t lastLine);
+	bool format(const char* data, size_t length, size_t firstLine, size_t lastLine,
+	            const ASFormatterCheckpoint& context);
+	void writeOutput(ASOutputSink& out) const;
+
+private:
+	bool formatRange(ASFormatter& runFormatter, ASBufferIterator& streamIterator,
+	                 size_t firstLine, size_t lastLine);
+	size_t findTopLevelLine(const char* data, size_t length, size_t line) const;
+
+private:
+	ASFormatter& formatter;      // has the options
+	std::string output;          // the formatted range
+	size_t rangeFirstLine;       // first source line replaced by the output
+	size_t rangeLastLine;        // last source line replaced by the output
+	size_t rangeStart;           // offset of the first line in the source
+	size_t rangeEnd;             // offset following the last line and its end of line
+	size_t contextLine;          // source line where formatting started
+
+public:	// inline functions
+	size_t getFirstLine() const { return rangeFirstLine; }
+	size_t getLastLine() const { return rangeLastLine; }
+	size_t getSourceStart() const { return rangeStart; }
+	size_t getSourceEnd() const { return rangeEnd; }
+	size_t getContextLine() const { return contextLine; }
+};
+
+//----------------------------------------------------------------------------
+// ASIndentQuery class
+// gets the indent of a single source line for an editor, such as the
+// line at the cursor after Enter or a closing brace
+// the lines before it are formatted by a formatter of its own with the
+// options of the formatter given to the constructor, nothing is written,
+// the indent is the indent of the first output line of the source line
+// the formatter state is kept at the start of every checkpointInterval
+// lines and at the last line queried, so a query formats only the
+// lines from the nearest saved state, after an edit invalidate() drops
+// the states that depend on the edited lines
+//----------------------------------------------------------------------------
+
+class ASIndentQuery
+{
+public:
+	explicit ASIndentQuery(const ASFormatter& formatter_, int checkpointInterval_ = 64);
+	std::string getIndent(const char* data, size_t length, size_t line);
+	std::string getIndent(const char* data, size_t length, size_t line,
+	                      const ASFormatterCheckpoint& context);
+	void invalidate(size_t firstLine);
+	void clear();
+
+private:
+	// reads the lines of a buffer from a saved state without an index,
+	// the target line is read as a placeholder statement if it is empty,
+	// and empty lines are added after the buffer up to the target line
+	class LineIterator : public ASSourceIterator
+	{
+	public:
+		LineIterator(const char* data, size_t length, size_t offset, size_t line, size_t targetLine_);
+		int  getStreamLength() const override;
+		std::string nextLine(bool emptyLineWasDeleted) override;
+		std::string peekNextLine() override;
+		void peekReset() override;
+		std::streamoff tellg() override;
+
+	private:
+		std::string readLine(size_t& pos, size_t line, bool& isLast, bool& endsBuffer);
+
+	private:
+		const char* inBuffer;        // pointer to the input buffer, not owned
+		size_t inLength;             // length of the input buffer
+		size_t inPos;                // start of the next line, past the length after the buffer
+		size_t firstLine;            // the line read first
+		std::vector<size_t> lineStarts;  // start of each line read by nextLine()
+		size_t lineNum;              // line returned by the next nextLine()
+		size_t peekLine;             // line returned by the next peekNextLine()
+		size_t linesExamined;        // lines returned by nextLine() or peekNextLine()
+		size_t peekStart;            // starting position for peekNextLine
+		size_t targetLine;           // the line read as a placeholder if it is empty
+		bool inEOF;                  // a read has reached the end of the lines
+		bool isPastEnd;              // a line after the buffer has been read
+
+	public:	// inline functions
+		size_t getLinesExamined() const { return lineNum > linesExamined ? lineNum : linesExamined; }
+		size_t getLinesRead() const { return lineNum; }
+		size_t getLineStart(size_t line) const
+		{ return line - firstLine < lineStarts.size() ? lineStarts[line - firstLine] : std::min(inPos, inLength); }
+		std::streamoff getPeekStart() const override { return static_cast<std::streamoff>(peekStart); }
+		bool hasMoreLines() const override { return !inEOF; }
+		bool hasReadPastEnd() const { return isPastEnd; }
+	};
+
+	// the formatter state at the start of a source line
+	struct SavedState
+	{
+		ASFormatterCheckpoint checkpoint;
+		size_t offset;               // offset of the line in the source
+		size_t linesExamined;        // source lines read or peeked by the formatter
+	};
+
+private:
+	std::string getIndentFrom(const char* data, size_t length, size_t line,
+	                          const ASFormatterCheckpoint* context);
+	void saveCheckpoints(const ASFormatter& runFormatter, const LineIterator& lineIterator,
+	                     size_t& taken, size_t line);
+	void saveState(SavedState state);
+	const SavedState& startAt(const char* data, size_t length, size_t line);
+
+private:
+	std::unique_ptr<ASFormatter> formatter;  // has a copy of the options
+	std::vector<SavedState> states;  // in source line order, at the checkpoint interval
+	SavedState current;          // state at the last line queried, if it has a checkpoint
+	size_t linesFormatted;       // source lines read by the last call
+
+public:	// inline functions
+	size_t getLinesFormatted() const { return linesFormatted; }
+};
+
+//----------------------------------------------------------------------------
+// ASFormatterPool class
+// a thread safe pool of formatters with the options set, so repeated
+// formatting jobs do not construct formatters or parse options
+// the formatters are keyed by a string for the option set and language
+// a formatter is leased for a job and returned to the pool when the
+// lease is destroyed, ASFormatter::reset ends the session of the job
+// the least recently used formatters are deleted above maxIdle
+//----------------------------------------------------------------------------
+
+class ASFormatterPool
+{
+public:
+	class Lease
+	{
+	public:
+		Lease(Lease&& other) noexcept;
+		~Lease();
+		Lease(const Lease&)            = delete;
+		Lease& operator=(const Lease&) = delete;
+		Lease& operator=(Lease&&)      = delete;
+		ASFormatter& operator*() const { return *formatter; }
+		ASFormatter* operator->() const { return formatter.get(); }
+
+	private:
+		friend class ASFormatterPool;
+		Lease(ASFormatterPool* pool_, const std::string& key_,
+		      std::unique_ptr<ASFormatter> formatter_, bool isReusable_);
+
+		ASFormatterPool* pool;                  // nullptr if moved from
+		std::string key;
+		std::unique_ptr<ASFormatter> formatter;
+		bool isReusable;                        // is returned to the pool
+	};
+
+	explicit ASFormatterPool(size_t maxIdle_ = 32);
+	template<typename Configure>
+	Lease acquire(const std::string& key, Configure configure);
+	void clear();
+	size_t getIdleCount() const;
+
+private:
+	std::unique_ptr<ASFormatter> take(const std::string& key);
+	void release(const std::string& key, std::unique_ptr<ASFormatter> formatter);
+
+private:
+	mutable std::mutex poolMutex;
+	std::list<std::pair<std::string, std::unique_ptr<ASFormatter> > > idle;  // most recent first
+	size_t maxIdle;
+};
+
+/**
+ * Lease a formatter for the key. A new formatter is configured by
+ * calling configure(ASFormatter&), which returns false if the formatter
+ * must not be reused, for example if the options had errors.
+ */
+template<typename Configure>
+ASFormatterPool::Lease ASFormatterPool::acquire(const std::string& key, Configure configure)
+{
+	std::unique_ptr<ASFormatter> formatter = take(key);
+	if (formatter != nullptr)
+		return Lease(this, key, std::move(formatter), true);
+	formatter.reset(new ASFormatter);
+	bool isReusable = configure(*formatter);
+	return Lease(this, key, std::move(formatter), isReusable);
+}
+
 //----------------------------------------------------------------------------
 // ASEncoding class for utf8/16 conversions
 // used by both console and library builds
@@ -163,6 +636,9 @@ public:
 	size_t utf16LengthFromUtf8(const char* utf8In, size_t len) const;
 	size_t utf16ToUtf8(char* utf16In, size_t inLen, bool isBigEndian,
 	                   bool firstBlock, char* utf8Out) const;
+
+private:
+	mutable eState utf16State = eStart;	// state is retained for subsequent blocks
 };
 
 //----------------------------------------------------------------------------
@@ -205,6 +681,30 @@ private:
 
 #ifndef	ASTYLE_LIB
 
+//----------------------------------------------------------------------------
+// ASMappedFile class for console build
+// maps a regular file read-only so it can be formatted without copying
+// the mapping must be closed before the file is replaced
+//----------------------------------------------------------------------------
+
+class ASMappedFile
+{
+public:
+	ASMappedFile() = default;
+	~ASMappedFile() { close(); }
+	ASMappedFile(const ASMappedFile&)            = delete;
+	ASMappedFile& operator=(ASMappedFile const&) = delete;
+	bool open(const std::string& fileName_);
+	void close();
+	const char* getData() const { return mapData; }
+	size_t getSize() const { return mapSize; }
+	bool isOpen() const { return mapData != nullptr; }
+
+private:
+	const char* mapData = nullptr;      // start of the mapped file
+	size_t mapSize = 0;                 // length of the mapped file
+};
+
 //----------------------------------------------------------------------------
 // ASConsole class for console build
 //----------------------------------------------------------------------------
@@ -221,6 +721,7 @@ private:    // variables
 	bool isDryRun;                      // dry-run option
 	bool noBackup;                      // suffix=none option
 	bool preserveDate;                  // preserve-date option
+	bool syncFiles;                     // sync-files option
 	bool isVerbose;                     // verbose option
 	bool isQuiet;                       // quiet option
 	bool isFormattedOnly;               // formatted lines only option
@@ -260,7 +761,6 @@ public:     // functions
 	explicit ASConsole(ASFormatter& formatterArg);
 	ASConsole(const ASConsole&)            = delete;
 	ASConsole& operator=(ASConsole const&) = delete;
-	void convertLineEnds(std::ostringstream& out, int lineEnd);
 	FileEncoding detectEncoding(const char* data, size_t dataSize) const;
 	void error() const;
 	void error(const char* why, const char* what) const;
@@ -281,6 +781,7 @@ public:     // functions
 	bool getLineEndsMixed() const;
 	bool getNoBackup() const;
 	bool getPreserveDate() const;
+	bool getSyncFiles() const;
 	std::string getLanguageID() const;
 	std::string getNumberFormat(int num, size_t lcid = 0) const;
 	std::string getNumberFormat(int num, const char* groupingArg, const char* separator) const;
@@ -305,6 +806,7 @@ public:     // functions
 	void setOptionFileName(const std::string& name);
 	void setOrigSuffix(const std::string& suffix);
 	void setPreserveDate(bool state);
+	void setSyncFiles(bool state);
 	void setProjectOptionFileName(const std::string& optfilepath);
 	void setStdPathIn(const std::string& path);
 	void setStdPathOut(const std::string& path);
@@ -320,7 +822,6 @@ public:     // functions
 	std::vector<std::string> getFileName() const;
 
 private:	// functions
-	void correctMixedLineEnds(std::ostringstream& out);
 	void formatFile(const std::string& fileName_);
 	std::string getParentDirectory(const std::string& absPath) const;
 	std::string findProjectOptionFilePath(const std::string& fileName_) const;
@@ -342,16 +843,23 @@ private:	// functions
 	void printSeparatingLine() const;
 	void printVerboseHeader() const;
 	void printVerboseStats(clock_t startTime) const;
-	FileEncoding readFile(const std::string& fileName_, std::stringstream& in) const;
+	FileEncoding mapFile(const std::string& fileName_, ASMappedFile& mappedFile) const;
+	FileEncoding readFile(const std::string& fileName_, std::string& in) const;
 	void removeFile(const char* fileName_, const char* errMsg) const;
 	void renameFile(const char* oldFileName, const char* newFileName, const char* errMsg) const;
+	void replaceLineEnds(std::string& text, const std::string& fromEOL, const std::string& toEOL) const;
 	void setOutputEOL(LineEndFormat lineEndFormat, const std::string& currentEOL);
 	void sleep(int seconds) const;
 	int  waitForRemove(const char* newFileName) const;
 	int  wildcmp(const char* wild, const char* data) const;
-	void writeFile(const std::string& fileName_, FileEncoding encoding, std::ostringstream& out) const;
+	void writeFile(const std::string& fileName_, FileEncoding encoding, const std::string& out) const;
 #ifdef _WIN32
 	void displayLastError();
+#else
+	void backupFile(const std::string& fileName_, const struct stat& stBuf) const;
+	bool copyFile(const std::string& fromName, const std::string& toName, const struct stat& stBuf) const;
+	bool replaceFile(const std::string& fileName_, const struct stat& stBuf,
+	                 const char* data, size_t length) const;
 #endif
 };
 #else	// ASTYLE_LIB
@@ -421,6 +929,17 @@ extern "C" EXPORT char* STDCALL AStyleMain(const char* pSourceIn,
                                            const char* pOptions,
                                            fpError fpErrorHandler,
                                            fpAlloc fpMemoryAlloc);
+extern "C" EXPORT unsigned long STDCALL AStyleMainToBuffer(const char* pSourceIn,
+                                                           const char* pOptions,
+                                                           fpError fpErrorHandler,
+                                                           char* pBufferOut,
+                                                           unsigned long bufferSize);
+extern "C" EXPORT char* STDCALL AStyleMainRange(const char* pSourceIn,
+                                                const char* pOptions,
+                                                int* pFirstLine,
+                                                int* pLastLine,
+                                                fpError fpErrorHandler,
+                                                fpAlloc fpMemoryAlloc);
 extern "C" EXPORT const char* STDCALL AStyleGetVersion(void);
 #endif	// ASTYLE_LIB
 
@@ -0,0 +1,134 @@
+// astyle_eol_test.cpp
+// Copyright (c) 2023 The Artistic Style Authors.
+// This code is licensed under the MIT License.
+// License.md describes the conditions under which this software may be distributed.
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Line end test for files with mixed line ends.
+ *
+ *   Each source has the same number of CR and CR+LF line ends. The output
+ *   end of line is selected from the lines read so far, and CR+LF wins a
+ *   tie, so the selection changes while the source is read. The expected
+ *   outputs are the outputs of the library before the line index of
+ *   ASBufferIterator was added.
+ *
+ *   The line ends of a whole buffer are checked with ASBufferIterator,
+ *   a tie is Windows (CR+LF) and is reported as a line end change.
+ *
+ *   The exit status is 0 if all of the checks pass.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ */
+
+#include "astyle_main.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+namespace
+{
+struct FormatCase
+{
+	const char* source;
+	const char* options;
+	const char* expected;
+};
+
+// every source has an equal CR and CR+LF count
+const FormatCase formatCases[] =
+{
+	{
+		"int a;\rint b;\r\nint c;\rint d;\r\n", "",
+		"int a;\r\nint b;\rint c;\r\nint d;\r\n"
+	},
+	{
+		"void f()\r\n{\rint a;\r\nreturn 1;\r}\r\n", "",
+		"void f()\r\n{\r\n    int a;\r\n    return 1;\r\n}\r\n"
+	},
+	{
+		"void f()\r{\r\nint a;\rreturn 1;\r\n}\r\r\n", "",
+		"void f()\r\n{\r    int a;\r\n    return 1;\r}\r\n"
+	},
+	{
+		"if (x)\r\n{\rint a;\r\n}\rint b;\r\n\r\n\r", "",
+		"if (x)\r\n{\r\n    int a;\r\n}\r\nint b;\r\n"
+	},
+	{
+		"void f()\r{\r\nint a;\rreturn 1;\r\n}\r", "break-blocks",
+		"void f()\r\n{\r    int a;\r\n    return 1;\r\n}\r\n"
+	}
+};
+
+int errorCount = 0;
+
+void STDCALL errorHandler(int errorNumber, const char* errorMessage)
+{
+	errorCount++;
+	fprintf(stderr, "error %d - %s\n", errorNumber, errorMessage);
+}
+
+char* STDCALL memoryAlloc(unsigned long memoryNeeded)
+{
+	return new (std::nothrow) char[memoryNeeded];
+}
+
+// show the line ends of a string
+std::string showLineEnds(const char* text)
+{
+	std::string shown;
+	for (; *text != '\0'; text++)
+	{
+		if (*text == '\r')
+			shown.append("\\r");
+		else if (*text == '\n')
+			shown.append("\\n");
+		else
+			shown.push_back(*text);
+	}
+	return shown;
+}
+
+bool checkFormat(const FormatCase& test)
+{
+	char* textOut = AStyleMain(test.source, test.options, errorHandler, memoryAlloc);
+	bool ok = textOut != nullptr && strcmp(textOut, test.expected) == 0;
+	if (!ok)
+	{
+		fprintf(stderr, "source   \"%s\"\n", showLineEnds(test.source).c_str());
+		fprintf(stderr, "expected \"%s\"\n", showLineEnds(test.expected).c_str());
+		fprintf(stderr, "output   \"%s\"\n", textOut == nullptr ? "(null)" : showLineEnds(textOut).c_str());
+	}
+	delete[] textOut;
+	return ok;
+}
+
+bool checkBuffer(const char* source, const char* expectedEOL)
+{
+	astyle::ASBufferIterator streamIterator(source, strlen(source));
+	bool ok = streamIterator.getInputEOL() == expectedEOL
+	          && streamIterator.getLineEndChange(astyle::LINEEND_DEFAULT);
+	if (!ok)
+		fprintf(stderr, "buffer \"%s\" has line end \"%s\"\n",
+		        showLineEnds(source).c_str(), showLineEnds(streamIterator.getInputEOL().c_str()).c_str());
+	return ok;
+}
+}   // end of anonymous namespace
+
+int main()
+{
+	int failCount = 0;
+	for (const FormatCase& test : formatCases)
+	{
+		if (!checkFormat(test))
+			failCount++;
+	}
+	if (!checkBuffer("int a;\rint b;\r\nint c;\rint d;\r\n", "\r\n"))
+		failCount++;
+	if (!checkBuffer("int a;\r\nint b;\rint c;\r\nint d;\rint e;", "\r\n"))
+		failCount++;
+
+	printf("eol failures=%d errors=%d\n", failCount, errorCount);
+	return (failCount == 0 && errorCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
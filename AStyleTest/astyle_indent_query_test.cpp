@@ -0,0 +1,171 @@
+// astyle_indent_query_test.cpp
+// Copyright (c) 2023 The Artistic Style Authors.
+// This code is licensed under the MIT License.
+// License.md describes the conditions under which this software may be distributed.
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Indent query test for ASIndentQuery.
+ *
+ *   Each source file is formatted with several option sets. The indent
+ *   of every line of the formatted source is then queried with
+ *   ASIndentQuery and compared with the indent of the line when the
+ *   formatted source is formatted again. The lines are queried in order,
+ *   as an editor does while the cursor moves down, and in a scattered
+ *   order that starts from the saved states. An empty line is not
+ *   compared, the query gives it the indent of a statement.
+ *
+ *   The exit status is 0 if all of the indents are the same.
+ *
+ *   Usage:
+ *      astyle_indent_query_test file ...
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ */
+
+#include "astyle_main.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// the option sets cover the formatter, the beautifier and the enhancer
+const char* const optionSets[] =
+{
+	"",
+	"style=gnu indent-preproc-cond indent-preproc-define break-blocks pad-oper",
+	"style=kr indent=tab indent-switches indent-namespaces add-braces",
+	"style=allman indent=spaces=2 indent-classes indent-cases pad-header"
+};
+
+int errorCount = 0;
+
+// an option error is a failure of the test, the options are fixed
+void STDCALL errorHandler(int errorNumber, const char* errorMessage)
+{
+	errorCount++;
+	fprintf(stderr, "error %d - %s\n", errorNumber, errorMessage);
+}
+
+// set the options of a formatter as AStyleMain does
+bool setOptions(astyle::ASFormatter& formatter, const char* options)
+{
+	astyle::ASOptions optionsParser(formatter);
+	std::vector<std::string> optionsVector;
+	std::stringstream optionStream(options);
+	optionsParser.importOptions(optionStream, optionsVector);
+	if (!optionsParser.parseOptions(optionsVector, "Invalid Artistic Style options:\n"))
+	{
+		errorHandler(130, optionsParser.getOptionErrors().c_str());
+		return false;
+	}
+	return true;
+}
+
+// format a source and split the output into lines
+std::vector<std::string> formatLines(const std::string& source, const char* options)
+{
+	astyle::ASFormatter formatter;
+	std::vector<std::string> lines;
+	if (!setOptions(formatter, options))
+		return lines;
+	astyle::ASBufferIterator streamIterator(source.data(), source.size());
+	formatter.init(&streamIterator);
+	while (formatter.hasMoreLines())
+		lines.emplace_back(formatter.nextLine());
+	return lines;
+}
+
+std::string joinLines(const std::vector<std::string>& lines)
+{
+	std::string text;
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		if (i > 0)
+			text.push_back('\n');
+		text.append(lines[i]);
+	}
+	return text;
+}
+
+std::string getIndent(const std::string& line)
+{
+	return line.substr(0, line.find_first_not_of(" \t"));
+}
+
+// query the indent of the non-empty lines of a formatted source
+// in the order of 'lines', return the number of different indents
+int checkQueries(const char* fileName, const char* options, const std::string& formatted,
+                 const std::vector<std::string>& expected, const std::vector<size_t>& lines)
+{
+	astyle::ASFormatter formatter;
+	if (!setOptions(formatter, options))
+		return 0;
+	astyle::ASIndentQuery query(formatter);
+	int mismatchCount = 0;
+	for (size_t line : lines)
+	{
+		if (expected[line].find_first_not_of(" \t") == std::string::npos)
+			continue;
+		std::string indent = query.getIndent(formatted.data(), formatted.size(), line);
+		if (indent != getIndent(expected[line]))
+		{
+			if (mismatchCount == 0)
+				fprintf(stderr, "%s \"%s\" line %zu: query \"%s\" format \"%s\"\n",
+				        fileName, options, line + 1, indent.c_str(), getIndent(expected[line]).c_str());
+			mismatchCount++;
+		}
+	}
+	return mismatchCount;
+}
+}   // end of anonymous namespace
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: astyle_indent_query_test file ...\n");
+		return EXIT_FAILURE;
+	}
+
+	int mismatchCount = 0;
+	size_t lineCount = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		std::ifstream in(argv[i], std::ios::binary);
+		if (!in)
+		{
+			fprintf(stderr, "cannot open %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+		std::stringstream buffer;
+		buffer << in.rdbuf();
+
+		for (const char* options : optionSets)
+		{
+			// the formatted source is the source of the queries,
+			// formatting it again gives the expected indents
+			std::string formatted = joinLines(formatLines(buffer.str(), options));
+			std::vector<std::string> expected = formatLines(formatted, options);
+			if (expected.empty())
+				continue;
+
+			// in order, then scattered from the saved states
+			std::vector<size_t> lines;
+			for (size_t line = 0; line < expected.size(); line++)
+				lines.push_back(line);
+			mismatchCount += checkQueries(argv[i], options, formatted, expected, lines);
+			lines.clear();
+			for (size_t line = 0; line < expected.size(); line += 8)
+				lines.push_back((line * 7919) % expected.size());
+			mismatchCount += checkQueries(argv[i], options, formatted, expected, lines);
+			lineCount += expected.size() + lines.size();
+		}
+	}
+
+	printf("indent query lines=%zu mismatches=%d errors=%d\n", lineCount, mismatchCount, errorCount);
+	return (mismatchCount == 0 && errorCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+// astyle_memory_test.cpp
+// Copyright (c) 2023 The Artistic Style Authors.
+// This code is licensed under the MIT License.
+// License.md describes the conditions under which this software may be distributed.
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Memory test for the ASArena of a formatting session.
+ *
+ *   Each preprocessor #if directive creates beautifier clones that are
+ *   deleted at the #endif. The clones and the stack elements they copy
+ *   are allocated from the session arena, so the arena must reuse the
+ *   freed memory. A source with many #if blocks is formatted at two
+ *   sizes, and the arena of the large source must not be larger than
+ *   the arena of the small one. The arena only grows during a session,
+ *   so its reserved bytes are its peak memory.
+ *
+ *   The exit status is 0 if all of the checks pass.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ */
+
+#include "astyle_main.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+// a source with 'blocks' #if blocks, optionally nested in a second #if
+std::string makeSource(int blocks, bool nested)
+{
+	std::string source;
+	for (int i = 0; i < blocks; i++)
+	{
+		std::string number = std::to_string(i);
+		if (nested)
+			source.append("#ifdef OUTER_" + number + "\n");
+		source.append("#if defined(OPTION_" + number + ")\n"
+		              "int first" + number + "(int value) { return value + " + number + "; }\n"
+		              "#else\n"
+		              "int second" + number + "(int value) { return value - " + number + "; }\n"
+		              "#endif\n");
+		if (nested)
+			source.append("#endif\n");
+	}
+	return source;
+}
+
+// format a source and return the arena statistics of the session
+astyle::ASArenaStats formatSource(const std::string& source, bool indentConditionals)
+{
+	astyle::ASFormatter formatter;
+	formatter.setPreprocConditionalIndent(indentConditionals);
+	astyle::ASBufferIterator streamIterator(source.data(), source.size());
+	formatter.init(&streamIterator);
+	while (formatter.hasMoreLines())
+		formatter.nextLine();
+	return formatter.getArenaStats();
+}
+
+bool checkBounded(bool nested, bool indentConditionals)
+{
+	astyle::ASArenaStats smallStats = formatSource(makeSource(1000, nested), indentConditionals);
+	astyle::ASArenaStats largeStats = formatSource(makeSource(20000, nested), indentConditionals);
+	bool ok = largeStats.bytesReserved <= smallStats.bytesReserved
+	          && largeStats.reuses > 0;
+	if (!ok)
+		fprintf(stderr, "nested=%d indent=%d arena bytes %zu for 1000 blocks, %zu for 20000 blocks, %zu reuses\n",
+		        nested, indentConditionals, smallStats.bytesReserved,
+		        largeStats.bytesReserved, largeStats.reuses);
+	return ok;
+}
+}   // end of anonymous namespace
+
+int main()
+{
+	int failCount = 0;
+	if (!checkBounded(false, false))
+		failCount++;
+	if (!checkBounded(true, false))
+		failCount++;
+	if (!checkBounded(true, true))
+		failCount++;
+
+	printf("memory failures=%d\n", failCount);
+	return failCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
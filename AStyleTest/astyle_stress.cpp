@@ -0,0 +1,188 @@
+// astyle_stress.cpp
+// Copyright (c) 2023 The Artistic Style Authors.
+// This code is licensed under the MIT License.
+// License.md describes the conditions under which this software may be distributed.
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Thread safety stress test for the AStyleMain library entry point.
+ *
+ *   Each source file is formatted with several option sets by a new
+ *   ASFormatter for each job, which is not shared with anything, to get
+ *   the expected outputs. Then the threads format all of the jobs with
+ *   AStyleMain at the same time, each thread starting at a different
+ *   job, so the pooled formatters are leased by several threads. Every
+ *   output is compared with the expected output. The exit status is 0
+ *   if all of the outputs are the same.
+ *
+ *   "make check" runs it on two of the library sources. "make tsan"
+ *   builds it with ThreadSanitizer in the "build-tsan" directory and
+ *   runs it, ThreadSanitizer must not report a data race. The defaults
+ *   are small enough for a ThreadSanitizer run.
+ *
+ *   Usage:
+ *      astyle_stress [--threads=N] [--rounds=N] file ...
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ */
+
+#include "astyle_main.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// the option sets cover the formatter, the beautifier and the enhancer
+const char* const optionSets[] =
+{
+	"",
+	"style=gnu indent-preproc-cond break-blocks pad-oper",
+	"style=kr indent=tab max-code-length=60 add-braces",
+	"mode=c indent-switches indent-namespaces align-pointer=name",
+	"style=allman indent=spaces=2 pad-header unpad-paren delete-empty-lines",
+	"mode=java style=java attach-closing-while",
+	"mode=cs style=whitesmith indent-cases"
+};
+
+std::atomic<int> errorCount(0);
+
+// an option error is a failure of the test, the options are fixed
+void STDCALL errorHandler(int errorNumber, const char* errorMessage)
+{
+	errorCount++;
+	fprintf(stderr, "error %d - %s\n", errorNumber, errorMessage);
+}
+
+char* STDCALL memoryAlloc(unsigned long memoryNeeded)
+{
+	return new (std::nothrow) char[memoryNeeded];
+}
+
+// format one job with a new formatter, as AStyleMain formats it,
+// an empty string is returned for an option error
+std::string formatExpected(const std::string& source, const char* options)
+{
+	astyle::ASFormatter formatter;
+	astyle::ASOptions optionsParser(formatter);
+	std::vector<std::string> optionsVector;
+	std::stringstream optionStream(options);
+	optionsParser.importOptions(optionStream, optionsVector);
+	if (!optionsParser.parseOptions(optionsVector, "Invalid Artistic Style options:"))
+	{
+		errorHandler(130, optionsParser.getOptionErrors().c_str());
+		return std::string();
+	}
+
+	std::string formatted;
+	astyle::ASBufferIterator streamIterator(source.data(), source.size());
+	formatter.init(&streamIterator);
+	while (formatter.hasMoreLines())
+	{
+		formatted.append(formatter.nextLine());
+		if (formatter.hasMoreLines())
+			formatted.append(streamIterator.getOutputEOL());
+		else if (formatter.getIsLineReady())
+		{
+			// this can happen if the file is missing a closing brace and break-blocks is requested
+			formatted.append(streamIterator.getOutputEOL());
+			formatted.append(formatter.nextLine());
+		}
+	}
+	return formatted;
+}
+
+// format one job with AStyleMain, an empty string is returned for a null result
+std::string formatJob(const std::string& source, const char* options)
+{
+	char* textOut = AStyleMain(source.c_str(), options, errorHandler, memoryAlloc);
+	if (textOut == nullptr)
+		return std::string();
+	std::string formatted(textOut);
+	delete[] textOut;
+	return formatted;
+}
+
+// get the numeric value of an option, or -1 if the argument is not the option
+int getOptionValue(const char* arg, const char* option)
+{
+	size_t length = strlen(option);
+	if (strncmp(arg, option, length) != 0)
+		return -1;
+	return atoi(arg + length);
+}
+}   // end of anonymous namespace
+
+int main(int argc, char** argv)
+{
+	int threadCount = 4;
+	int rounds = 1;
+	std::vector<std::string> sources;
+	for (int i = 1; i < argc; i++)
+	{
+		int value;
+		if ((value = getOptionValue(argv[i], "--threads=")) >= 0)
+			threadCount = value;
+		else if ((value = getOptionValue(argv[i], "--rounds=")) >= 0)
+			rounds = value;
+		else
+		{
+			std::ifstream in(argv[i], std::ios::binary);
+			if (!in)
+			{
+				fprintf(stderr, "cannot open %s\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+			std::stringstream buffer;
+			buffer << in.rdbuf();
+			sources.emplace_back(buffer.str());
+		}
+	}
+	if (sources.empty() || threadCount < 1 || rounds < 1)
+	{
+		fprintf(stderr, "usage: astyle_stress [--threads=N] [--rounds=N] file ...\n");
+		return EXIT_FAILURE;
+	}
+
+	// a new formatter for each job gives the expected output
+	const size_t optionCount = sizeof(optionSets) / sizeof(optionSets[0]);
+	const size_t jobCount = sources.size() * optionCount;
+	std::vector<std::string> expected;
+	expected.reserve(jobCount);
+	for (size_t job = 0; job < jobCount; job++)
+		expected.emplace_back(formatExpected(sources[job % sources.size()], optionSets[job / sources.size()]));
+
+	// each thread runs all of the jobs starting at its own offset,
+	// so different files and options are formatted at the same time
+	std::atomic<int> mismatchCount(0);
+	std::vector<std::thread> threads;
+	for (int thread = 0; thread < threadCount; thread++)
+	{
+		threads.emplace_back([&, thread]()
+		{
+			for (int round = 0; round < rounds; round++)
+			{
+				for (size_t i = 0; i < jobCount; i++)
+				{
+					size_t job = (i + static_cast<size_t>(thread * rounds + round) * 13) % jobCount;
+					std::string formatted = formatJob(sources[job % sources.size()],
+					                                  optionSets[job / sources.size()]);
+					if (formatted != expected[job])
+						mismatchCount++;
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	printf("threads=%d jobs=%zu mismatches=%d errors=%d\n",
+	       threadCount, jobCount * threadCount * rounds, mismatchCount.load(), errorCount.load());
+	return (mismatchCount == 0 && errorCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
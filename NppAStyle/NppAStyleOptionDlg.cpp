@@ -1103,6 +1103,7 @@ INT_PTR CALLBACK NppAStyleOptionDlg::run_dlgProc( UINT Message, WPARAM wParam, L
 					astyleOptionSet->languageAStyleOption[m_languageMode] = * m_astyleOption;
 					// m_astyleOption->saveConfigInfo( astyleOptionSet->languageSectionNames[m_languageMode] ); // Save current Language AStyleOption
 					astyleOptionSet->saveConfigInfo(); // Save All Language AStyleOption
+					clearFormatterPool();
 
 					display( FALSE );
 				}
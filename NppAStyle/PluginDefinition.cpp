@@ -32,7 +32,6 @@
 #include "NppAStyleOptionDlg.h"
 #include "resource.h"
 #include "astyle_main.h"
-#include <sstream>
 #include "NppAStyleOption.h"
 
 #pragma comment(lib,"shlwapi.lib")
@@ -54,6 +53,9 @@ NppAStyleOptionDlg astyleOptionDlg;
 TCHAR NppAStyleConfigFilePath[MAX_PATH];
 NppAStyleOptionSet astyleOptionSet;
 
+// formatters with the options of astyleOptionSet, reused between commands
+astyle::ASFormatterPool formatterPool;
+
 
 TCHAR *initNppAStyleConfigFilePath( bool isInit )
 {
@@ -94,6 +96,7 @@ void pluginCleanUp()
 
 
 void formatCode();
+void formatSelection();
 void openOptionDlg();
 void openAboutDlg();
 void openReadMeDlg();
@@ -125,10 +128,11 @@ void commandMenuInit()
 	shKey->_key = 0x5A; //VK_Z
 
 	setCommand( 0, TEXT( "Format Code" ), formatCode, shKey, false );
-	setCommand( 1, TEXT( "Options ..." ), openOptionDlg, NULL, false );
-	setCommand( 2, TEXT( "---" ), NULL, NULL, false );
-	setCommand( 3, TEXT( "ReadMe ..." ), openReadMeDlg, NULL, false );
-	setCommand( 4, TEXT( "About ..." ), openAboutDlg, NULL, false );
+	setCommand( 1, TEXT( "Format Selection" ), formatSelection, NULL, false );
+	setCommand( 2, TEXT( "Options ..." ), openOptionDlg, NULL, false );
+	setCommand( 3, TEXT( "---" ), NULL, NULL, false );
+	setCommand( 4, TEXT( "ReadMe ..." ), openReadMeDlg, NULL, false );
+	setCommand( 5, TEXT( "About ..." ), openAboutDlg, NULL, false );
 
 	aboutDlg.init( ( HINSTANCE )hModule, nppData );
 	readmeDlg.init( ( HINSTANCE )hModule, nppData );
@@ -191,10 +195,8 @@ static void formatRunProcCallback( const char *in, const char *out, HWND hwin )
 		::SendMessage( hwin, SCI_SETTEXT, 0, ( LPARAM ) out );
 }
 
-void AStyleCode( const char *textBuffer, const NppAStyleOption &m_astyleOption, fpRunProc fpRunProcHandler, HWND hwin )
+static void setAStyleOption( astyle::ASFormatter &formatter, const NppAStyleOption &m_astyleOption )
 {
-	astyle::ASFormatter formatter;
-
 	m_astyleOption.setFormatterOption( formatter );
 
 	// 0 C, 1 C++, 2 Java, 3 C#, 4 Objective-C, 5 JavaScript
@@ -242,33 +244,71 @@ void AStyleCode( const char *textBuffer, const NppAStyleOption &m_astyleOption,
 			formatter.setSpaceIndentation( iTabSize );
 		}
 	}
+}
+
+// a formatter of the pool with the options of a language mode,
+// the key has the tab settings of the current view if they are used
+static astyle::ASFormatterPool::Lease leaseFormatter( int languageMode )
+{
+	const NppAStyleOption &m_astyleOption = astyleOptionSet.languageAStyleOption[languageMode];
+	std::string key = std::to_string( languageMode );
+	if( m_astyleOption.isSameAsNppCurView )
+	{
+		HWND curScintilla = getNppCurrentScintilla();
+		key += ' ' + std::to_string( ::SendMessage( curScintilla, SCI_GETUSETABS, 0, 0 ) );
+		key += ' ' + std::to_string( ::SendMessage( curScintilla, SCI_GETTABWIDTH, 0, 0 ) );
+	}
+
+	return formatterPool.acquire( key, [&m_astyleOption]( astyle::ASFormatter &formatter )
+	{
+		setAStyleOption( formatter, m_astyleOption );
+		return true;
+	} );
+}
 
-	std::stringstream in( textBuffer );
-	astyle::ASStreamIterator<std::stringstream> streamIterator( &in );
-	std::ostringstream out;
+// the options of astyleOptionSet have changed
+void clearFormatterPool()
+{
+	formatterPool.clear();
+}
+
+static void formatText( const char *textBuffer, astyle::ASFormatter &formatter, fpRunProc fpRunProcHandler, HWND hwin )
+{
+	astyle::ASBufferIterator streamIterator( textBuffer, strlen( textBuffer ) );
+	astyle::ASStringSink out;
 	formatter.init( &streamIterator );
 
 	while( formatter.hasMoreLines() )
 	{
-		out << formatter.nextLine();
+		out.write( formatter.nextLine() );
 		if( formatter.hasMoreLines() )
-			out << streamIterator.getOutputEOL();
+			out.write( streamIterator.getOutputEOL() );
 		else
 		{
 			// this can happen if the file if missing a closing bracket and break-blocks is requested
 			if( formatter.getIsLineReady() )
 			{
-				out << streamIterator.getOutputEOL();
-				out << formatter.nextLine();
+				out.write( streamIterator.getOutputEOL() );
+				out.write( formatter.nextLine() );
 			}
 		}
 	}
 
-	fpRunProcHandler( textBuffer, out.str().c_str(), hwin );
+	fpRunProcHandler( textBuffer, out.getData(), hwin );
 }
 
+void AStyleCode( const char *textBuffer, const NppAStyleOption &m_astyleOption, fpRunProc fpRunProcHandler, HWND hwin )
+{
+	astyle::ASFormatter formatter;
+
+	setAStyleOption( formatter, m_astyleOption );
 
-void formatCode()
+	formatText( textBuffer, formatter, fpRunProcHandler, hwin );
+}
+
+
+// 0 C, 1 C++, 2 Java, 3 C#, 4 Objective-C, 5 JavaScript, -1 if not supported
+static int getAStyleLanguageMode()
 {
 	int langType;
 	int languageMode = 0;
@@ -301,9 +341,18 @@ void formatCode()
 	else
 	{
 		::MessageBox( NULL, TEXT( "AStyle only support C, C++, Objective-C, C# and Java" ), TEXT( "NppAStyle Message" ), 0 );
-		return;
+		return -1;
 	}
 
+	return languageMode;
+}
+
+void formatCode()
+{
+	int languageMode = getAStyleLanguageMode();
+	if( languageMode < 0 )
+		return;
+
 	if( astyleOptionSet.languageAStyleOption[languageMode].formattingStyle == 0 )
 		return;
 
@@ -324,13 +373,67 @@ void formatCode()
 	const unsigned int pos_cur = ::SendMessage( curScintilla, SCI_GETCURRENTPOS, 0, 0 );
 	const unsigned int lineNumber_cur = ::SendMessage( curScintilla, SCI_LINEFROMPOSITION, pos_cur, 0 );
 
-	AStyleCode( textBuffer, astyleOptionSet.languageAStyleOption[languageMode], formatRunProcCallback, curScintilla );
+	astyle::ASFormatterPool::Lease formatter = leaseFormatter( languageMode );
+	formatText( textBuffer, *formatter, formatRunProcCallback, curScintilla );
 
 	::SendMessage( curScintilla, SCI_GOTOLINE, lineNumber_cur, 0 );
 
 	::free( textBuffer );
 }
 
+void formatSelection()
+{
+	int languageMode = getAStyleLanguageMode();
+	if( languageMode < 0 )
+		return;
+
+	if( astyleOptionSet.languageAStyleOption[languageMode].formattingStyle == 0 )
+		return;
+
+	HWND curScintilla = getNppCurrentScintilla();
+
+	bool isReadOnly = 0 != ::SendMessage( curScintilla, SCI_GETREADONLY, 0, 0 );
+	if( isReadOnly )
+	{
+		::MessageBox( NULL, TEXT( "Current document is read-only !" ), TEXT( "NppAStyle Message" ), 0 );
+		return;
+	}
+
+	// the lines of the selection, a selection ending at a line start does not include the line
+	const unsigned int pos_start = ::SendMessage( curScintilla, SCI_GETSELECTIONSTART, 0, 0 );
+	const unsigned int pos_end = ::SendMessage( curScintilla, SCI_GETSELECTIONEND, 0, 0 );
+	int firstLine = ::SendMessage( curScintilla, SCI_LINEFROMPOSITION, pos_start, 0 );
+	int lastLine = ::SendMessage( curScintilla, SCI_LINEFROMPOSITION, pos_end, 0 );
+	if( lastLine > firstLine && ( unsigned int )::SendMessage( curScintilla, SCI_POSITIONFROMLINE, lastLine, 0 ) == pos_end )
+		lastLine--;
+
+	int textSize = ( int )::SendMessage( curScintilla, SCI_GETLENGTH, 0, 0 );
+	char *textBuffer = ( char * )::malloc( textSize + 1 );
+	::SendMessage( curScintilla, SCI_GETTEXT, ( WPARAM )( textSize + 1 ), ( LPARAM )textBuffer );
+
+	astyle::ASFormatterPool::Lease formatter = leaseFormatter( languageMode );
+
+	// the range may be widened to whole statements
+	astyle::ASRangeFormatter rangeFormatter( *formatter );
+	if( rangeFormatter.format( textBuffer, textSize, firstLine, lastLine ) )
+	{
+		astyle::ASStringSink out;
+		rangeFormatter.writeOutput( out );
+		size_t sourceStart = rangeFormatter.getSourceStart();
+		size_t sourceLength = rangeFormatter.getSourceEnd() - sourceStart;
+		if( out.getText().compare( 0, std::string::npos, textBuffer + sourceStart, sourceLength ) != 0 )
+		{
+			::SendMessage( curScintilla, SCI_SETTARGETSTART, sourceStart, 0 );
+			::SendMessage( curScintilla, SCI_SETTARGETEND, sourceStart + sourceLength, 0 );
+			::SendMessage( curScintilla, SCI_REPLACETARGET, out.getText().length(), ( LPARAM ) out.getData() );
+		}
+	}
+
+	::SendMessage( curScintilla, SCI_GOTOLINE, firstLine, 0 );
+
+	::free( textBuffer );
+}
+
 void openOptionDlg()
 {
 	astyleOptionDlg.doDialog();
@@ -40,7 +40,7 @@ const TCHAR NPP_PLUGIN_NAME[] = TEXT( "NppAStyle" );
 //-- STEP 2. DEFINE YOUR PLUGIN COMMAND NUMBER --//
 //-----------------------------------------------//
 // Here define the number of your plugin commands
-const int nbFunc = 5;
+const int nbFunc = 6;
 
 
 // Initialization of your plugin data
@@ -67,4 +67,7 @@ struct NppAStyleOption;
 
 void AStyleCode( const char *textBuffer, const NppAStyleOption &m_astyleOption, fpRunProc fpRunProcHandler, HWND hwin );
 
+// delete the formatters prepared with the previous options
+void clearFormatterPool();
+
 #endif // _PLUGINDEFINITION_H_